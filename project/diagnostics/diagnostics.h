@@ -51,6 +51,17 @@ extern "C" {
 
 #define ENABLE_DIAGNOSTICS
     
+/* Fault black-box recorder, see fault_recorder.h */
+#define ENABLE_FAULT_RECORDER
+    
+/* Size in bytes of the X2CScope buffer */
+#define DIAGNOSTICS_BUFFER_SIZE     4900
+/* RAM in bytes for the X2CScope buffer and the fault recorder buffer, out of
+ * 8KB of dsPIC33CK64MC105, rest is left to application data and stack */
+#define DIAGNOSTICS_RAM_BUDGET      6144
+    
+#include <stdint.h>
+    
 /**
  * Initializes diagnostics
  */
@@ -66,6 +77,12 @@ void DiagnosticsStepIsr(void);
  */
 void DiagnosticsStepMain(void);
 
+/**
+ * Returns the X2CScope buffer and its size in bytes, for reuse when the scope
+ * is not in use
+ */
+uint8_t *DiagnosticsBufferGet(uint16_t *);
+
 #ifdef __cplusplus
 }
 #endif
@@ -48,11 +48,12 @@
 
 #include "X2CScope.h"
 #include "uart1.h"
+#include "diagnostics.h"
 #include <stdint.h>
 
-#define X2C_DATA __attribute__((section("x2cscope_data_buf")))
+#define X2C_DATA __attribute__((section("x2cscope_data_buf"),aligned(2)))
 #define X2C_BAUDRATE_DIVIDER 54
-#define X2C_BUFFER_SIZE 4900
+#define X2C_BUFFER_SIZE DIAGNOSTICS_BUFFER_SIZE
 X2C_DATA static uint8_t X2C_BUFFER[X2C_BUFFER_SIZE];
     /*
      * baud rate = 100MHz/16/(1+baudrate_divider) for highspeed = false
@@ -107,6 +108,12 @@ void DiagnosticsStepIsr(void)
     X2CScope_Update();
 }
 
+uint8_t *DiagnosticsBufferGet(uint16_t *pSize)
+{
+    *pSize = sizeof(X2C_BUFFER);
+    return X2C_BUFFER;
+}
+
 /* ---------- communication primitives used by X2CScope library ---------- */
 
 static void X2CScope_sendSerial(uint8_t data)
@@ -0,0 +1,468 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file fault_recorder.c
+ *
+ * @brief This module implements the fault black-box recorder, a circular RAM
+ * buffer of selected signals which freezes on a motor or PFC fault.
+ *
+ * Component: DIAGNOSTICS
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+
+#include "fault_recorder.h"
+#include "uart1.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define FAULT_RECORDER_BAUDRATE_DIVIDER     54
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+FAULT_RECORDER_T faultRecorder;
+
+#ifndef FAULT_RECORDER_SHARE_X2C_BUFFER
+static int16_t faultRecorderBuffer[FAULT_RECORDER_BUFFER_SIZE/2];
+#endif
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+#ifdef FAULT_RECORDER_UART_DUMP
+static uint8_t FaultRecorderFrameByte(FAULT_RECORDER_T *, uint16_t);
+#endif
+
+// </editor-fold>
+
+/**
+* <B> Function: void FaultRecorderInit(void)  </B>
+*
+* @brief Function to assign the recorder buffer and remove all channels. When
+* X2CScope is not in use, the X2CScope buffer is reused and UART1 is 
+* configured for the dump.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> FaultRecorderInit(); </CODE>
+*
+*/
+void FaultRecorderInit(void)
+{
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    
+#ifdef FAULT_RECORDER_SHARE_X2C_BUFFER
+    uint16_t bufferSize;
+    
+    pRecorder->pBuffer = (int16_t *)DiagnosticsBufferGet(&bufferSize);
+    pRecorder->bufferWords = bufferSize >> 1;
+#else
+    pRecorder->pBuffer = faultRecorderBuffer;
+    pRecorder->bufferWords = sizeof(faultRecorderBuffer) >> 1;
+#endif
+    
+    pRecorder->channelCount = 0;
+    pRecorder->sampleCapacity = 0;
+    pRecorder->source = FAULT_RECORDER_SOURCE_NONE;
+    pRecorder->faultCode = 0;
+    pRecorder->state = FAULT_RECORDER_IDLE;
+    
+#ifdef FAULT_RECORDER_UART_DUMP
+    UART1_InterruptReceiveDisable();
+    UART1_InterruptReceiveFlagClear();
+    UART1_InterruptTransmitDisable();
+    UART1_InterruptTransmitFlagClear();
+    UART1_Initialize();
+    UART1_BaudRateDividerSet(FAULT_RECORDER_BAUDRATE_DIVIDER);
+    UART1_SpeedModeStandard();
+    UART1_ModuleEnable();
+#endif
+}
+
+/**
+* <B> Function: bool FaultRecorderChannelAdd(uint16_t, 
+*                                       const volatile int16_t *)  </B>
+*
+* @brief Function to add a signal to the recorder. Channels are added while
+* the recorder is not armed.
+*
+* @param    channel identifier - FAULT_RECORDER_CHANNEL_ID_T.
+* @param    pointer to the recorded signal.
+* @return   true if channel is added, false if no channel is free.
+* @example
+* <CODE> FaultRecorderChannelAdd(FAULT_RECORDER_CH_IA, &ia); </CODE>
+*
+*/
+bool FaultRecorderChannelAdd(uint16_t channelId, const volatile int16_t *pSignal)
+{
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    
+    if((pRecorder->channelCount >= FAULT_RECORDER_CHANNELS_MAX) ||
+        (pRecorder->state != FAULT_RECORDER_IDLE))
+    {
+        return false;
+    }
+    
+    pRecorder->channelId[pRecorder->channelCount] = (uint8_t)channelId;
+    pRecorder->pChannel[pRecorder->channelCount] = pSignal;
+    pRecorder->channelCount++;
+    
+    return true;
+}
+
+/**
+* <B> Function: void FaultRecorderArm(void)  </B>
+*
+* @brief Function to clear the buffer, split it into pre and post trigger
+* samples and start recording.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> FaultRecorderArm(); </CODE>
+*
+*/
+void FaultRecorderArm(void)
+{
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    uint16_t capacity;
+    
+    pRecorder->state = FAULT_RECORDER_IDLE;
+    
+    if(pRecorder->channelCount == 0)
+    {
+        return;
+    }
+    
+    capacity = pRecorder->bufferWords / pRecorder->channelCount;
+    if(capacity < 2)
+    {
+        return;
+    }
+    
+    pRecorder->sampleCapacity = capacity;
+    pRecorder->postTrigger = capacity - (uint16_t)(__builtin_muluu(capacity,
+                                FAULT_RECORDER_PRETRIGGER_PERCENT) / 100);
+    if(pRecorder->postTrigger == 0)
+    {
+        pRecorder->postTrigger = 1;
+    }
+    pRecorder->postTriggerCount = pRecorder->postTrigger;
+    pRecorder->sampleCount = 0;
+    pRecorder->writeIndex = 0;
+    pRecorder->triggerSample = 0;
+    pRecorder->dividerCount = 0;
+    pRecorder->source = FAULT_RECORDER_SOURCE_NONE;
+    pRecorder->faultCode = 0;
+    
+    pRecorder->state = FAULT_RECORDER_ARMED;
+}
+
+/**
+* <B> Function: void FaultRecorderTrigger(uint16_t, uint16_t)  </B>
+*
+* @brief Function to trigger the recorder. Only the first trigger after arming
+* is recorded, the buffer freezes once the post trigger samples are taken.
+* Called from the MC1 (IP6) and PFC (IP7) interrupts, the CPU priority is 
+* raised to 7 so that a trigger is not interrupted by the other source and the
+* first trigger wins.
+*
+* @param    trigger source - FAULT_RECORDER_SOURCE_T.
+* @param    fault state of the trigger source.
+* @return   none.
+* @example
+* <CODE> FaultRecorderTrigger(FAULT_RECORDER_SOURCE_MC1, faultState); </CODE>
+*
+*/
+void FaultRecorderTrigger(uint16_t source, uint16_t faultCode)
+{
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    uint16_t savedIpl;
+    
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    if(pRecorder->state == FAULT_RECORDER_ARMED)
+    {
+        pRecorder->source = source;
+        pRecorder->faultCode = faultCode;
+        pRecorder->postTriggerCount = pRecorder->postTrigger;
+        pRecorder->state = FAULT_RECORDER_TRIGGERED;
+    }
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+/**
+* <B> Function: void FaultRecorderDumpRequest(void)  </B>
+*
+* @brief Function to start sending the frozen buffer over UART1. Dump frame
+* (little endian) is :
+*   - 'F','R', format version, channel count
+*   - sample count, sample divider, trigger sample, source, fault code(16 bit)
+*   - channel identifiers(8 bit each)
+*   - samples oldest first, channels interleaved(16 bit each)
+*   - 16 bit sum of all preceding bytes
+* Request is ignored unless the buffer is frozen and the recorder owns UART1.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> FaultRecorderDumpRequest(); </CODE>
+*
+*/
+void FaultRecorderDumpRequest(void)
+{
+#ifdef FAULT_RECORDER_UART_DUMP
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    
+    if(pRecorder->state == FAULT_RECORDER_FROZEN)
+    {
+        pRecorder->dumpIndex = 0;
+        pRecorder->checksum = 0;
+        pRecorder->dumpSize = FAULT_RECORDER_HEADER_SIZE + 
+            pRecorder->channelCount + 2 + 
+            (__builtin_muluu(pRecorder->sampleCount, 
+                                pRecorder->channelCount) << 1);
+        pRecorder->state = FAULT_RECORDER_DUMP;
+    }
+#endif
+}
+
+/**
+* <B> Function: void FaultRecorderStepIsr(void)  </B>
+*
+* @brief Function to record one sample of all channels every 
+* FAULT_RECORDER_SAMPLE_DIVIDER calls. Called from control loop ISR after the
+* control state machine.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> FaultRecorderStepIsr(); </CODE>
+*
+*/
+void FaultRecorderStepIsr(void)
+{
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    int16_t *pSample;
+    uint16_t channel;
+    
+    if((pRecorder->state != FAULT_RECORDER_ARMED) &&
+        (pRecorder->state != FAULT_RECORDER_TRIGGERED))
+    {
+        return;
+    }
+    
+    pRecorder->dividerCount++;
+    if(pRecorder->dividerCount < FAULT_RECORDER_SAMPLE_DIVIDER)
+    {
+        return;
+    }
+    pRecorder->dividerCount = 0;
+    
+    pSample = pRecorder->pBuffer + 
+            __builtin_muluu(pRecorder->writeIndex, pRecorder->channelCount);
+    for(channel = 0; channel < pRecorder->channelCount; channel++)
+    {
+        pSample[channel] = *pRecorder->pChannel[channel];
+    }
+    
+    pRecorder->writeIndex++;
+    if(pRecorder->writeIndex >= pRecorder->sampleCapacity)
+    {
+        pRecorder->writeIndex = 0;
+    }
+    if(pRecorder->sampleCount < pRecorder->sampleCapacity)
+    {
+        pRecorder->sampleCount++;
+    }
+    
+    if(pRecorder->state == FAULT_RECORDER_TRIGGERED)
+    {
+        pRecorder->postTriggerCount--;
+        if(pRecorder->postTriggerCount == 0)
+        {
+            pRecorder->triggerSample = 
+                            pRecorder->sampleCount - pRecorder->postTrigger;
+            pRecorder->state = FAULT_RECORDER_FROZEN;
+        }
+    }
+}
+
+/**
+* <B> Function: void FaultRecorderStepMain(void)  </B>
+*
+* @brief Function to process UART1 commands and send the dump frame without
+* blocking, as long as the transmit buffer has space.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> FaultRecorderStepMain(); </CODE>
+*
+*/
+void FaultRecorderStepMain(void)
+{
+#ifdef FAULT_RECORDER_UART_DUMP
+    FAULT_RECORDER_T *pRecorder = &faultRecorder;
+    uint8_t data;
+    
+    if(UART1_IsReceiveBufferDataReady())
+    {
+        data = (uint8_t)UART1_DataRead();
+        if(data == FAULT_RECORDER_CMD_DUMP)
+        {
+            FaultRecorderDumpRequest();
+        }
+        else if((data == FAULT_RECORDER_CMD_ARM) && 
+                (pRecorder->state != FAULT_RECORDER_DUMP))
+        {
+            FaultRecorderArm();
+        }
+    }
+    
+    while((pRecorder->state == FAULT_RECORDER_DUMP) &&
+            (!UART1_StatusBufferFullTransmitGet()))
+    {
+        data = FaultRecorderFrameByte(pRecorder, pRecorder->dumpIndex);
+        if(pRecorder->dumpIndex < (pRecorder->dumpSize - 2))
+        {
+            pRecorder->checksum += data;
+        }
+        UART1_DataWrite(data);
+        
+        pRecorder->dumpIndex++;
+        if(pRecorder->dumpIndex >= pRecorder->dumpSize)
+        {
+            pRecorder->state = FAULT_RECORDER_FROZEN;
+        }
+    }
+#endif
+}
+
+#ifdef FAULT_RECORDER_UART_DUMP
+/**
+* <B> Function: uint8_t FaultRecorderFrameByte(FAULT_RECORDER_T *, uint16_t) 
+* </B>
+*
+* @brief Function to get a byte of the dump frame.
+*
+* @param    pointer to the recorder data structure.
+* @param    byte index in the frame.
+* @return   frame byte.
+* @example
+* <CODE> data = FaultRecorderFrameByte(&faultRecorder, index); </CODE>
+*
+*/
+static uint8_t FaultRecorderFrameByte(FAULT_RECORDER_T *pRecorder, 
+                                        uint16_t index)
+{
+    uint16_t word, sample, oldest, sampleBytes;
+    
+    if(index < FAULT_RECORDER_HEADER_SIZE)
+    {
+        switch(index >> 1)
+        {
+            case 0:
+                word = (FAULT_RECORDER_SYNC1 << 8) | FAULT_RECORDER_SYNC0;
+                break;
+            case 1:
+                word = (pRecorder->channelCount << 8) | 
+                                            FAULT_RECORDER_FORMAT_VERSION;
+                break;
+            case 2:
+                word = pRecorder->sampleCount;
+                break;
+            case 3:
+                word = FAULT_RECORDER_SAMPLE_DIVIDER;
+                break;
+            case 4:
+                word = pRecorder->triggerSample;
+                break;
+            case 5:
+                word = pRecorder->source;
+                break;
+            default:
+                word = pRecorder->faultCode;
+                break;
+        }
+    }
+    else
+    {
+        index -= FAULT_RECORDER_HEADER_SIZE;
+        if(index < pRecorder->channelCount)
+        {
+            return pRecorder->channelId[index];
+        }
+        index -= pRecorder->channelCount;
+        
+        sampleBytes = pRecorder->channelCount << 1;
+        sample = index / sampleBytes;
+        if(sample >= pRecorder->sampleCount)
+        {
+            word = pRecorder->checksum;
+            index = index - __builtin_muluu(sample, sampleBytes);
+        }
+        else
+        {
+            /* Oldest sample is at write index once the buffer has wrapped */
+            oldest = (pRecorder->sampleCount < pRecorder->sampleCapacity) ?
+                                                0 : pRecorder->writeIndex;
+            sample = sample + oldest;
+            if(sample >= pRecorder->sampleCapacity)
+            {
+                sample -= pRecorder->sampleCapacity;
+            }
+            index = index - __builtin_muluu(index / sampleBytes, sampleBytes);
+            word = (uint16_t)pRecorder->pBuffer[
+                __builtin_muluu(sample, pRecorder->channelCount) + (index >> 1)];
+        }
+    }
+    
+    return (index & 1) ? (uint8_t)(word >> 8) : (uint8_t)word;
+}
+#endif
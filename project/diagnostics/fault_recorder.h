@@ -0,0 +1,226 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file fault_recorder.h
+ *
+ * @brief This module implements the fault black-box recorder, a circular RAM
+ * buffer of selected signals which freezes on a motor or PFC fault.
+ *
+ * Component: DIAGNOSTICS
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __FAULT_RECORDER_H
+#define __FAULT_RECORDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "diagnostics.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Maximum number of recorded signals */
+#define FAULT_RECORDER_CHANNELS_MAX         16
+/* Number of control loop ISR ticks(62.5us) between samples */
+#define FAULT_RECORDER_SAMPLE_DIVIDER       4
+/* Share of the buffer holding samples taken before the trigger, in percent */
+#define FAULT_RECORDER_PRETRIGGER_PERCENT   75
+
+#ifdef ENABLE_DIAGNOSTICS
+/* X2CScope is in use, recorder needs dedicated RAM and the frozen buffer is 
+ * read with X2CScope. Samples kept in the dedicated buffer with all channels
+ * configured, 32 samples hold 8ms at FAULT_RECORDER_SAMPLE_DIVIDER 4. Fewer
+ * channels give proportionally more samples */
+    #define FAULT_RECORDER_BUFFER_SAMPLES   32
+/* Size in bytes */
+    #define FAULT_RECORDER_BUFFER_SIZE      (FAULT_RECORDER_BUFFER_SAMPLES* \
+                                            FAULT_RECORDER_CHANNELS_MAX*2)
+    #if (DIAGNOSTICS_BUFFER_SIZE + FAULT_RECORDER_BUFFER_SIZE) > \
+                                                        DIAGNOSTICS_RAM_BUDGET
+        #error "Fault recorder and X2CScope buffers exceed DIAGNOSTICS_RAM_BUDGET"
+    #endif
+#else
+/* X2CScope is not in use, recorder reuses the X2CScope buffer and owns UART1
+ * for dumping the frozen buffer */
+    #define FAULT_RECORDER_SHARE_X2C_BUFFER
+    #define FAULT_RECORDER_UART_DUMP
+#endif
+
+/* UART1 commands accepted when FAULT_RECORDER_UART_DUMP is defined */
+#define FAULT_RECORDER_CMD_DUMP             'D'
+#define FAULT_RECORDER_CMD_ARM              'A'
+
+/* Dump frame : header, channel IDs, samples(oldest first), checksum */
+#define FAULT_RECORDER_SYNC0                'F'
+#define FAULT_RECORDER_SYNC1                'R'
+#define FAULT_RECORDER_FORMAT_VERSION       1
+#define FAULT_RECORDER_HEADER_SIZE          14
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef enum
+{
+    FAULT_RECORDER_IDLE = 0,        /* No channels or buffer configured */
+    FAULT_RECORDER_ARMED = 1,       /* Recording, waiting for trigger */
+    FAULT_RECORDER_TRIGGERED = 2,   /* Recording post trigger samples */
+    FAULT_RECORDER_FROZEN = 3,      /* Buffer frozen, ready for dump */
+    FAULT_RECORDER_DUMP = 4,        /* Frozen buffer being sent over UART */
+
+} FAULT_RECORDER_STATE_T;
+
+typedef enum
+{
+    FAULT_RECORDER_SOURCE_NONE = 0,
+    FAULT_RECORDER_SOURCE_MC1 = 1,  /* Motor control 1 fault */
+    FAULT_RECORDER_SOURCE_PFC = 2,  /* PFC fault */
+
+} FAULT_RECORDER_SOURCE_T;
+
+/**
+ * Signal identifiers, sent in the dump so that host decoder can name and
+ * scale the recorded channels
+ */
+typedef enum
+{
+    FAULT_RECORDER_CH_IA = 0,
+    FAULT_RECORDER_CH_IB = 1,
+    FAULT_RECORDER_CH_ID = 2,
+    FAULT_RECORDER_CH_IQ = 3,
+    FAULT_RECORDER_CH_VD = 4,
+    FAULT_RECORDER_CH_VQ = 5,
+    FAULT_RECORDER_CH_THETA = 6,
+    FAULT_RECORDER_CH_OMEGA = 7,
+    FAULT_RECORDER_CH_VDC = 8,
+    FAULT_RECORDER_CH_MC1_STATE = 9,
+    FAULT_RECORDER_CH_FOC_STATE = 10,
+    FAULT_RECORDER_CH_MC1_FAULT = 11,
+    FAULT_RECORDER_CH_PFC_IL = 12,
+    FAULT_RECORDER_CH_PFC_VAC = 13,
+    FAULT_RECORDER_CH_PFC_STATE = 14,
+    FAULT_RECORDER_CH_PFC_FAULT = 15,
+
+} FAULT_RECORDER_CHANNEL_ID_T;
+
+typedef struct
+{
+    uint16_t
+        state,              /* Recorder state - FAULT_RECORDER_STATE_T */
+        channelCount,       /* Number of configured channels */
+        bufferWords,        /* Buffer size in 16 bit words */
+        sampleCapacity,     /* Buffer size in samples */
+        sampleCount,        /* Valid samples in buffer */
+        writeIndex,         /* Sample index for next write */
+        postTrigger,        /* Samples to record after trigger */
+        postTriggerCount,   /* Remaining post trigger samples */
+        triggerSample,      /* Trigger position from oldest sample */
+        dividerCount,       /* Sample divider counter */
+        source,             /* Trigger source - FAULT_RECORDER_SOURCE_T */
+        faultCode,          /* Fault state of the trigger source */
+        dumpIndex,          /* Byte index of frame being sent */
+        dumpSize,           /* Frame size in bytes */
+        checksum;           /* Running checksum of frame being sent */
+
+    uint8_t
+        channelId[FAULT_RECORDER_CHANNELS_MAX]; /* FAULT_RECORDER_CHANNEL_ID_T*/
+
+    const volatile int16_t
+        *pChannel[FAULT_RECORDER_CHANNELS_MAX]; /* Recorded signals */
+
+    int16_t
+        *pBuffer;           /* Sample buffer */
+
+} FAULT_RECORDER_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+/**
+ * Initializes the recorder buffer and removes all channels
+ */
+void FaultRecorderInit(void);
+
+/**
+ * Adds a signal to the recorder, returns false if no channel is free.
+ * Channels are added before FaultRecorderArm().
+ */
+bool FaultRecorderChannelAdd(uint16_t, const volatile int16_t *);
+
+/**
+ * Clears the buffer and starts recording
+ */
+void FaultRecorderArm(void);
+
+/**
+ * Starts the post trigger recording, called on entry to a fault state
+ */
+void FaultRecorderTrigger(uint16_t, uint16_t);
+
+/**
+ * Requests a dump of the frozen buffer over UART1
+ */
+void FaultRecorderDumpRequest(void);
+
+/**
+ * Records a sample, executes during the control loop ISR
+ */
+void FaultRecorderStepIsr(void);
+
+/**
+ * Handles UART commands and dump, executes during the main loop
+ */
+void FaultRecorderStepMain(void);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FAULT_RECORDER_H */
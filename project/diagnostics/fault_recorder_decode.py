@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""
+Host decoder for the fault black-box recorder dump (diagnostics/fault_recorder.c).
+
+Usage:
+    fault_recorder_decode.py --port COM5 [--baud 115200] [--csv out.csv]
+    fault_recorder_decode.py --file dump.bin [--csv out.csv]
+
+With --port the script sends the dump command 'D' and reads the frame; pyserial
+is required in that case. Samples are printed (or written to CSV) in physical
+units, using the scaling of mc1_user_params.h / pfc_userparams.h.
+"""
+
+import argparse
+import struct
+import sys
+
+SYNC = b'FR'
+FORMAT_VERSION = 1
+HEADER_SIZE = 14
+CONTROL_PERIOD_SEC = 62.5e-6
+
+# Channel identifier : (name, full scale of Q15 value, unit)
+CHANNELS = {
+    0: ('Ia', 22.0, 'A'),
+    1: ('Ib', 22.0, 'A'),
+    2: ('Id', 22.0, 'A'),
+    3: ('Iq', 22.0, 'A'),
+    4: ('Vd', 311.0, 'V'),
+    5: ('Vq', 311.0, 'V'),
+    6: ('theta', 180.0, 'deg'),
+    7: ('omega', 7500.0, 'rpm'),
+    8: ('Vdc', 453.3, 'V'),
+    9: ('mc1State', None, ''),
+    10: ('focState', None, ''),
+    11: ('mc1Fault', None, ''),
+    12: ('pfcIL', 22.0, 'A'),
+    13: ('pfcVac', 453.0, 'V'),
+    14: ('pfcState', None, ''),
+    15: ('pfcFault', None, ''),
+}
+
+SOURCES = {0: 'none', 1: 'MC1', 2: 'PFC'}
+
+
+def decode(frame):
+    if len(frame) < HEADER_SIZE or frame[0:2] != SYNC:
+        raise ValueError('frame sync not found')
+    version, channels = frame[2], frame[3]
+    if version != FORMAT_VERSION:
+        raise ValueError('unsupported format version %d' % version)
+    samples, divider, trigger, source, fault = struct.unpack_from(
+        '<5H', frame, 4)
+    size = HEADER_SIZE + channels + 2 * samples * channels + 2
+    if len(frame) < size:
+        raise ValueError('frame truncated, %d of %d bytes' % (len(frame), size))
+    checksum, = struct.unpack_from('<H', frame, size - 2)
+    if (sum(frame[:size - 2]) & 0xFFFF) != checksum:
+        raise ValueError('checksum error')
+
+    ids = list(frame[HEADER_SIZE:HEADER_SIZE + channels])
+    data = struct.unpack_from('<%dh' % (samples * channels), frame,
+                              HEADER_SIZE + channels)
+    rows = [data[i * channels:(i + 1) * channels] for i in range(samples)]
+    info = {
+        'samples': samples,
+        'period': divider * CONTROL_PERIOD_SEC,
+        'trigger': trigger,
+        'source': SOURCES.get(source, str(source)),
+        'fault': fault,
+    }
+    return info, ids, rows
+
+
+def scale(channelId, value):
+    scaleInfo = CHANNELS.get(channelId)
+    if scaleInfo is None or scaleInfo[1] is None:
+        return value & 0xFFFF
+    return value * scaleInfo[1] / 32768.0
+
+
+def read_port(port, baud):
+    import serial
+    with serial.Serial(port, baud, timeout=2) as link:
+        link.reset_input_buffer()
+        link.write(b'D')
+        frame = bytearray(link.read(HEADER_SIZE))
+        if len(frame) < HEADER_SIZE:
+            raise ValueError('no response, is the recorder frozen?')
+        channels = frame[3]
+        samples, = struct.unpack_from('<H', frame, 4)
+        frame += link.read(channels + 2 * samples * channels + 2)
+        return bytes(frame)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                        formatter_class=argparse.RawDescriptionHelpFormatter)
+    group = parser.add_mutually_exclusive_group(required=True)
+    group.add_argument('--port')
+    group.add_argument('--file')
+    parser.add_argument('--baud', type=int, default=115200)
+    parser.add_argument('--csv')
+    parser.add_argument('--raw', help='save received frame to file')
+    args = parser.parse_args()
+
+    if args.port:
+        frame = read_port(args.port, args.baud)
+        if args.raw:
+            with open(args.raw, 'wb') as f:
+                f.write(frame)
+    else:
+        with open(args.file, 'rb') as f:
+            frame = f.read()
+
+    info, ids, rows = decode(frame)
+    print('source %s, fault 0x%04X, %d samples every %.1f us, trigger at %d'
+          % (info['source'], info['fault'], info['samples'],
+             info['period'] * 1e6, info['trigger']), file=sys.stderr)
+
+    names = [CHANNELS.get(i, ('ch%d' % i,))[0] for i in ids]
+    out = open(args.csv, 'w') if args.csv else sys.stdout
+    out.write('t_ms,' + ','.join(names) + '\n')
+    for n, row in enumerate(rows):
+        t = (n - info['trigger']) * info['period'] * 1e3
+        out.write('%.4f,' % t + ','.join(
+            '%g' % scale(i, v) for i, v in zip(ids, row)) + '\n')
+    if out is not sys.stdout:
+        out.close()
+
+
+if __name__ == '__main__':
+    main()
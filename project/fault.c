@@ -53,13 +53,18 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+#include <libq.h>
+
 #include "fault.h"
+#include "general.h"
 
 // </editor-fold> 
 
 // <editor-fold defaultstate="collapsed" desc="Function Declarations ">
 
-
+static bool MCAPP_FaultDebounce(MCAPP_FAULT_T *, uint16_t, bool);
+static bool MCAPP_OverCurrentFaultCheck(MCAPP_FAULT_T *);
+static bool MCAPP_PhaseLossFaultCheck(MCAPP_FAULT_T *);
 
 // </editor-fold> 
 
@@ -72,45 +77,356 @@
 // <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
 
 /**
- * <B> Function: MCAPP_OverCurrentFault_Detect(MCAPP_MEASURE_T *pMotorInputs, MCAPP_FAULT_T * pFault)  </B>
+ * <B> Function: MCAPP_FaultInit(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function to reset the debounce counters of all fault detectors.
+ * Active faults and the restart history are retained.
+ * @param Pointer to the fault data structure
+ * @return none.
+ * @example
+ * <CODE> MCAPP_FaultInit(&fault); </CODE>
+ */
+void MCAPP_FaultInit(MCAPP_FAULT_T *pFault)
+{
+    uint16_t faultId;
+    
+    for(faultId = 0; faultId < MCAPP_FAULT_ID_COUNT; faultId++)
+    {
+        pFault->detect[faultId].count = 0;
+    }
+    
+    pFault->phaseLoss.sumIa = 0;
+    pFault->phaseLoss.sumIb = 0;
+    pFault->phaseLoss.sumIc = 0;
+    pFault->phaseLoss.counter = 0;
+    pFault->phaseLoss.status = 0;
+    
+    pFault->warningState = MCAPP_FAULT_NONE;
+    pFault->speedMonitorEnable = 0;
+    pFault->runTime = 0;
+}
+
+/**
+ * <B> Function: MCAPP_FaultDetect(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function to execute all fault detectors. It is called every control
+ * cycle while the motor is running. Checks based on estimated speed are 
+ * executed only when speedMonitorEnable is set.
+ * @param Pointer to the fault data structure
+ * @return 1 if a fault stopping the motor is active, 0 otherwise
+ * @example
+ * <CODE> status = MCAPP_FaultDetect(&fault); </CODE>
+ */
+bool MCAPP_FaultDetect(MCAPP_FAULT_T *pFault)
+{
+    const int16_t vdc = *pFault->pVdc;
+    
+    MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_OVERCURRENT,
+                            MCAPP_OverCurrentFaultCheck(pFault));
+    
+    MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_DC_OVERVOLTAGE,
+                            (vdc > pFault->dcOverVoltageLimit));
+    
+    MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_DC_UNDERVOLTAGE,
+                            (vdc < pFault->dcUnderVoltageLimit));
+    
+    if(MCAPP_PhaseLossFaultCheck(pFault))
+    {
+        /* Phase loss is debounced in terms of accumulation windows */
+        MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_PHASE_LOSS,
+                            pFault->phaseLoss.status);
+    }
+    
+    if(pFault->speedMonitorEnable == 1)
+    {
+        MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_OVERSPEED,
+                    (_Q15abs(*pFault->pVelEstim) > pFault->overSpeedLimit));
+        
+        /* Loss of lock is reported by the estimator monitor */
+        MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_LOSS_OF_LOCK,
+                            (*pFault->pLossOfLock != 0));
+    }
+    
+    /* Stall is reported by the estimator monitor in closed loop and by the 
+     * open loop start when the estimator does not lock */
+    MCAPP_FaultDebounce(pFault, MCAPP_FAULT_ID_STALL, (*pFault->pStall != 0));
+    
+    /* Reset restart counter once the motor runs fault free long enough */
+    if(pFault->faultState == MCAPP_FAULT_NONE)
+    {
+        if(pFault->runTime < pFault->runTimeLimit)
+        {
+            pFault->runTime++;
+        }
+        else
+        {
+            pFault->restartCount = 0;
+        }
+    }
+    
+    return (pFault->faultState != MCAPP_FAULT_NONE);
+}
+
+/**
+ * <B> Function: MCAPP_FaultSet(MCAPP_FAULT_T *pFault, uint16_t faultId)  </B>
+ * 
+ * @brief Function to report a fault detected outside the fault manager, 
+ * e.g. PWM PCI fault. The fault is set without debounce.
+ * @param Pointer to the fault data structure and the fault detector index
+ * @return none.
+ * @example
+ * <CODE> MCAPP_FaultSet(&fault, MCAPP_FAULT_ID_PWM_PCI); </CODE>
+ */
+void MCAPP_FaultSet(MCAPP_FAULT_T *pFault, uint16_t faultId)
+{
+    pFault->detect[faultId].count = pFault->detect[faultId].countLimit;
+    MCAPP_FaultDebounce(pFault, faultId, 1);
+}
+
+/**
+ * <B> Function: MCAPP_FaultClear(MCAPP_FAULT_T *pFault)  </B>
  * 
- * @brief Function to detect overcurrent fault
- * @param Pointer to the data structure containing measured motor parameters 
- * and fault data structure
- * @return fault status
+ * @brief Function to clear all faults including latched faults and reset 
+ * the restart policy.
+ * @param Pointer to the fault data structure
+ * @return none.
+ * @example
+ * <CODE> MCAPP_FaultClear(&fault); </CODE>
  */
-bool MCAPP_OverCurrentFault_Detect(MCAPP_MEASURE_T *pMotorInputs, MCAPP_FAULT_T * pFault)
+void MCAPP_FaultClear(MCAPP_FAULT_T *pFault)
 {
-    MCAPP_MEASURE_CURRENT_T *pCurrent = &pMotorInputs->measureCurrent;
+    MCAPP_FaultInit(pFault);
     
-    bool faultStatus;
+    pFault->faultState = MCAPP_FAULT_NONE;
+    pFault->faultHistory = MCAPP_FAULT_NONE;
+    pFault->restartDelay = 0;
+    pFault->restartCount = 0;
+}
+
+/**
+ * <B> Function: MCAPP_FaultAcknowledge(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function to acknowledge faults, e.g. when the run command is 
+ * re-issued after automatic restarts are used up. Faults with restart or 
+ * warning severity are cleared and the restart policy is reset. Latched 
+ * faults are kept until MCAPP_FaultClear().
+ * @param Pointer to the fault data structure
+ * @return 1 if no fault is left active, 0 otherwise
+ * @example
+ * <CODE> status = MCAPP_FaultAcknowledge(&fault); </CODE>
+ */
+bool MCAPP_FaultAcknowledge(MCAPP_FAULT_T *pFault)
+{
+    uint16_t faultId, latchMask = MCAPP_FAULT_NONE;
+    
+    for(faultId = 0; faultId < MCAPP_FAULT_ID_COUNT; faultId++)
+    {
+        if(pFault->detect[faultId].severity == MCAPP_FAULT_SEVERITY_LATCH)
+        {
+            latchMask |= (1 << faultId);
+        }
+    }
+    
+    pFault->faultState &= latchMask;
+    if(pFault->faultState != MCAPP_FAULT_NONE)
+    {
+        return 0;
+    }
+    
+    MCAPP_FaultInit(pFault);
+    pFault->restartDelay = 0;
+    pFault->restartCount = 0;
+    
+    return 1;
+}
+
+/**
+ * <B> Function: MCAPP_FaultRestartCheck(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function implementing the restart policy. It is called every control
+ * cycle while the motor is in fault. Once the restart delay has elapsed, the
+ * faults are cleared if none of them is latched and the number of restarts
+ * since the last fault free run is below the limit.
+ * @param Pointer to the fault data structure
+ * @return 1 if the motor can be restarted, 0 otherwise
+ * @example
+ * <CODE> status = MCAPP_FaultRestartCheck(&fault); </CODE>
+ */
+bool MCAPP_FaultRestartCheck(MCAPP_FAULT_T *pFault)
+{
+    uint16_t faultId;
+    
+    for(faultId = 0; faultId < MCAPP_FAULT_ID_COUNT; faultId++)
+    {
+        if((pFault->faultState & (1 << faultId)) && 
+            (pFault->detect[faultId].severity == MCAPP_FAULT_SEVERITY_LATCH))
+        {
+            return 0;
+        }
+    }
+    
+    if(pFault->restartCount >= pFault->restartCountMax)
+    {
+        return 0;
+    }
+    
+    if(pFault->restartDelay < pFault->restartDelayLimit)
+    {
+        pFault->restartDelay++;
+        return 0;
+    }
+    
+    pFault->restartDelay = 0;
+    pFault->restartCount++;
+    pFault->faultState = MCAPP_FAULT_NONE;
+    MCAPP_FaultInit(pFault);
+    
+    return 1;
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/**
+ * <B> Function: MCAPP_FaultDebounce(MCAPP_FAULT_T *, uint16_t, bool)  </B>
+ * 
+ * @brief Function to debounce a fault condition. The debounce counter 
+ * increments while the condition is present and decrements otherwise. Once
+ * the limit is reached the fault is reported as per its severity.
+ * @param Pointer to the fault data structure, fault detector index and the
+ * fault condition
+ * @return 1 if the fault is debounced, 0 otherwise
+ */
+static bool MCAPP_FaultDebounce(MCAPP_FAULT_T *pFault, uint16_t faultId, 
+                                    bool condition)
+{
+    MCAPP_FAULT_DETECT_T *pDetect = &pFault->detect[faultId];
+    const uint16_t faultMask = (1 << faultId);
+    
+    if(condition)
+    {
+        if(pDetect->count < pDetect->countLimit)
+        {
+            pDetect->count++;
+        }
+    }
+    else if(pDetect->count > 0)
+    {
+        pDetect->count--;
+    }
+    
+    if((pDetect->count >= pDetect->countLimit) && condition)
+    {
+        pFault->faultHistory |= faultMask;
+        
+        if(pDetect->severity == MCAPP_FAULT_SEVERITY_WARNING)
+        {
+            pFault->warningState |= faultMask;
+        }
+        else
+        {
+            pFault->faultState |= faultMask;
+        }
+        return 1;
+    }
+    else
+    {
+        pFault->warningState &= ~faultMask;
+        return 0;
+    }
+}
+
+/**
+ * <B> Function: MCAPP_OverCurrentFaultCheck(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function to check the maximum of the phase currents against the 
+ * over current limit.
+ * @param Pointer to the fault data structure
+ * @return 1 if over current condition is present, 0 otherwise
+ */
+static bool MCAPP_OverCurrentFaultCheck(MCAPP_FAULT_T *pFault)
+{
+    const int16_t Ia = *pFault->pIa;
+    const int16_t Ib = *pFault->pIb;
     
     int16_t Imax, Ic;
     
-    Ic = -pCurrent->Ia -pCurrent->Ib ;
+    Ic = -Ia - Ib;
     
-    /*Temp overcurrent fault*/
-    if((pCurrent->Ia > pCurrent->Ib)&&(pCurrent->Ia > Ic)){
-        Imax = pCurrent->Ia;
+    if((Ia > Ib)&&(Ia > Ic)){
+        Imax = Ia;
     }
-    else if ( ( pCurrent->Ib > Ic ) ){
-        Imax = pCurrent->Ib;
+    else if ( ( Ib > Ic ) ){
+        Imax = Ib;
     }
     else{
         Imax = Ic;
     }
     
-    if(( Imax > pFault->overCurrentFaultLimit))
+    return (Imax > pFault->overCurrentFaultLimit);
+}
+
+/**
+ * <B> Function: MCAPP_PhaseLossFaultCheck(MCAPP_FAULT_T *pFault)  </B>
+ * 
+ * @brief Function to accumulate the absolute phase currents over a window of
+ * PHASE_LOSS_WINDOW_COUNT samples. At the end of the window a phase is 
+ * considered open if its mean current is less than a quarter of the mean of 
+ * all three phases. The window spans at least one electrical cycle only above
+ * phaseLossSpeedMin, below it the accumulation is restarted and no check is 
+ * made, as a stationary current vector can leave a phase without current.
+ * @param Pointer to the fault data structure
+ * @return 1 at the end of window, 0 otherwise
+ */
+static bool MCAPP_PhaseLossFaultCheck(MCAPP_FAULT_T *pFault)
+{
+    MCAPP_FAULT_PHASE_LOSS_T *pPhaseLoss = &pFault->phaseLoss;
+    const int16_t Ia = *pFault->pIa;
+    const int16_t Ib = *pFault->pIb;
+    
+    int16_t meanIa, meanIb, meanIc, meanI, minI;
+    
+    if(_Q15abs(*pFault->pVelEstim) < pFault->phaseLossSpeedMin)
     {
-        pFault->faultState = MCAPP_OVERCURRENT_FAULT;
-        faultStatus = 1;
+        pPhaseLoss->sumIa = 0;
+        pPhaseLoss->sumIb = 0;
+        pPhaseLoss->sumIc = 0;
+        pPhaseLoss->counter = 0;
+        
+        return 0;
     }
-    else{
-        pFault->faultState = MCAPP_FAULT_NONE;
-        faultStatus = 0;
+    
+    pPhaseLoss->sumIa += _Q15abs(Ia);
+    pPhaseLoss->sumIb += _Q15abs(Ib);
+    pPhaseLoss->sumIc += _Q15abs(-Ia - Ib);
+    pPhaseLoss->counter++;
+    
+    if(pPhaseLoss->counter >= PHASE_LOSS_WINDOW_COUNT)
+    {
+        meanIa = (int16_t)(pPhaseLoss->sumIa >> PHASE_LOSS_WINDOW_BITS);
+        meanIb = (int16_t)(pPhaseLoss->sumIb >> PHASE_LOSS_WINDOW_BITS);
+        meanIc = (int16_t)(pPhaseLoss->sumIc >> PHASE_LOSS_WINDOW_BITS);
+        
+        /* Sum in 32 bits, it exceeds Q15 above 1/3 of full scale */
+        meanI = (int16_t)__builtin_divsd((int32_t)meanIa + meanIb + meanIc, 
+                                                                        3);
+        
+        minI = (meanIa < meanIb) ? meanIa : meanIb;
+        minI = (meanIc < minI) ? meanIc : minI;
+        
+        pPhaseLoss->status = ((meanI > pFault->phaseLossCurrentMin) && 
+                                (minI < (meanI >> 2)));
+        
+        pPhaseLoss->sumIa = 0;
+        pPhaseLoss->sumIb = 0;
+        pPhaseLoss->sumIc = 0;
+        pPhaseLoss->counter = 0;
+        
+        return 1;
     }
     
-    return faultStatus;
+    return 0;
 }
 
 // </editor-fold>
\ No newline at end of file
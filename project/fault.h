@@ -59,36 +59,130 @@ extern "C" {
 
 // <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
 
+/* Number of phase current samples accumulated per phase loss check window */
+#define PHASE_LOSS_WINDOW_BITS      (int16_t)10
+#define PHASE_LOSS_WINDOW_COUNT     (int16_t)(1 << PHASE_LOSS_WINDOW_BITS)
 
 // </editor-fold>
 
 // <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
 
 /**
- * Status of saturation
+ * Fault flags, one bit per fault detector
  */
-typedef enum 
+typedef enum
 {
-    MCAPP_FAULT_NONE = 0,             
-    MCAPP_OVERCURRENT_FAULT = 1,      
+    MCAPP_FAULT_NONE = 0,
+    MCAPP_OVERCURRENT_FAULT = 0x0001,       /* Phase over current */
+    MCAPP_DC_OVERVOLTAGE_FAULT = 0x0002,    /* DC bus over voltage */
+    MCAPP_DC_UNDERVOLTAGE_FAULT = 0x0004,   /* DC bus under voltage */
+    MCAPP_LOSS_OF_LOCK_FAULT = 0x0008,      /* Estimator loss of lock */
+    MCAPP_STALL_FAULT = 0x0010,             /* Rotor stall */
+    MCAPP_PHASE_LOSS_FAULT = 0x0020,        /* Open motor phase */
+    MCAPP_OVERSPEED_FAULT = 0x0040,         /* Estimated speed above limit */
+    MCAPP_PWM_PCI_FAULT = 0x0080,           /* PWM PCI fault input */
 
 } MCAPP_FAULT_STATE_T;
-   
-    
+
+/**
+ * Fault detector index, bit position of the fault in MCAPP_FAULT_STATE_T
+ */
+typedef enum
+{
+    MCAPP_FAULT_ID_OVERCURRENT = 0,
+    MCAPP_FAULT_ID_DC_OVERVOLTAGE = 1,
+    MCAPP_FAULT_ID_DC_UNDERVOLTAGE = 2,
+    MCAPP_FAULT_ID_LOSS_OF_LOCK = 3,
+    MCAPP_FAULT_ID_STALL = 4,
+    MCAPP_FAULT_ID_PHASE_LOSS = 5,
+    MCAPP_FAULT_ID_OVERSPEED = 6,
+    MCAPP_FAULT_ID_PWM_PCI = 7,
+    MCAPP_FAULT_ID_COUNT = 8,           /* Number of fault detectors */
+
+} MCAPP_FAULT_ID_T;
+
+/**
+ * Action taken once a fault detector is debounced
+ */
+typedef enum
+{
+    MCAPP_FAULT_SEVERITY_WARNING = 0,   /* Report only, motor keeps running */
+    MCAPP_FAULT_SEVERITY_RESTART = 1,   /* Stop motor, automatic restart allowed */
+    MCAPP_FAULT_SEVERITY_LATCH = 2,     /* Stop motor until faults are cleared */
+
+} MCAPP_FAULT_SEVERITY_T;
+
 typedef struct
 {
-    int16_t 
+    uint16_t
+        count,              /* Debounce counter */
+        countLimit,         /* Debounce limit */
+        severity;           /* Fault severity - MCAPP_FAULT_SEVERITY_T */
+
+}MCAPP_FAULT_DETECT_T;
+
+typedef struct
+{
+    int32_t
+        sumIa,              /* Accumulation of |Ia| */
+        sumIb,              /* Accumulation of |Ib| */
+        sumIc;              /* Accumulation of |Ic| */
+
+    int16_t
+        counter,            /* Samples accumulated in present window */
+        status;             /* Phase loss detected in last window */
+
+}MCAPP_FAULT_PHASE_LOSS_T;
+
+typedef struct
+{
+    int16_t
         overCurrentFaultLimit,    /* Over current fault limit */
-        faultState;         /* Fault state*/
-    
+        dcOverVoltageLimit,       /* DC bus over voltage fault limit */
+        dcUnderVoltageLimit,      /* DC bus under voltage fault limit */
+        overSpeedLimit,           /* Over speed fault limit */
+        phaseLossCurrentMin,      /* Minimum mean current for phase loss check*/
+        phaseLossSpeedMin;        /* Minimum speed for phase loss check */
+
+    uint16_t
+        faultState,         /* Fault state - tripped faults */
+        warningState,       /* Faults detected with warning severity */
+        faultHistory,       /* Faults detected since last fault clear */
+        speedMonitorEnable, /* Enables checks based on estimated speed */
+        restartDelay,       /* Restart delay counter */
+        restartDelayLimit,  /* Delay before automatic restart */
+        restartCount,       /* Automatic restarts since last fault free run */
+        restartCountMax,    /* Maximum number of automatic restarts */
+        runTime,            /* Fault free run time counter */
+        runTimeLimit;       /* Fault free run time to reset restart counter */
+
+    MCAPP_FAULT_DETECT_T
+        detect[MCAPP_FAULT_ID_COUNT];   /* Fault detectors */
+
+    MCAPP_FAULT_PHASE_LOSS_T
+        phaseLoss;          /* Phase loss detection parameters */
+
+    const int16_t
+        *pIa,               /* Pointer for Ia */
+        *pIb,               /* Pointer for Ib */
+        *pVdc,              /* Pointer for Vdc */
+        *pVelEstim,         /* Pointer for estimated speed */
+        *pLossOfLock,       /* Pointer for estimator loss of lock flag */
+        *pStall;            /* Pointer for estimator stall flag */
+
 }MCAPP_FAULT_T;
 
 // </editor-fold>
 
 // <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
 
-bool MCAPP_OverCurrentFault_Detect(MCAPP_MEASURE_T *, MCAPP_FAULT_T*);
-    
+void MCAPP_FaultInit(MCAPP_FAULT_T *);
+bool MCAPP_FaultDetect(MCAPP_FAULT_T *);
+void MCAPP_FaultSet(MCAPP_FAULT_T *, uint16_t);
+void MCAPP_FaultClear(MCAPP_FAULT_T *);
+bool MCAPP_FaultAcknowledge(MCAPP_FAULT_T *);
+bool MCAPP_FaultRestartCheck(MCAPP_FAULT_T *);
+
 // </editor-fold>
 
 
@@ -0,0 +1,468 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file fault_log.c
+ *
+ * @brief This module implements the non-volatile fault and event log in program
+ * flash memory.
+ * 
+ * Records are appended to a ring of flash pages. A record is committed by its
+ * checksum word, which is programmed last, so a record interrupted by a power
+ * fail is ignored on the next power up. Events are queued in RAM from the
+ * ISRs and written from the main loop one double word at a time, only while
+ * the caller allows flash operations.
+ *
+ * Component: APPLICATION
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <xc.h>
+
+#include "fault_log.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+MCAPP_FAULT_LOG_T faultLog;
+
+#ifdef __XC16__
+/* Reserve the log area, not loaded by the programmer */
+const uint16_t __attribute__((space(prog), address(FAULT_LOG_ADDRESS), 
+    noload, keep)) faultLogArea[FAULT_LOG_PAGE_COUNT * FLASH_PAGE_WORDS];
+#endif
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static uint32_t MCAPP_FaultLogSlotAddress(uint16_t, uint16_t);
+static uint16_t MCAPP_FaultLogChecksum(const uint16_t *);
+static bool MCAPP_FaultLogSlotRead(uint16_t, uint16_t, 
+                                    MCAPP_FAULT_LOG_RECORD_T *);
+static bool MCAPP_FaultLogSlotBlank(uint16_t, uint16_t);
+static bool MCAPP_FaultLogPageBlank(uint16_t);
+static void MCAPP_FaultLogPageNext(MCAPP_FAULT_LOG_T *);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_FaultLogInit(uint16_t)  </B>
+*
+* @brief Function to find the newest record and the next free slot in the 
+* log area and to queue the power up event. Execute before enabling the 
+* interrupts which report events.
+*
+* @param    reset cause(RCON).
+* @return   none.
+* @example
+* <CODE> MCAPP_FaultLogInit(RCON); </CODE>
+*
+*/
+void MCAPP_FaultLogInit(uint16_t resetCause)
+{
+    MCAPP_FAULT_LOG_T *pLog = &faultLog;
+    MCAPP_FAULT_LOG_RECORD_T record;
+    uint16_t page, slot;
+    bool found = false;
+    
+    pLog->page = 0;
+    pLog->sequence = 0;
+    pLog->bootCount = 0;
+    
+    /* Newest valid record decides the page in use */
+    for(page = 0; page < FAULT_LOG_PAGE_COUNT; page++)
+    {
+        for(slot = 0; slot < FAULT_LOG_PAGE_SLOTS; slot++)
+        {
+            if(MCAPP_FaultLogSlotRead(page, slot, &record))
+            {
+                if((!found) || 
+                    ((int16_t)(record.sequence - pLog->sequence) >= 0))
+                {
+                    found = true;
+                    pLog->page = page;
+                    pLog->sequence = record.sequence;
+                    pLog->bootCount = record.bootCount;
+                }
+            }
+        }
+    }
+    if(found)
+    {
+        pLog->sequence++;
+        pLog->bootCount++;
+    }
+    
+    /* Next slot follows the last slot which is not blank, which skips records
+     * interrupted by a power fail */
+    pLog->slot = 0;
+    for(slot = FAULT_LOG_PAGE_SLOTS; slot > 0; slot--)
+    {
+        if(!MCAPP_FaultLogSlotBlank(pLog->page, slot - 1))
+        {
+            pLog->slot = slot;
+            break;
+        }
+    }
+    pLog->erasePending = 0;
+    if(pLog->slot >= FAULT_LOG_PAGE_SLOTS)
+    {
+        MCAPP_FaultLogPageNext(pLog);
+    }
+    else if((!found) && (!MCAPP_FaultLogPageBlank(pLog->page)))
+    {
+        /* No valid record, erase the area in use */
+        pLog->slot = 0;
+        pLog->erasePending = 1;
+    }
+    
+    pLog->writeActive = 0;
+    pLog->writeErrors = 0;
+    pLog->dropped = 0;
+    pLog->queueHead = 0;
+    pLog->queueTail = 0;
+    pLog->timeTick = 0;
+    pLog->time = 0;
+    
+    MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_BOOT, resetCause, 0, 0, 0, 0);
+}
+
+/**
+* <B> Function: void MCAPP_FaultLogTimeTick(void)  </B>
+*
+* @brief Function to update the time stamp, executes in Timer1 ISR.
+*
+* @param    none.
+* @return   none.
+* @example
+* <CODE> MCAPP_FaultLogTimeTick(); </CODE>
+*
+*/
+void MCAPP_FaultLogTimeTick(void)
+{
+    faultLog.timeTick++;
+    if(faultLog.timeTick >= FAULT_LOG_TIME_TICKS)
+    {
+        faultLog.timeTick = 0;
+        faultLog.time++;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_FaultLogEventSet(uint16_t, uint16_t, int16_t, 
+*                                   int16_t, int16_t, uint16_t)  </B>
+*
+* @brief Function to queue an event with time stamp and operating point. Does 
+* not access flash, hence can be called from the ISRs. Called from the MC1 
+* (IP6) and PFC (IP7) interrupts, the queue is updated at CPU priority 7 so 
+* that an event is not interrupted by an event of the other source. Event is
+* dropped if the queue is full.
+*
+* @param    event - MCAPP_FAULT_LOG_EVENT_T.
+* @param    event code.
+* @param    operating point 0, 1, 2.
+* @param    counter.
+* @return   none.
+* @example
+* <CODE> MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_MC1_FAULT, faultState,
+*                                   speed, vdc, iq, restartCount); </CODE>
+*
+*/
+void MCAPP_FaultLogEventSet(uint16_t event, uint16_t code, int16_t point0, 
+                    int16_t point1, int16_t point2, uint16_t counter)
+{
+    MCAPP_FAULT_LOG_T *pLog = &faultLog;
+    MCAPP_FAULT_LOG_RECORD_T *pEntry;
+    uint16_t head, savedIpl;
+    uint32_t time;
+    
+    SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+    
+    head = pLog->queueHead;
+    if(((head - pLog->queueTail) & (2*FAULT_LOG_QUEUE_SIZE - 1)) >= 
+                                                        FAULT_LOG_QUEUE_SIZE)
+    {
+        pLog->dropped++;
+        RESTORE_CPU_IPL(savedIpl);
+        return;
+    }
+    
+    /* Time is updated by Timer1 ISR(IP5), which can not interrupt here */
+    time = pLog->time;
+    
+    pEntry = &pLog->queue[head & (FAULT_LOG_QUEUE_SIZE - 1)];
+    pEntry->event = event;
+    pEntry->code = code;
+    pEntry->timeLow = (uint16_t)time;
+    pEntry->timeHigh = (uint16_t)(time >> 16);
+    pEntry->operatingPoint[0] = point0;
+    pEntry->operatingPoint[1] = point1;
+    pEntry->operatingPoint[2] = point2;
+    pEntry->counter = counter;
+    
+    pLog->queueHead = (head + 1) & (2*FAULT_LOG_QUEUE_SIZE - 1);
+    
+    RESTORE_CPU_IPL(savedIpl);
+}
+
+/**
+* <B> Function: void MCAPP_FaultLogStepMain(bool, bool)  </B>
+*
+* @brief Function to write the queued events, executes in the main loop. 
+* Instruction fetch stalls during flash operations, so the caller allows
+* programming(about 20us per call) and page erase(several ms) only when 
+* the stall does not disturb the control loops. A record is written one 
+* double word per call and verified after the checksum is programmed.
+*
+* @param    programming allowed.
+* @param    page erase allowed.
+* @return   none.
+* @example
+* <CODE> MCAPP_FaultLogStepMain(motorStopped && pfcStopped, 
+*                                   motorStopped && pfcStopped); </CODE>
+*
+*/
+void MCAPP_FaultLogStepMain(bool programAllowed, bool eraseAllowed)
+{
+    MCAPP_FAULT_LOG_T *pLog = &faultLog;
+    MCAPP_FAULT_LOG_RECORD_T record;
+    const uint16_t *pWords;
+    uint16_t tail, savedIpl;
+    
+    if(pLog->erasePending == 1)
+    {
+        if(eraseAllowed)
+        {
+            FLASH_PageErase(MCAPP_FaultLogSlotAddress(pLog->page, 0));
+            if(MCAPP_FaultLogPageBlank(pLog->page))
+            {
+                pLog->erasePending = 0;
+            }
+        }
+        return;
+    }
+    
+    if(pLog->writeActive == 0)
+    {
+        tail = pLog->queueTail;
+        if(tail == pLog->queueHead)
+        {
+            return;
+        }
+        pLog->record = pLog->queue[tail & (FAULT_LOG_QUEUE_SIZE - 1)];
+        pLog->queueTail = (tail + 1) & (2*FAULT_LOG_QUEUE_SIZE - 1);
+        
+        /* Events are dropped by the ISRs */
+        SET_AND_SAVE_CPU_IPL(savedIpl, 7);
+        pLog->record.dropped = pLog->dropped;
+        pLog->dropped = 0;
+        RESTORE_CPU_IPL(savedIpl);
+        
+        pLog->record.sequence = pLog->sequence;
+        pLog->record.bootCount = pLog->bootCount;
+        pLog->record.checksum = 
+                    MCAPP_FaultLogChecksum((const uint16_t *)&pLog->record);
+        pLog->writeStep = 0;
+        pLog->writeActive = 1;
+    }
+    
+    if(!programAllowed)
+    {
+        return;
+    }
+    
+    pWords = (const uint16_t *)&pLog->record + (pLog->writeStep << 1);
+    FLASH_DoubleWordWrite(MCAPP_FaultLogSlotAddress(pLog->page, pLog->slot) +
+            (pLog->writeStep * FLASH_DWORD_SIZE_ADDRESS), pWords[0], pWords[1]);
+    pLog->writeStep++;
+    
+    if(pLog->writeStep >= (FAULT_LOG_RECORD_WORDS >> 1))
+    {
+        if((MCAPP_FaultLogSlotRead(pLog->page, pLog->slot, &record)) &&
+            (record.sequence == pLog->record.sequence))
+        {
+            pLog->sequence++;
+            pLog->writeActive = 0;
+        }
+        else
+        {
+            /* Write the record again in the next slot */
+            pLog->writeErrors++;
+            pLog->writeStep = 0;
+        }
+        
+        pLog->slot++;
+        if(pLog->slot >= FAULT_LOG_PAGE_SLOTS)
+        {
+            MCAPP_FaultLogPageNext(pLog);
+        }
+    }
+}
+
+/**
+* <B> Function: bool MCAPP_FaultLogRecordRead(uint16_t, 
+*                                       MCAPP_FAULT_LOG_RECORD_T *)  </B>
+*
+* @brief Function to read a record from the log, newest first.
+*
+* @param    record index, 0 is the newest record.
+* @param    pointer to the record.
+* @return   true if the record exists.
+* @example
+* <CODE> valid = MCAPP_FaultLogRecordRead(0, &record); </CODE>
+*
+*/
+bool MCAPP_FaultLogRecordRead(uint16_t index, MCAPP_FAULT_LOG_RECORD_T *pRecord)
+{
+    MCAPP_FAULT_LOG_T *pLog = &faultLog;
+    uint16_t page = pLog->page;
+    uint16_t slot = pLog->slot;
+    uint16_t count;
+    
+    /* Walk back from the next free slot through the page ring */
+    for(count = 0; count < (FAULT_LOG_PAGE_COUNT * FAULT_LOG_PAGE_SLOTS); 
+                                                                    count++)
+    {
+        if(slot == 0)
+        {
+            page = (page == 0) ? (FAULT_LOG_PAGE_COUNT - 1) : (page - 1);
+            slot = FAULT_LOG_PAGE_SLOTS;
+        }
+        slot--;
+        
+        if(MCAPP_FaultLogSlotRead(page, slot, pRecord))
+        {
+            if(index == 0)
+            {
+                return true;
+            }
+            index--;
+        }
+    }
+    return false;
+}
+
+static uint32_t MCAPP_FaultLogSlotAddress(uint16_t page, uint16_t slot)
+{
+    return (uint32_t)FAULT_LOG_ADDRESS + 
+        (uint32_t)page * FLASH_PAGE_SIZE_ADDRESS + 
+        (uint32_t)slot * (FAULT_LOG_RECORD_WORDS << 1);
+}
+
+static uint16_t MCAPP_FaultLogChecksum(const uint16_t *pWords)
+{
+    uint16_t index, sum = 0;
+    
+    for(index = 0; index < (FAULT_LOG_RECORD_WORDS - 1); index++)
+    {
+        sum += pWords[index];
+    }
+    sum = ~sum;
+    
+    /* Erased value is reserved for records without checksum */
+    if(sum == 0xFFFF)
+    {
+        sum = 0xFFFE;
+    }
+    return sum;
+}
+
+static bool MCAPP_FaultLogSlotRead(uint16_t page, uint16_t slot, 
+                                    MCAPP_FAULT_LOG_RECORD_T *pRecord)
+{
+    uint16_t *pWords = (uint16_t *)pRecord;
+    uint32_t address = MCAPP_FaultLogSlotAddress(page, slot);
+    uint16_t index;
+    
+    for(index = 0; index < FAULT_LOG_RECORD_WORDS; index++)
+    {
+        pWords[index] = FLASH_WordRead(address);
+        address += 2;
+    }
+    return (pRecord->checksum == MCAPP_FaultLogChecksum(pWords));
+}
+
+static bool MCAPP_FaultLogSlotBlank(uint16_t page, uint16_t slot)
+{
+    uint32_t address = MCAPP_FaultLogSlotAddress(page, slot);
+    uint16_t index;
+    
+    for(index = 0; index < FAULT_LOG_RECORD_WORDS; index++)
+    {
+        if(FLASH_WordRead(address) != 0xFFFF)
+        {
+            return false;
+        }
+        address += 2;
+    }
+    return true;
+}
+
+static bool MCAPP_FaultLogPageBlank(uint16_t page)
+{
+    uint32_t address = MCAPP_FaultLogSlotAddress(page, 0);
+    uint16_t index;
+    
+    for(index = 0; index < FLASH_PAGE_WORDS; index++)
+    {
+        if(FLASH_WordRead(address) != 0xFFFF)
+        {
+            return false;
+        }
+        address += 2;
+    }
+    return true;
+}
+
+static void MCAPP_FaultLogPageNext(MCAPP_FAULT_LOG_T *pLog)
+{
+    pLog->page++;
+    if(pLog->page >= FAULT_LOG_PAGE_COUNT)
+    {
+        pLog->page = 0;
+    }
+    pLog->slot = 0;
+    
+    /* Oldest records are erased when the page is reused */
+    pLog->erasePending = MCAPP_FaultLogPageBlank(pLog->page) ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file fault_log.h
+ *
+ * @brief This module implements the non-volatile fault and event log in program
+ * flash memory.
+ *
+ * Component: APPLICATION
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef FAULT_LOG_H
+#define	FAULT_LOG_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "flash.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Define to log fault events in program flash memory */
+#define ENABLE_FAULT_LOG
+
+/* Log area : FAULT_LOG_PAGE_COUNT flash pages used as a ring, last page of 
+ * program memory holds configuration words and is not used */
+#define FAULT_LOG_ADDRESS           0x9800
+#define FAULT_LOG_PAGE_COUNT        2
+
+/* Record size in 16 bit words, multiple of 2(double word) */
+#define FAULT_LOG_RECORD_WORDS      12
+#define FAULT_LOG_PAGE_SLOTS        (FLASH_PAGE_WORDS/FAULT_LOG_RECORD_WORDS)
+
+/* Events buffered in RAM until written, power of 2 */
+#define FAULT_LOG_QUEUE_SIZE        4
+
+/* Timer1 ISR(100us) ticks per second of time stamp */
+#define FAULT_LOG_TIME_TICKS        10000
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef enum
+{
+    MCAPP_FAULT_LOG_BOOT = 1,           /* Power up, code is reset cause(RCON)*/
+    MCAPP_FAULT_LOG_MC1_FAULT = 2,      /* Motor fault, code is fault state */
+    MCAPP_FAULT_LOG_PFC_FAULT = 3,      /* PFC fault, code is fault status */
+
+} MCAPP_FAULT_LOG_EVENT_T;
+
+/**
+ * Log record, stored in flash as FAULT_LOG_RECORD_WORDS words. The checksum
+ * is programmed last and commits the record.
+ */
+typedef struct
+{
+    uint16_t
+        sequence,           /* Record sequence number */
+        event,              /* Event - MCAPP_FAULT_LOG_EVENT_T */
+        code,               /* Event code */
+        timeLow,            /* Time since power up in seconds, lower word */
+        timeHigh,           /* Time since power up in seconds, upper word */
+        bootCount;          /* Power up count */
+
+    int16_t
+        operatingPoint[3];  /* Motor : speed, Vdc, Iq reference
+                               PFC : rectified Vac, Vdc, inductor current */
+
+    uint16_t
+        counter,            /* Motor : automatic restart count */
+        dropped,            /* Events dropped as the queue was full */
+        checksum;           /* Record checksum, never 0xFFFF */
+
+} MCAPP_FAULT_LOG_RECORD_T;
+
+typedef struct
+{
+    uint16_t
+        page,               /* Page in use */
+        slot,               /* Next record slot in the page */
+        sequence,           /* Sequence number of next record */
+        bootCount,          /* Power up count */
+        erasePending,       /* Page must be erased before writing */
+        writeActive,        /* Record is being written */
+        writeStep,          /* Next double word of record to be written */
+        writeErrors,        /* Records which failed verification */
+        timeTick;           /* Timer ticks of present second */
+
+    volatile uint16_t
+        queueHead,          /* Queue write index, updated by ISR */
+        queueTail,          /* Queue read index, updated by main loop */
+        dropped;            /* Events dropped since last record */
+
+    volatile uint32_t
+        time;               /* Time since power up in seconds */
+
+    MCAPP_FAULT_LOG_RECORD_T
+        record,             /* Record being written */
+        queue[FAULT_LOG_QUEUE_SIZE];    /* Events to be written */
+
+} MCAPP_FAULT_LOG_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_FaultLogInit(uint16_t);
+void MCAPP_FaultLogTimeTick(void);
+void MCAPP_FaultLogEventSet(uint16_t, uint16_t, int16_t, int16_t, int16_t, 
+                            uint16_t);
+void MCAPP_FaultLogStepMain(bool, bool);
+bool MCAPP_FaultLogRecordRead(uint16_t, MCAPP_FAULT_LOG_RECORD_T *);
+
+// </editor-fold>
+
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* FAULT_LOG_H */
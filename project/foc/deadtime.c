@@ -0,0 +1,207 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file deadtime.c
+ *
+ * @brief This module compensates the voltage error of inverter dead time.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "deadtime.h"
+#include "general.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define Q15_ONE_BY_3        10923 /* 1/3 */
+#define Q15_ONE_BY_SQRT3    18919 /* 1/sqrt(3) */
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+inline static int16_t MCAPP_DeadTimePolarity(int16_t, int16_t);
+inline static uint16_t MCAPP_DeadTimeDuty(uint16_t, int16_t, 
+                                            const MCAPP_DEADTIME_T *, int16_t *);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_DeadTimeInit(MCAPP_DEADTIME_T *)  </B>
+*
+* @brief Function to reset dead time compensation states.
+*
+* @param Pointer to the data structure containing dead time compensation 
+*        parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DeadTimeInit(&deadTime); </CODE>
+*
+*/
+void MCAPP_DeadTimeInit(MCAPP_DEADTIME_T *pDeadTime)
+{
+    pDeadTime->qPolarity.a = 0;
+    pDeadTime->qPolarity.b = 0;
+    pDeadTime->qPolarity.c = 0;
+    pDeadTime->valphabetaOut.alpha = 0;
+    pDeadTime->valphabetaOut.beta = 0;
+}
+
+/**
+* <B> Function: void MCAPP_DeadTimeCompensation(MCAPP_DEADTIME_T *, 
+*               MC_DUTYCYCLEOUT_T *)  </B>
+*
+* @brief Function correcting PWM duty cycles for dead time and calculating 
+* the voltage applied by the inverter. The applied voltage is the commanded 
+* voltage with the part of dead time voltage error which is not corrected by
+* duty, e.g. when correction is disabled or duty is at its limit.
+*
+* @param Pointer to the data structure containing dead time compensation 
+*        parameters.
+* @param Pointer to duty cycles from space vector modulation.
+* @return   none.
+* @example
+* <CODE> MCAPP_DeadTimeCompensation(&deadTime, &pwmDuty); </CODE>
+*
+*/
+void MCAPP_DeadTimeCompensation(MCAPP_DEADTIME_T *pDeadTime, 
+                                    MC_DUTYCYCLEOUT_T *pDuty)
+{
+    const MC_ABC_T *pIabc = pDeadTime->pIabc;
+    MC_ABC_T countError;
+    int16_t qVoltPerCount;
+    
+    pDeadTime->qPolarity.a = MCAPP_DeadTimePolarity(pIabc->a, 
+                                            pDeadTime->polarityGain);
+    pDeadTime->qPolarity.b = MCAPP_DeadTimePolarity(pIabc->b, 
+                                            pDeadTime->polarityGain);
+    pDeadTime->qPolarity.c = MCAPP_DeadTimePolarity(pIabc->c, 
+                                            pDeadTime->polarityGain);
+    
+    pDuty->dutycycle1 = MCAPP_DeadTimeDuty(pDuty->dutycycle1, 
+                        pDeadTime->qPolarity.a, pDeadTime, &countError.a);
+    pDuty->dutycycle2 = MCAPP_DeadTimeDuty(pDuty->dutycycle2, 
+                        pDeadTime->qPolarity.b, pDeadTime, &countError.b);
+    pDuty->dutycycle3 = MCAPP_DeadTimeDuty(pDuty->dutycycle3, 
+                        pDeadTime->qPolarity.c, pDeadTime, &countError.c);
+    
+    if (pDeadTime->estimatorEnable)
+    {
+        /* Convert duty errors to phase voltages, common mode of the 
+         * errors does not reach the motor */
+        qVoltPerCount = (int16_t)(__builtin_mulss(*pDeadTime->pVdc, 
+                            pDeadTime->qVoltPerCount) >> 
+                            (15 + 12 - DEADTIME_VOLT_QVALUE));
+        countError.a = (int16_t)(__builtin_mulss(countError.a, 
+                            qVoltPerCount) >> DEADTIME_VOLT_QVALUE);
+        countError.b = (int16_t)(__builtin_mulss(countError.b, 
+                            qVoltPerCount) >> DEADTIME_VOLT_QVALUE);
+        countError.c = (int16_t)(__builtin_mulss(countError.c, 
+                            qVoltPerCount) >> DEADTIME_VOLT_QVALUE);
+        
+        pDeadTime->valphabetaOut.alpha = pDeadTime->pVAlphaBeta->alpha + 
+            (int16_t)(__builtin_mulss((countError.a << 1) - countError.b - 
+                            countError.c, Q15_ONE_BY_3) >> 15);
+        pDeadTime->valphabetaOut.beta = pDeadTime->pVAlphaBeta->beta + 
+            (int16_t)(__builtin_mulss(countError.b - countError.c, 
+                            Q15_ONE_BY_SQRT3) >> 15);
+    }
+    else
+    {
+        pDeadTime->valphabetaOut = *pDeadTime->pVAlphaBeta;
+    }
+}
+
+/**
+* <B> Function: MCAPP_DeadTimePolarity(int16_t, int16_t) </B>
+*
+* @brief Phase current polarity, proportional to current in the transition 
+* band and -1 or 1 outside.
+*
+*/
+inline static int16_t MCAPP_DeadTimePolarity(int16_t current, int16_t gain)
+{
+    return UTIL_SatShrS16(__builtin_mulss(current, gain), 0);
+}
+
+/**
+* <B> Function: MCAPP_DeadTimeDuty(uint16_t, int16_t, const MCAPP_DEADTIME_T *,
+*               int16_t *) </B>
+*
+* @brief Corrects duty of a phase by dead time in the direction of current
+* and limits it to the PWM driver limits. Duty error left uncorrected is
+* returned through pointer. A phase clamped to a rail by discontinuous PWM 
+* does not switch and has no dead time.
+*
+*/
+inline static uint16_t MCAPP_DeadTimeDuty(uint16_t duty, int16_t qPolarity,
+                        const MCAPP_DEADTIME_T *pDeadTime, int16_t *pCountError)
+{
+    const int16_t loss = (int16_t)(__builtin_mulss(qPolarity, 
+                                        pDeadTime->compCounts) >> 15);
+    int32_t dutyOut = duty;
+    
+    if ((duty == 0) || (duty >= pDeadTime->dutyHigh))
+    {
+        *pCountError = 0;
+        return duty;
+    }
+    if (pDeadTime->enable)
+    {
+        dutyOut += loss;
+        if (dutyOut < (int32_t)pDeadTime->dutyMin)
+        {
+            dutyOut = pDeadTime->dutyMin;
+        }
+        else if (dutyOut > (int32_t)pDeadTime->dutyMax)
+        {
+            dutyOut = pDeadTime->dutyMax;
+        }
+    }
+    *pCountError = (int16_t)(dutyOut - duty) - loss;
+    
+    return (uint16_t)dutyOut;
+}
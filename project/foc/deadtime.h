@@ -0,0 +1,126 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file deadtime.h
+ *
+ * @brief This module compensates the voltage error of inverter dead time.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __DEADTIME_H
+#define __DEADTIME_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Fractional bits added to the voltage per duty count after scaling with 
+ * DC bus voltage */
+#define DEADTIME_VOLT_QVALUE    8
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to dead time compensation.
+    During dead time both switches of a phase are off and the phase current 
+    flows through a diode, so the phase loses the dead time of voltage when
+    current flows out of the inverter and gains it when current flows in. 
+    Duty of each phase is corrected by dead time in the direction of phase 
+    current, with a linear transition around zero current where the current
+    direction is not certain. */
+
+typedef struct
+{
+    /* Duty correction at full polarity, in PWM counts */
+    int16_t compCounts;
+    /* Gain from phase current to polarity, 1/transition current */
+    int16_t polarityGain;
+    /* Phase voltage per PWM count at full DC bus voltage, in Q27 of voltage 
+     * base */
+    int16_t qVoltPerCount;
+    /* Duty limits of the PWM driver and duty at positive rail */
+    uint16_t dutyMin,
+             dutyMax,
+             dutyHigh;
+    
+    /* Phase current polarity, -1..1 in Q15 */
+    MC_ABC_T qPolarity;
+    
+    /* Voltage applied by the inverter, input of estimators */
+    MC_ALPHABETA_T valphabetaOut;
+    
+    uint16_t
+        enable,             /* Duty correction enable */
+        estimatorEnable;    /* Dead time voltage error correction of
+                             * estimator voltage enable */
+    
+    const MC_ABC_T *pIabc;
+    const MC_ALPHABETA_T *pVAlphaBeta;
+    const int16_t *pVdc;
+    
+} MCAPP_DEADTIME_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_DeadTimeInit(MCAPP_DEADTIME_T *);
+void MCAPP_DeadTimeCompensation(MCAPP_DEADTIME_T *, MC_DUTYCYCLEOUT_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __DEADTIME_H */
@@ -0,0 +1,105 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file decoupling.c
+ *
+ * @brief This module calculates D and Q axis feedforward voltages of the current
+ * controllers from speed and currents.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "decoupling.h"
+#include "general.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_DecouplingInit(MCAPP_DECOUPLING_T *)  </B>
+*
+* @brief Function to reset decoupling feedforward voltages.
+*
+* @param Pointer to the data structure containing decoupling parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DecouplingInit(&decoupling); </CODE>
+*
+*/
+void MCAPP_DecouplingInit(MCAPP_DECOUPLING_T *pDecoupling)
+{
+    pDecoupling->vdqFeedForward.d = 0;
+    pDecoupling->vdqFeedForward.q = 0;
+}
+
+/**
+* <B> Function: void MCAPP_DecouplingStep(MCAPP_DECOUPLING_T *)  </B>
+*
+* @brief Function calculating the cross coupling and back EMF voltages, 
+* Vd = -w*Lq*Iq and Vq = w*(Ld*Id + Psi). Measured currents are used, so the
+* feedforward stays correct while current controllers are in voltage limit.
+*
+* @param Pointer to the data structure containing decoupling parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DecouplingStep(&decoupling); </CODE>
+*
+*/
+void MCAPP_DecouplingStep(MCAPP_DECOUPLING_T *pDecoupling)
+{
+    const int16_t omega = *pDecoupling->pOmega;
+    const uint16_t qValue = pDecoupling->qValue;
+    int16_t fluxD, fluxQ;
+    
+    /* Flux linkages in Q15 per unit */
+    fluxQ = UTIL_SatShrS16(__builtin_mulss(pDecoupling->qLq, 
+                                pDecoupling->pIdq->q), qValue);
+    fluxD = UTIL_SatShrS16(__builtin_mulss(pDecoupling->qLd, 
+                                pDecoupling->pIdq->d) + 
+                ((int32_t)pDecoupling->qFlux << 15), qValue);
+    
+    pDecoupling->vdqFeedForward.d = 
+                        -(int16_t)(__builtin_mulss(omega, fluxQ) >> 15);
+    pDecoupling->vdqFeedForward.q = 
+                        (int16_t)(__builtin_mulss(omega, fluxD) >> 15);
+}
@@ -0,0 +1,108 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file decoupling.h
+ *
+ * @brief This module calculates D and Q axis feedforward voltages of the current
+ * controllers from speed and currents.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __DECOUPLING_H
+#define __DECOUPLING_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to decoupling of the current
+    controllers. In the rotating frame the motor voltages are
+    Vd = Rs*Id + Ld*dId/dt - w*Lq*Iq and Vq = Rs*Iq + Lq*dIq/dt + w*Ld*Id + 
+    w*Psi, the speed dependent terms are fed forward, so the current 
+    controllers see only the resistance and inductance. */
+
+typedef struct
+{
+    /* D and Q axis inductance, per unit of voltage base/(current base *
+     * electrical speed base), and per unit flux linkage, scaled by 2^qValue */
+    int16_t qLd,
+            qLq,
+            qFlux;
+    /* Fractional bits of inductances and flux linkage */
+    uint16_t qValue;
+    
+    /* Feedforward voltages */
+    MC_DQ_T vdqFeedForward;
+    
+    uint16_t
+        enable,             /* Feedforward enable */
+        active;             /* Feedforward is applied to current controllers */
+    
+    const int16_t *pOmega;
+    const MC_DQ_T *pIdq;
+    
+} MCAPP_DECOUPLING_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_DecouplingInit(MCAPP_DECOUPLING_T *);
+void MCAPP_DecouplingStep(MCAPP_DECOUPLING_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __DECOUPLING_H */
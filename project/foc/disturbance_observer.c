@@ -0,0 +1,159 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file disturbance_observer.c
+ *
+ * @brief This module implements the load torque disturbance observer with feedforward
+ * to the speed controller.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "general.h"
+#include "disturbance_observer.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_DisturbanceObserverInit(
+*               MCAPP_DISTURBANCE_OBSERVER_T *)  </B>
+*
+* @brief Function to reset the disturbance observer at motor start.
+*
+* @param Pointer to the data structure containing observer parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DisturbanceObserverInit(&disturbance); </CODE>
+*
+*/
+void MCAPP_DisturbanceObserverInit(MCAPP_DISTURBANCE_OBSERVER_T *pObserver)
+{
+    pObserver->omega = 0;
+    pObserver->load = 0;
+    pObserver->iqSum = 0;
+    pObserver->qIqFeedForward = 0;
+    pObserver->count = 0;
+    pObserver->active = 0;
+}
+
+/**
+* <B> Function: void MCAPP_DisturbanceObserverStep(
+*               MCAPP_DISTURBANCE_OBSERVER_T *)  </B>
+*
+* @brief Function to estimate the load current and feed it forward to the 
+* speed controller. It is called every control cycle in closed loop with the
+* speed controller and executes once in countLimit cycles. The first step 
+* after start-up takes the mean current as the load, since the speed 
+* controller has been preset to it.
+*
+* @param Pointer to the data structure containing observer parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DisturbanceObserverStep(&disturbance); </CODE>
+*
+*/
+void MCAPP_DisturbanceObserverStep(MCAPP_DISTURBANCE_OBSERVER_T *pObserver)
+{
+    MCAPP_PISTATE_T *pPISpeed = pObserver->pPISpeed;
+    const int32_t loadMax = (int32_t)pObserver->qIqMax << 16;
+    int32_t integrator, integratorMax, integratorMin;
+    int16_t iqMean, error, feedForward;
+    
+    pObserver->iqSum += *pObserver->pIq;
+    pObserver->count++;
+    if (pObserver->count < pObserver->countLimit)
+    {
+        return;
+    }
+    pObserver->count = 0;
+    iqMean = __builtin_divsd(pObserver->iqSum, pObserver->countLimit);
+    pObserver->iqSum = 0;
+    
+    if (pObserver->active == 0)
+    {
+        pObserver->omega = (int32_t)*pObserver->pVelEstim << 16;
+        pObserver->load = (int32_t)iqMean << 16;
+        pObserver->qIqFeedForward = iqMean;
+        pObserver->active = 1;
+        return;
+    }
+    
+    /* Speed error with 8 fractional bits */
+    error = UTIL_SatShrS16(((int32_t)*pObserver->pVelEstim << 16) - 
+                                                    pObserver->omega, 8);
+    
+    /* Speed change from current above load, and speed correction */
+    pObserver->omega += (__builtin_mulsu(UTIL_SatShrS16((int32_t)iqMean - 
+                (pObserver->load >> 16), 0), pObserver->speedGain) >> 
+                (DISTURBANCE_GAIN_QVALUE - 16)) + 
+            (__builtin_mulsu(error, pObserver->qSpeedCorrGain) >> 7);
+    
+    /* Speed above prediction means load is lower than estimated */
+    pObserver->load -= __builtin_mulsu(error, pObserver->loadCorrGain);
+    if (pObserver->load > loadMax)
+    {
+        pObserver->load = loadMax;
+    }
+    else if (pObserver->load < -loadMax)
+    {
+        pObserver->load = -loadMax;
+    }
+    
+    /* Change of load estimate is added to the speed controller integrator */
+    feedForward = (int16_t)((pObserver->load + 0x8000) >> 16);
+    integrator = pPISpeed->integrator + 
+            (((int32_t)feedForward - pObserver->qIqFeedForward) << 16);
+    integratorMax = (int32_t)pPISpeed->outMax << 16;
+    integratorMin = (int32_t)pPISpeed->outMin << 16;
+    if (integrator > integratorMax)
+    {
+        integrator = integratorMax;
+    }
+    else if (integrator < integratorMin)
+    {
+        integrator = integratorMin;
+    }
+    pPISpeed->integrator = integrator;
+    pObserver->qIqFeedForward = feedForward;
+}
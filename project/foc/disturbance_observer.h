@@ -0,0 +1,128 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file disturbance_observer.h
+ *
+ * @brief This module implements the load torque disturbance observer with feedforward
+ * to the speed controller.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __DISTURBANCE_OBSERVER_H
+#define __DISTURBANCE_OBSERVER_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sat_pi/sat_pi.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Fractional bits of speed change per step for one current count */
+#define DISTURBANCE_GAIN_QVALUE     20
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to the load torque 
+    disturbance observer. Load torque is expressed as the Q axis current 
+    that balances it. Observer predicts speed from the mean Q axis current 
+    and the load estimate over a step with the mechanical time constant, and
+    corrects the speed prediction and load estimate by the error to the 
+    estimated speed. Changes of the load estimate are added to the speed 
+    controller integrator, which feeds the load forward to the Q axis 
+    current reference without a step when the controller is preset. */
+
+typedef struct
+{
+    /* Predicted speed, speed counts shifted left by 16 */
+    int32_t omega;
+    /* Load current estimate, current counts shifted left by 16 */
+    int32_t load;
+    /* Sum of Q axis current over the step */
+    int32_t iqSum;
+    /* Speed change per step for one current count, DISTURBANCE_GAIN_QVALUE */
+    uint16_t speedGain;
+    /* Speed correction gain, Q15 */
+    uint16_t qSpeedCorrGain;
+    /* Load correction, current counts per speed count, shifted left by 8 */
+    uint16_t loadCorrGain;
+    /* Load current fed forward */
+    int16_t qIqFeedForward;
+    /* Load estimate limit */
+    int16_t qIqMax;
+    /* Control cycles per observer step */
+    uint16_t countLimit;
+    uint16_t count;
+    /* Observer started flag, cleared at motor start */
+    uint16_t active;
+    /* Disturbance observer enable flag */
+    uint16_t enable;
+    
+    const int16_t *pIq;
+    const int16_t *pVelEstim;
+    MCAPP_PISTATE_T *pPISpeed;
+    
+} MCAPP_DISTURBANCE_OBSERVER_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_DisturbanceObserverInit(MCAPP_DISTURBANCE_OBSERVER_T *);
+void MCAPP_DisturbanceObserverStep(MCAPP_DISTURBANCE_OBSERVER_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __DISTURBANCE_OBSERVER_H */
@@ -0,0 +1,267 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file dpwm.c
+ *
+ * @brief This module implements discontinuous pulse width modulation, which clamps
+ * one phase to a DC bus rail in each 60 degree sector to reduce switching.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dpwm.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static bool MCAPP_DPWMIsActive(MCAPP_DPWM_T *);
+static uint16_t MCAPP_DPWMSelectPhase(uint16_t, const int16_t *, bool *);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_DPWMInit(MCAPP_DPWM_T *)  </B>
+*
+* @brief Function to reset discontinuous PWM states.
+*
+* @param Pointer to the data structure containing discontinuous PWM 
+*        parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_DPWMInit(&dpwm); </CODE>
+*
+*/
+void MCAPP_DPWMInit(MCAPP_DPWM_T *pDPWM)
+{
+    pDPWM->active = 0;
+    pDPWM->highCount[0] = 0;
+    pDPWM->highCount[1] = 0;
+    pDPWM->highCount[2] = 0;
+}
+
+/**
+* <B> Function: void MCAPP_DPWMStep(MCAPP_DPWM_T *, MC_DUTYCYCLEOUT_T *) </B>
+*
+* @brief Function shifting space vector modulation duty cycles to clamp one
+* phase to a rail. Duty cycles are not changed below the modulation index of
+* discontinuous PWM.
+*
+* @param Pointer to the data structure containing discontinuous PWM 
+*        parameters.
+* @param Pointer to duty cycles from space vector modulation.
+* @return   none.
+* @example
+* <CODE> MCAPP_DPWMStep(&dpwm, &pwmDuty); </CODE>
+*
+*/
+void MCAPP_DPWMStep(MCAPP_DPWM_T *pDPWM, MC_DUTYCYCLEOUT_T *pDuty)
+{
+    uint16_t *pPhaseDuty[3];
+    int16_t vabc[3];
+    int32_t offset, duty;
+    uint16_t phase, index;
+    bool clampHigh;
+    
+    if (!MCAPP_DPWMIsActive(pDPWM))
+    {
+        pDPWM->highCount[0] = 0;
+        pDPWM->highCount[1] = 0;
+        pDPWM->highCount[2] = 0;
+        return;
+    }
+    
+    pPhaseDuty[0] = &pDuty->dutycycle1;
+    pPhaseDuty[1] = &pDuty->dutycycle2;
+    pPhaseDuty[2] = &pDuty->dutycycle3;
+    vabc[0] = pDPWM->pVabc->a;
+    vabc[1] = pDPWM->pVabc->b;
+    vabc[2] = pDPWM->pVabc->c;
+    
+    phase = MCAPP_DPWMSelectPhase(pDPWM->mode, vabc, &clampHigh);
+    
+    /* Phases which are not at positive rail restart refresh count */
+    for (index = 0; index < 3; index++)
+    {
+        if ((index != phase) || !clampHigh)
+        {
+            pDPWM->highCount[index] = 0;
+        }
+    }
+    
+    if (!clampHigh)
+    {
+        offset = -(int32_t)*pPhaseDuty[phase];
+        
+        /* PWM driver raises a duty below dutyMin to dutyMin, changing line
+         * voltages. When another phase would fall below dutyMin, the 
+         * clamped phase is held at dutyMin for the period */
+        for (index = 0; index < 3; index++)
+        {
+            if ((index != phase) && 
+                (((int32_t)*pPhaseDuty[index] + offset) < pDPWM->dutyMin))
+            {
+                offset += pDPWM->dutyMin;
+                break;
+            }
+        }
+    }
+    else if (pDPWM->highCount[phase] < pDPWM->refreshCountLimit)
+    {
+        pDPWM->highCount[phase]++;
+        offset = (int32_t)pDPWM->dutyHigh - *pPhaseDuty[phase];
+    }
+    else
+    {
+        /* Low side switch turns on for one period to refresh bootstrap */
+        pDPWM->highCount[phase] = 0;
+        offset = (int32_t)pDPWM->dutyRefresh - *pPhaseDuty[phase];
+    }
+    
+    for (index = 0; index < 3; index++)
+    {
+        duty = (int32_t)*pPhaseDuty[index] + offset;
+        if (duty < 0)
+        {
+            duty = 0;
+        }
+        else if (duty > (int32_t)pDPWM->dutyHigh)
+        {
+            duty = pDPWM->dutyHigh;
+        }
+        *pPhaseDuty[index] = (uint16_t)duty;
+    }
+}
+
+/**
+* <B> Function: MCAPP_DPWMIsActive(MCAPP_DPWM_T *) </B>
+*
+* @brief Compares voltage vector magnitude with the modulation index 
+* thresholds and returns true when discontinuous PWM is to be used.
+*
+*/
+static bool MCAPP_DPWMIsActive(MCAPP_DPWM_T *pDPWM)
+{
+    const MC_ALPHABETA_T *pVAlphaBeta = pDPWM->pVAlphaBeta;
+    int32_t vMagSquare, vLimitSquare;
+    int16_t vLimit;
+    
+    if (pDPWM->mode == MCAPP_DPWM_NONE)
+    {
+        pDPWM->active = 0;
+        return false;
+    }
+    
+    vLimit = (int16_t)(__builtin_mulss(*pDPWM->pVdc, (pDPWM->active) ? 
+                pDPWM->qVoltFactorOff : pDPWM->qVoltFactorOn) >> 15);
+    vLimitSquare = __builtin_mulss(vLimit, vLimit) >> 1;
+    vMagSquare = (__builtin_mulss(pVAlphaBeta->alpha, pVAlphaBeta->alpha) >> 1)
+                + (__builtin_mulss(pVAlphaBeta->beta, pVAlphaBeta->beta) >> 1);
+    pDPWM->active = (vMagSquare >= vLimitSquare);
+    
+    return pDPWM->active;
+}
+
+/**
+* <B> Function: MCAPP_DPWMSelectPhase(uint16_t, const int16_t *, bool *) </B>
+*
+* @brief Selects the phase to clamp and the rail from phase voltages. DPWM0
+* and DPWM2 clamp the phase with the largest line voltage to the next or to 
+* the previous phase, which shifts the clamped interval by 30 degrees from 
+* DPWM1.
+*
+*/
+static uint16_t MCAPP_DPWMSelectPhase(uint16_t mode, const int16_t *vabc,
+                                        bool *pClampHigh)
+{
+    uint16_t index, phaseMax = 0, phaseMin = 0, phase = 0;
+    int32_t lineVoltage, lineVoltageMax = 0, magnitude, magnitudeMax = -1;
+    
+    if ((mode == MCAPP_DPWM_0) || (mode == MCAPP_DPWM_2))
+    {
+        for (index = 0; index < 3; index++)
+        {
+            /* DPWM0 : Va-Vb, Vb-Vc, Vc-Va, DPWM2 : Va-Vc, Vb-Va, Vc-Vb */
+            lineVoltage = (int32_t)vabc[index] - vabc[(mode == MCAPP_DPWM_0) ?
+                                ((index + 1) % 3) : ((index + 2) % 3)];
+            magnitude = (lineVoltage < 0) ? -lineVoltage : lineVoltage;
+            if (magnitude > magnitudeMax)
+            {
+                magnitudeMax = magnitude;
+                lineVoltageMax = lineVoltage;
+                phase = index;
+            }
+        }
+        *pClampHigh = (lineVoltageMax > 0);
+        return phase;
+    }
+    
+    for (index = 1; index < 3; index++)
+    {
+        if (vabc[index] > vabc[phaseMax])
+        {
+            phaseMax = index;
+        }
+        if (vabc[index] < vabc[phaseMin])
+        {
+            phaseMin = index;
+        }
+    }
+    
+    if (mode == MCAPP_DPWM_MIN)
+    {
+        *pClampHigh = false;
+    }
+    else if (mode == MCAPP_DPWM_MAX)
+    {
+        *pClampHigh = true;
+    }
+    else
+    {
+        /* DPWM1 : phase with largest voltage magnitude */
+        *pClampHigh = ((int32_t)vabc[phaseMax] + vabc[phaseMin] >= 0);
+    }
+    
+    return (*pClampHigh) ? phaseMax : phaseMin;
+}
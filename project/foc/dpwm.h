@@ -0,0 +1,130 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file dpwm.h
+ *
+ * @brief This module implements discontinuous pulse width modulation, which clamps
+ * one phase to a DC bus rail in each 60 degree sector to reduce switching.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __DPWM_H
+#define __DPWM_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="DEFINITIONS ">
+
+/* Modulation modes, defined as macros so that the selected DPWM_MODE can be
+ * checked by the preprocessor */
+#define MCAPP_DPWM_NONE     0   /* Continuous space vector modulation only */
+#define MCAPP_DPWM_0        1   /* Clamp 60 degrees, leading phase voltage 
+                                 * peak by 30 degrees */
+#define MCAPP_DPWM_1        2   /* Clamp 60 degrees around phase voltage 
+                                 * peak */
+#define MCAPP_DPWM_2        3   /* Clamp 60 degrees, lagging phase voltage 
+                                 * peak by 30 degrees */
+#define MCAPP_DPWM_MIN      4   /* Clamp lowest phase to negative rail */
+#define MCAPP_DPWM_MAX      5   /* Clamp highest phase to positive rail */
+
+typedef uint16_t MCAPP_DPWM_MODE_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to discontinuous PWM. All 
+    duty cycles of space vector modulation are shifted by the same amount 
+    until the selected phase reaches a rail, line voltages are unchanged. 
+    Discontinuous PWM is used above a modulation index, with hysteresis. A
+    phase clamped to the positive rail gets one period at dutyRefresh after
+    refreshCountLimit periods, to recharge its bootstrap capacitor. */
+
+typedef struct
+{
+    /* Linear voltage limit, DC bus voltage/sqrt(3), times modulation index
+     * to start and to stop discontinuous PWM, Q15 of voltage base per 
+     * Q15 of DC bus voltage */
+    int16_t qVoltFactorOn,
+            qVoltFactorOff;
+    
+    uint16_t
+        mode,               /* Modulation mode - MCAPP_DPWM_MODE_T */
+        active,             /* Discontinuous PWM is in use */
+        dutyMin,            /* Lowest duty of the PWM driver above 0 */
+        dutyHigh,           /* Duty at positive rail, PWM period */
+        dutyRefresh,        /* Duty of bootstrap refresh period */
+        refreshCountLimit;  /* Periods at positive rail before refresh */
+    
+    /* Periods each phase spent at positive rail */
+    uint16_t highCount[3];
+    
+    const MC_ABC_T *pVabc;
+    const MC_ALPHABETA_T *pVAlphaBeta;
+    const int16_t *pVdc;
+    
+} MCAPP_DPWM_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_DPWMInit(MCAPP_DPWM_T *);
+void MCAPP_DPWMStep(MCAPP_DPWM_T *, MC_DUTYCYCLEOUT_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __DPWM_H */
@@ -0,0 +1,259 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_adapt.c
+ *
+ * @brief This module adapts winding resistance and back EMF constant of the PLL
+ * estimator online, to follow their change with motor temperature.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15abs function use */
+#include <libq.h>
+#include "estim_adapt.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static void MCAPP_EstimatorAdaptNormalize(int32_t, uint16_t, int16_t *,
+                                            uint16_t *);
+static int32_t MCAPP_EstimatorAdaptToNominal(int16_t, uint16_t, uint16_t);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_EstimatorAdaptInit(MCAPP_ESTIMATOR_ADAPT_T *)  </B>
+*
+* @brief Function to reset Estimator Adaptation variables. Adapted parameters
+* are not reset, motor temperature does not change with a restart.
+*
+* @param    pointer to the data structure containing adaptation parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorAdaptInit(&adapt); </CODE>
+*
+*/
+void MCAPP_EstimatorAdaptInit(MCAPP_ESTIMATOR_ADAPT_T *pAdapt)
+{
+    pAdapt->count = 0;
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorAdaptStep(MCAPP_ESTIMATOR_ADAPT_T *)  </B>
+*
+* @brief Function to adapt resistance and inverse back EMF constant of the PLL
+* estimator. It is called every control cycle in closed loop and executes 
+* once in countLimit cycles, using the filtered back EMF of the estimator.
+* Parameters are adapted only while the estimator is locked:
+*   - below qRsMaxSpeed with |Iq| above qRsMinCurrent, Rs error = Esd/Iq
+*   - above qKfiMinSpeed, relative 1/Ke error = -Esd/Esq
+* Each error is applied through a first order filter and the result is 
+* limited. Updated values are written to the estimator, the lock monitor and
+* the motor parameters in this interrupt, so a value and its scale are never
+* used half updated.
+*
+* @param    pointer to the data structure containing adaptation parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorAdaptStep(&adapt); </CODE>
+*
+*/
+void MCAPP_EstimatorAdaptStep(MCAPP_ESTIMATOR_ADAPT_T *pAdapt)
+{
+    MCAPP_ESTIMATOR_PLL_T *pEstim = pAdapt->pEstim;
+    const int16_t omegaAbs = _Q15abs(pEstim->qOmegaFilt);
+    const int16_t iq = pAdapt->pIdq->q;
+    const int16_t iqAbs = _Q15abs(iq);
+    int16_t error, esd;
+    int32_t step, target;
+    uint16_t scale;
+    
+    pAdapt->count++;
+    if (pAdapt->count < pAdapt->countLimit)
+    {
+        return;
+    }
+    pAdapt->count = 0;
+    
+    if (!MCAPP_EstimatorPLLIsLocked(pEstim) || 
+        (pAdapt->pMonitor->violation == 1))
+    {
+        return;
+    }
+    
+    if ((omegaAbs < pAdapt->qRsMaxSpeed) && 
+        (iqAbs > pAdapt->qRsMinCurrent))
+    {
+        /* Rs error at nominal scale(Q15 or less) = Esd/Iq, |Esd| is limited
+         * below |Iq| so that the quotient fits in 16 bits */
+        esd = pEstim->qEsdf;
+        if (esd >= iqAbs)
+        {
+            esd = iqAbs - 1;
+        }
+        else if (esd <= -iqAbs)
+        {
+            esd = 1 - iqAbs;
+        }
+        error = __builtin_divsd((int32_t)esd << pAdapt->rsScaleNominal, iq);
+        pAdapt->rsStateVar += __builtin_mulss(error, pAdapt->qKfilter);
+        target = pAdapt->rsStateVar >> 15;
+        if (target > pAdapt->rsMax)
+        {
+            pAdapt->rsStateVar = pAdapt->rsMax << 15;
+        }
+        else if (target < pAdapt->rsMin)
+        {
+            pAdapt->rsStateVar = pAdapt->rsMin << 15;
+        }
+        MCAPP_EstimatorAdaptNormalize(pAdapt->rsStateVar >> 15, 
+                pAdapt->rsScaleNominal, &pAdapt->pMotor->qRs, 
+                &pAdapt->pMotor->qRsScale);
+    }
+    else if (omegaAbs > pAdapt->qKfiMinSpeed)
+    {
+        /* Relative 1/Ke error = -Esd/Esq, |Esd| < |Esq| while locked */
+        error = (int16_t)__builtin_divsd((int32_t)pEstim->qEsdf << 15, 
+                                        pEstim->qEsqf);
+        /* 1/Ke may exceed 16 bits at nominal scale : the filtered error is
+         * pre-shifted so that the product fits in 32 bits */
+        step = __builtin_mulss(error, pAdapt->qKfilter) >> 8;
+        pAdapt->invKfiStateVar -= 
+                        (step * (pAdapt->invKfiStateVar >> 15)) >> 7;
+        target = pAdapt->invKfiStateVar >> 15;
+        if (target > pAdapt->invKfiMax)
+        {
+            pAdapt->invKfiStateVar = pAdapt->invKfiMax << 15;
+        }
+        else if (target < pAdapt->invKfiMin)
+        {
+            pAdapt->invKfiStateVar = pAdapt->invKfiMin << 15;
+        }
+        MCAPP_EstimatorAdaptNormalize(pAdapt->invKfiStateVar >> 15, 
+                pAdapt->invKfiScaleNominal, &pEstim->qInvKfiConst, &scale);
+        pEstim->qInvKfiConstScale = (int16_t)scale;
+        pAdapt->pMonitor->qInvKfiConst = pEstim->qInvKfiConst;
+        pAdapt->pMonitor->qInvKfiConstScale = (int16_t)scale;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorAdaptRebase(MCAPP_ESTIMATOR_ADAPT_T *)  
+* </B>
+*
+* @brief Function to continue adaptation from resistance and inverse back EMF
+* constant presently used by the estimator, e.g. after motor parameter 
+* identification. Limits are moved by the same ratio as the values.
+*
+* @param    pointer to the data structure containing adaptation parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorAdaptRebase(&adapt); </CODE>
+*
+*/
+void MCAPP_EstimatorAdaptRebase(MCAPP_ESTIMATOR_ADAPT_T *pAdapt)
+{
+    const int32_t rsOld = pAdapt->rsStateVar >> 15;
+    const int32_t invKfiOld = pAdapt->invKfiStateVar >> 15;
+    const int32_t rs = MCAPP_EstimatorAdaptToNominal(pAdapt->pMotor->qRs,
+                        pAdapt->pMotor->qRsScale, pAdapt->rsScaleNominal);
+    const int32_t invKfi = MCAPP_EstimatorAdaptToNominal(
+                        pAdapt->pEstim->qInvKfiConst,
+                        (uint16_t)pAdapt->pEstim->qInvKfiConstScale, 
+                        pAdapt->invKfiScaleNominal);
+    
+    if ((rsOld > 0) && (rs > 0))
+    {
+        pAdapt->rsMin = pAdapt->rsMin * rs / rsOld;
+        pAdapt->rsMax = pAdapt->rsMax * rs / rsOld;
+        pAdapt->rsStateVar = rs << 15;
+    }
+    if ((invKfiOld > 0) && (invKfi > 0))
+    {
+        pAdapt->invKfiMin = pAdapt->invKfiMin * invKfi / invKfiOld;
+        pAdapt->invKfiMax = pAdapt->invKfiMax * invKfi / invKfiOld;
+        pAdapt->invKfiStateVar = invKfi << 15;
+    }
+}
+
+/**
+* <B> Function: int32_t MCAPP_EstimatorAdaptToNominal(int16_t, uint16_t, 
+*               uint16_t)  </B>
+*
+* @brief Converts a 16 bit value and its scale to nominal scale.
+*
+*/
+static int32_t MCAPP_EstimatorAdaptToNominal(int16_t value, uint16_t scale,
+                                            uint16_t scaleNominal)
+{
+    if (scale > scaleNominal)
+    {
+        return (int32_t)value >> (scale - scaleNominal);
+    }
+    return (int32_t)value << (scaleNominal - scale);
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorAdaptNormalize(int32_t, uint16_t, 
+*               int16_t *, uint16_t *)  </B>
+*
+* @brief Converts a value at nominal scale to 16 bit value and scale. Scale
+* is reduced while the value exceeds 16 bits, so that the product 
+* (value*x) >> scale is unchanged.
+*
+*/
+static void MCAPP_EstimatorAdaptNormalize(int32_t value, uint16_t scale,
+                                    int16_t *pValue, uint16_t *pScale)
+{
+    while ((value > INT16_MAX) && (scale > 0))
+    {
+        value >>= 1;
+        scale--;
+    }
+    *pValue = (int16_t)value;
+    *pScale = scale;
+}
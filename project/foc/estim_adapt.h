@@ -0,0 +1,128 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_adapt.h
+ *
+ * @brief This module adapts winding resistance and back EMF constant of the PLL
+ * estimator online, to follow their change with motor temperature.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef __ESTIM_ADAPT_H
+#define __ESTIM_ADAPT_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+#include "motor_params.h"
+#include "estim_pll.h"
+#include "estim_monitor.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to estimator parameter 
+    adaptation. A resistance or back EMF constant error shows up as d axis 
+    back EMF in the estimator frame. At low speed under load it is dominated
+    by the resistance error, Esd = -dRs*Iq, which is used to adapt Rs; at high
+    speed it is dominated by the back EMF constant error, Esd/Esq = dKe/Ke,
+    which is used to adapt 1/Ke. Adapted values are kept over motor restarts.*/
+        
+typedef struct
+{
+    /* Resistance held at nominal scale, shifted left by 15 */
+    int32_t rsStateVar;
+    /* Resistance limits at nominal scale */
+    int32_t rsMin;
+    int32_t rsMax;
+    /* Inverse back EMF constant held at nominal scale, shifted left by 15 */
+    int32_t invKfiStateVar;
+    /* Inverse back EMF constant limits at nominal scale */
+    int32_t invKfiMin;
+    int32_t invKfiMax;
+    /* Nominal scale of resistance and inverse back EMF constant */
+    uint16_t rsScaleNominal;
+    uint16_t invKfiScaleNominal;
+    /* Resistance is adapted below this speed */
+    int16_t qRsMaxSpeed;
+    /* Resistance is adapted above this Q axis current */
+    int16_t qRsMinCurrent;
+    /* Back EMF constant is adapted above this speed */
+    int16_t qKfiMinSpeed;
+    /* Adaptation filter constant */
+    int16_t qKfilter;
+    /* Control cycles per adaptation step */
+    uint16_t countLimit;
+    uint16_t count;
+    /* Adaptation enable flag */
+    uint16_t enable;
+    
+    MCAPP_MOTOR_T *pMotor;
+    MCAPP_ESTIMATOR_PLL_T *pEstim;
+    MCAPP_ESTIMATOR_MONITOR_T *pMonitor;
+    const MC_DQ_T *pIdq;
+    
+} MCAPP_ESTIMATOR_ADAPT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_EstimatorAdaptInit (MCAPP_ESTIMATOR_ADAPT_T *);
+void MCAPP_EstimatorAdaptStep (MCAPP_ESTIMATOR_ADAPT_T *);
+void MCAPP_EstimatorAdaptRebase (MCAPP_ESTIMATOR_ADAPT_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __ESTIM_ADAPT_H */
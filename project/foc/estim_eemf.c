@@ -0,0 +1,327 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_eemf.c
+ *
+ * @brief This module implements extended EMF observer with quadrature PLL
+ * Estimator.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15abs function use */
+#include <libq.h>
+#include "estim_eemf.h"
+#include "general.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_EstimatorEEMFInit(void *)  </B>
+*
+* @brief Function to reset extended EMF observer Estimator Data Structure 
+* variables. Inverse of Ls/dt is calculated here from motor parameters.
+*
+* @param    pointer to the data structure containing Estimator parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorEEMFInit(&estimator); </CODE>
+*
+*/
+void MCAPP_EstimatorEEMFInit(void *pData)
+{
+    MCAPP_ESTIMATOR_EEMF_T *pEstim = (MCAPP_ESTIMATOR_EEMF_T *)pData;
+    const MCAPP_MOTOR_T *pMotor = pEstim->pMotor;
+    int32_t invLsDt;
+    
+    /* 1/(Ls/dt) in Q15, scaled down if Ls/dt is less than 1 */
+    invLsDt = ((int32_t)1 << (15 + pMotor->qLsDtScale)) / pMotor->qLsDt;
+    pEstim->qInvLsDtScale = 15;
+    while (invLsDt > INT16_MAX)
+    {
+        invLsDt >>= 1;
+        pEstim->qInvLsDtScale--;
+    }
+    pEstim->qInvLsDt = (int16_t)invLsDt;
+    
+    pEstim->qK1 = pEstim->qK1Min;
+    pEstim->qK2 = pEstim->qK2Min;
+    
+    pEstim->qIalphaEst = 0;
+    pEstim->qIbetaEst = 0;
+    pEstim->qIalphaStateVar = 0;
+    pEstim->qIbetaStateVar = 0;
+    pEstim->qEalphaStateVar = 0;
+    pEstim->qEbetaStateVar = 0;
+    pEstim->vAlphaBetaLast.alpha = 0;
+    pEstim->vAlphaBetaLast.beta = 0;
+    pEstim->EMFAlphaBeta.alpha = 0;
+    pEstim->EMFAlphaBeta.beta = 0;
+    pEstim->EMFdq.d = 0;
+    pEstim->EMFdq.q = 0;
+    
+    pEstim->qErrorPLL = 0;
+    pEstim->qEmag = 0;
+    pEstim->qOmegaIntStateVar = 0;
+    
+    pEstim->qThetaStateVar = 0;
+    pEstim->qTheta = 0;
+    
+    pEstim->qOmega = 0;
+    pEstim->qOmegaFilt = 0;
+    pEstim->qOmegaStateVar = 0;
+    
+    pEstim->output.qTheta = 0;
+    pEstim->output.qOmega = 0;
+    pEstim->output.qEsd = 0;
+    pEstim->output.qEsq = 0;
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorEEMFReset(void *, int16_t, int16_t)  </B>
+*
+* @brief Function to set extended EMF observer Estimator angle and speed. 
+* Estimated EMF is set to the back EMF expected at the given angle and speed,
+* estimated currents are set to the measured currents.
+*
+* @param    pointer to the data structure containing Estimator parameters.
+* @param    angle.
+* @param    speed.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorEEMFReset(&estimator, qTheta, qOmega); </CODE>
+*
+*/
+void MCAPP_EstimatorEEMFReset(void *pData, int16_t qTheta, int16_t qOmega)
+{
+    MCAPP_ESTIMATOR_EEMF_T *pEstim = (MCAPP_ESTIMATOR_EEMF_T *)pData;
+    MC_SINCOS_T estimSinCos;
+    int32_t esq, esqLimit;
+    
+    pEstim->qTheta = qTheta;
+    pEstim->qThetaStateVar = (int32_t)qTheta << 15;
+    
+    pEstim->qOmega = qOmega;
+    pEstim->qOmegaIntStateVar = (int32_t)qOmega << 15;
+    pEstim->qOmegaFilt = qOmega;
+    pEstim->qOmegaStateVar = (int32_t)qOmega << 15;
+    pEstim->qErrorPLL = 0;
+    
+    /* Es = Omega / InvKfi, aligned to q axis of the given angle. Dividend is
+     * limited to keep the quotient of the 32/16 bit division in 16 bits. */
+    esq = (int32_t)qOmega << pEstim->qInvKfiConstScale;
+    esqLimit = __builtin_mulss(pEstim->qInvKfiConst, INT16_MAX);
+    if (esq > esqLimit)
+    {
+        esq = esqLimit;
+    }
+    else if (esq < -esqLimit)
+    {
+        esq = -esqLimit;
+    }
+    pEstim->EMFdq.d = 0;
+    pEstim->EMFdq.q = __builtin_divsd(esq, pEstim->qInvKfiConst);
+    
+    MC_CalculateSineCosine_Assembly_Ram(qTheta, &estimSinCos);
+    pEstim->qEalphaStateVar = -__builtin_mulss(pEstim->EMFdq.q, estimSinCos.sin);
+    pEstim->qEbetaStateVar = __builtin_mulss(pEstim->EMFdq.q, estimSinCos.cos);
+    pEstim->EMFAlphaBeta.alpha = (int16_t)(pEstim->qEalphaStateVar >> 15);
+    pEstim->EMFAlphaBeta.beta = (int16_t)(pEstim->qEbetaStateVar >> 15);
+    
+    pEstim->qIalphaEst = pEstim->pIAlphaBeta->alpha;
+    pEstim->qIbetaEst = pEstim->pIAlphaBeta->beta;
+    pEstim->qIalphaStateVar = (int32_t)pEstim->qIalphaEst << 15;
+    pEstim->qIbetaStateVar = (int32_t)pEstim->qIbetaEst << 15;
+    pEstim->vAlphaBetaLast = *pEstim->pVAlphaBeta;
+    
+    pEstim->output.qTheta = pEstim->qTheta;
+    pEstim->output.qOmega = pEstim->qOmegaFilt;
+    pEstim->output.qEsd = pEstim->EMFdq.d;
+    pEstim->output.qEsq = pEstim->EMFdq.q;
+}
+
+/**
+* <B> Function: bool MCAPP_EstimatorEEMFIsLocked(const void *)  </B>
+*
+* @brief Function to check if extended EMF observer Estimator output can be
+* used for closed loop control: speed is above the threshold speed and 
+* estimated angle error(|Esd| < |Esq|) is less than 45 degrees.
+*
+* @param    pointer to the data structure containing Estimator parameters.
+* @return   true if estimate can be used.
+* @example
+* <CODE> locked = MCAPP_EstimatorEEMFIsLocked(&estimator); </CODE>
+*
+*/
+bool MCAPP_EstimatorEEMFIsLocked(const void *pData)
+{
+    const MCAPP_ESTIMATOR_EEMF_T *pEstim = 
+                                    (const MCAPP_ESTIMATOR_EEMF_T *)pData;
+    
+    return ((_Q15abs(pEstim->qOmegaFilt) > pEstim->qThresholdSpeed) &&
+            (_Q15abs(pEstim->EMFdq.d) < _Q15abs(pEstim->EMFdq.q)));
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorEEMF(void *)  </B>
+*
+* @brief Extended EMF observer to determine rotor speed and position based on
+* motor parameters and feedbacks.
+* A current observer predicts Ialphabeta from the voltage applied over the
+* last control period and the estimated EMF. The voltage applied over the 
+* last period is the one read in the previous call, as duty cycle is updated
+* at the start of the next PWM cycle. The prediction error corrects the 
+* estimated EMF, which is also rotated by the estimated speed so that it
+* does not lag during acceleration. Observer gains increase with speed. A 
+* quadrature PLL locks the estimated angle to the EMF vector, the phase error
+* is normalized by the EMF magnitude so the PLL bandwidth does not depend on 
+* speed.
+*
+* @param    pointer to the data structure containing Estimator parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorEEMF(&estimator); </CODE>
+*
+*/
+void MCAPP_EstimatorEEMF(void *pData)
+{
+    MCAPP_ESTIMATOR_EEMF_T *pEstim = (MCAPP_ESTIMATOR_EEMF_T *)pData;
+    const MCAPP_MOTOR_T *pMotor = pEstim->pMotor;
+    const MC_ALPHABETA_T *pIAlphaBeta = pEstim->pIAlphaBeta;
+    const MC_ALPHABETA_T *pVAlphaBeta = pEstim->pVAlphaBeta;
+ 
+    MC_SINCOS_T     estimSinCos;        /* Sine-cosine for estimator */  
+    
+    int16_t omegaAbs, errorAlpha, errorBeta, uAlpha, uBeta, rotation;
+    int16_t error;
+    
+    /* Speed adaptive observer gains: K = Kmin + Kslope*|Omega| */
+    omegaAbs = _Q15abs(pEstim->qOmega);
+    pEstim->qK1 = pEstim->qK1Min + 
+            (int16_t)(__builtin_mulss(pEstim->qK1Slope, omegaAbs) >> 15);
+    pEstim->qK2 = pEstim->qK2Min + 
+            (int16_t)(__builtin_mulss(pEstim->qK2Slope, omegaAbs) >> 15);
+    
+    /* Current prediction with the voltage applied over the last period:
+     * Estimated Ialphabeta += (Valphabeta - Rs*Estimated Ialphabeta 
+     *                                                  - Ealphabeta)/(Ls/dt) */
+    uAlpha = UTIL_SatShrS16((int32_t)pEstim->vAlphaBetaLast.alpha 
+        - (__builtin_mulss(pMotor->qRs, pEstim->qIalphaEst) >> pMotor->qRsScale)
+        - pEstim->EMFAlphaBeta.alpha, 0);
+    uBeta = UTIL_SatShrS16((int32_t)pEstim->vAlphaBetaLast.beta 
+        - (__builtin_mulss(pMotor->qRs, pEstim->qIbetaEst) >> pMotor->qRsScale)
+        - pEstim->EMFAlphaBeta.beta, 0);
+    pEstim->vAlphaBetaLast = *pVAlphaBeta;
+    pEstim->qIalphaStateVar = UTIL_StateLimit(pEstim->qIalphaStateVar
+        + (__builtin_mulss(pEstim->qInvLsDt, uAlpha) 
+                                        << (15 - pEstim->qInvLsDtScale)));
+    pEstim->qIbetaStateVar = UTIL_StateLimit(pEstim->qIbetaStateVar
+        + (__builtin_mulss(pEstim->qInvLsDt, uBeta) 
+                                        << (15 - pEstim->qInvLsDtScale)));
+    
+    /* Current prediction error = Ialphabeta - Estimated Ialphabeta */
+    errorAlpha = UTIL_SatShrS16((int32_t)pIAlphaBeta->alpha - 
+                        (int16_t)(pEstim->qIalphaStateVar >> 15), 0);
+    errorBeta = UTIL_SatShrS16((int32_t)pIAlphaBeta->beta - 
+                        (int16_t)(pEstim->qIbetaStateVar >> 15), 0);
+    
+    /* Current observer correction:
+     * Estimated Ialphabeta += K1*(Ialphabeta - Estimated Ialphabeta) */
+    pEstim->qIalphaStateVar = UTIL_StateLimit(pEstim->qIalphaStateVar
+        + __builtin_mulss(pEstim->qK1, errorAlpha));
+    pEstim->qIbetaStateVar = UTIL_StateLimit(pEstim->qIbetaStateVar
+        + __builtin_mulss(pEstim->qK1, errorBeta));
+    pEstim->qIalphaEst = (int16_t)(pEstim->qIalphaStateVar >> 15);
+    pEstim->qIbetaEst = (int16_t)(pEstim->qIbetaStateVar >> 15);
+    
+    /* EMF observer, EMF vector rotates with Omega:
+     * Ealpha += -Omega*Ts*Ebeta - K2*(Ialpha - Estimated Ialpha)
+     * Ebeta  +=  Omega*Ts*Ealpha - K2*(Ibeta - Estimated Ibeta)
+     * Ebeta is rotated with the updated Ealpha, which keeps the magnitude of
+     * the rotated vector(forward Euler rotation would grow it every cycle) */
+    rotation = (int16_t)(__builtin_mulss(pEstim->qOmega, 
+                                    pEstim->qRotationConst) >> 15);
+    pEstim->qEalphaStateVar = UTIL_StateLimit(pEstim->qEalphaStateVar
+        - __builtin_mulss(rotation, pEstim->EMFAlphaBeta.beta)
+        - __builtin_mulss(pEstim->qK2, errorAlpha));
+    pEstim->EMFAlphaBeta.alpha = (int16_t)(pEstim->qEalphaStateVar >> 15);
+    pEstim->qEbetaStateVar = UTIL_StateLimit(pEstim->qEbetaStateVar
+        + __builtin_mulss(rotation, pEstim->EMFAlphaBeta.alpha)
+        - __builtin_mulss(pEstim->qK2, errorBeta));
+    pEstim->EMFAlphaBeta.beta = (int16_t)(pEstim->qEbetaStateVar >> 15);
+    
+    /* Calculate sine and cosine components of the rotor flux angle */
+    MC_CalculateSineCosine_Assembly_Ram(pEstim->qTheta, &estimSinCos);
+
+    /*  Park_EMF.d =  EMF.alpha*cos(Angle) + EMF.beta*sin(Angle)
+        Park_EMF.q = -EMF.alpha*sin(Angle) + EMF.beta*cos(Angle) */
+    MC_TransformPark_Assembly(&pEstim->EMFAlphaBeta, &estimSinCos, 
+                                    &pEstim->EMFdq);
+    
+    /* PLL phase error = -sgn(Eq)*Ed/|E| = sin(angle error), held at zero
+     * when the EMF is too small to determine the angle */
+    pEstim->qEmag = UTIL_MagnitudeApprox(pEstim->EMFdq.d, pEstim->EMFdq.q);
+    error = UTIL_PLLPhaseError(pEstim->EMFdq.d, pEstim->EMFdq.q, 
+                                pEstim->qEmag, pEstim->qEmagMin);
+    pEstim->qErrorPLL = error;
+    
+    /* PLL PI controller, output is estimated speed */
+    pEstim->qOmega = UTIL_PIClamped(&pEstim->qOmegaIntStateVar, 
+                                    pEstim->qKpPLL, pEstim->qKiPLL, error);
+    
+    /* Integrate the estimated rotor flux velocity to get estimated rotor angle */  
+    pEstim->qThetaStateVar += __builtin_mulss(pEstim->qOmega, pEstim->qDeltaT);
+    pEstim->qTheta = (int16_t) (pEstim->qThetaStateVar >> 15);
+    
+    /* Filter the estimated  rotor velocity using a first order low-pass filter */
+    const int16_t Omegadiff = (int16_t) (pEstim->qOmega - pEstim->qOmegaFilt);
+    pEstim->qOmegaStateVar += __builtin_mulss(Omegadiff, pEstim->qOmegaFiltConst);
+    pEstim->qOmegaFilt = (int16_t) (pEstim->qOmegaStateVar >> 15);  
+    
+    pEstim->output.qTheta = pEstim->qTheta;
+    pEstim->output.qOmega = pEstim->qOmegaFilt;
+    pEstim->output.qEsd = pEstim->EMFdq.d;
+    pEstim->output.qEsq = pEstim->EMFdq.q;
+}
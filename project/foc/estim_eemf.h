@@ -0,0 +1,163 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_eemf.h
+ *
+ * @brief This module implements extended EMF observer with quadrature PLL
+ * Estimator.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef __ESTIM_EEMF_H
+#define __ESTIM_EEMF_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+#include "motor_params.h"
+#include "estim_interface.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to extended EMF observer
+    estimator. The observer estimates the alpha-beta extended EMF from the
+    current prediction error, the quadrature PLL locks the estimated angle
+    to the EMF vector. */
+        
+typedef struct
+{
+    /* Integration constant */
+    int16_t qDeltaT;
+    /* Rotation of EMF vector per control period at peak speed, Q15 radian */
+    int16_t qRotationConst;
+    /* Inverse of Ls/dt and its scaling, calculated at initialization */
+    int16_t qInvLsDt,
+            qInvLsDtScale;
+    
+    /* Current observer gain = qK1Min + qK1Slope * |Omega| */
+    int16_t qK1Min,
+            qK1Slope,
+            qK1;
+    /* EMF observer gain = qK2Min + qK2Slope * |Omega| */
+    int16_t qK2Min,
+            qK2Slope,
+            qK2;
+    
+    /* Estimated currents and its state variables */
+    int16_t qIalphaEst,
+            qIbetaEst;
+    int32_t qIalphaStateVar,
+            qIbetaStateVar;
+    /* State variables for estimated EMF */
+    int32_t qEalphaStateVar,
+            qEbetaStateVar;
+    /* Voltage of previous control cycle, applied over the last period */
+    MC_ALPHABETA_T vAlphaBetaLast;
+    
+    /* PLL proportional and integral gains */
+    int16_t qKpPLL,
+            qKiPLL;
+    /* PLL phase error, sine of estimated angle error */
+    int16_t qErrorPLL;
+    /* Minimum EMF magnitude for PLL phase detector */
+    int16_t qEmagMin;
+    /* EMF magnitude, max + 3/8 min approximation */
+    int16_t qEmag;
+    /* State variable for PLL integral term */
+    int32_t qOmegaIntStateVar;
+    
+    /* angle of estimation */
+    int16_t qTheta;
+    /* internal variable for angle */
+    int32_t qThetaStateVar;
+    /* Estimated speed - PLL output and filtered */
+    int16_t qOmega,
+            qOmegaFilt;
+    /* Filter constant for Estimated speed */
+    int16_t qOmegaFiltConst;
+    /* State Variable for Estimated speed */
+    int32_t qOmegaStateVar;
+    /* Minimum speed for closed loop control */
+    int16_t qThresholdSpeed;
+    
+    int16_t qInvKfiConst,
+            qInvKfiConstScale;
+    
+    /* Back EMF voltage in alpha-beta */ 
+    MC_ALPHABETA_T  EMFAlphaBeta;    
+    /* Back EMF voltage in DQ */
+    MC_DQ_T         EMFdq;            
+    
+    /* Outputs common to all estimators */
+    MCAPP_ESTIMATOR_OUTPUT_T output;
+    
+    const MC_ALPHABETA_T *pIAlphaBeta;
+    const MC_ALPHABETA_T *pVAlphaBeta;
+    const MCAPP_MOTOR_T *pMotor;
+    
+} MCAPP_ESTIMATOR_EEMF_T;        
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_EstimatorEEMFInit (void *);
+void MCAPP_EstimatorEEMF (void *);
+void MCAPP_EstimatorEEMFReset (void *, int16_t, int16_t);
+bool MCAPP_EstimatorEEMFIsLocked (const void *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* end of __ESTIM_EEMF_H */
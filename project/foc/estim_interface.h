@@ -55,17 +55,57 @@ extern "C" {
 // <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // </editor-fold>
 
 // <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
 
+/**
+ * Estimators which can be selected for the control scheme
+ */
+typedef enum
+{
+    MCAPP_ESTIMATOR_PLL = 0,            /* PLL estimator - estim_pll.c */
+    MCAPP_ESTIMATOR_EEMF = 1,           /* Extended EMF observer - estim_eemf.c */
+    MCAPP_ESTIMATOR_COUNT = 2,          /* Number of estimators */
+
+}MCAPP_ESTIMATOR_ID_T;
+
+/**
+ * Outputs common to all estimators, updated by the estimator step
+ */
+typedef struct
+{
+    int16_t
+        qTheta,             /* Estimated angle */
+        qOmega,             /* Estimated speed, filtered */
+        qEsd,               /* Back EMF d axis, filtered */
+        qEsq;               /* Back EMF q axis, filtered */
+}MCAPP_ESTIMATOR_OUTPUT_T;
+
 typedef struct
 {
     int16_t
         qVelEstim,            /* Speed */
         qTheta,             /* Angle */
         qThetaOffset;       /* Angle Offset during transition */
+    
+    uint16_t
+        estimatorId;        /* Selected estimator - MCAPP_ESTIMATOR_ID_T */
+    
+    void *pEstim;           /* Data structure of selected estimator */
+    const MCAPP_ESTIMATOR_OUTPUT_T *pOutput;  /* Selected estimator outputs */
+    
+    /* Resets estimator states */
+    void (*MCAPP_EstimatorInit) (void *);
+    /* Executes estimator once every control cycle */
+    void (*MCAPP_EstimatorStep) (void *);
+    /* Sets estimator angle and speed, e.g. for flying start */
+    void (*MCAPP_EstimatorReset) (void *, int16_t, int16_t);
+    /* Returns true when the estimate can be used for closed loop control */
+    bool (*MCAPP_EstimatorIsLocked) (const void *);
+    
 }MCAPP_ESTIMATOR_T;
 
 // </editor-fold>
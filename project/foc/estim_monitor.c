@@ -0,0 +1,207 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_monitor.c
+ *
+ * @brief This module implements the estimator lock monitor.
+ * Estimated back EMF is compared with the back EMF expected at the reference
+ * speed, and the d axis back EMF and speed error residuals are checked. Loss of
+ * lock is flagged when the residuals fail for a few electrical cycles.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <libq.h>
+#include "estim_monitor.h"
+#include "general.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_EstimatorMonitorInit(MCAPP_ESTIMATOR_MONITOR_T *)  </B>
+*
+* @brief Function to reset Estimator Lock Monitor variables.
+*
+* @param    pointer to the data structure containing monitor parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorMonitorInit(&monitor); </CODE>
+*
+*/
+void MCAPP_EstimatorMonitorInit(MCAPP_ESTIMATOR_MONITOR_T *pMonitor)
+{
+    pMonitor->qOmegaBEMF = 0;
+    pMonitor->angleAcc = 0;
+    pMonitor->timeCount = 0;
+    pMonitor->violation = 0;
+    pMonitor->lossOfLock = 0;
+    pMonitor->stall = 0;
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorMonitor(MCAPP_ESTIMATOR_MONITOR_T *)  </B>
+*
+* @brief Function to check the estimator outputs for physical consistency.
+* It executes in fixed time (no loops or divisions) every control cycle in
+* closed loop. The residual checks are:
+*   - BEMF magnitude converted to speed (|Es| / Ke) against reference speed
+*   - |Esd| against |Esq|, i.e. angle error of the estimator 
+*   - error between reference speed and estimated speed
+* While any residual fails, the electrical angle travelled at reference speed
+* is accumulated; loss of lock is flagged when it exceeds the configured 
+* number of electrical cycles or when the time limit is reached at very low
+* speed. Loss of lock with low BEMF speed is reported as stall.
+* Below qVelRefMin the residuals are not meaningful (e.g. position hold at
+* zero reference), the monitor is blanked and its accumulators are reset.
+*
+* @param    pointer to the data structure containing monitor parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorMonitor(&monitor); </CODE>
+*
+*/
+void MCAPP_EstimatorMonitor(MCAPP_ESTIMATOR_MONITOR_T *pMonitor)
+{
+    const MCAPP_ESTIMATOR_OUTPUT_T *pOutput = pMonitor->pOutput;
+    
+    const int16_t velRef = _Q15abs(pMonitor->pCtrlParam->qVelRef);
+    const int16_t esdAbs = _Q15abs(pOutput->qEsd);
+    const int16_t esqAbs = _Q15abs(pOutput->qEsq);
+    
+    int16_t esMag, esMin, speedError, velLimit;
+    uint16_t deltaAngle;
+    
+    /* BEMF magnitude approximation: |Es| = max + 3/8*min, error < 7% */
+    if(esdAbs > esqAbs)
+    {
+        esMag = esdAbs;
+        esMin = esqAbs;
+    }
+    else
+    {
+        esMag = esqAbs;
+        esMin = esdAbs;
+    }
+    esMag = esMag + (esMin >> 2) + (esMin >> 3);
+    
+    /* Convert BEMF magnitude to speed using 1/Ke */
+    pMonitor->qOmegaBEMF = UTIL_SatShrS16(__builtin_mulss(pMonitor->qInvKfiConst,
+                                        esMag), pMonitor->qInvKfiConstScale);
+    
+    pMonitor->violation = 0;
+    
+    if(velRef < pMonitor->qVelRefMin)
+    {
+        pMonitor->angleAcc = 0;
+        pMonitor->timeCount = 0;
+        return;
+    }
+    
+    speedError = _Q15abs(pMonitor->pCtrlParam->qVelRef - pOutput->qOmega);
+    
+    /* BEMF consistent with reference speed */
+    velLimit = (int16_t)(__builtin_mulss(velRef, pMonitor->qBEMFRatioMin) >> 15);
+    if(pMonitor->qOmegaBEMF < velLimit)
+    {
+        pMonitor->violation = 1;
+    }
+    velLimit = UTIL_SatShrS16(((int32_t)velRef << 15) + 
+                    __builtin_mulss(velRef, pMonitor->qBEMFRatioExcess), 15);
+    if(pMonitor->qOmegaBEMF > velLimit)
+    {
+        pMonitor->violation = 1;
+    }
+    
+    /* Estimator angle error within limit */
+    if(esdAbs > (int16_t)(__builtin_mulss(esqAbs, pMonitor->qEsdRatioMax) >> 15))
+    {
+        pMonitor->violation = 1;
+    }
+    
+    /* Estimated speed follows the reference */
+    if(speedError > pMonitor->qSpeedErrorMax)
+    {
+        pMonitor->violation = 1;
+    }
+    
+    /* Electrical angle travelled in this cycle at reference speed */
+    deltaAngle = (uint16_t)(__builtin_mulss(velRef, pMonitor->qDeltaT) >> 15);
+    
+    if(pMonitor->violation == 1)
+    {
+        pMonitor->angleAcc += deltaAngle;
+        if(pMonitor->timeCount < pMonitor->timeCountLimit)
+        {
+            pMonitor->timeCount++;
+        }
+    }
+    else
+    {
+        if(pMonitor->angleAcc > deltaAngle)
+        {
+            pMonitor->angleAcc -= deltaAngle;
+        }
+        else
+        {
+            pMonitor->angleAcc = 0;
+        }
+        if(pMonitor->timeCount > 0)
+        {
+            pMonitor->timeCount--;
+        }
+    }
+    
+    if((pMonitor->angleAcc >= pMonitor->angleAccLimit) || 
+        (pMonitor->timeCount >= pMonitor->timeCountLimit))
+    {
+        if(pMonitor->qOmegaBEMF < pMonitor->qStallSpeed)
+        {
+            pMonitor->stall = 1;
+        }
+        else
+        {
+            pMonitor->lossOfLock = 1;
+        }
+    }
+}
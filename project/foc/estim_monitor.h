@@ -0,0 +1,124 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file estim_monitor.h
+ *
+ * @brief This module implements the estimator lock monitor, which checks the
+ * estimated back EMF for consistency with the commanded speed.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __ESTIM_MONITOR_H
+#define __ESTIM_MONITOR_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "foc_control_types.h"
+#include "estim_interface.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to estimator lock monitor. */
+        
+typedef struct
+{
+    /* Back EMF magnitude converted to speed */
+    int16_t qOmegaBEMF;
+    /* Minimum ratio of BEMF speed to reference speed */
+    int16_t qBEMFRatioMin;
+    /* Maximum excess ratio of BEMF speed over reference speed */
+    int16_t qBEMFRatioExcess;
+    /* Maximum ratio of |Esd| to |Esq| */
+    int16_t qEsdRatioMax;
+    /* Maximum error between reference and estimated speed */
+    int16_t qSpeedErrorMax;
+    /* Speed below which loss of lock is reported as stall */
+    int16_t qStallSpeed;
+    /* Reference speed below which the monitor is blanked */
+    int16_t qVelRefMin;
+    /* Electrical angle travelled while estimate is inconsistent */
+    uint32_t angleAcc;
+    /* Electrical angle limit for loss of lock */
+    uint32_t angleAccLimit;
+    /* Time spent while estimate is inconsistent */
+    uint16_t timeCount;
+    /* Time limit for loss of lock */
+    uint16_t timeCountLimit;
+    /* Set when residual checks fail in present cycle */
+    int16_t violation;
+    /* Loss of lock flag */
+    int16_t lossOfLock;
+    /* Stall flag */
+    int16_t stall;
+    /* Inverse of BEMF constant and its scale, to convert BEMF to speed */
+    int16_t qInvKfiConst;
+    int16_t qInvKfiConstScale;
+    /* Integration constant, to convert speed to angle */
+    int16_t qDeltaT;
+    
+    const MCAPP_ESTIMATOR_OUTPUT_T *pOutput;
+    const MCAPP_CONTROL_T *pCtrlParam;
+    
+} MCAPP_ESTIMATOR_MONITOR_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_EstimatorMonitorInit (MCAPP_ESTIMATOR_MONITOR_T *);
+void MCAPP_EstimatorMonitor (MCAPP_ESTIMATOR_MONITOR_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* end of __ESTIM_MONITOR_H */
@@ -53,6 +53,7 @@
 /* _Q15abs and _Q15sqrt function use */
 #include <libq.h>
 #include "estim_pll.h"
+#include "general.h"
 
 // </editor-fold>
 
@@ -61,7 +62,7 @@
 // </editor-fold>
 
 /**
-* <B> Function: void MCAPP_EstimatorPLLInit(MCAPP_PLL_ESTIMATOR_T *)  </B>
+* <B> Function: void MCAPP_EstimatorPLLInit(void *)  </B>
 *
 * @brief Function to reset PLL Estimator Data Structure variables.
 *
@@ -71,8 +72,10 @@
 * <CODE> MMCAPP_EstimatorPLLInit(&estimator); </CODE>
 *
 */
-void MCAPP_EstimatorPLLInit(MCAPP_ESTIMATOR_PLL_T *pEstim)
+void MCAPP_EstimatorPLLInit(void *pData)
 {
+    MCAPP_ESTIMATOR_PLL_T *pEstim = (MCAPP_ESTIMATOR_PLL_T *)pData;
+    
     pEstim->qDiCounter = 0;
     pEstim->qEsdStateVar = 0;
     pEstim->qEsqStateVar = 0;
@@ -82,10 +85,88 @@ void MCAPP_EstimatorPLLInit(MCAPP_ESTIMATOR_PLL_T *pEstim)
     
     pEstim->qOmegaFilt = 0;
     pEstim->qOmegaStateVar = 0;
+    
+    pEstim->qEsdf = 0;
+    pEstim->qEsqf = 0;
+    
+    pEstim->output.qTheta = 0;
+    pEstim->output.qOmega = 0;
+    pEstim->output.qEsd = 0;
+    pEstim->output.qEsq = 0;
 }
 
 /**
-* <B> Function: void MCAPP_EstimatorPLL(MCAPP_PLL_ESTIMATOR_T *)  </B>
+* <B> Function: void MCAPP_EstimatorPLLReset(void *, int16_t, int16_t)  </B>
+*
+* @brief Function to set PLL Estimator angle and speed. Back EMF filter 
+* states are set to the back EMF expected at the given speed.
+*
+* @param    pointer to the data structure containing PLL Estimator parameters.
+* @param    angle.
+* @param    speed.
+* @return   none.
+* @example
+* <CODE> MCAPP_EstimatorPLLReset(&estimator, qTheta, qOmega); </CODE>
+*
+*/
+void MCAPP_EstimatorPLLReset(void *pData, int16_t qTheta, int16_t qOmega)
+{
+    MCAPP_ESTIMATOR_PLL_T *pEstim = (MCAPP_ESTIMATOR_PLL_T *)pData;
+    int32_t esq, esqLimit;
+    
+    pEstim->qTheta = qTheta;
+    pEstim->qThetaStateVar = (int32_t)qTheta << 15;
+    
+    pEstim->qOmega = qOmega;
+    pEstim->qOmegaFilt = qOmega;
+    pEstim->qOmegaStateVar = (int32_t)qOmega << 15;
+    
+    /* Es = Omega / InvKfi, dividend is limited to keep the quotient of the 
+     * 32/16 bit division in 16 bits, Es saturates at high speed */
+    esq = (int32_t)qOmega << pEstim->qInvKfiConstScale;
+    esqLimit = __builtin_mulss(pEstim->qInvKfiConst, INT16_MAX);
+    if (esq > esqLimit)
+    {
+        esq = esqLimit;
+    }
+    else if (esq < -esqLimit)
+    {
+        esq = -esqLimit;
+    }
+    pEstim->qEsqf = __builtin_divsd(esq, pEstim->qInvKfiConst);
+    pEstim->qEsqStateVar = (int32_t)pEstim->qEsqf << 15;
+    pEstim->qEsdf = 0;
+    pEstim->qEsdStateVar = 0;
+    
+    pEstim->output.qTheta = pEstim->qTheta;
+    pEstim->output.qOmega = pEstim->qOmegaFilt;
+    pEstim->output.qEsd = pEstim->qEsdf;
+    pEstim->output.qEsq = pEstim->qEsqf;
+}
+
+/**
+* <B> Function: bool MCAPP_EstimatorPLLIsLocked(const void *)  </B>
+*
+* @brief Function to check if PLL Estimator output can be used for closed
+* loop control: speed is above the BEMF threshold speed and estimated angle
+* error(|Esd| < |Esq|) is less than 45 degrees.
+*
+* @param    pointer to the data structure containing PLL Estimator parameters.
+* @return   true if estimate can be used.
+* @example
+* <CODE> locked = MCAPP_EstimatorPLLIsLocked(&estimator); </CODE>
+*
+*/
+bool MCAPP_EstimatorPLLIsLocked(const void *pData)
+{
+    const MCAPP_ESTIMATOR_PLL_T *pEstim = (const MCAPP_ESTIMATOR_PLL_T *)pData;
+    
+    return ((_Q15abs(pEstim->qOmegaFilt) > pEstim->qThresholdSpeedBEMF) &&
+            (_Q15abs(pEstim->qEsdf) < _Q15abs(pEstim->qEsqf)));
+}
+
+/**
+* <B> Function: void MCAPP_EstimatorPLL(void *)  </B>
 *
 * @brief Observer to determine rotor speed and position based on
 * motor parameters and feedbacks.
@@ -96,8 +177,9 @@ void MCAPP_EstimatorPLLInit(MCAPP_ESTIMATOR_PLL_T *pEstim)
 * <CODE> MCAPP_EstimatorPLL(&estimator); </CODE>
 *
 */
-void MCAPP_EstimatorPLL(MCAPP_ESTIMATOR_PLL_T *pEstim)
+void MCAPP_EstimatorPLL(void *pData)
 {
+    MCAPP_ESTIMATOR_PLL_T *pEstim = (MCAPP_ESTIMATOR_PLL_T *)pData;
     const MCAPP_MOTOR_T *pMotor = pEstim->pMotor;
     const MC_ALPHABETA_T *pIAlphaBeta = pEstim->pIAlphaBeta;
  
@@ -262,4 +344,9 @@ void MCAPP_EstimatorPLL(MCAPP_ESTIMATOR_PLL_T *pEstim)
     const int16_t Omegadiff = (int16_t) (pEstim->qOmega - pEstim->qOmegaFilt);
     pEstim->qOmegaStateVar += __builtin_mulss(Omegadiff, pEstim->qOmegaFiltConst);
     pEstim->qOmegaFilt = (int16_t) (pEstim->qOmegaStateVar >> 15);  
+    
+    pEstim->output.qTheta = pEstim->qTheta;
+    pEstim->output.qOmega = pEstim->qOmegaFilt;
+    pEstim->output.qEsd = pEstim->qEsdf;
+    pEstim->output.qEsq = pEstim->qEsqf;
 }
@@ -60,6 +60,7 @@
 #include "measure.h"
 #include "foc_control_types.h"
 #include "motor_params.h"
+#include "estim_interface.h"
 
 // </editor-fold>
 
@@ -132,6 +133,9 @@ typedef struct
     /* Back EMF voltage in DQ */
     MC_DQ_T         BEMFdq;            
     
+    /* Outputs common to all estimators */
+    MCAPP_ESTIMATOR_OUTPUT_T output;
+    
     const MC_DQ_T    *pIdq;  
     const MCAPP_CONTROL_T *pCtrlParam;
     const MC_ALPHABETA_T *pIAlphaBeta;
@@ -146,8 +150,10 @@ typedef struct
 
 // <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
 
-void MCAPP_EstimatorPLLInit (MCAPP_ESTIMATOR_PLL_T *);
-void MCAPP_EstimatorPLL (MCAPP_ESTIMATOR_PLL_T *);
+void MCAPP_EstimatorPLLInit (void *);
+void MCAPP_EstimatorPLL (void *);
+void MCAPP_EstimatorPLLReset (void *, int16_t, int16_t);
+bool MCAPP_EstimatorPLLIsLocked (const void *);
 
 // </editor-fold>
 
@@ -0,0 +1,284 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file flying_start.c
+ *
+ * @brief This module implements catching of a spinning rotor with zero current
+ * control, so that the motor can start without stopping it first.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15abs function use */
+#include <libq.h>
+#include "flying_start.h"
+#include "general.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Definitions ">
+
+/* Back EMF rotation is checked over this many control cycles to find the
+ * direction, less than half a turn at maximum speed */
+#define FLYING_START_DIRECTION_COUNT    8
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_FlyingStartInit(MCAPP_FLYING_START_T *)  </B>
+*
+* @brief Function to reset flying start Data Structure variables.
+*
+* @param    pointer to the data structure containing flying start parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_FlyingStartInit(&flyingStart); </CODE>
+*
+*/
+void MCAPP_FlyingStartInit(MCAPP_FLYING_START_T *pFS)
+{
+    pFS->qErrorPLL = 0;
+    pFS->qOmegaIntStateVar = 0;
+    pFS->qThetaStateVar = 0;
+    pFS->qTheta = 0;
+    pFS->qOmega = 0;
+    pFS->qOmegaFilt = 0;
+    pFS->qOmegaStateVar = 0;
+    pFS->qEmag = 0;
+    pFS->qEsdStateVar = 0;
+    pFS->qEsqStateVar = 0;
+    pFS->EMFdqFilt.d = 0;
+    pFS->EMFdqFilt.q = 0;
+    
+    pFS->EMFAlphaBetaLast.alpha = 0;
+    pFS->EMFAlphaBetaLast.beta = 0;
+    pFS->iAlphaBetaLast = *pFS->pIAlphaBeta;
+    pFS->vAlphaBetaLast.alpha = 0;
+    pFS->vAlphaBetaLast.beta = 0;
+    
+    pFS->count = 0;
+    pFS->lockCount = 0;
+    pFS->speedInitCount = 0;
+}
+
+/**
+* <B> Function: void MCAPP_FlyingStartStep(MCAPP_FLYING_START_T *)  </B>
+*
+* @brief Function executing flying start PLL, called once every control 
+* cycle between the feedback and forward paths, current references are
+* zero. Back EMF is calculated as V - Rs*I - Ls*dI/dt; the current change
+* since the last cycle is caused by the voltage calculated two cycles ago,
+* as duty cycle is updated at the start of the next PWM cycle.
+* PLL phase error -sgn(Eq)*Ed/|E| rotates the frame until back EMF is on the
+* Q axis; the frame is then aligned with the rotor or 180 degrees off, which
+* is resolved by MCAPP_FlyingStartRotorAngle(). PLL speed is initialized from
+* back EMF magnitude and rotation direction, and the frame is turned to within
+* 45 degrees of lock, so that pull-in is fast at any speed.
+*
+* @param    pointer to the data structure containing flying start parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_FlyingStartStep(&flyingStart); </CODE>
+*
+*/
+void MCAPP_FlyingStartStep(MCAPP_FLYING_START_T *pFS)
+{
+    const MCAPP_MOTOR_T *pMotor = pFS->pMotor;
+    const MC_ALPHABETA_T *pIAlphaBeta = pFS->pIAlphaBeta;
+    MC_SINCOS_T fsSinCos;
+    int16_t emag, error;
+    int32_t cross;
+    
+    /* Ealphabeta = Valphabeta - Rs*Ialphabeta - Ls*(dIalphabeta/dt) */
+    pFS->EMFAlphaBeta.alpha = UTIL_SatShrS16((int32_t)pFS->vAlphaBetaLast.alpha
+        - (__builtin_mulss(pMotor->qRs, pIAlphaBeta->alpha) >> pMotor->qRsScale)
+        - (__builtin_mulss(pMotor->qLsDt, 
+                    pIAlphaBeta->alpha - pFS->iAlphaBetaLast.alpha) 
+                                                    >> pMotor->qLsDtScale), 0);
+    pFS->EMFAlphaBeta.beta = UTIL_SatShrS16((int32_t)pFS->vAlphaBetaLast.beta
+        - (__builtin_mulss(pMotor->qRs, pIAlphaBeta->beta) >> pMotor->qRsScale)
+        - (__builtin_mulss(pMotor->qLsDt, 
+                    pIAlphaBeta->beta - pFS->iAlphaBetaLast.beta) 
+                                                    >> pMotor->qLsDtScale), 0);
+    pFS->iAlphaBetaLast = *pIAlphaBeta;
+    pFS->vAlphaBetaLast = *pFS->pVAlphaBeta;
+    
+    /* Back EMF in control frame, back EMF calculated from the last current
+     * change is half a control cycle old */
+    MC_CalculateSineCosine_Assembly_Ram(pFS->qTheta - 
+        (int16_t)(__builtin_mulss(pFS->qOmega, pFS->qDeltaT) >> 16), &fsSinCos);
+    MC_TransformPark_Assembly(&pFS->EMFAlphaBeta, &fsSinCos, &pFS->EMFdq);
+    
+    /* Filter the current derivative noise once PLL speed is initialized, 
+     * back EMF is then nearly constant in the control frame */
+    if (pFS->speedInitCount > FLYING_START_DIRECTION_COUNT)
+    {
+        pFS->qEsdStateVar += __builtin_mulss((int16_t)(pFS->EMFdq.d - 
+                                    pFS->EMFdqFilt.d), pFS->qKfilterEsdq);
+        pFS->qEsqStateVar += __builtin_mulss((int16_t)(pFS->EMFdq.q - 
+                                    pFS->EMFdqFilt.q), pFS->qKfilterEsdq);
+    }
+    else
+    {
+        pFS->qEsdStateVar = (int32_t)pFS->EMFdq.d << 15;
+        pFS->qEsqStateVar = (int32_t)pFS->EMFdq.q << 15;
+    }
+    pFS->EMFdqFilt.d = (int16_t)(pFS->qEsdStateVar >> 15);
+    pFS->EMFdqFilt.q = (int16_t)(pFS->qEsqStateVar >> 15);
+    
+    if (pFS->speedInitCount <= FLYING_START_DIRECTION_COUNT)
+    {
+        /* Speed = |E|*InvKfi, direction from rotation of back EMF vector 
+         * over FLYING_START_DIRECTION_COUNT cycles, unfiltered back EMF is
+         * used as the frame is not synchronous yet */
+        emag = UTIL_MagnitudeApprox(pFS->EMFdq.d, pFS->EMFdq.q);
+        if (emag <= pFS->qEmagMin)
+        {
+            pFS->speedInitCount = 0;
+        }
+        else if (pFS->speedInitCount == 0)
+        {
+            pFS->EMFAlphaBetaLast = pFS->EMFAlphaBeta;
+            pFS->speedInitCount++;
+        }
+        else if (pFS->speedInitCount < FLYING_START_DIRECTION_COUNT)
+        {
+            pFS->speedInitCount++;
+        }
+        else
+        {
+            cross = __builtin_mulss(pFS->EMFAlphaBetaLast.alpha, 
+                                                    pFS->EMFAlphaBeta.beta) -
+                    __builtin_mulss(pFS->EMFAlphaBetaLast.beta, 
+                                                    pFS->EMFAlphaBeta.alpha);
+            pFS->qOmega = UTIL_SatShrS16(__builtin_mulss(emag, 
+                            pFS->qInvKfiConst), pFS->qInvKfiConstScale);
+            if (cross < 0)
+            {
+                pFS->qOmega = -pFS->qOmega;
+            }
+            pFS->qOmegaIntStateVar = (int32_t)pFS->qOmega << 15;
+            pFS->qOmegaFilt = pFS->qOmega;
+            pFS->qOmegaStateVar = pFS->qOmegaIntStateVar;
+            pFS->speedInitCount++;
+            
+            /* Frame was not turning with the rotor until now, turn it by 90
+             * degrees if back EMF is nearer to the D axis so that PLL starts
+             * within 45 degrees of lock */
+            if (_Q15abs(pFS->EMFdq.d) > _Q15abs(pFS->EMFdq.q))
+            {
+                pFS->qTheta += 0x4000;
+                pFS->qThetaStateVar = (int32_t)pFS->qTheta << 15;
+                pFS->EMFdqFilt.d = pFS->EMFdq.q;
+                pFS->EMFdqFilt.q = UTIL_SatShrS16(-(int32_t)pFS->EMFdq.d, 0);
+                pFS->EMFdq = pFS->EMFdqFilt;
+                pFS->qEsdStateVar = (int32_t)pFS->EMFdqFilt.d << 15;
+                pFS->qEsqStateVar = (int32_t)pFS->EMFdqFilt.q << 15;
+            }
+        }
+    }
+    
+    /* PLL phase error = -sgn(Eq)*Ed/|E| = sin(angle error) */
+    pFS->qEmag = UTIL_MagnitudeApprox(pFS->EMFdqFilt.d, pFS->EMFdqFilt.q);
+    error = UTIL_PLLPhaseError(pFS->EMFdqFilt.d, pFS->EMFdqFilt.q, 
+                                pFS->qEmag, pFS->qEmagMin);
+    pFS->qErrorPLL = error;
+    
+    if ((pFS->qEmag > pFS->qEmagMin) && (_Q15abs(error) < pFS->qLockError))
+    {
+        if (pFS->lockCount < pFS->lockCountLimit)
+        {
+            pFS->lockCount++;
+        }
+    }
+    else
+    {
+        pFS->lockCount = 0;
+    }
+    
+    /* PLL PI controller, output is frame speed */
+    pFS->qOmega = UTIL_PIClamped(&pFS->qOmegaIntStateVar, pFS->qKpPLL, 
+                                    pFS->qKiPLL, error);
+    
+    /* Integrate the speed to get the frame angle */  
+    pFS->qThetaStateVar += __builtin_mulss(pFS->qOmega, pFS->qDeltaT);
+    pFS->qTheta = (int16_t) (pFS->qThetaStateVar >> 15);
+    
+    /* Filter the speed using a first order low-pass filter */
+    const int16_t omegaDiff = (int16_t) (pFS->qOmega - pFS->qOmegaFilt);
+    pFS->qOmegaStateVar += __builtin_mulss(omegaDiff, pFS->qOmegaFiltConst);
+    pFS->qOmegaFilt = (int16_t) (pFS->qOmegaStateVar >> 15);
+    
+    if (pFS->count < UINT16_MAX)
+    {
+        pFS->count++;
+    }
+}
+
+/**
+* <B> Function: int16_t MCAPP_FlyingStartRotorAngle(const MCAPP_FLYING_START_T *)
+* </B>
+*
+* @brief Function to get the rotor angle once PLL is locked. Back EMF on Q
+* axis has the sign of the speed when the frame is aligned with the rotor,
+* otherwise the frame is 180 degrees off.
+*
+* @param    pointer to the data structure containing flying start parameters.
+* @return   rotor angle.
+* @example
+* <CODE> qTheta = MCAPP_FlyingStartRotorAngle(&flyingStart); </CODE>
+*
+*/
+int16_t MCAPP_FlyingStartRotorAngle(const MCAPP_FLYING_START_T *pFS)
+{
+    if ((pFS->EMFdqFilt.q > 0) == (pFS->qOmegaFilt > 0))
+    {
+        return pFS->qTheta;
+    }
+    else
+    {
+        return (int16_t)(pFS->qTheta + 0x8000);
+    }
+}
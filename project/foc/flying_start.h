@@ -0,0 +1,165 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file flying_start.h
+ *
+ * @brief This module implements catching of a spinning rotor with zero current
+ * control, so that the motor can start without stopping it first.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef __FLYING_START_H
+#define __FLYING_START_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+#include "motor_params.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to flying start. Current
+    references are held at zero while back EMF is calculated from phase 
+    voltages and currents. A quadrature PLL rotates the control frame until
+    back EMF is on the Q axis, so the current controllers hold zero current
+    with the back EMF as their output. */
+        
+typedef struct
+{
+    /* PLL proportional and integral gains */
+    int16_t qKpPLL,
+            qKiPLL;
+    /* PLL phase error, sin of angle error */
+    int16_t qErrorPLL;
+    /* State variable for PLL integral term */
+    int32_t qOmegaIntStateVar;
+    /* Integration constant */
+    int16_t qDeltaT;
+    
+    /* angle of control frame, Q axis along back EMF */
+    int16_t qTheta;
+    /* internal variable for angle */
+    int32_t qThetaStateVar;
+    /* Estimated speed - PLL output and filtered */
+    int16_t qOmega,
+            qOmegaFilt;
+    /* Filter constant for Estimated speed */
+    int16_t qOmegaFiltConst;
+    /* State Variable for Estimated speed */
+    int32_t qOmegaStateVar;
+    /* Inverse of back EMF constant, used for initial PLL speed */
+    int16_t qInvKfiConst,
+            qInvKfiConstScale;
+    
+    /* Filter constant and state variables for D-Q back EMF */
+    int16_t qKfilterEsdq;
+    int32_t qEsdStateVar,
+            qEsqStateVar;
+    /* Back EMF magnitude and minimum magnitude for the PLL phase detector */
+    int16_t qEmag,
+            qEmagMin;
+    /* Maximum PLL phase error to count as locked */
+    int16_t qLockError;
+    
+    uint16_t
+        count,              /* Time since start of catching */
+        lockCount,          /* Time PLL has been locked */
+        lockCountLimit,     /* Lock time needed to catch the rotor */
+        speedInitCount;     /* Progress of PLL speed initialization */
+    
+    MC_ALPHABETA_T
+        EMFAlphaBeta,       /* Back EMF in alpha-beta */
+        EMFAlphaBetaLast,   /* Back EMF of previous control cycle */
+        iAlphaBetaLast,     /* Current of previous control cycle */
+        vAlphaBetaLast;     /* Voltage of previous control cycle */
+    
+    MC_DQ_T
+        EMFdq,              /* Back EMF in control frame */
+        EMFdqFilt;          /* Filtered back EMF in control frame */
+    
+    const MC_ALPHABETA_T *pIAlphaBeta;
+    const MC_ALPHABETA_T *pVAlphaBeta;
+    const MCAPP_MOTOR_T *pMotor;
+    
+} MCAPP_FLYING_START_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_FlyingStartInit (MCAPP_FLYING_START_T *);
+void MCAPP_FlyingStartStep (MCAPP_FLYING_START_T *);
+int16_t MCAPP_FlyingStartRotorAngle (const MCAPP_FLYING_START_T *);
+
+/**
+* <B> Function: bool MCAPP_FlyingStartIsLocked(const MCAPP_FLYING_START_T *)
+* </B>
+*
+* @brief Function to check if angle and speed of the spinning rotor are known.
+*
+* @param    pointer to the data structure containing flying start parameters.
+* @return   true if PLL has been locked on back EMF for lockCountLimit.
+* @example
+* <CODE> locked = MCAPP_FlyingStartIsLocked(&flyingStart); </CODE>
+*
+*/
+inline static bool MCAPP_FlyingStartIsLocked(const MCAPP_FLYING_START_T *pFS)
+{
+    return (pFS->lockCount >= pFS->lockCountLimit);
+}
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __FLYING_START_H */
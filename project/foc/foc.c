@@ -56,6 +56,7 @@
 
 #include "id_ref.h"
 #include "estim_pll.h"
+#include "pi_tune.h"
 #include "port_config.h" 
 #include "mc1_calc_params.h"
 // </editor-fold>
@@ -68,9 +69,17 @@
 
 static void MCAPP_FOCFeedbackPath(MCAPP_FOC_T *);
 static void MCAPP_FOCForwardPath(MCAPP_FOC_T *);
-static void MCAPP_SpeedReferenceRamp(MCAPP_CONTROL_T *);
+static void MCAPP_FOCModulation(MCAPP_FOC_T *);
+static void MCAPP_FOCDecoupling(MCAPP_FOC_T *);
+static void MCAPP_FOCMotorIdApply(MCAPP_FOC_T *);
+static void MCAPP_SpeedReferenceRamp(MCAPP_FOC_T *);
+static void MCAPP_FOCIqFeedForward(MCAPP_FOC_T *);
+static void MCAPP_FOCIqReference(MCAPP_FOC_T *);
 static void MCAPP_CalculateModulationSiganl(MC_ABC_T *, MC_ABC_T *);
 static void MCAPP_DCLinkVoltageCompensation(MC_ABC_T *, MC_ABC_T *, int16_t* );
+static void MCAPP_IfCurrentControl(MCAPP_FOC_T *);
+static int16_t MCAPP_HandoverStep(int16_t, uint16_t);
+static int16_t MCAPP_HandoverRamp(int16_t, int16_t);
 
 // </editor-fold>
 
@@ -99,7 +108,20 @@ void MCAPP_FOCInit(MCAPP_FOC_T *pFOC)
     MCAPP_ControllerPIInit(&pFOC->piSpeed);
     
     MCAPP_FluxWeakeningControlInit(&pFOC->fluxControl);
-    MCAPP_EstimatorPLLInit(&pFOC->estimPLL); 
+    pFOC->estimInterface.MCAPP_EstimatorInit(pFOC->estimInterface.pEstim); 
+    MCAPP_EstimatorMonitorInit(&pFOC->estimMonitor);
+    MCAPP_EstimatorAdaptInit(&pFOC->estimAdapt);
+    MCAPP_HFIInit(&pFOC->hfi);
+    MCAPP_FlyingStartInit(&pFOC->flyingStart);
+    MCAPP_DecouplingInit(&pFOC->decoupling);
+    MCAPP_DeadTimeInit(&pFOC->deadTime);
+    MCAPP_DPWMInit(&pFOC->dpwm);
+    MCAPP_OvermodulationInit(&pFOC->overmod);
+    MCAPP_SpeedProfileInit(&pFOC->speedProfile);
+    MCAPP_PositionInit(&pFOC->position);
+    MCAPP_TorqueControlInit(&pFOC->torqueControl);
+    MCAPP_DisturbanceObserverInit(&pFOC->disturbance);
+    pFOC->decoupling.active = 0;
     
     pCtrlParam->lockTime = 0;
     pCtrlParam->speedRampSkipCnt = 0;
@@ -108,6 +130,13 @@ void MCAPP_FOCInit(MCAPP_FOC_T *pFOC)
     pCtrlParam->OLThetaSum = 0;
     pCtrlParam->qIdRef = 0;
     pCtrlParam->qIqRef = 0;
+    /* I-f regulation may have lowered open loop current in last run */
+    pCtrlParam->OLCurrent = pCtrlParam->OLCurrentStart;
+    pCtrlParam->OLCurrentRampSkipCnt = 0;
+    pCtrlParam->qThetaOffsetStep = 0;
+    pCtrlParam->qIdRefOffset = 0;
+    pCtrlParam->qIdRefOffsetStep = 0;
+    pCtrlParam->OLStallTime = 0;
     
     pFOC->faultStatus = 0;
     
@@ -131,6 +160,10 @@ void MCAPP_FOCInit(MCAPP_FOC_T *pFOC)
 void MCAPP_FOCStateMachine(MCAPP_FOC_T *pFOC)
 {
     MCAPP_CONTROL_T *pCtrlParam = &pFOC->ctrlParam;
+    MCAPP_ESTIMATOR_T *pEstimInterface = &pFOC->estimInterface;
+    MC_DQ_T vdqFeedForward;
+    MC_SINCOS_T sincosOffset;
+    int16_t qIqRotor;
 
     switch (pFOC->focState)
     {
@@ -169,7 +202,14 @@ void MCAPP_FOCStateMachine(MCAPP_FOC_T *pFOC)
         case FOC_OPEN_LOOP:
             MCAPP_FOCFeedbackPath(pFOC); 
             
-            if(pCtrlParam->OLCurrent < pCtrlParam->OLCurrentMax)
+            if((pCtrlParam->openLoop == 0) && 
+                pEstimInterface->MCAPP_EstimatorIsLocked(
+                                                    pEstimInterface->pEstim))
+            {
+                /* I-f: reduce current to what the load needs */
+                MCAPP_IfCurrentControl(pFOC);
+            }
+            else if(pCtrlParam->OLCurrent < pCtrlParam->OLCurrentMax)
             {
                 pCtrlParam->OLCurrent += pCtrlParam->OLCurrentRampRate;
             }
@@ -188,16 +228,50 @@ void MCAPP_FOCStateMachine(MCAPP_FOC_T *pFOC)
                 }
             }
             else if((pCtrlParam->openLoop == 0)&&
-                    (pFOC->estimPLL.qOmegaFilt > pFOC->pMotor->qMaxOLSpeed))
+                    (pEstimInterface->pOutput->qOmega > pFOC->pMotor->qMaxOLSpeed)
+                    && pEstimInterface->MCAPP_EstimatorIsLocked(
+                                                    pEstimInterface->pEstim))
             {
                 pFOC->estimInterface.qThetaOffset = pCtrlParam->OLTheta -
-                                                        pFOC->estimPLL.qTheta;
-                /* Reset speed PI controller */
-                MCAPP_ControllerPIReset(&pFOC->piSpeed, pFOC->idq.q);                 
+                                            pEstimInterface->pOutput->qTheta;
+                /* Blend angle and d axis current to closed loop values over 
+                 * the handover time */
+                pCtrlParam->qThetaOffsetStep = MCAPP_HandoverStep(
+                                        pFOC->estimInterface.qThetaOffset,
+                                        pCtrlParam->handoverTimeLimit);
+                pCtrlParam->qIdRefOffset = pCtrlParam->qIdRef;
+                pCtrlParam->qIdRefOffsetStep = MCAPP_HandoverStep(
+                                        pCtrlParam->qIdRefOffset,
+                                        pCtrlParam->handoverTimeLimit);
+                /* Reset speed PI controller to the torque producing part
+                 * of the open loop current, the q axis current in the 
+                 * estimated rotor frame. The open loop q current is larger
+                 * by the load angle and accelerates the rotor as the angle
+                 * blends to closed loop */
+                MC_CalculateSineCosine_Assembly_Ram(
+                    pFOC->estimInterface.qThetaOffset, &sincosOffset);
+                qIqRotor = (int16_t)((__builtin_mulss(pFOC->idq.q, 
+                                                        sincosOffset.cos) +
+                                      __builtin_mulss(pFOC->idq.d, 
+                                                        sincosOffset.sin)) >> 15);
+                MCAPP_ControllerPIReset(&pFOC->piSpeed, qIqRotor);                 
                 pCtrlParam->speedRampSkipCnt = 0;          
                 pFOC->focState = FOC_CLOSE_LOOP;
             }
-            MCAPP_EstimatorPLL(&pFOC->estimPLL);
+            else if(pCtrlParam->openLoop == 0)
+            {
+                /* Rotor does not follow the forced angle, report stall to 
+                 * the fault manager instead of forcing current forever */
+                if(pCtrlParam->OLStallTime < pCtrlParam->OLStallTimeLimit)
+                {
+                    pCtrlParam->OLStallTime++;
+                }
+                else
+                {
+                    pFOC->estimMonitor.stall = 1;
+                }
+            }
+            pEstimInterface->MCAPP_EstimatorStep(pEstimInterface->pEstim);
             /* Calculate open loop theta */
             pCtrlParam->OLThetaSum += __builtin_mulss(pCtrlParam->qVelRef, 
                                                         pCtrlParam->normDeltaT);           
@@ -219,39 +293,213 @@ void MCAPP_FOCStateMachine(MCAPP_FOC_T *pFOC)
             
             MCAPP_FOCFeedbackPath(pFOC);
 
-            MCAPP_EstimatorPLL(&pFOC->estimPLL);
-
-            /* Close the loop slowly */            
-            if(pFOC->estimInterface.qThetaOffset > 10)
-            {
-                pFOC->estimInterface.qThetaOffset-=10;
-            }
-            else if(pFOC->estimInterface.qThetaOffset < -10)
+            pEstimInterface->MCAPP_EstimatorStep(pEstimInterface->pEstim);
+            
+            /* Check the estimate for loss of lock and stall */
+            MCAPP_EstimatorMonitor(&pFOC->estimMonitor);
+            
+            /* Track Rs and Ke of PLL estimator in a slow rate group */
+            if (pFOC->estimAdapt.enable && 
+                (pEstimInterface->pEstim == &pFOC->estimPLL))
             {
-                pFOC->estimInterface.qThetaOffset+=10;
+                MCAPP_EstimatorAdaptStep(&pFOC->estimAdapt);
             }
-            else
+
+            /* Close the loop slowly */            
+            pFOC->estimInterface.qThetaOffset = MCAPP_HandoverRamp(
+                                        pFOC->estimInterface.qThetaOffset,
+                                        pCtrlParam->qThetaOffsetStep);
+            pCtrlParam->qIdRefOffset = MCAPP_HandoverRamp(
+                                        pCtrlParam->qIdRefOffset,
+                                        pCtrlParam->qIdRefOffsetStep);
+ 
+            pFOC->estimInterface.qTheta  = pEstimInterface->pOutput->qTheta + pFOC->estimInterface.qThetaOffset ;                                   
+            pFOC->estimInterface.qVelEstim = pEstimInterface->pOutput->qOmega ;
+            
+            /* Return to high frequency injection at low speed */
+            if (pCtrlParam->hfiEnable && 
+                (_Q15abs(pFOC->estimInterface.qVelEstim) < 
+                                            pCtrlParam->qHFIReturnSpeed))
             {
-                pFOC->estimInterface.qThetaOffset = 0;
+                MCAPP_HFIReset(&pFOC->hfi, pFOC->estimInterface.qTheta,
+                                    pFOC->estimInterface.qVelEstim);
+                pCtrlParam->qIdRefOffset = 0;
+                pFOC->focState = FOC_HFI;
             }
- 
-            pFOC->estimInterface.qTheta  = pFOC->estimPLL.qTheta + pFOC->estimInterface.qThetaOffset ;                                   
-            pFOC->estimInterface.qVelEstim = pFOC->estimPLL.qOmegaFilt ;
 			
-            MCAPP_SpeedReferenceRamp(pCtrlParam);
-
-            /* Execute Outer Speed Loop - Iq Reference Generation */
-            MCAPP_ControllerPIUpdate(pCtrlParam->qVelRef, pFOC->estimInterface.qVelEstim, 
-            &pFOC->piSpeed, MCAPP_SAT_NONE, &pCtrlParam->qIqRef,
-            pCtrlParam->qVelRef);
+            MCAPP_FOCIqReference(pFOC);
             
             /* Id Reference generation- Flux Weakening  */
             MCAPP_FluxWeakeningControl(&pFOC->fluxControl);
-            pCtrlParam->qIdRef = pFOC->fluxControl.feedBackFW.IdRef;
+            pCtrlParam->qIdRef = UTIL_SatShrS16(
+                            (int32_t)pFOC->fluxControl.feedBackFW.IdRef + 
+                            pCtrlParam->qIdRefOffset, 0);
  
             MCAPP_FOCForwardPath(pFOC);
             break;
 
+        case FOC_HFI:
+            MCAPP_FOCFeedbackPath(pFOC);
+            
+            MCAPP_HFIStep(&pFOC->hfi);
+            /* Current controllers act on fundamental current only */
+            pFOC->idq = pFOC->hfi.idqFundamental;
+            
+            /* Estimator runs in background to be ready at crossover */
+            pEstimInterface->MCAPP_EstimatorStep(pEstimInterface->pEstim);
+            
+            pFOC->estimInterface.qTheta = pFOC->hfi.qTheta;
+            pFOC->estimInterface.qVelEstim = pFOC->hfi.qOmegaFilt;
+            pFOC->estimInterface.qThetaOffset = 0;
+            
+            if (MCAPP_HFIIsReady(&pFOC->hfi))
+            {
+                MCAPP_FOCIqReference(pFOC);
+                pCtrlParam->qIdRef = 0;
+                
+                /* Crossover to back EMF estimator, which starts from HFI 
+                 * angle and speed */
+                if ((pCtrlParam->openLoop == 0) &&
+                    (_Q15abs(pFOC->estimInterface.qVelEstim) > 
+                                            pCtrlParam->qHFICrossoverSpeed))
+                {
+                    pEstimInterface->MCAPP_EstimatorReset(
+                        pEstimInterface->pEstim, pFOC->estimInterface.qTheta,
+                        pFOC->estimInterface.qVelEstim);
+                    pFOC->hfi.qVdInjection = 0;
+                    pFOC->focState = FOC_CLOSE_LOOP;
+                }
+            }
+            else
+            {
+                pCtrlParam->qIqRef = 0;
+                pCtrlParam->qIdRef = pFOC->hfi.qIdRef;
+            }
+            
+            MCAPP_FOCForwardPath(pFOC);
+            break;
+            
+        case FOC_FLYING_START:
+            MCAPP_FOCFeedbackPath(pFOC);
+            
+            MCAPP_FlyingStartStep(&pFOC->flyingStart);
+            
+            /* Estimator runs in background to be ready at catch */
+            pEstimInterface->MCAPP_EstimatorStep(pEstimInterface->pEstim);
+            
+            pFOC->estimInterface.qTheta = pFOC->flyingStart.qTheta;
+            pFOC->estimInterface.qVelEstim = pFOC->flyingStart.qOmegaFilt;
+            pFOC->estimInterface.qThetaOffset = 0;
+            vdqFeedForward = pFOC->flyingStart.EMFdqFilt;
+            
+            if (MCAPP_FlyingStartIsLocked(&pFOC->flyingStart) &&
+                (pFOC->flyingStart.qOmegaFilt >= 
+                                        pCtrlParam->qFlyingStartMinSpeed))
+            {
+                /* Rotor caught, close the loop at present speed */
+                pFOC->estimInterface.qTheta = 
+                            MCAPP_FlyingStartRotorAngle(&pFOC->flyingStart);
+                if (pFOC->estimInterface.qTheta != pFOC->flyingStart.qTheta)
+                {
+                    /* Frame turns by 180 degrees, back EMF changes sign */
+                    vdqFeedForward.d = -vdqFeedForward.d;
+                    vdqFeedForward.q = -vdqFeedForward.q;
+                }
+                pEstimInterface->MCAPP_EstimatorReset(pEstimInterface->pEstim,
+                    pFOC->estimInterface.qTheta, pFOC->estimInterface.qVelEstim);
+                MCAPP_ControllerPIReset(&pFOC->piSpeed, 0);
+                pCtrlParam->qVelRef = pFOC->estimInterface.qVelEstim;
+                pCtrlParam->speedRampSkipCnt = 0;
+                pFOC->focState = FOC_CLOSE_LOOP;
+            }
+            else if ((pFOC->flyingStart.count >= pCtrlParam->flyingStartTimeLimit)
+                && (pFOC->flyingStart.qOmegaFilt > 
+                                        -pCtrlParam->qFlyingStartMinSpeed))
+            {
+                /* Rotor is not spinning fast enough to catch, start from 
+                 * standstill. Rotor spinning in reverse is left to coast 
+                 * down first */
+                vdqFeedForward.d = 0;
+                vdqFeedForward.q = 0;
+                pFOC->estimInterface.qTheta = 0;
+                pFOC->estimInterface.qVelEstim = 0;
+                pFOC->focState = 
+                        (pCtrlParam->hfiEnable) ? FOC_HFI : FOC_RTR_LOCK;
+            }
+            
+            /* Current controllers hold zero current, back EMF is fed forward
+             * as their integral term */
+            pCtrlParam->qIdRef = 0;
+            pCtrlParam->qIqRef = 0;
+            MCAPP_ControllerPIReset(&pFOC->piDCurrent, vdqFeedForward.d);
+            MCAPP_ControllerPIReset(&pFOC->piQCurrent, vdqFeedForward.q);
+            
+            MCAPP_FOCForwardPath(pFOC);
+            break;
+            
+        case FOC_MOTOR_ID:
+            MCAPP_FOCFeedbackPath(pFOC);
+            
+            MCAPP_MotorIdStep(&pFOC->motorId);
+            if (pFOC->motorId.tuneRequest)
+            {
+                MCAPP_PITuneCurrent(&pFOC->piDCurrent, 
+                        pFOC->motorId.qCurrentBandwidth, pFOC->motorId.qRs, 
+                        pFOC->motorId.rsScale, pFOC->motorId.qLdDt, 
+                        pFOC->motorId.lsDtScale);
+                MCAPP_PITuneCurrent(&pFOC->piQCurrent, 
+                        pFOC->motorId.qCurrentBandwidth, pFOC->motorId.qRs, 
+                        pFOC->motorId.rsScale, pFOC->motorId.qLqDt, 
+                        pFOC->motorId.lsDtScale);
+            }
+            if (pFOC->speedTune.enable && 
+                (pFOC->motorId.resultValid & MOTOR_ID_INERTIA_VALID) &&
+                (pFOC->motorId.tauMech != pFOC->speedTune.tauMech))
+            {
+                /* Speed controller follows the identified inertia */
+                MCAPP_PITuneSpeed(&pFOC->piSpeed, &pFOC->speedTune,
+                        pFOC->motorId.tauMech, pFOC->motorId.qFriction);
+            }
+            if (pFOC->motorId.paramUpdate)
+            {
+                /* Estimator continues on identified parameters from the 
+                 * forced angle and speed */
+                MCAPP_FOCMotorIdApply(pFOC);
+                pEstimInterface->MCAPP_EstimatorReset(pEstimInterface->pEstim,
+                            pFOC->motorId.qTheta, pFOC->motorId.qOmega);
+            }
+            pEstimInterface->MCAPP_EstimatorStep(pEstimInterface->pEstim);
+            
+            if (pFOC->motorId.useEstimatorAngle)
+            {
+                pFOC->estimInterface.qTheta = pEstimInterface->pOutput->qTheta;
+                pFOC->estimInterface.qVelEstim = 
+                                            pEstimInterface->pOutput->qOmega;
+            }
+            else
+            {
+                pFOC->estimInterface.qTheta = pFOC->motorId.qTheta;
+                pFOC->estimInterface.qVelEstim = pFOC->motorId.qOmega;
+            }
+            pFOC->estimInterface.qThetaOffset = 0;
+            
+            if (pFOC->motorId.voltageMode)
+            {
+                /* Voltage pulses bypass the current controllers, which 
+                 * restart from the applied voltage */
+                pFOC->vdq = pFOC->motorId.vdqRef;
+                MCAPP_ControllerPIReset(&pFOC->piDCurrent, pFOC->vdq.d);
+                MCAPP_ControllerPIReset(&pFOC->piQCurrent, pFOC->vdq.q);
+                MCAPP_FOCModulation(pFOC);
+            }
+            else
+            {
+                pCtrlParam->qIdRef = pFOC->motorId.qIdRef;
+                pCtrlParam->qIqRef = pFOC->motorId.qIqRef;
+                MCAPP_FOCForwardPath(pFOC);
+            }
+            break;
+            
         case FOC_FAULT:
                     
             break;
@@ -263,6 +511,115 @@ void MCAPP_FOCStateMachine(MCAPP_FOC_T *pFOC)
     } /* End Of switch - case */
 }
 
+/**
+* <B> Function: bool MCAPP_FOCEstimatorSelect(MCAPP_FOC_T *, uint16_t)  </B>
+*
+* @brief Function to select the estimator used by FOC and connect its hooks
+* and outputs. Estimators are registered here; select only while FOC is in
+* FOC_INIT state (motor stopped).
+*
+* @param Pointer to the data structure containing FOC parameters.
+* @param Estimator - MCAPP_ESTIMATOR_ID_T.
+* @return true if the estimator is available.
+* @example
+* <CODE> MCAPP_FOCEstimatorSelect(&mc, MCAPP_ESTIMATOR_PLL); </CODE>
+*
+*/
+bool MCAPP_FOCEstimatorSelect(MCAPP_FOC_T *pFOC, uint16_t estimatorId)
+{
+    MCAPP_ESTIMATOR_T *pEstimInterface = &pFOC->estimInterface;
+    
+    switch(estimatorId)
+    {
+        case MCAPP_ESTIMATOR_PLL:
+            pEstimInterface->pEstim = &pFOC->estimPLL;
+            pEstimInterface->pOutput = &pFOC->estimPLL.output;
+            pEstimInterface->MCAPP_EstimatorInit = MCAPP_EstimatorPLLInit;
+            pEstimInterface->MCAPP_EstimatorStep = MCAPP_EstimatorPLL;
+            pEstimInterface->MCAPP_EstimatorReset = MCAPP_EstimatorPLLReset;
+            pEstimInterface->MCAPP_EstimatorIsLocked = 
+                                                MCAPP_EstimatorPLLIsLocked;
+            break;
+            
+        case MCAPP_ESTIMATOR_EEMF:
+            pEstimInterface->pEstim = &pFOC->estimEEMF;
+            pEstimInterface->pOutput = &pFOC->estimEEMF.output;
+            pEstimInterface->MCAPP_EstimatorInit = MCAPP_EstimatorEEMFInit;
+            pEstimInterface->MCAPP_EstimatorStep = MCAPP_EstimatorEEMF;
+            pEstimInterface->MCAPP_EstimatorReset = MCAPP_EstimatorEEMFReset;
+            pEstimInterface->MCAPP_EstimatorIsLocked = 
+                                                MCAPP_EstimatorEEMFIsLocked;
+            break;
+            
+        default:
+            return false;
+    }
+    
+    pEstimInterface->estimatorId = estimatorId;
+    pFOC->estimMonitor.pOutput = pEstimInterface->pOutput;
+    pEstimInterface->MCAPP_EstimatorInit(pEstimInterface->pEstim);
+    
+    return true;
+}
+
+/**
+* <B> Function: void MCAPP_FOCStartFromAngle(MCAPP_FOC_T *, int16_t)  </B>
+*
+* @brief Function to start the motor from a known rotor angle, e.g. found by
+* initial position detection. Rotor lock is skipped: HFI starts tracking
+* from the angle, otherwise open loop starts from the angle. Call after start
+* transition has set the start state.
+*
+* @param Pointer to the data structure containing FOC parameters.
+* @param Rotor angle.
+* @return none.
+* @example
+* <CODE> MCAPP_FOCStartFromAngle(&mc, qTheta); </CODE>
+*
+*/
+void MCAPP_FOCStartFromAngle(MCAPP_FOC_T *pFOC, int16_t qTheta)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pFOC->ctrlParam;
+    MCAPP_ESTIMATOR_T *pEstimInterface = &pFOC->estimInterface;
+    
+    pEstimInterface->MCAPP_EstimatorReset(pEstimInterface->pEstim, qTheta, 0);
+    pEstimInterface->qTheta = qTheta;
+    pEstimInterface->qThetaOffset = 0;
+    
+    if (pCtrlParam->hfiEnable)
+    {
+        MCAPP_HFIReset(&pFOC->hfi, qTheta, 0);
+        pFOC->focState = FOC_HFI;
+    }
+    else
+    {
+        pCtrlParam->lockTime = 0;
+        pCtrlParam->speedRampSkipCnt = 0;
+        pCtrlParam->OLThetaSum = (int32_t)qTheta << 15;
+        pCtrlParam->OLTheta = qTheta;
+        pFOC->focState = FOC_OPEN_LOOP;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_FOCMotorIdStart(MCAPP_FOC_T *)  </B>
+*
+* @brief Function to start motor parameter identification instead of the 
+* motor. Call after MCAPP_FOCInit() with PWM outputs enabled, identification
+* is complete when MCAPP_MotorIdIsComplete() returns true.
+*
+* @param Pointer to the data structure containing FOC parameters.
+* @return none.
+* @example
+* <CODE> MCAPP_FOCMotorIdStart(&mc); </CODE>
+*
+*/
+void MCAPP_FOCMotorIdStart(MCAPP_FOC_T *pFOC)
+{
+    MCAPP_MotorIdInit(&pFOC->motorId);
+    pFOC->focState = FOC_MOTOR_ID;
+}
+
 /**
 * <B> Function: void MCAPP_FOCFeedbackPath (MCAPP_FOC_T *)  </B>
 *
@@ -301,36 +658,137 @@ static void MCAPP_FOCFeedbackPath(MCAPP_FOC_T *pFOC)
 
 static void MCAPP_FOCForwardPath(MCAPP_FOC_T *pFOC)
 {
-    int16_t vqSquaredLimit, vdSquared, vPhaseMax, vMaxSquare;
+    int16_t vqSquaredLimit, vdSquared, vPhaseMax, vMaxSquare, vqMax;
+    MC_DQ_T vdqFeedForward, vdqPI;
+    const MC_DQ_T *pIdq = &pFOC->idq;
+    
+    if (pFOC->position.enable)
+    {
+        MCAPP_PositionAccumulate(&pFOC->position);
+    }
+    
+    MCAPP_FOCDecoupling(pFOC);
+    
+    /* Current controllers use filtered currents during overmodulation, 
+     * keeping the 6th harmonic out of the voltage reference */
+    if (pFOC->overmod.enable)
+    {
+        MCAPP_OvermodulationCurrentFilter(&pFOC->overmod);
+        if (pFOC->overmod.active)
+        {
+            pIdq = &pFOC->overmod.idqFilt;
+        }
+    }
+    
+    /* Controller output limits leave room for the feedforward voltage, 
+     * feedforward voltage is limited to the available voltage */
+    vPhaseMax = (int16_t)(__builtin_mulss(VMAX_FACTOR, (*pFOC->pVdc))>>15);
+    pFOC->vPhaseMax = vPhaseMax;
+    vdqFeedForward.d = UTIL_LimitS16(pFOC->decoupling.vdqFeedForward.d, 
+                                        -vPhaseMax, vPhaseMax);
+    pFOC->piDCurrent.outMax = 
+                    UTIL_SatShrS16((int32_t)vPhaseMax - vdqFeedForward.d, 0);
+    pFOC->piDCurrent.outMin = 
+                    UTIL_SatShrS16(-(int32_t)vPhaseMax - vdqFeedForward.d, 0);
     
     /** Execute inner current control loops */
-    /* Execute PI Control of Q axis. */
-    MCAPP_ControllerPIUpdate(pFOC->ctrlParam.qIdRef,  pFOC->idq.d, 
-            &pFOC->piDCurrent, MCAPP_SAT_NONE, &pFOC->vdq.d,
+    /* Execute PI Control of D axis. */
+    MCAPP_ControllerPIUpdate(pFOC->ctrlParam.qIdRef,  pIdq->d, 
+            &pFOC->piDCurrent, MCAPP_SAT_NONE, &vdqPI.d,
             pFOC->ctrlParam.qIdRef);
+    pFOC->vdq.d = UTIL_SatShrS16((int32_t)vdqPI.d + vdqFeedForward.d, 0);
 
     /* Generate Q axis current reference based on available voltage and D axis
        voltage */
-    vPhaseMax = (int16_t)(__builtin_mulss(VMAX_FACTOR, (*pFOC->pVdc))>>15);
     vMaxSquare = (int16_t)(__builtin_mulss(vPhaseMax, vPhaseMax)>>15);
     vdSquared  = (int16_t)(__builtin_mulss(pFOC->vdq.d, pFOC->vdq.d)>>15);
     vqSquaredLimit = vMaxSquare - vdSquared;  
-    pFOC->piDCurrent.outMax = vPhaseMax;
-    pFOC->piDCurrent.outMin = -vPhaseMax; 
-    pFOC->piQCurrent.outMax = _Q15sqrt(vqSquaredLimit);
-    pFOC->piQCurrent.outMin = -(pFOC->piQCurrent.outMax); 
+    vqMax = _Q15sqrt(vqSquaredLimit);
+    vdqFeedForward.q = UTIL_LimitS16(pFOC->decoupling.vdqFeedForward.q, 
+                                        -vqMax, vqMax);
+    pFOC->piQCurrent.outMax = 
+                    UTIL_SatShrS16((int32_t)vqMax - vdqFeedForward.q, 0);
+    pFOC->piQCurrent.outMin = 
+                    UTIL_SatShrS16(-(int32_t)vqMax - vdqFeedForward.q, 0);
     
     /* Execute PI Control of Q axis. */ 
-    MCAPP_ControllerPIUpdate(pFOC->ctrlParam.qIqRef,  pFOC->idq.q, 
-            &pFOC->piQCurrent, MCAPP_SAT_NONE, &pFOC->vdq.q,
+    MCAPP_ControllerPIUpdate(pFOC->ctrlParam.qIqRef,  pIdq->q, 
+            &pFOC->piQCurrent, MCAPP_SAT_NONE, &vdqPI.q,
             pFOC->ctrlParam.qIqRef);
+    pFOC->vdq.q = UTIL_SatShrS16((int32_t)vdqPI.q + vdqFeedForward.q, 0);
+    
+    MCAPP_FOCModulation(pFOC);
+}
+
+/**
+* <B> Function: void MCAPP_FOCDecoupling(MCAPP_FOC_T *)  </B>
+*
+* @brief Updates the cross coupling and back EMF feedforward voltages in 
+* closed loop. When feedforward starts or stops, the step of feedforward 
+* voltage is moved into the integral terms of the current controllers, so 
+* controller outputs continue without a step.
+*
+* @param Pointer to the data structure containing FOC parameters.
+* @return none.
+* @example
+* <CODE> MCAPP_FOCDecoupling(&mc); </CODE>
+*
+*/
+static void MCAPP_FOCDecoupling(MCAPP_FOC_T *pFOC)
+{
+    MCAPP_DECOUPLING_T *pDecoupling = &pFOC->decoupling;
+    const MC_DQ_T vdqLast = pDecoupling->vdqFeedForward;
+    const uint16_t active = (pDecoupling->enable && 
+                                (pFOC->focState == FOC_CLOSE_LOOP));
+    
+    if (active)
+    {
+        MCAPP_DecouplingStep(pDecoupling);
+    }
+    else
+    {
+        MCAPP_DecouplingInit(pDecoupling);
+    }
+    
+    if (active != pDecoupling->active)
+    {
+        MCAPP_ControllerPIReset(&pFOC->piDCurrent, 
+            UTIL_SatShrS16(pFOC->piDCurrent.integrator - 
+            (((int32_t)pDecoupling->vdqFeedForward.d - vdqLast.d) << 16), 16));
+        MCAPP_ControllerPIReset(&pFOC->piQCurrent, 
+            UTIL_SatShrS16(pFOC->piQCurrent.integrator - 
+            (((int32_t)pDecoupling->vdqFeedForward.q - vdqLast.q) << 16), 16));
+        pDecoupling->active = active;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_FOCModulation(MCAPP_FOC_T *)  </B>
+*
+* @brief Generates PWM duty cycles from D and Q axis voltages at the present
+* angle.
+*
+* @param Pointer to the data structure containing FOC parameters.
+* @return none.
+* @example
+* <CODE> MCAPP_FOCModulation(&mc); </CODE>
+*
+*/
+static void MCAPP_FOCModulation(MCAPP_FOC_T *pFOC)
+{
+    MC_DQ_T vdqOut;
     
     /* Calculate sin and cos of theta (angle) */
     MC_CalculateSineCosine_Assembly_Ram(pFOC->estimInterface.qTheta, 
                                             &pFOC->sincosTheta);
 
+    /* Superimpose high frequency injection voltage on D axis, injection
+       voltage is zero outside FOC_HFI state */
+    vdqOut.d = UTIL_SatShrS16((int32_t)pFOC->vdq.d + pFOC->hfi.qVdInjection, 0);
+    vdqOut.q = pFOC->vdq.q;
+    
     /* Perform inverse Clarke and Park transforms and generate phase voltages.*/
-    MC_TransformParkInverse_Assembly(&pFOC->vdq, &pFOC->sincosTheta, 
+    MC_TransformParkInverse_Assembly(&vdqOut, &pFOC->sincosTheta, 
                                                         &pFOC->valphabeta);
     
     /* Calculate Vr1,Vr2,Vr3 from qValpha, qVbeta */
@@ -339,24 +797,92 @@ static void MCAPP_FOCForwardPath(MCAPP_FOC_T *pFOC)
     /* DC Link voltage compensation */
     MCAPP_DCLinkVoltageCompensation(&pFOC->vabc, &pFOC->vabcCompDC, pFOC->pVdc);
     
-    /* Calculate modulation signal input for MC_CalculateSpaceVector_Assembly */
-    MCAPP_CalculateModulationSiganl(&pFOC->vabcCompDC, &pFOC->vabcScaled);
+    if (MCAPP_OvermodulationStep(&pFOC->overmod, pFOC->pPWMDuty))
+    {
+        /* Voltage reference is above the linear limit, estimators use the 
+         * voltage applied by the inverter */
+        pFOC->valphabeta = pFOC->overmod.valphabetaOut;
+    }
+    else
+    {
+        /* Calculate modulation signal input for 
+         * MC_CalculateSpaceVector_Assembly */
+        MCAPP_CalculateModulationSiganl(&pFOC->vabcCompDC, &pFOC->vabcScaled);
 
-    /* Execute space vector modulation and generate PWM duty cycles */
-    MC_CalculateSpaceVector_Assembly(&pFOC->vabcScaled, pFOC->pwmPeriod,
-                                                    pFOC->pPWMDuty);
+        /* Execute space vector modulation and generate PWM duty cycles */
+        MC_CalculateSpaceVector_Assembly(&pFOC->vabcScaled, pFOC->pwmPeriod,
+                                                        pFOC->pPWMDuty);
+
+        /* Clamp one phase to a rail at high modulation index */
+        MCAPP_DPWMStep(&pFOC->dpwm, pFOC->pPWMDuty);
+    }
+    
+    /* Correct duty cycles for dead time */
+    MCAPP_DeadTimeCompensation(&pFOC->deadTime, pFOC->pPWMDuty);
 }
 
 
 
 /**
-* <B> Function: void MCAPP_SpeedReferenceRamp(MCAPP_CONTROL_T *)  </B>
+* <B> Function: void MCAPP_FOCMotorIdApply(MCAPP_FOC_T *)  </B>
+*
+* @brief Replaces configured motor and estimator parameters with the 
+* identified ones. Ls of the estimators is set to Lq, which keeps the angle 
+* estimate correct on salient motors.
 *
 */
-static void MCAPP_SpeedReferenceRamp(MCAPP_CONTROL_T *pCtrlParam)
+static void MCAPP_FOCMotorIdApply(MCAPP_FOC_T *pFOC)
 {
-    int16_t deltaSpeed = pCtrlParam->qVelRef - 
-                                (int16_t)pCtrlParam->qTargetVelocity;
+    const MCAPP_MOTOR_ID_T *pId = &pFOC->motorId;
+    const int16_t invKfi = pId->qInvKfiConst;
+    const int16_t invKfiScale = (int16_t)pId->invKfiConstScale;
+    
+    if (pId->resultValid & MOTOR_ID_RS_VALID)
+    {
+        pFOC->pMotor->qRs = pId->qRs;
+        pFOC->pMotor->qRsScale = pId->rsScale;
+    }
+    if (pId->resultValid & MOTOR_ID_LQ_VALID)
+    {
+        pFOC->pMotor->qLsDt = pId->qLqDt;
+        pFOC->pMotor->qLsDtScale = pId->lsDtScale;
+    }
+    if (pId->resultValid & MOTOR_ID_KE_VALID)
+    {
+        pFOC->estimPLL.qInvKfiConst = invKfi;
+        pFOC->estimPLL.qInvKfiConstScale = invKfiScale;
+        pFOC->estimEEMF.qInvKfiConst = invKfi;
+        pFOC->estimEEMF.qInvKfiConstScale = invKfiScale;
+        pFOC->estimMonitor.qInvKfiConst = invKfi;
+        pFOC->estimMonitor.qInvKfiConstScale = invKfiScale;
+        pFOC->flyingStart.qInvKfiConst = invKfi;
+        pFOC->flyingStart.qInvKfiConstScale = invKfiScale;
+    }
+    /* Online adaptation continues from the identified values */
+    MCAPP_EstimatorAdaptRebase(&pFOC->estimAdapt);
+}
+
+/**
+* <B> Function: void MCAPP_SpeedReferenceRamp(MCAPP_FOC_T *)  </B>
+*
+*/
+static void MCAPP_SpeedReferenceRamp(MCAPP_FOC_T *pFOC)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pFOC->ctrlParam;
+    int16_t deltaSpeed;
+    
+    if (pFOC->position.enable)
+    {
+        MCAPP_PositionStep(&pFOC->position);
+        return;
+    }
+    if (pFOC->speedProfile.enable)
+    {
+        MCAPP_SpeedProfileStep(&pFOC->speedProfile);
+        return;
+    }
+    
+    deltaSpeed = pCtrlParam->qVelRef - (int16_t)pCtrlParam->qTargetVelocity;
     if(deltaSpeed < 0)
     {
         if(pCtrlParam->speedRampSkipCnt >= pCtrlParam->speedRampIncLimit)
@@ -381,6 +907,131 @@ static void MCAPP_SpeedReferenceRamp(MCAPP_CONTROL_T *pCtrlParam)
 }
 
 
+/**
+* <B> Function: void MCAPP_FOCIqFeedForward(MCAPP_FOC_T *)  </B>
+*
+* @brief Adds the acceleration current of position control to the speed 
+* controller output, within the speed controller output limits.
+*
+*/
+static void MCAPP_FOCIqFeedForward(MCAPP_FOC_T *pFOC)
+{
+    if (pFOC->position.enable)
+    {
+        pFOC->ctrlParam.qIqRef = UTIL_LimitS16(UTIL_SatShrS16(
+                    (int32_t)pFOC->ctrlParam.qIqRef + 
+                    pFOC->position.qIqFeedForward, 0), 
+                    pFOC->piSpeed.outMin, pFOC->piSpeed.outMax);
+    }
+}
+
+/**
+* <B> Function: void MCAPP_FOCIqReference(MCAPP_FOC_T *)  </B>
+*
+* @brief Q axis current reference in closed loop, from the torque mode 
+* current command or from the speed controller. Position control restarts 
+* from the present speed after torque mode. Load estimate of the disturbance
+* observer is fed forward through the speed controller integrator.
+*
+*/
+static void MCAPP_FOCIqReference(MCAPP_FOC_T *pFOC)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pFOC->ctrlParam;
+    
+    if (pFOC->disturbance.enable)
+    {
+        MCAPP_DisturbanceObserverStep(&pFOC->disturbance);
+    }
+    
+    if (pFOC->torqueControl.enable && 
+        MCAPP_TorqueControlStep(&pFOC->torqueControl))
+    {
+        pFOC->position.active = 0;
+        return;
+    }
+    
+    MCAPP_SpeedReferenceRamp(pFOC);
+
+    /* Execute Outer Speed Loop - Iq Reference Generation */
+    MCAPP_ControllerPIUpdate(pCtrlParam->qVelRef, 
+        pFOC->estimInterface.qVelEstim, &pFOC->piSpeed, MCAPP_SAT_NONE, 
+        &pCtrlParam->qIqRef, pCtrlParam->qVelRef);
+    MCAPP_FOCIqFeedForward(pFOC);
+}
+
+/**
+* <B> Function: void MCAPP_IfCurrentControl(MCAPP_FOC_T *)  </B>
+*
+* @brief I-f current regulation in open loop. Load angle is the estimated rotor
+* angle ahead of the forced current angle; a large load angle means the current
+* exceeds the load torque, so current is reduced, and increased otherwise.
+* Current is adjusted once every OLCurrentRampSkipCntLimit calls.
+*
+*/
+static void MCAPP_IfCurrentControl(MCAPP_FOC_T *pFOC)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pFOC->ctrlParam;
+    int16_t qLoadAngle = (int16_t)(pFOC->estimInterface.pOutput->qTheta - 
+                                                        pCtrlParam->OLTheta);
+    
+    if (pCtrlParam->OLCurrentRampSkipCnt < 
+                                pCtrlParam->OLCurrentRampSkipCntLimit)
+    {
+        pCtrlParam->OLCurrentRampSkipCnt++;
+        return;
+    }
+    pCtrlParam->OLCurrentRampSkipCnt = 0;
+    
+    if (qLoadAngle > pCtrlParam->qIfLoadAngle)
+    {
+        if (pCtrlParam->OLCurrent > pCtrlParam->OLCurrentMin)
+        {
+            pCtrlParam->OLCurrent -= pCtrlParam->OLCurrentRampRate;
+        }
+    }
+    else if (pCtrlParam->OLCurrent < pCtrlParam->OLCurrentMax)
+    {
+        pCtrlParam->OLCurrent += pCtrlParam->OLCurrentRampRate;
+    }
+}
+
+/**
+* <B> Function: int16_t MCAPP_HandoverStep(int16_t, uint16_t)  </B>
+*
+* @brief Step per control period to ramp a value to zero in given time.
+* Step is at least one count so the ramp always completes.
+*
+*/
+static int16_t MCAPP_HandoverStep(int16_t value, uint16_t timeLimit)
+{
+    int16_t step = value;
+    
+    if (timeLimit > 1)
+    {
+        step = __builtin_divsd((int32_t)value, (int16_t)timeLimit);
+    }
+    if ((step == 0) && (value != 0))
+    {
+        step = (value > 0) ? 1 : -1;
+    }
+    return step;
+}
+
+/**
+* <B> Function: int16_t MCAPP_HandoverRamp(int16_t, int16_t)  </B>
+*
+* @brief Ramps a value to zero by step, step has the sign of the value.
+*
+*/
+static int16_t MCAPP_HandoverRamp(int16_t value, int16_t step)
+{
+    if ((step == 0) || (_Q15abs(value) <= _Q15abs(step)))
+    {
+        return 0;
+    }
+    return value - step;
+}
+
 /**
 * <B> Function: void MCAPP_CalculateModulationSiganl(MC_ABC_T *, MC_ABC_T *)  </B>
 *
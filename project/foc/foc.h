@@ -67,6 +67,9 @@ extern "C" {
 
 void MCAPP_FOCStateMachine(MCAPP_FOC_T *);
 void MCAPP_FOCInit(MCAPP_FOC_T *);
+bool MCAPP_FOCEstimatorSelect(MCAPP_FOC_T *, uint16_t);
+void MCAPP_FOCStartFromAngle(MCAPP_FOC_T *, int16_t);
+void MCAPP_FOCMotorIdStart(MCAPP_FOC_T *);
 
 // </editor-fold>
 
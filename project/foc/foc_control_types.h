@@ -80,20 +80,35 @@ typedef struct
         OLTheta,                    /* Open Loop Angle */
         lockCurrent,                /* Locking current */
         OLCurrent,                  /* Open Loop Current */
+        OLCurrentStart,             /* Open Loop Current at start */
         OLCurrentMax,               /* Maximum Open Loop Current */
+        OLCurrentMin,               /* Minimum Open Loop Current in I-f */
+        qIfLoadAngle,               /* I-f load angle reference */
         OLCurrentRampSkipCnt,       /* Current ramp update counter */
         OLCurrentRampSkipCntLimit,  /* Current Ramp slew rate in open loop */
         OLCurrentRampRate,          /* Current Ramp rate in open loop */
 		
         normDeltaT,                 /* Scaled sampling time */
+        qHFICrossoverSpeed,         /* Speed to leave HFI for closed loop */
+        qHFIReturnSpeed,            /* Speed to return to HFI from closed loop*/
+        qFlyingStartMinSpeed,       /* Minimum speed to catch spinning rotor */
+        qThetaOffsetStep,           /* Handover angle offset ramp step */
+        qIdRefOffset,               /* Handover D axis current offset */
+        qIdRefOffsetStep,           /* Handover D axis current ramp step */
 
         qTargetVelocity;            /* Speed Reference */
 
     uint16_t
         openLoop,                   /* Open loop flag */
         fluxWeakEnable,             /* Flux weakening enable flag */
+        hfiEnable,                  /* High frequency injection enable flag */
+        flyingStartEnable,          /* Flying start enable flag */
+        flyingStartTimeLimit,       /* Time to catch before standstill start */
         lockTime,                   /* Lock variable for initial ramp */
         lockTimeLimit,              /* Total lock time */
+        handoverTimeLimit,          /* Open loop to closed loop blend time */
+        OLStallTime,                /* Time at open loop speed without lock */
+        OLStallTimeLimit,           /* Open loop time limit to report stall */
         OLSpeedRampRate;            /* Ramp rate for Open loop */
 
     int32_t
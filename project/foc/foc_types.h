@@ -61,6 +61,21 @@ extern "C" {
 #include "foc_control_types.h"
 #include "estim_interface.h"
 #include "estim_pll.h"
+#include "estim_eemf.h"
+#include "estim_monitor.h"
+#include "estim_adapt.h"
+#include "hfi.h"
+#include "flying_start.h"
+#include "motor_id.h"
+#include "pi_tune.h"
+#include "decoupling.h"
+#include "deadtime.h"
+#include "dpwm.h"
+#include "overmodulation.h"
+#include "speed_profile.h"
+#include "position.h"
+#include "torque_control.h"
+#include "disturbance_observer.h"
 #include "motor_control.h"
 #include "motor_params.h"
 #include "sat_pi/sat_pi.h"
@@ -77,6 +92,9 @@ typedef enum
     FOC_OPEN_LOOP = 2,         /* Open Loop */
     FOC_CLOSE_LOOP = 3,        /* Closed Loop */
     FOC_FAULT = 4,             /* Motor is in Fault */
+    FOC_HFI = 5,               /* High Frequency Injection */
+    FOC_FLYING_START = 6,      /* Catch spinning rotor */
+    FOC_MOTOR_ID = 7,          /* Motor parameter identification */
 
 }FOC_CONTROL_STATE_T;
 
@@ -125,6 +143,51 @@ typedef struct
 	
     MCAPP_ESTIMATOR_PLL_T
         estimPLL;         	/* Estimator Structure */
+    
+    MCAPP_ESTIMATOR_EEMF_T
+        estimEEMF;          /* Extended EMF Observer Estimator Structure */
+    
+    MCAPP_ESTIMATOR_MONITOR_T
+        estimMonitor;       /* Estimator Lock Monitor Structure */
+    
+    MCAPP_ESTIMATOR_ADAPT_T
+        estimAdapt;         /* Estimator Parameter Adaptation Structure */
+    
+    MCAPP_HFI_T
+        hfi;                /* High Frequency Injection Structure */
+    
+    MCAPP_FLYING_START_T
+        flyingStart;        /* Flying Start Structure */
+    
+    MCAPP_MOTOR_ID_T
+        motorId;            /* Motor Parameter Identification Structure */
+    
+    MCAPP_SPEED_TUNE_T
+        speedTune;          /* Speed Controller Tuning Structure */
+    
+    MCAPP_DECOUPLING_T
+        decoupling;         /* Current Controller Decoupling Structure */
+    
+    MCAPP_DEADTIME_T
+        deadTime;           /* Dead Time Compensation Structure */
+    
+    MCAPP_DPWM_T
+        dpwm;               /* Discontinuous PWM Structure */
+    
+    MCAPP_OVERMODULATION_T
+        overmod;            /* Overmodulation Structure */
+    
+    MCAPP_SPEED_PROFILE_T
+        speedProfile;       /* S-curve Speed Profile Structure */
+    
+    MCAPP_POSITION_T
+        position;           /* Position Control Structure */
+    
+    MCAPP_TORQUE_CONTROL_T
+        torqueControl;      /* Torque Mode Structure */
+    
+    MCAPP_DISTURBANCE_OBSERVER_T
+        disturbance;        /* Load Disturbance Observer Structure */
         
     MCAPP_ESTIMATOR_T
         estimInterface;     /* Estimator Interface Structure */       
@@ -137,6 +200,8 @@ typedef struct
     
     uint16_t pwmPeriod;     /* PWM Period */
     
+    int16_t vPhaseMax;      /* Voltage limit of current controllers */
+    
 }MCAPP_FOC_T;
 
 
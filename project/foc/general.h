@@ -53,6 +53,7 @@ extern "C" {
 
 // <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
 #include <stdint.h>
+#include <libq.h>
 
 // </editor-fold>
 
@@ -77,6 +78,9 @@ extern "C" {
 /* Function to calculate normalized value of a parameter */
 #define NORM_VALUE(actual, base)    Q15( ((float)actual) / ((float)base) )
 
+/* Limit of 32 bit state variables, holding Q15 value shifted left by 15 */
+#define UTIL_STATE_MAX      ((int32_t)INT16_MAX << 15)
+
     
 /**
  * Computes saturated shift-right with an S16 result.
@@ -105,6 +109,77 @@ inline static int16_t UTIL_SatShrS16(int32_t x, uint16_t q)
     }
     return ylo;
 }    
+
+/**
+ * Limits a state variable so that its upper word is within Q15 range.
+ */
+inline static int32_t UTIL_StateLimit(int32_t state)
+{
+    if (state > UTIL_STATE_MAX)
+    {
+        state = UTIL_STATE_MAX;
+    }
+    else if (state < -UTIL_STATE_MAX)
+    {
+        state = -UTIL_STATE_MAX;
+    }
+    return state;
+}
+
+/**
+ * Approximates the magnitude of vector (x, y) as 
+ * max(|x|,|y|) + 3/8*min(|x|,|y|), within -2.8% and +6.8% of the magnitude.
+ */
+inline static int16_t UTIL_MagnitudeApprox(int16_t x, int16_t y)
+{
+    const int16_t absX = _Q15abs(x);
+    const int16_t absY = _Q15abs(y);
+    
+    if (absX > absY)
+    {
+        return UTIL_SatShrS16((int32_t)absX + 
+                            (__builtin_mulss(absY, Q15(0.375)) >> 15), 0);
+    }
+    else
+    {
+        return UTIL_SatShrS16((int32_t)absY + 
+                            (__builtin_mulss(absX, Q15(0.375)) >> 15), 0);
+    }
+}
+
+/**
+ * Computes the PLL phase error -sgn(Eq)*Ed/|E| = sin(angle error) from the 
+ * back EMF in the estimated rotor frame and its magnitude. Error is held at
+ * zero when the magnitude is not above magMin, too small to determine the 
+ * angle.
+ */
+inline static int16_t UTIL_PLLPhaseError(int16_t ed, int16_t eq, int16_t mag,
+                                            int16_t magMin)
+{
+    int16_t error = 0;
+    
+    if (mag > magMin)
+    {
+        error = __builtin_divsd(__builtin_mulss(_Q15abs(ed), INT16_MAX), mag);
+        if ((ed > 0) == (eq > 0))
+        {
+            error = -error;
+        }
+    }
+    return error;
+}
+
+/**
+ * Executes a PI controller with the integral state limited by 
+ * UTIL_StateLimit(). State holds Q15 value shifted left by 15, returns the
+ * Q15 output.
+ */
+inline static int16_t UTIL_PIClamped(int32_t *pState, int16_t kp, int16_t ki,
+                                        int16_t error)
+{
+    *pState = UTIL_StateLimit(*pState + __builtin_mulss(ki, error));
+    return UTIL_SatShrS16(*pState + __builtin_mulss(kp, error), 15);
+}
     
     
     
@@ -0,0 +1,247 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file hfi.c
+ *
+ * @brief This module implements high frequency injection angle estimator for
+ * zero and low speed operation of salient motors.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15abs function use */
+#include <libq.h>
+#include "hfi.h"
+#include "general.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_HFIInit(MCAPP_HFI_T *)  </B>
+*
+* @brief Function to reset HFI Estimator Data Structure variables and start
+* angle detection from HFI_ALIGN state.
+*
+* @param    pointer to the data structure containing HFI parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_HFIInit(&hfi); </CODE>
+*
+*/
+void MCAPP_HFIInit(MCAPP_HFI_T *pHFI)
+{
+    pHFI->qVdInjection = 0;
+    pHFI->injectionSign = 1;
+    
+    pHFI->qErrorPLL = 0;
+    pHFI->qOmegaIntStateVar = 0;
+    pHFI->qThetaStateVar = 0;
+    pHFI->qTheta = 0;
+    pHFI->qOmega = 0;
+    pHFI->qOmegaFilt = 0;
+    pHFI->qOmegaStateVar = 0;
+    
+    pHFI->qIdRef = 0;
+    pHFI->responsePositive = 0;
+    pHFI->responseNegative = 0;
+    
+    pHFI->idqLast.d = 0;
+    pHFI->idqLast.q = 0;
+    pHFI->idqFundamental.d = 0;
+    pHFI->idqFundamental.q = 0;
+    
+    pHFI->state = HFI_ALIGN;
+    pHFI->stateTime = 0;
+}
+
+/**
+* <B> Function: void MCAPP_HFIReset(MCAPP_HFI_T *, int16_t, int16_t)  </B>
+*
+* @brief Function to restart HFI Estimator from known angle and speed, e.g.
+* when speed drops below crossover speed. Angle detection is skipped.
+*
+* @param    pointer to the data structure containing HFI parameters.
+* @param    angle.
+* @param    speed.
+* @return   none.
+* @example
+* <CODE> MCAPP_HFIReset(&hfi, qTheta, qOmega); </CODE>
+*
+*/
+void MCAPP_HFIReset(MCAPP_HFI_T *pHFI, int16_t qTheta, int16_t qOmega)
+{
+    MCAPP_HFIInit(pHFI);
+    
+    pHFI->qTheta = qTheta;
+    pHFI->qThetaStateVar = (int32_t)qTheta << 15;
+    pHFI->qOmega = qOmega;
+    pHFI->qOmegaIntStateVar = (int32_t)qOmega << 15;
+    pHFI->qOmegaFilt = qOmega;
+    pHFI->qOmegaStateVar = (int32_t)qOmega << 15;
+    
+    pHFI->idqLast = *pHFI->pIdq;
+    pHFI->idqFundamental = *pHFI->pIdq;
+    
+    pHFI->state = HFI_RUN;
+}
+
+/**
+* <B> Function: void MCAPP_HFIStep(MCAPP_HFI_T *)  </B>
+*
+* @brief High frequency injection estimator, executed once every control 
+* cycle after Idq is calculated with the estimated angle.
+* Injection voltage alternates every control cycle; the difference of two
+* consecutive Idq samples is the injection response and their average is
+* the fundamental current used by the current controllers. Q axis response
+* demodulated with the injection sign gives the angle error for the PLL.
+* Since the response is the same for D and -D axis, the magnet polarity is
+* detected after alignment: the D axis response is larger with positive D
+* current, as the stator iron saturates.
+*
+* @param    pointer to the data structure containing HFI parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_HFIStep(&hfi); </CODE>
+*
+*/
+void MCAPP_HFIStep(MCAPP_HFI_T *pHFI)
+{
+    const MC_DQ_T *pIdq = pHFI->pIdq;
+    int16_t diffD, diffQ, error;
+    
+    /* Fundamental = average, response = difference of consecutive samples */
+    pHFI->idqFundamental.d = (int16_t)(((int32_t)pIdq->d + pHFI->idqLast.d) >> 1);
+    pHFI->idqFundamental.q = (int16_t)(((int32_t)pIdq->q + pHFI->idqLast.q) >> 1);
+    diffD = UTIL_SatShrS16((int32_t)pIdq->d - pHFI->idqLast.d, 0);
+    diffQ = UTIL_SatShrS16((int32_t)pIdq->q - pHFI->idqLast.q, 0);
+    pHFI->idqLast = *pIdq;
+    
+    /* Demodulate with the sign of injection voltage causing the response */
+    if (pHFI->injectionSign != pHFI->demodPolarity)
+    {
+        diffQ = -diffQ;
+    }
+    
+    /* Angle error = Q response / (Vh*(1/Ld - 1/Lq)*dt) */
+    error = UTIL_SatShrS16(__builtin_mulss(diffQ, pHFI->qErrorGain), 
+                                pHFI->qErrorGainScale);
+    pHFI->qErrorPLL = error;
+    
+    /* PLL PI controller, output is estimated speed */
+    pHFI->qOmega = UTIL_PIClamped(&pHFI->qOmegaIntStateVar, pHFI->qKpPLL, 
+                                    pHFI->qKiPLL, error);
+    
+    /* Integrate the estimated rotor velocity to get estimated rotor angle */  
+    pHFI->qThetaStateVar += __builtin_mulss(pHFI->qOmega, pHFI->qDeltaT);
+    
+    /* Filter the estimated  rotor velocity using a first order low-pass filter */
+    const int16_t Omegadiff = (int16_t) (pHFI->qOmega - pHFI->qOmegaFilt);
+    pHFI->qOmegaStateVar += __builtin_mulss(Omegadiff, pHFI->qOmegaFiltConst);
+    pHFI->qOmegaFilt = (int16_t) (pHFI->qOmegaStateVar >> 15);  
+    
+    /* Magnet polarity detection, response is summed over second half of the
+     * state after D axis current has settled */
+    switch (pHFI->state)
+    {
+        case HFI_ALIGN:
+            pHFI->qIdRef = 0;
+            if (++pHFI->stateTime >= pHFI->alignTimeLimit)
+            {
+                pHFI->stateTime = 0;
+                pHFI->responsePositive = 0;
+                pHFI->responseNegative = 0;
+                pHFI->state = HFI_POLARITY_POSITIVE;
+            }
+            break;
+            
+        case HFI_POLARITY_POSITIVE:
+            pHFI->qIdRef = pHFI->qPolarityCurrent;
+            if (pHFI->stateTime >= (pHFI->polarityTimeLimit >> 1))
+            {
+                pHFI->responsePositive += _Q15abs(diffD);
+            }
+            if (++pHFI->stateTime >= pHFI->polarityTimeLimit)
+            {
+                pHFI->stateTime = 0;
+                pHFI->state = HFI_POLARITY_NEGATIVE;
+            }
+            break;
+            
+        case HFI_POLARITY_NEGATIVE:
+            pHFI->qIdRef = -pHFI->qPolarityCurrent;
+            if (pHFI->stateTime >= (pHFI->polarityTimeLimit >> 1))
+            {
+                pHFI->responseNegative += _Q15abs(diffD);
+            }
+            if (++pHFI->stateTime >= pHFI->polarityTimeLimit)
+            {
+                /* Estimated angle is on -D axis, turn it by 180 degrees */
+                if (pHFI->responseNegative > pHFI->responsePositive)
+                {
+                    pHFI->qThetaStateVar += (int32_t)0x8000 << 15;
+                }
+                pHFI->qIdRef = 0;
+                pHFI->stateTime = 0;
+                pHFI->state = HFI_RUN;
+            }
+            break;
+            
+        case HFI_RUN:
+        default:
+            break;
+    }
+    pHFI->qTheta = (int16_t) (pHFI->qThetaStateVar >> 15);
+    
+    /* Square wave injection voltage for next control cycle */
+    pHFI->injectionSign = -pHFI->injectionSign;
+    if (pHFI->injectionSign > 0)
+    {
+        pHFI->qVdInjection = pHFI->qVdInjectionAmp;
+    }
+    else
+    {
+        pHFI->qVdInjection = -pHFI->qVdInjectionAmp;
+    }
+}
@@ -0,0 +1,174 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file hfi.h
+ *
+ * @brief This module implements high frequency injection angle estimator for
+ * zero and low speed operation of salient motors.
+ *
+ * Component: ESTIMATOR
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef __HFI_H
+#define __HFI_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="ENUMERATED CONSTANTS ">
+
+typedef enum
+{
+    HFI_ALIGN = 0,              /* Estimated angle converges to D or -D axis */
+    HFI_POLARITY_POSITIVE = 1,  /* Response measured with positive D bias */
+    HFI_POLARITY_NEGATIVE = 2,  /* Response measured with negative D bias */
+    HFI_RUN = 3,                /* Angle and speed estimate valid */
+
+}MCAPP_HFI_STATE_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to high frequency injection
+    estimator. A square wave voltage at half the control frequency is 
+    injected on estimated D axis; the Q axis current response is 
+    proportional to sin(2*angle error) on a salient motor(Ld < Lq). */
+        
+typedef struct
+{
+    /* Injection voltage amplitude and present injection voltage, zero
+       until the first estimator step */
+    int16_t qVdInjectionAmp,
+            qVdInjection;
+    /* Sign of the last injection voltage, 1 or -1 */
+    int16_t injectionSign;
+    /* 1 if response is caused by the last injection, -1 if by the one 
+       before, depends on PWM update delay */
+    int16_t demodPolarity;
+    /* Gain and scale to convert Q current response to angle error */
+    int16_t qErrorGain,
+            qErrorGainScale;
+    
+    /* PLL proportional and integral gains */
+    int16_t qKpPLL,
+            qKiPLL;
+    /* PLL phase error, angle error in Q15 radian */
+    int16_t qErrorPLL;
+    /* State variable for PLL integral term */
+    int32_t qOmegaIntStateVar;
+    /* Integration constant */
+    int16_t qDeltaT;
+    
+    /* angle of estimation */
+    int16_t qTheta;
+    /* internal variable for angle */
+    int32_t qThetaStateVar;
+    /* Estimated speed - PLL output and filtered */
+    int16_t qOmega,
+            qOmegaFilt;
+    /* Filter constant for Estimated speed */
+    int16_t qOmegaFiltConst;
+    /* State Variable for Estimated speed */
+    int32_t qOmegaStateVar;
+    
+    /* D axis current reference during polarity detection */
+    int16_t qPolarityCurrent,
+            qIdRef;
+    /* Sum of |D current response| with positive and negative D bias */
+    int32_t responsePositive,
+            responseNegative;
+    
+    uint16_t
+        state,              /* HFI state - MCAPP_HFI_STATE_T */
+        stateTime,          /* Time spent in present state */
+        alignTimeLimit,     /* Duration of HFI_ALIGN state */
+        polarityTimeLimit;  /* Duration of each polarity detection state */
+    
+    MC_DQ_T
+        idqLast,            /* Idq of previous control cycle */
+        idqFundamental;     /* Idq with injection response removed */
+    
+    const MC_DQ_T *pIdq;
+    
+} MCAPP_HFI_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_HFIInit (MCAPP_HFI_T *);
+void MCAPP_HFIReset (MCAPP_HFI_T *, int16_t, int16_t);
+void MCAPP_HFIStep (MCAPP_HFI_T *);
+
+/**
+* <B> Function: bool MCAPP_HFIIsReady(const MCAPP_HFI_T *)  </B>
+*
+* @brief Function to check if angle and polarity are detected.
+*
+* @param    pointer to the data structure containing HFI parameters.
+* @return   true if estimate can be used for torque production.
+* @example
+* <CODE> ready = MCAPP_HFIIsReady(&hfi); </CODE>
+*
+*/
+inline static bool MCAPP_HFIIsReady(const MCAPP_HFI_T *pHFI)
+{
+    return (pHFI->state == HFI_RUN);
+}
+
+// </editor-fold>
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif /* end of __HFI_H */
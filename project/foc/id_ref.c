@@ -57,7 +57,11 @@
 // </editor-fold>
 
 // <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
-static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *);
+static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *,
+                                                    int16_t);
+static void MCAPP_MTPAControl(MCAPP_MTPA_T *);
+static int16_t MCAPP_FluxFeedForward(const MCAPP_FLUX_WEAKENING_VOLT_FB_T *);
+inline static int16_t MCAPP_FluxInterpolate(int16_t, int16_t, int16_t);
 static void MCAPP_FluxControlVoltFeedbackInit(MCAPP_FLUX_WEAKENING_VOLT_FB_T *);
 // </editor-fold>
 
@@ -73,6 +77,7 @@ void MCAPP_FluxWeakeningControlInit(MCAPP_ID_REFERENCE_T *pIdRefGen)
 {
     MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFeedBackFW = &pIdRefGen->feedBackFW;
 
+    pIdRefGen->mtpa.IdRef = 0;
     MCAPP_FluxControlVoltFeedbackInit(pFeedBackFW);
 }
 /**
@@ -93,9 +98,12 @@ void MCAPP_FluxWeakeningControl(MCAPP_ID_REFERENCE_T *pIdRefGen)
 {
     MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFeedBackFW = &pIdRefGen->feedBackFW;
 
-    /* Calculate Flux Weakening Control current */
+    /* Calculate maximum torque per ampere current */
+    MCAPP_MTPAControl(&pIdRefGen->mtpa);
+    
+    /* Calculate Flux Weakening Control current, which adds to MTPA current */
 
-    MCAPP_FluxControlVoltFeedback(pFeedBackFW);
+    MCAPP_FluxControlVoltFeedback(pFeedBackFW, pIdRefGen->mtpa.IdRef);
 }
 
 /**
@@ -116,22 +124,31 @@ static void  MCAPP_FluxControlVoltFeedbackInit(MCAPP_FLUX_WEAKENING_VOLT_FB_T *p
     pFdWeak->FWeakPI.integrator = 0;
     pFdWeak->IdRefFiltStateVar = 0;
     pFdWeak->IdRef = 0;
+    pFdWeak->IdRefFeedForward = 0;
 }
 
 /**
-* <B> Function: MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T * )  </B>
+* <B> Function: MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *,
+*               int16_t)  </B>
 *
-* @brief Function implementing Field Weakening Control
+* @brief Function implementing Field Weakening Control. The feedforward 
+* table gives the Id needed to keep the voltage at its reference with zero 
+* Iq, the lower of it and the base Id reference is used. The voltage 
+* controller output adds to it, it is zero until voltage reaches the 
+* reference, so Id moves from the base reference into field weakening 
+* without a step and the controller only trims the feedforward.
 *
 * @param Pointer to the data structure containing Field Weakening Control
 *        parameters.
+* @param Base Id reference, MTPA current.
 * @return   none.
 * @example
-* <CODE> MCAPP_FluxControlVoltFeedback(&fieldWeak); </CODE>
+* <CODE> MCAPP_FluxControlVoltFeedback(&fieldWeak, IdRefMTPA); </CODE>
 *
 */
 
-static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFdWeak)
+static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFdWeak,
+                                                int16_t IdRefBase)
 {    
     const MC_DQ_T *pVdq         = pFdWeak->pVdq;
     const MCAPP_MOTOR_T *pMotor = pFdWeak->pMotor;
@@ -139,20 +156,43 @@ static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFdWea
 
     int16_t vdSqr, vqSqr, IdRefOut; 
 
-    /* Compute voltage vector magnitude */
-    vdSqr  = (int16_t)(__builtin_mulss(pVdq->d, pVdq->d) >> 15);
-    vqSqr  = (int16_t)(__builtin_mulss(pVdq->q, pVdq->q) >> 15);
-    pFdWeak->voltageMag = _Q15sqrt(vdSqr+vqSqr);
+    if (pFdWeak->feedForwardEnable)
+    {
+        pFdWeak->IdRefFeedForward = MCAPP_FluxFeedForward(pFdWeak);
+        if (pFdWeak->IdRefFeedForward < IdRefBase)
+        {
+            IdRefBase = pFdWeak->IdRefFeedForward;
+        }
+    }
     
     if((pCtrlParam->qVelRef > (pMotor->qNominalSpeed>>1)))
     { 
+        if (pFdWeak->voltageRefTrack)
+        {
+            /* Voltage reference is a fraction of the present voltage limit
+             * of current controllers */
+            pFdWeak->voltageMagRef = (int16_t)(__builtin_mulss(
+                *pFdWeak->pVoltageMax, pFdWeak->qVoltageRefFactor) >> 15);
+        }
+        
+        /* Compute voltage vector magnitude */
+        vdSqr  = (int16_t)(__builtin_mulss(pVdq->d, pVdq->d) >> 15);
+        vqSqr  = (int16_t)(__builtin_mulss(pVdq->q, pVdq->q) >> 15);
+        pFdWeak->voltageMag = _Q15sqrt(vdSqr+vqSqr);
+        
         /* Compute PI output: pFdWeak->IdRef */
         MCAPP_ControllerPIUpdate(pFdWeak->voltageMagRef, pFdWeak->voltageMag, 
             &pFdWeak->FWeakPI, MCAPP_SAT_NONE, &IdRefOut, pFdWeak->voltageMagRef); 
+        
+        IdRefOut = UTIL_SatShrS16((int32_t)IdRefOut + IdRefBase, 0);
+        if (IdRefOut < pFdWeak->IdRefMin)
+        {
+            IdRefOut = pFdWeak->IdRefMin;
+        }
     }
     else
     {
-        IdRefOut = 0 ;
+        IdRefOut = IdRefBase;
         
         /* Reset PI integrator to Nominal Idrefernce value for smooth transition
          * when switching to PI output computation. */
@@ -171,6 +211,116 @@ static void MCAPP_FluxControlVoltFeedback(MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFdWea
 #endif
 }
 
+/**
+* <B> Function: MCAPP_MTPAControl(MCAPP_MTPA_T *)  </B>
+*
+* @brief Function calculating maximum torque per ampere D axis current for 
+* the Q axis current reference. For a salient motor with Lq > Ld, torque per
+* ampere is highest at
+*   Id = a - sqrt(a^2 + Iq^2), a = Psi/(2*(Lq - Ld))
+* calculated as Id = -Iq^2/(a + sqrt(a^2 + Iq^2)), which keeps resolution 
+* when a is large compared to Iq. a and Iq are normalized to 13 bits for the
+* square root.
+*
+* @param Pointer to the data structure containing MTPA parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_MTPAControl(&mtpa); </CODE>
+*
+*/
+static void MCAPP_MTPAControl(MCAPP_MTPA_T *pMTPA)
+{
+    const int16_t iq = _Q15abs(pMTPA->pCtrlParam->qIqRef);
+    int32_t a = pMTPA->currentConst;
+    int32_t iqShifted = iq;
+    int32_t num;
+    int16_t shift = 0, root, den;
+    
+    if ((pMTPA->enable == 0) || (a <= 0) || (iq == 0))
+    {
+        pMTPA->IdRef = 0;
+        return;
+    }
+    
+    while ((a > (INT16_MAX >> 2)) || (iqShifted > (INT16_MAX >> 2)))
+    {
+        a >>= 1;
+        iqShifted >>= 1;
+        shift++;
+    }
+    while ((a <= (INT16_MAX >> 3)) && (iqShifted <= (INT16_MAX >> 3)))
+    {
+        a <<= 1;
+        iqShifted <<= 1;
+        shift--;
+    }
+    root = _Q15sqrt((int16_t)((__builtin_mulss((int16_t)a, (int16_t)a) + 
+            __builtin_mulss((int16_t)iqShifted, (int16_t)iqShifted)) >> 15));
+    den = (int16_t)a + root;
+    
+    num = __builtin_mulss(iq, iq);
+    num = (shift >= 0) ? (num >> shift) : (num << (-shift));
+    pMTPA->IdRef = -(int16_t)__builtin_divsd(num, den);
+}
+
+/**
+* <B> Function: MCAPP_FluxFeedForward(const MCAPP_FLUX_WEAKENING_VOLT_FB_T *)
+* </B>
+*
+* @brief Function reading the flux weakening feedforward table with bilinear
+* interpolation in speed reference and DC bus voltage. Speed reference 
+* leads the speed, so Id is in place before the voltage rises in fast 
+* accelerations.
+*
+* @param Pointer to the data structure containing Field Weakening Control
+*        parameters.
+* @return   Id reference.
+* @example
+* <CODE> IdRefFF = MCAPP_FluxFeedForward(&fieldWeak); </CODE>
+*
+*/
+static int16_t MCAPP_FluxFeedForward(const MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFdWeak)
+{
+    const int16_t stepMask = (1 << FW_FF_STEP_BITS) - 1;
+    const int16_t speed = _Q15abs(pFdWeak->pCtrlParam->qVelRef);
+    const int16_t speedIndex = speed >> FW_FF_STEP_BITS;
+    const int16_t speedFrac = speed & stepMask;
+    int16_t vdc = *pFdWeak->pVdc - pFdWeak->vdcTableMin;
+    int16_t vdcIndex, vdcFrac, id0, id1;
+    const int16_t *pRow;
+    
+    if (vdc < 0)
+    {
+        vdc = 0;
+    }
+    vdcIndex = vdc >> FW_FF_STEP_BITS;
+    vdcFrac = vdc & stepMask;
+    if (vdcIndex >= (FW_FF_VDC_POINTS - 1))
+    {
+        vdcIndex = FW_FF_VDC_POINTS - 2;
+        vdcFrac = stepMask + 1;
+    }
+    
+    pRow = pFdWeak->pFeedForwardTable + 
+                (vdcIndex * FW_FF_SPEED_POINTS) + speedIndex;
+    id0 = MCAPP_FluxInterpolate(pRow[0], pRow[1], speedFrac);
+    pRow += FW_FF_SPEED_POINTS;
+    id1 = MCAPP_FluxInterpolate(pRow[0], pRow[1], speedFrac);
+    
+    return MCAPP_FluxInterpolate(id0, id1, vdcFrac);
+}
 
+/**
+* <B> Function: MCAPP_FluxInterpolate(int16_t, int16_t, int16_t) </B>
+*
+* @brief Linear interpolation between two table values, fraction has 
+* FW_FF_STEP_BITS bits.
+*
+*/
+inline static int16_t MCAPP_FluxInterpolate(int16_t y0, int16_t y1, 
+                                                int16_t frac)
+{
+    return y0 + (int16_t)(__builtin_mulss(y1 - y0, frac) >> FW_FF_STEP_BITS);
+}
 
 // </editor-fold>
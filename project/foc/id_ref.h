@@ -62,6 +62,17 @@ extern "C" {
 #include "sat_pi/sat_pi.h"
 
 // </editor-fold>    
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Flux weakening feedforward table, rows of FW_FF_SPEED_POINTS Id values at
+ * speeds 0..1 per unit for FW_FF_VDC_POINTS DC bus voltages from the lowest 
+ * table voltage, both axes in steps of 2^FW_FF_STEP_BITS */
+#define FW_FF_SPEED_POINTS      9
+#define FW_FF_VDC_POINTS        5
+#define FW_FF_STEP_BITS         12
+
+// </editor-fold>
     
 // <editor-fold defaultstate="collapsed" desc="TYPE DEFINITIONS ">
 
@@ -73,7 +84,12 @@ typedef struct
         IdRefFiltConst,     /* Filter constant for Id */
         IdRefMin,           /* Lower limit on IdRef */
         voltageMag,         /* Voltage vector magnitude */
-        voltageMagRef;      /* Voltage vector magnitude reference */
+        voltageMagRef,      /* Voltage vector magnitude reference */
+        IdRefFeedForward,   /* Id Current reference from feedforward table */
+        feedForwardEnable,  /* Feedforward table enable */
+        vdcTableMin,        /* DC bus voltage of first table row */
+        voltageRefTrack,    /* Voltage reference follows *pVoltageMax */
+        qVoltageRefFactor;  /* Voltage reference per voltage limit */
             
     int32_t
         IdRefFiltStateVar;  /* Accumulation variable for IdRef filter */
@@ -83,9 +99,30 @@ typedef struct
     MCAPP_CONTROL_T *pCtrlParam;
     const MC_DQ_T *pVdq;
     const MCAPP_MOTOR_T *pMotor;
+    const int16_t *pVdc;
+    const int16_t *pVoltageMax;
+    /* Feedforward table, [FW_FF_VDC_POINTS][FW_FF_SPEED_POINTS] */
+    const int16_t *pFeedForwardTable;
 
 } MCAPP_FLUX_WEAKENING_VOLT_FB_T;
     
+/*
+ * Maximum torque per ampere data type
+ */
+
+typedef struct
+{
+    int16_t
+        IdRef,              /* MTPA Id Current reference */
+        enable;             /* MTPA enable, Id reference is 0 if disabled */
+    
+    int32_t
+        currentConst;       /* Psi/(2*(Lq - Ld)), Q15 per unit current */
+    
+    const MCAPP_CONTROL_T *pCtrlParam;
+    
+} MCAPP_MTPA_T;
+
 /*
  * Flux weakening control data type
  */
@@ -95,6 +132,9 @@ typedef struct
     int16_t 
         IdRefFilt;          /* Filtered Id Current reference */
     
+    MCAPP_MTPA_T
+        mtpa;               /* Maximum torque per ampere Structure */
+    
     MCAPP_FLUX_WEAKENING_VOLT_FB_T 
         feedBackFW;         /* Voltage feedback based Flux Weakening Structure */
     
@@ -0,0 +1,323 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file ipd.c
+ *
+ * @brief This module implements initial rotor position detection by inductance
+ * saturation pulses.
+ *
+ * Component: APPLICATION
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <libq.h>
+
+#include "ipd.h"
+#include "general.h"
+
+// </editor-fold> 
+
+// <editor-fold defaultstate="collapsed" desc="Definitions ">
+
+/* 1/sqrt(3) for Ibeta calculation */
+#define IPD_ONE_BY_SQRT3    Q15(0.57735)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static int16_t MCAPP_IPDProjection(const MCAPP_IPD_T *, uint16_t);
+static void MCAPP_IPDAngleCalculate(MCAPP_IPD_T *);
+static int16_t MCAPP_IPDAtan2(int16_t, int16_t);
+
+// </editor-fold> 
+
+// <editor-fold defaultstate="collapsed" desc="Global Variables  ">
+
+/* Cosine and sine of voltage vector angles (0,60..300 degrees) */
+static const int16_t ipdCosVector[IPD_VECTOR_COUNT] = 
+    {Q15(0.99997), Q15(0.5), Q15(-0.5), Q15(-1.0), Q15(-0.5), Q15(0.5)};
+static const int16_t ipdSinVector[IPD_VECTOR_COUNT] = 
+    {0, Q15(0.86603), Q15(0.86603), 0, Q15(-0.86603), Q15(-0.86603)};
+
+/* Cosine and sine of voltage vector angles (0,60..300 degrees) and of twice
+ * the angles, divided by 3 so that the sums are Fourier coefficients */
+static const int16_t ipdCos1[IPD_VECTOR_COUNT] = 
+    {Q15(0.33333), Q15(0.16667), Q15(-0.16667), Q15(-0.33333), Q15(-0.16667), 
+                                                                Q15(0.16667)};
+static const int16_t ipdSin1[IPD_VECTOR_COUNT] = 
+    {0, Q15(0.28868), Q15(0.28868), 0, Q15(-0.28868), Q15(-0.28868)};
+static const int16_t ipdCos2[IPD_VECTOR_COUNT] = 
+    {Q15(0.33333), Q15(-0.16667), Q15(-0.16667), Q15(0.33333), Q15(-0.16667),
+                                                                Q15(-0.16667)};
+static const int16_t ipdSin2[IPD_VECTOR_COUNT] = 
+    {0, Q15(0.28868), Q15(-0.28868), 0, Q15(0.28868), Q15(-0.28868)};
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_IPDInit(MCAPP_IPD_T *)  </B>
+*
+* @brief Function to start initial position detection.
+*
+* @param    pointer to the data structure containing IPD parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_IPDInit(&ipd); </CODE>
+*
+*/
+void MCAPP_IPDInit(MCAPP_IPD_T *pIPD)
+{
+    uint16_t index;
+    
+    for (index = 0; index < IPD_VECTOR_COUNT; index++)
+    {
+        pIPD->response[index] = 0;
+    }
+    pIPD->qTheta = 0;
+    pIPD->angleValid = 0;
+    pIPD->vectorIndex = 0;
+    pIPD->count = 0;
+    
+    pIPD->vector = IPD_VECTOR_ZERO;
+    pIPD->outputUpdate = 1;
+    pIPD->state = IPD_BOOTSTRAP;
+}
+
+/**
+* <B> Function: void MCAPP_IPDStep(MCAPP_IPD_T *)  </B>
+*
+* @brief Function executing initial position detection, called once every
+* control cycle. Each active voltage vector is applied for pulseCountLimit
+* cycles and the current along the vector is sampled at the end of the pulse,
+* then outputs are switched off until the current decays. The current is 
+* larger along the magnet north pole as the stator iron saturates, first
+* harmonic of the six responses gives angle including polarity. On salient
+* motors second harmonic gives a finer angle, which is then used with the
+* polarity from first harmonic.
+* Output overrides are synchronized to the PWM cycle start, which is also the
+* current sampling point, hence the current at the end of a pulse is sampled
+* one control cycle after the vector command that ends the pulse.
+* Caller applies vector command using HAL_MC1SetVoltageVector() or switches
+* off the outputs if outputUpdate is set.
+*
+* @param    pointer to the data structure containing IPD parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_IPDStep(&ipd); </CODE>
+*
+*/
+void MCAPP_IPDStep(MCAPP_IPD_T *pIPD)
+{
+    pIPD->outputUpdate = 0;
+    pIPD->count++;
+    
+    switch (pIPD->state)
+    {
+        case IPD_BOOTSTRAP:
+            if (pIPD->count >= pIPD->bootstrapCountLimit)
+            {
+                pIPD->count = 0;
+                pIPD->vector = IPD_VECTOR_OFF;
+                pIPD->outputUpdate = 1;
+                pIPD->state = IPD_DECAY;
+            }
+            break;
+            
+        case IPD_PULSE:
+            if (pIPD->count >= pIPD->pulseCountLimit)
+            {
+                pIPD->count = 0;
+                pIPD->vector = IPD_VECTOR_OFF;
+                pIPD->outputUpdate = 1;
+                pIPD->state = IPD_MEASURE;
+            }
+            break;
+            
+        case IPD_MEASURE:
+            pIPD->response[pIPD->vectorIndex] = 
+                                MCAPP_IPDProjection(pIPD, pIPD->vectorIndex);
+            pIPD->vectorIndex++;
+            pIPD->state = IPD_DECAY;
+            break;
+            
+        case IPD_DECAY:
+            if (pIPD->count >= pIPD->decayCountLimit)
+            {
+                pIPD->count = 0;
+                if (pIPD->vectorIndex < IPD_VECTOR_COUNT)
+                {
+                    /* Vectors are numbered 1 to 6 from phase A axis */
+                    pIPD->vector = pIPD->vectorIndex + 1;
+                    pIPD->outputUpdate = 1;
+                    pIPD->state = IPD_PULSE;
+                }
+                else
+                {
+                    MCAPP_IPDAngleCalculate(pIPD);
+                    pIPD->state = IPD_DONE;
+                }
+            }
+            break;
+            
+        case IPD_DONE:
+        default:
+            break;
+    }
+}
+
+/**
+* <B> Function: int16_t MCAPP_IPDProjection(const MCAPP_IPD_T *, uint16_t)  </B>
+*
+* @brief Function to calculate the measured current along a voltage vector.
+*
+* @param    pointer to the data structure containing IPD parameters.
+* @param    vector index, 0 for vector along phase A axis.
+* @return   current along the vector.
+*/
+static int16_t MCAPP_IPDProjection(const MCAPP_IPD_T *pIPD, uint16_t index)
+{
+    const int16_t ialpha = *pIPD->pIa;
+    const int16_t ibeta = UTIL_SatShrS16(__builtin_mulss(IPD_ONE_BY_SQRT3, 
+                                    UTIL_SatShrS16((int32_t)*pIPD->pIa + 
+                                    ((int32_t)*pIPD->pIb << 1), 1)), 14);
+    
+    /* Response = Ialpha*cos(vector angle) + Ibeta*sin(vector angle) */
+    return UTIL_SatShrS16(__builtin_mulss(ialpha, ipdCosVector[index]) + 
+                          __builtin_mulss(ibeta, ipdSinVector[index]), 15);
+}
+
+/**
+* <B> Function: void MCAPP_IPDAngleCalculate(MCAPP_IPD_T *)  </B>
+*
+* @brief Function to calculate rotor angle from the six responses.
+*
+* @param    pointer to the data structure containing IPD parameters.
+* @return   none.
+*/
+static void MCAPP_IPDAngleCalculate(MCAPP_IPD_T *pIPD)
+{
+    int32_t h1Alpha = 0, h1Beta = 0, h2Alpha = 0, h2Beta = 0;
+    int16_t theta2, delta;
+    uint16_t index;
+    
+    for (index = 0; index < IPD_VECTOR_COUNT; index++)
+    {
+        h1Alpha += __builtin_mulss(pIPD->response[index], ipdCos1[index]);
+        h1Beta += __builtin_mulss(pIPD->response[index], ipdSin1[index]);
+        h2Alpha += __builtin_mulss(pIPD->response[index], ipdCos2[index]);
+        h2Beta += __builtin_mulss(pIPD->response[index], ipdSin2[index]);
+    }
+    pIPD->qH1Alpha = UTIL_SatShrS16(h1Alpha, 15);
+    pIPD->qH1Beta = UTIL_SatShrS16(h1Beta, 15);
+    pIPD->qH2Alpha = UTIL_SatShrS16(h2Alpha, 15);
+    pIPD->qH2Beta = UTIL_SatShrS16(h2Beta, 15);
+    pIPD->qH1Mag = UTIL_MagnitudeApprox(pIPD->qH1Alpha, pIPD->qH1Beta);
+    pIPD->qH2Mag = UTIL_MagnitudeApprox(pIPD->qH2Alpha, pIPD->qH2Beta);
+    
+    if (pIPD->qH1Mag < pIPD->qResponseMin)
+    {
+        /* Saturation is too weak to tell the polarity */
+        pIPD->angleValid = 0;
+        return;
+    }
+    
+    pIPD->qTheta = MCAPP_IPDAtan2(pIPD->qH1Beta, pIPD->qH1Alpha);
+    if (pIPD->qH2Mag > pIPD->qH1Mag)
+    {
+        /* Saliency angle is D or -D axis, choose the one near first harmonic */
+        theta2 = MCAPP_IPDAtan2(pIPD->qH2Beta, pIPD->qH2Alpha) >> 1;
+        delta = theta2 - pIPD->qTheta;
+        if (_Q15abs(delta) > 0x4000)
+        {
+            theta2 += (int16_t)0x8000;
+        }
+        pIPD->qTheta = theta2;
+    }
+    pIPD->angleValid = 1;
+}
+
+/**
+* <B> Function: int16_t MCAPP_IPDAtan2(int16_t, int16_t)  </B>
+*
+* @brief Function to calculate angle of a vector, 65536 counts per 
+* revolution. atan(z) = z*(pi/4 + 0.273*(1 - z)) for 0 <= z <= 1, error is
+* below 0.25 degree.
+*
+* @param    y component.
+* @param    x component.
+* @return   angle.
+*/
+static int16_t MCAPP_IPDAtan2(int16_t y, int16_t x)
+{
+    const int16_t absX = _Q15abs(x);
+    const int16_t absY = _Q15abs(y);
+    int16_t ratio, angle;
+    
+    if (absX == absY)
+    {
+        angle = (absX == 0) ? 0 : 0x2000;
+    }
+    else
+    {
+        ratio = (absY < absX) ? __builtin_divf(absY, absX) : 
+                                __builtin_divf(absX, absY);
+        /* 0x2000 is pi/4, 2847 is 0.273 in the same unit */
+        angle = (int16_t)(__builtin_mulss(ratio, 0x2000 + 
+                    (int16_t)(__builtin_mulss(2847, 0x7FFF - ratio) >> 15)) >> 15);
+        if (absY > absX)
+        {
+            angle = 0x4000 - angle;
+        }
+    }
+    if (x < 0)
+    {
+        angle = (int16_t)0x8000 - angle;
+    }
+    if (y < 0)
+    {
+        angle = -angle;
+    }
+    return angle;
+}
@@ -0,0 +1,146 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file ipd.h
+ *
+ * @brief This module implements initial rotor position detection by inductance
+ * saturation pulses.
+ *
+ * Component: APPLICATION
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef IPD_H
+#define	IPD_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Number of active voltage vectors */
+#define IPD_VECTOR_COUNT    6
+/* Vector command to switch all outputs off */
+#define IPD_VECTOR_OFF      (int16_t)-1
+/* Zero voltage vector, all bottom switches on */
+#define IPD_VECTOR_ZERO     (int16_t)0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef enum
+{
+    IPD_BOOTSTRAP = 0,          /* Charge bootstrap capacitors */
+    IPD_PULSE = 1,              /* Active voltage vector applied */
+    IPD_MEASURE = 2,            /* Current at end of pulse is sampled */
+    IPD_DECAY = 3,              /* Outputs off, current decays */
+    IPD_DONE = 4,               /* Detection complete */
+
+}MCAPP_IPD_STATE_T;
+
+typedef struct
+{
+    int16_t
+        response[IPD_VECTOR_COUNT], /* Current along each voltage vector */
+        qH1Alpha,           /* First harmonic of response, alpha */
+        qH1Beta,            /* First harmonic of response, beta */
+        qH2Alpha,           /* Second harmonic of response, alpha */
+        qH2Beta,            /* Second harmonic of response, beta */
+        qH1Mag,             /* First harmonic magnitude */
+        qH2Mag,             /* Second harmonic magnitude */
+        qResponseMin,       /* Minimum first harmonic magnitude */
+        qTheta,             /* Detected rotor angle */
+        vector,             /* Voltage vector command, IPD_VECTOR_OFF or 0-7 */
+        outputUpdate;       /* Set when vector command has changed */
+
+    uint16_t
+        enable,             /* Detection enabled at start */
+        state,              /* Detection state - MCAPP_IPD_STATE_T */
+        vectorIndex,        /* Index of present vector */
+        count,              /* Time spent in present state */
+        bootstrapCountLimit,/* Bootstrap charging time */
+        pulseCountLimit,    /* Voltage pulse duration */
+        decayCountLimit,    /* Current decay time between pulses */
+        angleValid;         /* Detected angle can be used */
+
+    const int16_t
+        *pIa,               /* Pointer for Ia */
+        *pIb;               /* Pointer for Ib */
+
+}MCAPP_IPD_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_IPDInit(MCAPP_IPD_T *);
+void MCAPP_IPDStep(MCAPP_IPD_T *);
+
+/**
+* <B> Function: bool MCAPP_IPDIsComplete(const MCAPP_IPD_T *)  </B>
+*
+* @brief Function to check if initial position detection is complete.
+*
+* @param    pointer to the data structure containing IPD parameters.
+* @return   true if complete, angleValid tells if the angle was detected.
+* @example
+* <CODE> done = MCAPP_IPDIsComplete(&ipd); </CODE>
+*
+*/
+inline static bool MCAPP_IPDIsComplete(const MCAPP_IPD_T *pIPD)
+{
+    return (pIPD->state == IPD_DONE);
+}
+
+// </editor-fold>
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* IPD_H */
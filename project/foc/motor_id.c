@@ -0,0 +1,742 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file motor_id.c
+ *
+ * @brief This module identifies motor parameters on target: resistance by DC
+ * current injection, d and q axis inductance by voltage pulses, back EMF constant
+ * from an open loop spin and inertia from a torque step.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15abs and _Q15sqrt function use */
+#include <libq.h>
+#include "motor_id.h"
+#include "general.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Definitions ">
+
+/* Fractional bits of acceleration, speed change per control period */
+#define MOTOR_ID_ACCEL_QVALUE   15
+/* Minimum current change for resistance and inductance calculation */
+#define MOTOR_ID_DELTA_I_MIN    (int16_t)64
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static bool MCAPP_MotorIdAverage(MCAPP_MOTOR_ID_T *);
+static bool MCAPP_MotorIdPulses(MCAPP_MOTOR_ID_T *, int16_t, int16_t *);
+static void MCAPP_MotorIdSpinStart(MCAPP_MOTOR_ID_T *);
+static bool MCAPP_MotorIdCurrentStep(MCAPP_MOTOR_ID_T *);
+static void MCAPP_MotorIdForcedAngle(MCAPP_MOTOR_ID_T *);
+static void MCAPP_MotorIdBackEMF(MCAPP_MOTOR_ID_T *);
+static void MCAPP_MotorIdAccel(MCAPP_MOTOR_ID_T *, int16_t, uint16_t);
+static void MCAPP_MotorIdMechanics(MCAPP_MOTOR_ID_T *);
+static int32_t MCAPP_MotorIdShiftDivide(int32_t, int32_t, int16_t);
+static int16_t MCAPP_MotorIdDivide(int32_t, int16_t, uint16_t *);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_MotorIdInit(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Function to reset Motor Parameter Identification variables.
+*
+* @param    pointer to the data structure containing identification parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_MotorIdInit(&motorId); </CODE>
+*
+*/
+void MCAPP_MotorIdInit(MCAPP_MOTOR_ID_T *pId)
+{
+    pId->state = MOTOR_ID_RS_ALIGN;
+    pId->count = 0;
+    pId->avgCount = 0;
+    pId->pulseIndex = 0;
+    pId->voltageMode = 0;
+    pId->useEstimatorAngle = 0;
+    pId->paramUpdate = 0;
+    pId->tuneRequest = 0;
+    pId->resultValid = 0;
+    pId->riseCount = 0;
+    
+    pId->qIdRef = 0;
+    pId->qIqRef = 0;
+    pId->vdqRef.d = 0;
+    pId->vdqRef.q = 0;
+    pId->qTheta = 0;
+    pId->qOmega = 0;
+    pId->thetaStateVar = 0;
+    pId->omegaStateVar = 0;
+    
+    pId->sumVd = 0;
+    pId->sumVq = 0;
+    pId->sumId = 0;
+    pId->sumIq = 0;
+    pId->sumVoltTime = 0;
+    pId->sumDeltaI = 0;
+    pId->sumEs2 = 0;
+    
+    pId->tauMech = 0;
+    pId->qIqLoad = 0;
+    pId->qFriction = 0;
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdStep(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Function executing motor parameter identification, called every 
+* control cycle. The control scheme applies the current or voltage references
+* and the angle set here. Steps are:
+*   - Rs: rotor is aligned with D axis current at angle zero, Rs is the change
+*     of average D axis voltage over the change of current between two 
+*     current levels, which cancels inverter voltage errors
+*   - Ld, Lq: pairs of opposite voltage pulses on D and then Q axis, 
+*     L/dt = (V - Rs*I)*pulse time/current change
+*   - Current step: if enabled, the current controllers are tuned on the 
+*     identified parameters and checked with a D axis current step, 
+*     bandwidth is halved and the controllers retuned while it overshoots
+*   - Ke: open loop spin with Q axis current, back EMF is the average voltage 
+*     less the resistive and inductive drops, 1/Ke = speed/back EMF
+*   - Inertia and friction: identified parameters are handed to the 
+*     estimator, then equal positive and negative Q axis current steps 
+*     followed by a coast with zero current are applied in closed loop angle.
+*     Inertia, viscous friction and load follow from the three accelerations
+*     at their mean speeds.
+* A step that fails ends identification, parameters found so far are kept.
+*
+* @param    pointer to the data structure containing identification parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_MotorIdStep(&motorId); </CODE>
+*
+*/
+void MCAPP_MotorIdStep(MCAPP_MOTOR_ID_T *pId)
+{
+    const MCAPP_ESTIMATOR_T *pEstimInterface = pId->pEstimInterface;
+    const int16_t omega = pEstimInterface->pOutput->qOmega;
+    int16_t deltaV, deltaI;
+    uint16_t scale;
+    
+    switch (pId->state)
+    {
+        case MOTOR_ID_RS_ALIGN:
+            pId->qIdRef = pId->qCurrentLow;
+            if (MCAPP_MotorIdAverage(pId))
+            {
+                pId->qVdLow = pId->qVdAvg;
+                pId->qIdLow = pId->qIdAvg;
+                pId->qIdRef = pId->qCurrentHigh;
+                pId->state = MOTOR_ID_RS_HIGH;
+            }
+            break;
+            
+        case MOTOR_ID_RS_HIGH:
+            if (MCAPP_MotorIdAverage(pId))
+            {
+                deltaV = pId->qVdAvg - pId->qVdLow;
+                deltaI = pId->qIdAvg - pId->qIdLow;
+                pId->qIdRef = 0;
+                if ((deltaI > MOTOR_ID_DELTA_I_MIN) && (deltaV > 0))
+                {
+                    pId->rsScale = pId->rsScaleNominal;
+                    pId->qRs = MCAPP_MotorIdDivide(deltaV, deltaI, 
+                                                        &pId->rsScale);
+                    pId->resultValid |= MOTOR_ID_RS_VALID;
+                    pId->state = MOTOR_ID_LD;
+                }
+                else
+                {
+                    pId->state = MOTOR_ID_DONE;
+                }
+            }
+            break;
+            
+        case MOTOR_ID_LD:
+            if (pId->voltageMode == 0)
+            {
+                /* Let D axis current settle to zero before the pulses */
+                pId->count++;
+                if (pId->count >= pId->settleCountLimit)
+                {
+                    pId->count = 0;
+                    pId->voltageMode = 1;
+                }
+            }
+            else if (MCAPP_MotorIdPulses(pId, pId->pIdq->d, &pId->vdqRef.d))
+            {
+                if (pId->sumDeltaI > MOTOR_ID_DELTA_I_MIN)
+                {
+                    pId->lsDtScale = pId->lsDtScaleNominal;
+                    pId->qLdDt = MCAPP_MotorIdDivide(
+                                pId->sumVoltTime >> pId->pulseBits,
+                                (int16_t)(pId->sumDeltaI >> pId->pulseBits),
+                                &pId->lsDtScale);
+                    pId->resultValid |= MOTOR_ID_LD_VALID;
+                    pId->sumVoltTime = 0;
+                    pId->sumDeltaI = 0;
+                    pId->state = MOTOR_ID_LQ;
+                }
+                else
+                {
+                    pId->voltageMode = 0;
+                    pId->state = MOTOR_ID_DONE;
+                }
+            }
+            break;
+            
+        case MOTOR_ID_LQ:
+            if (MCAPP_MotorIdPulses(pId, pId->pIdq->q, &pId->vdqRef.q))
+            {
+                pId->voltageMode = 0;
+                if (pId->sumDeltaI > MOTOR_ID_DELTA_I_MIN)
+                {
+                    scale = pId->lsDtScale;
+                    pId->qLqDt = MCAPP_MotorIdDivide(
+                                pId->sumVoltTime >> pId->pulseBits,
+                                (int16_t)(pId->sumDeltaI >> pId->pulseBits),
+                                &scale);
+                    /* Ld and Lq share the scale */
+                    pId->qLdDt >>= (pId->lsDtScale - scale);
+                    pId->lsDtScale = scale;
+                    pId->resultValid |= MOTOR_ID_LQ_VALID;
+                    
+                    pId->tuneRequest = pId->currentTuneEnable;
+                    if (pId->currentTuneEnable && pId->stepTestEnable)
+                    {
+                        pId->state = MOTOR_ID_CURRENT_STEP;
+                    }
+                    else
+                    {
+                        MCAPP_MotorIdSpinStart(pId);
+                    }
+                }
+                else
+                {
+                    pId->state = MOTOR_ID_DONE;
+                }
+            }
+            break;
+            
+        case MOTOR_ID_CURRENT_STEP:
+            pId->tuneRequest = 0;
+            if (MCAPP_MotorIdCurrentStep(pId))
+            {
+                deltaI = pId->qCurrentHigh - pId->qCurrentLow;
+                deltaI = (int16_t)(__builtin_mulss(deltaI, pId->qOvershootMax)
+                                                                        >> 15);
+                if (((pId->qIPeak - pId->qCurrentHigh) > deltaI) &&
+                    (pId->qCurrentBandwidth > pId->qCurrentBandwidthMin))
+                {
+                    /* Retune with lower bandwidth and repeat the step */
+                    pId->qCurrentBandwidth >>= 1;
+                    pId->tuneRequest = 1;
+                }
+                else
+                {
+                    pId->resultValid |= MOTOR_ID_STEP_VALID;
+                    MCAPP_MotorIdSpinStart(pId);
+                }
+            }
+            break;
+            
+        case MOTOR_ID_KE_RAMP:
+            MCAPP_MotorIdForcedAngle(pId);
+            if (pId->qOmega >= pId->qSpinSpeed)
+            {
+                pId->count = 0;
+                pId->state = MOTOR_ID_KE_MEASURE;
+            }
+            break;
+            
+        case MOTOR_ID_KE_MEASURE:
+            MCAPP_MotorIdForcedAngle(pId);
+            MCAPP_MotorIdBackEMF(pId);
+            break;
+            
+        case MOTOR_ID_KE_LOCK:
+            pId->paramUpdate = 0;
+            MCAPP_MotorIdForcedAngle(pId);
+            pId->count++;
+            if ((pId->count >= pId->settleCountLimit) &&
+                pEstimInterface->MCAPP_EstimatorIsLocked(
+                                                    pEstimInterface->pEstim))
+            {
+                pId->useEstimatorAngle = 1;
+                pId->qIqRef = pId->qInertiaCurrent;
+                pId->qOmegaStart = omega;
+                pId->count = 0;
+                pId->state = MOTOR_ID_INERTIA_ACCEL;
+            }
+            else if (pId->count >= (pId->settleCountLimit << 2))
+            {
+                pId->qIqRef = 0;
+                pId->state = MOTOR_ID_DONE;
+            }
+            break;
+            
+        case MOTOR_ID_INERTIA_ACCEL:
+            pId->count++;
+            if (pId->count == pId->inertiaSettleCountLimit)
+            {
+                pId->qOmegaStart = omega;
+            }
+            else if ((pId->count > pId->inertiaSettleCountLimit) &&
+                ((omega >= (pId->qSpinSpeed + (pId->qSpinSpeed >> 1))) ||
+                (pId->count >= pId->inertiaCountLimit)))
+            {
+                MCAPP_MotorIdAccel(pId, omega, 0);
+                pId->qIqRef = -pId->qInertiaCurrent;
+                pId->state = MOTOR_ID_INERTIA_DECEL;
+            }
+            break;
+            
+        case MOTOR_ID_INERTIA_DECEL:
+            pId->count++;
+            if (pId->count == pId->inertiaSettleCountLimit)
+            {
+                pId->qOmegaStart = omega;
+            }
+            else if ((pId->count > pId->inertiaSettleCountLimit) &&
+                ((omega <= (pId->qSpinSpeed >> 1)) ||
+                (pId->count >= pId->inertiaCountLimit)))
+            {
+                MCAPP_MotorIdAccel(pId, omega, 1);
+                pId->qIqRef = 0;
+                pId->state = MOTOR_ID_INERTIA_COAST;
+            }
+            break;
+            
+        case MOTOR_ID_INERTIA_COAST:
+            pId->count++;
+            if (pId->count == pId->inertiaSettleCountLimit)
+            {
+                pId->qOmegaStart = omega;
+            }
+            else if ((pId->count > pId->inertiaSettleCountLimit) &&
+                ((omega <= (pId->qSpinSpeed >> 2)) ||
+                (pId->count >= pId->inertiaCountLimit)))
+            {
+                MCAPP_MotorIdAccel(pId, omega, 2);
+                MCAPP_MotorIdMechanics(pId);
+                pId->state = MOTOR_ID_DONE;
+            }
+            break;
+            
+        case MOTOR_ID_DONE:
+        default:
+            pId->qIdRef = 0;
+            pId->qIqRef = 0;
+            pId->voltageMode = 0;
+            pId->paramUpdate = 0;
+            pId->tuneRequest = 0;
+            break;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdSpinStart(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Starts the open loop spin with Q axis current from the aligned 
+* position.
+*
+* @return none.
+*/
+static void MCAPP_MotorIdSpinStart(MCAPP_MOTOR_ID_T *pId)
+{
+    pId->qIdRef = 0;
+    pId->qIqRef = pId->qSpinCurrent;
+    pId->thetaStateVar = 0;
+    pId->omegaStateVar = 0;
+    pId->count = 0;
+    pId->state = MOTOR_ID_KE_RAMP;
+}
+
+/**
+* <B> Function: bool MCAPP_MotorIdCurrentStep(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Holds D axis current at the low level for settleCountLimit control 
+* cycles, then steps it to the high level for stepCountLimit cycles, 
+* recording the peak current and the time to reach 90% of the step.
+*
+* @return true when the step is done.
+*/
+static bool MCAPP_MotorIdCurrentStep(MCAPP_MOTOR_ID_T *pId)
+{
+    const int16_t qCurrent = pId->pIdq->d;
+    const int16_t deltaI = pId->qCurrentHigh - pId->qCurrentLow;
+    const int16_t qRiseLevel = pId->qCurrentLow + 
+                        (int16_t)(__builtin_mulss(deltaI, Q15(0.9)) >> 15);
+    
+    pId->count++;
+    if (pId->count < pId->settleCountLimit)
+    {
+        pId->qIdRef = pId->qCurrentLow;
+        pId->qIPeak = qCurrent;
+        pId->riseCount = 0;
+        return false;
+    }
+    
+    pId->qIdRef = pId->qCurrentHigh;
+    if (qCurrent > pId->qIPeak)
+    {
+        pId->qIPeak = qCurrent;
+    }
+    if ((pId->riseCount == 0) && (qCurrent >= qRiseLevel))
+    {
+        pId->riseCount = pId->count - pId->settleCountLimit;
+    }
+    
+    if (pId->count >= (pId->settleCountLimit + pId->stepCountLimit))
+    {
+        pId->count = 0;
+        return true;
+    }
+    return false;
+}
+
+/**
+* <B> Function: bool MCAPP_MotorIdAverage(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Waits settleCountLimit control cycles, then averages D and Q axis 
+* voltages and currents over 2^averageBits control cycles.
+*
+* @return true when the averages are updated.
+*/
+static bool MCAPP_MotorIdAverage(MCAPP_MOTOR_ID_T *pId)
+{
+    if (pId->count < pId->settleCountLimit)
+    {
+        pId->count++;
+        return false;
+    }
+    
+    pId->sumVd += pId->pVdq->d;
+    pId->sumVq += pId->pVdq->q;
+    pId->sumId += pId->pIdq->d;
+    pId->sumIq += pId->pIdq->q;
+    pId->avgCount++;
+    if (pId->avgCount < (1 << pId->averageBits))
+    {
+        return false;
+    }
+    
+    pId->qVdAvg = (int16_t)(pId->sumVd >> pId->averageBits);
+    pId->qVqAvg = (int16_t)(pId->sumVq >> pId->averageBits);
+    pId->qIdAvg = (int16_t)(pId->sumId >> pId->averageBits);
+    pId->qIqAvg = (int16_t)(pId->sumIq >> pId->averageBits);
+    pId->sumVd = 0;
+    pId->sumVq = 0;
+    pId->sumId = 0;
+    pId->sumIq = 0;
+    pId->avgCount = 0;
+    pId->count = 0;
+    return true;
+}
+
+/**
+* <B> Function: bool MCAPP_MotorIdPulses(MCAPP_MOTOR_ID_T *, int16_t, 
+*               int16_t *)  </B>
+*
+* @brief Applies 2^pulseBits voltage pulses of alternating sign, each 
+* pulseCountLimit control cycles long, followed by decayCountLimit cycles of 
+* zero voltage. Duty cycle takes effect one control cycle later, so current
+* change is measured from the first to the (pulseCountLimit+1)th cycle after 
+* the pulse starts. Voltage*time less the resistive drop and current change 
+* are accumulated with the sign of the pulse.
+*
+* @return true when all pulses are done.
+*/
+static bool MCAPP_MotorIdPulses(MCAPP_MOTOR_ID_T *pId, int16_t qCurrent,
+                                    int16_t *pVoltageRef)
+{
+    const int16_t vPulse = (pId->pulseIndex & 1) ? 
+                                -pId->qPulseVoltage : pId->qPulseVoltage;
+    int16_t currentAvg, voltage;
+    
+    *pVoltageRef = (pId->count < pId->pulseCountLimit) ? vPulse : 0;
+    
+    if (pId->count == 1)
+    {
+        pId->qIStart = qCurrent;
+    }
+    else if (pId->count == (pId->pulseCountLimit + 1))
+    {
+        currentAvg = (int16_t)(((int32_t)pId->qIStart + qCurrent) >> 1);
+        voltage = vPulse - (int16_t)(__builtin_mulss(pId->qRs, currentAvg) 
+                                                        >> pId->rsScale);
+        if (vPulse > 0)
+        {
+            pId->sumVoltTime += __builtin_mulss(voltage, pId->pulseCountLimit);
+            pId->sumDeltaI += qCurrent - pId->qIStart;
+        }
+        else
+        {
+            pId->sumVoltTime -= __builtin_mulss(voltage, pId->pulseCountLimit);
+            pId->sumDeltaI -= qCurrent - pId->qIStart;
+        }
+    }
+    
+    pId->count++;
+    if (pId->count > (pId->pulseCountLimit + pId->decayCountLimit))
+    {
+        pId->count = 0;
+        pId->pulseIndex++;
+        if (pId->pulseIndex >= (1 << pId->pulseBits))
+        {
+            pId->pulseIndex = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdForcedAngle(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Ramps forced speed up to qSpinSpeed and integrates it to angle.
+*
+*/
+static void MCAPP_MotorIdForcedAngle(MCAPP_MOTOR_ID_T *pId)
+{
+    if (pId->qOmega < pId->qSpinSpeed)
+    {
+        pId->omegaStateVar += pId->omegaRampRate;
+        pId->qOmega = (int16_t)(pId->omegaStateVar >> 15);
+        if (pId->qOmega > pId->qSpinSpeed)
+        {
+            pId->qOmega = pId->qSpinSpeed;
+        }
+    }
+    pId->thetaStateVar += __builtin_mulss(pId->qOmega, pId->qDeltaT);
+    pId->qTheta = (int16_t)(pId->thetaStateVar >> 15);
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdBackEMF(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Calculates back EMF in the forced frame every control cycle, 
+* Es = V - Rs*I - j*w*Ls*I with Ls = (Ld+Lq)/2. After settleCountLimit cycles
+* |Es|^2 is averaged over 2^averageBits cycles and 1/Ke = w/RMS(|Es|).
+* Back EMF magnitude does not depend on the angle of the forced frame. The 
+* rotor swings around the forced angle with little damping; averaging the 
+* voltage vector before taking its magnitude would shrink it with the swing,
+* the mean square of the magnitude only grows with the speed ripple squared.
+*
+*/
+static void MCAPP_MotorIdBackEMF(MCAPP_MOTOR_ID_T *pId)
+{
+    int16_t reactance, ed, eq, emag;
+    
+    if (pId->count < pId->settleCountLimit)
+    {
+        pId->count++;
+        return;
+    }
+    
+    /* X = w*(L/dt)*dt, dt as electrical angle per control period */
+    reactance = UTIL_SatShrS16(__builtin_mulss(pId->qOmega, 
+                (int16_t)(((int32_t)pId->qLdDt + pId->qLqDt) >> 1)), 
+                pId->lsDtScale);
+    reactance = (int16_t)(__builtin_mulss(reactance, pId->qDeltaTheta) >> 15);
+    
+    ed = UTIL_SatShrS16((int32_t)pId->pVdq->d 
+            - (__builtin_mulss(pId->qRs, pId->pIdq->d) >> pId->rsScale)
+            + (__builtin_mulss(reactance, pId->pIdq->q) >> 15), 0);
+    eq = UTIL_SatShrS16((int32_t)pId->pVdq->q 
+            - (__builtin_mulss(pId->qRs, pId->pIdq->q) >> pId->rsScale)
+            - (__builtin_mulss(reactance, pId->pIdq->d) >> 15), 0);
+    pId->sumEs2 += UTIL_SatShrS16(__builtin_mulss(ed, ed) + 
+                                        __builtin_mulss(eq, eq), 15);
+    pId->avgCount++;
+    if (pId->avgCount < (1 << pId->averageBits))
+    {
+        return;
+    }
+    
+    emag = _Q15sqrt((int16_t)(pId->sumEs2 >> pId->averageBits));
+    pId->sumEs2 = 0;
+    pId->avgCount = 0;
+    
+    if (emag > 0)
+    {
+        pId->invKfiConstScale = pId->invKfiConstScaleNominal;
+        pId->qInvKfiConst = MCAPP_MotorIdDivide(pId->qOmega, emag, 
+                                                &pId->invKfiConstScale);
+        pId->resultValid |= MOTOR_ID_KE_VALID;
+        /* Control scheme hands the new parameters to the estimator */
+        pId->paramUpdate = 1;
+        pId->count = 0;
+        pId->state = MOTOR_ID_KE_LOCK;
+    }
+    else
+    {
+        pId->state = MOTOR_ID_DONE;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdAccel(MCAPP_MOTOR_ID_T *, int16_t, 
+*               uint16_t)  </B>
+*
+* @brief Records the mean acceleration and mean speed of a step from the 
+* speed after inertiaSettleCountLimit cycles, skipping the lag of the 
+* estimated speed behind the current step.
+*
+*/
+static void MCAPP_MotorIdAccel(MCAPP_MOTOR_ID_T *pId, int16_t omega,
+                                    uint16_t index)
+{
+    pId->accel[index] = ((int32_t)(omega - pId->qOmegaStart) 
+                                    << MOTOR_ID_ACCEL_QVALUE) / 
+                            (pId->count - pId->inertiaSettleCountLimit);
+    pId->qOmegaMean[index] = (int16_t)(((int32_t)omega + pId->qOmegaStart) 
+                                                                    >> 1);
+    pId->qOmegaStart = omega;
+    pId->count = 0;
+}
+
+/**
+* <B> Function: void MCAPP_MotorIdMechanics(MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Calculates mechanical time constant, viscous friction and load 
+* current from the accelerations a1, a2, a3 at mean speeds w1, w2, w3 with 
+* Q axis current I, -I and 0:
+*   tau*ak + B*wk + Iload = Ik
+* Subtracting the coast step removes the load:
+*   tau = I*(w1 + w2 - 2*w3)/det, B = -I*(a1 + a2 - 2*a3)/det
+*   det = (a1 - a3)*(w2 - w3) - (a2 - a3)*(w1 - w3)
+*   Iload = -tau*a3 - B*w3
+*
+*/
+static void MCAPP_MotorIdMechanics(MCAPP_MOTOR_ID_T *pId)
+{
+    const int16_t qI = pId->qInertiaCurrent;
+    const int16_t dw1 = pId->qOmegaMean[0] - pId->qOmegaMean[2];
+    const int16_t dw2 = pId->qOmegaMean[1] - pId->qOmegaMean[2];
+    int32_t da1 = pId->accel[0] - pId->accel[2];
+    int32_t da2 = pId->accel[1] - pId->accel[2];
+    int32_t daSum = da1 + da2;
+    int32_t det, friction, load;
+    int16_t shift = 0;
+    
+    /* Accelerations to 15 bits, products fit in 32 bits */
+    while ((da1 > (INT16_MAX >> 1)) || (da1 < -(INT16_MAX >> 1)) ||
+           (da2 > (INT16_MAX >> 1)) || (da2 < -(INT16_MAX >> 1)) ||
+           (daSum > (INT16_MAX >> 1)) || (daSum < -(INT16_MAX >> 1)))
+    {
+        da1 >>= 1;
+        da2 >>= 1;
+        daSum >>= 1;
+        shift++;
+    }
+    det = __builtin_mulss((int16_t)da1, dw2) - 
+                                __builtin_mulss((int16_t)da2, dw1);
+    if ((det <= 0) || (dw1 <= 0) || (dw2 <= 0))
+    {
+        return;
+    }
+    
+    /* Accelerations are shifted left by MOTOR_ID_ACCEL_QVALUE-shift */
+    pId->tauMech = MCAPP_MotorIdShiftDivide(
+                    __builtin_mulss(qI, (int16_t)(((int32_t)dw1 + dw2) >> 1)),
+                    det, MOTOR_ID_ACCEL_QVALUE + 1 - shift);
+    friction = MCAPP_MotorIdShiftDivide(
+                    -__builtin_mulss(qI, (int16_t)daSum), det, 15);
+    pId->qFriction = UTIL_SatShrS16(friction, 0);
+    load = -((pId->tauMech * pId->accel[2]) >> MOTOR_ID_ACCEL_QVALUE)
+            - (__builtin_mulss(pId->qFriction, pId->qOmegaMean[2]) >> 15);
+    pId->qIqLoad = UTIL_SatShrS16(load, 0);
+    pId->resultValid |= MOTOR_ID_INERTIA_VALID;
+}
+
+/**
+* <B> Function: int32_t MCAPP_MotorIdShiftDivide(int32_t, int32_t, int16_t)
+* </B>
+*
+* @brief Calculates (num << shift)/den for positive den, shifting num before
+* the division as far as it allows to keep resolution.
+*
+*/
+static int32_t MCAPP_MotorIdShiftDivide(int32_t num, int32_t den, 
+                                            int16_t shift)
+{
+    int32_t quotient;
+    
+    while ((shift > 0) && (num < (INT32_MAX >> 1)) && 
+            (num > -(INT32_MAX >> 1)))
+    {
+        num <<= 1;
+        shift--;
+    }
+    quotient = num / den;
+    return (shift >= 0) ? (quotient << shift) : (quotient >> (-shift));
+}
+
+/**
+* <B> Function: int16_t MCAPP_MotorIdDivide(int32_t, int16_t, uint16_t *) 
+* </B>
+*
+* @brief Calculates (num << scale)/den for positive num and den. Scale is 
+* reduced until the quotient fits in 16 bits.
+*
+*/
+static int16_t MCAPP_MotorIdDivide(int32_t num, int16_t den, uint16_t *pScale)
+{
+    while ((*pScale > 0) && (num >= ((int32_t)den << (15 - *pScale))))
+    {
+        (*pScale)--;
+    }
+    if (num >= ((int32_t)den << 15))
+    {
+        return INT16_MAX;
+    }
+    return __builtin_divsd(num << *pScale, den);
+}
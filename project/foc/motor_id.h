@@ -0,0 +1,253 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file motor_id.h
+ *
+ * @brief This module identifies motor parameters on target: resistance by DC
+ * current injection, d and q axis inductance by voltage pulses, back EMF constant
+ * from an open loop spin and inertia from a torque step.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+
+#ifndef __MOTOR_ID_H
+#define __MOTOR_ID_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+#include "estim_interface.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Identified parameters, bits of resultValid */
+#define MOTOR_ID_RS_VALID       0x0001
+#define MOTOR_ID_LD_VALID       0x0002
+#define MOTOR_ID_LQ_VALID       0x0004
+#define MOTOR_ID_KE_VALID       0x0008
+#define MOTOR_ID_INERTIA_VALID  0x0010  /* Inertia, friction and load */
+#define MOTOR_ID_STEP_VALID     0x0020
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+typedef enum
+{
+    MOTOR_ID_RS_ALIGN = 0,      /* Align rotor with D axis current */
+    MOTOR_ID_RS_HIGH = 1,       /* Measure D axis voltage at high current */
+    MOTOR_ID_LD = 2,            /* Voltage pulses on D axis */
+    MOTOR_ID_LQ = 3,            /* Voltage pulses on Q axis */
+    MOTOR_ID_CURRENT_STEP = 4,  /* D axis current step with tuned gains */
+    MOTOR_ID_KE_RAMP = 5,       /* Open loop speed ramp with Q axis current */
+    MOTOR_ID_KE_MEASURE = 6,    /* Measure voltages at constant speed */
+    MOTOR_ID_KE_LOCK = 7,       /* Wait for estimator lock on new parameters*/
+    MOTOR_ID_INERTIA_ACCEL = 8, /* Positive Q axis current step */
+    MOTOR_ID_INERTIA_DECEL = 9, /* Negative Q axis current step */
+    MOTOR_ID_INERTIA_COAST = 10,/* Coast with zero Q axis current */
+    MOTOR_ID_DONE = 11,         /* Identification complete */
+
+}MCAPP_MOTOR_ID_STATE_T;
+
+ /* Description:
+    This structure will host parameters related to motor parameter 
+    identification. Results use the per unit scaling of the control:
+    qRs and qLdDt/qLqDt as NORM_RS and NORM_LSDT, qInvKfiConst as 
+    NORM_INVKFI_CONST, the mechanical time constant as control periods to
+    accelerate to 1 per unit speed with 1 per unit Q axis current, and the 
+    viscous friction as Q axis current at 1 per unit speed in Q15. */
+        
+typedef struct
+{
+    /* Identification state - MCAPP_MOTOR_ID_STATE_T */
+    uint16_t state;
+    /* Time spent in present state or pulse */
+    uint16_t count;
+    /* Samples accumulated for averages */
+    uint16_t avgCount;
+    /* Present voltage pulse */
+    uint16_t pulseIndex;
+    /* Identification requested at next start */
+    uint16_t request;
+    /* Set when voltage references are applied without current control */
+    uint16_t voltageMode;
+    /* Set when control uses the estimator angle */
+    uint16_t useEstimatorAngle;
+    /* Set for one control cycle when identified parameters are to be used */
+    uint16_t paramUpdate;
+    /* Set for one control cycle when current controllers are to be tuned 
+     * with identified Rs, Ld, Lq and qCurrentBandwidth */
+    uint16_t tuneRequest;
+    /* Identified parameters - MOTOR_ID_xx_VALID bits */
+    uint16_t resultValid;
+    
+    /* Current references */
+    int16_t qIdRef;
+    int16_t qIqRef;
+    /* Voltage references in voltage mode */
+    MC_DQ_T vdqRef;
+    /* Forced angle and speed */
+    int16_t qTheta;
+    int16_t qOmega;
+    int32_t thetaStateVar;
+    int32_t omegaStateVar;
+    
+    /* Sums and averages of voltages and currents */
+    int32_t sumVd;
+    int32_t sumVq;
+    int32_t sumId;
+    int32_t sumIq;
+    int16_t qVdAvg;
+    int16_t qVqAvg;
+    int16_t qIdAvg;
+    int16_t qIqAvg;
+    /* Sum of squared back EMF magnitude */
+    int32_t sumEs2;
+    /* Voltage and current at low current for resistance */
+    int16_t qVdLow;
+    int16_t qIdLow;
+    /* Current at start of voltage pulse */
+    int16_t qIStart;
+    /* Sums of voltage*time and current change of the voltage pulses */
+    int32_t sumVoltTime;
+    int32_t sumDeltaI;
+    /* Speed at start, acceleration shifted by MOTOR_ID_ACCEL_QVALUE and mean
+     * speed of accelerate, decelerate and coast steps */
+    int16_t qOmegaStart;
+    int32_t accel[3];
+    int16_t qOmegaMean[3];
+    /* Peak current of current step */
+    int16_t qIPeak;
+    
+    /* Identified parameters */
+    int16_t qRs;
+    int16_t qLdDt;
+    int16_t qLqDt;
+    int16_t qInvKfiConst;
+    int16_t qIqLoad;
+    int16_t qFriction;
+    uint16_t rsScale;
+    uint16_t lsDtScale;
+    uint16_t invKfiConstScale;
+    int32_t tauMech;
+    /* Current controller bandwidth, crossover frequency*control period in 
+     * Q15, halved each time the current step overshoots */
+    int16_t qCurrentBandwidth;
+    /* Control periods for the current step to reach 90% */
+    uint16_t riseCount;
+    
+    /* Configuration */
+    int16_t qCurrentLow;
+    int16_t qCurrentHigh;
+    int16_t qPulseVoltage;
+    int16_t qSpinCurrent;
+    int16_t qSpinSpeed;
+    int16_t qInertiaCurrent;
+    /* Integration constant, to convert speed to angle */
+    int16_t qDeltaT;
+    /* Electrical angle per control period at 1 per unit speed, Q15 radian */
+    int16_t qDeltaTheta;
+    int32_t omegaRampRate;
+    uint16_t settleCountLimit;
+    uint16_t averageBits;
+    uint16_t pulseCountLimit;
+    uint16_t pulseBits;
+    uint16_t decayCountLimit;
+    uint16_t inertiaCountLimit;
+    uint16_t inertiaSettleCountLimit;
+    /* Current controllers are tuned after Ld and Lq are identified */
+    uint16_t currentTuneEnable;
+    /* Tuned current controllers are checked with a D axis current step */
+    uint16_t stepTestEnable;
+    uint16_t stepCountLimit;
+    /* Largest overshoot, fraction of the step in Q15 */
+    int16_t qOvershootMax;
+    /* Bandwidth is not reduced below this */
+    int16_t qCurrentBandwidthMin;
+    /* Scales of identified parameters, reduced if the value needs it */
+    uint16_t rsScaleNominal;
+    uint16_t lsDtScaleNominal;
+    uint16_t invKfiConstScaleNominal;
+    
+    const MC_DQ_T *pIdq;
+    const MC_DQ_T *pVdq;
+    const MCAPP_ESTIMATOR_T *pEstimInterface;
+    
+} MCAPP_MOTOR_ID_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_MotorIdInit (MCAPP_MOTOR_ID_T *);
+void MCAPP_MotorIdStep (MCAPP_MOTOR_ID_T *);
+
+/**
+* <B> Function: bool MCAPP_MotorIdIsComplete(const MCAPP_MOTOR_ID_T *)  </B>
+*
+* @brief Function to check if motor parameter identification is complete.
+*
+* @param    pointer to the data structure containing identification parameters.
+* @return   true if complete, resultValid tells which parameters were found.
+* @example
+* <CODE> done = MCAPP_MotorIdIsComplete(&motorId); </CODE>
+*
+*/
+inline static bool MCAPP_MotorIdIsComplete(const MCAPP_MOTOR_ID_T *pId)
+{
+    return (pId->state == MOTOR_ID_DONE);
+}
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __MOTOR_ID_H */
@@ -0,0 +1,273 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file overmodulation.c
+ *
+ * @brief This module implements overmodulation, which extends the output voltage of
+ * space vector modulation up to six-step operation.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* _Q15sqrt function use */
+#include <libq.h>
+#include "overmodulation.h"
+#include "general.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define Q15_ONE_BY_3        10923 /* 1/3 */
+#define Q15_ONE_BY_SQRT3    18919 /* 1/sqrt(3) */
+/* Square of linear limit, 1/3 */
+#define OVERMOD_LINEAR_SQUARE   10923
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Global Variables  ">
+
+/* Reference gain giving an output voltage fundamental equal to the voltage
+ * magnitude, calculated numerically for limited min-max zero sequence 
+ * modulation. Last point is six-step operation */
+static const int16_t overmodGainTable[OVERMOD_TABLE_POINTS] = 
+    {4096, 4101, 4113, 4131, 4157, 4193, 4243, 4318, 4459, 4760, 5152, 5684, 
+     6460, 7737, 10442, 27154, 32767};
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static int16_t MCAPP_OvermodulationGain(int16_t);
+inline static uint16_t MCAPP_OvermodulationDuty(int32_t, int16_t, uint16_t);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_OvermodulationInit(MCAPP_OVERMODULATION_T *)  </B>
+*
+* @brief Function to reset overmodulation states.
+*
+* @param Pointer to the data structure containing overmodulation parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_OvermodulationInit(&overmod); </CODE>
+*
+*/
+void MCAPP_OvermodulationInit(MCAPP_OVERMODULATION_T *pOvermod)
+{
+    pOvermod->active = 0;
+    pOvermod->qGain = (1 << OVERMOD_GAIN_QVALUE);
+    pOvermod->idFiltStateVar = 0;
+    pOvermod->iqFiltStateVar = 0;
+    pOvermod->idqFilt.d = 0;
+    pOvermod->idqFilt.q = 0;
+}
+
+/**
+* <B> Function: bool MCAPP_OvermodulationStep(MCAPP_OVERMODULATION_T *,
+*               MC_DUTYCYCLEOUT_T *)  </B>
+*
+* @brief Function calculating duty cycles when the voltage reference is above
+* the linear limit of space vector modulation. Duty cycles are min-max zero
+* sequence modulation of the references multiplied by the gain, limited to 
+* 0..dutyMax, which is space vector modulation in the linear range. 
+* References are scaled to the voltage range of 0..dutyMax, so that phase 
+* currents are sampled on the low side shunts at all duty cycles. Voltage 
+* applied by the inverter is calculated from the duty cycles.
+*
+* @param Pointer to the data structure containing overmodulation parameters.
+* @param Pointer to duty cycles.
+* @return   true if duty cycles are calculated, false in linear range.
+* @example
+* <CODE> if (!MCAPP_OvermodulationStep(&overmod, &pwmDuty)) {...} </CODE>
+*
+*/
+bool MCAPP_OvermodulationStep(MCAPP_OVERMODULATION_T *pOvermod, 
+                                MC_DUTYCYCLEOUT_T *pDuty)
+{
+    const MC_ABC_T *pVabc = pOvermod->pVabc;
+    const uint16_t period = pOvermod->dutyMax;
+    /* Q14 ratio of PWM period to duty range */
+    const uint16_t qRangeGain = __builtin_divud(
+                            (uint32_t)pOvermod->dutyHigh << 14, period);
+    MC_ABC_T vabc;
+    int16_t vAlpha, vBeta, vMagSquare, vMax, vMin, qVoltPerCount;
+    int32_t vZero, dutyMean;
+    
+    /* References in Q15 of the voltage of duty range */
+    vabc.a = UTIL_SatShrS16(__builtin_mulsu(pVabc->a, qRangeGain), 14);
+    vabc.b = UTIL_SatShrS16(__builtin_mulsu(pVabc->b, qRangeGain), 14);
+    vabc.c = UTIL_SatShrS16(__builtin_mulsu(pVabc->c, qRangeGain), 14);
+    
+    vAlpha = vabc.a;
+    vBeta = (int16_t)((__builtin_mulss(vabc.b, Q15_ONE_BY_SQRT3) - 
+                        __builtin_mulss(vabc.c, Q15_ONE_BY_SQRT3)) >> 15);
+    vMagSquare = (int16_t)((__builtin_mulss(vAlpha, vAlpha) + 
+                        __builtin_mulss(vBeta, vBeta)) >> 15);
+    
+    if ((pOvermod->enable == 0) || (vMagSquare <= OVERMOD_LINEAR_SQUARE))
+    {
+        pOvermod->active = 0;
+        return false;
+    }
+    pOvermod->active = 1;
+    
+    pOvermod->qGain = MCAPP_OvermodulationGain(_Q15sqrt(vMagSquare));
+    
+    /* Min-max zero sequence */
+    vMax = (vabc.a > vabc.b) ? vabc.a : vabc.b;
+    vMax = (vMax > vabc.c) ? vMax : vabc.c;
+    vMin = (vabc.a < vabc.b) ? vabc.a : vabc.b;
+    vMin = (vMin < vabc.c) ? vMin : vabc.c;
+    vZero = -(((int32_t)vMax + vMin) >> 1);
+    
+    pDuty->dutycycle1 = MCAPP_OvermodulationDuty(vabc.a + vZero, 
+                                                pOvermod->qGain, period);
+    pDuty->dutycycle2 = MCAPP_OvermodulationDuty(vabc.b + vZero, 
+                                                pOvermod->qGain, period);
+    pDuty->dutycycle3 = MCAPP_OvermodulationDuty(vabc.c + vZero, 
+                                                pOvermod->qGain, period);
+    
+    /* Applied phase voltages in PWM counts, common mode removed */
+    dutyMean = __builtin_mulss((int16_t)(pDuty->dutycycle1 + 
+                    pDuty->dutycycle2 + pDuty->dutycycle3), Q15_ONE_BY_3) >> 15;
+    vAlpha = (int16_t)(pDuty->dutycycle1 - dutyMean);
+    vBeta = (int16_t)(__builtin_mulss((int16_t)(pDuty->dutycycle2 - 
+                    pDuty->dutycycle3), Q15_ONE_BY_SQRT3) >> 15);
+    
+    qVoltPerCount = (int16_t)(__builtin_mulss(*pOvermod->pVdc, 
+                    pOvermod->qVoltPerCount) >> (15 + 12 - OVERMOD_VOLT_QVALUE));
+    pOvermod->valphabetaOut.alpha = (int16_t)(__builtin_mulss(vAlpha, 
+                    qVoltPerCount) >> OVERMOD_VOLT_QVALUE);
+    pOvermod->valphabetaOut.beta = (int16_t)(__builtin_mulss(vBeta, 
+                    qVoltPerCount) >> OVERMOD_VOLT_QVALUE);
+    
+    return true;
+}
+
+/**
+* <B> Function: void MCAPP_OvermodulationCurrentFilter(
+*               MCAPP_OVERMODULATION_T *)  </B>
+*
+* @brief Function filtering D and Q axis currents for the current controllers
+* during overmodulation. Filter runs at all times so the filtered currents 
+* are ready when overmodulation starts.
+*
+* @param Pointer to the data structure containing overmodulation parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_OvermodulationCurrentFilter(&overmod); </CODE>
+*
+*/
+void MCAPP_OvermodulationCurrentFilter(MCAPP_OVERMODULATION_T *pOvermod)
+{
+    pOvermod->idFiltStateVar += __builtin_mulss((pOvermod->pIdq->d - 
+                    pOvermod->idqFilt.d), pOvermod->qCurrentFilterConst);
+    pOvermod->idqFilt.d = (int16_t)(pOvermod->idFiltStateVar >> 15);
+    pOvermod->iqFiltStateVar += __builtin_mulss((pOvermod->pIdq->q - 
+                    pOvermod->idqFilt.q), pOvermod->qCurrentFilterConst);
+    pOvermod->idqFilt.q = (int16_t)(pOvermod->iqFiltStateVar >> 15);
+}
+
+/**
+* <B> Function: MCAPP_OvermodulationGain(int16_t) </B>
+*
+* @brief Reference gain for voltage magnitude, linear interpolation in the 
+* gain table.
+*
+*/
+static int16_t MCAPP_OvermodulationGain(int16_t vMagnitude)
+{
+    const int16_t offset = vMagnitude - OVERMOD_TABLE_START;
+    const int16_t index = offset >> OVERMOD_TABLE_STEP_BITS;
+    const int16_t frac = offset & ((1 << OVERMOD_TABLE_STEP_BITS) - 1);
+    
+    if (offset <= 0)
+    {
+        return overmodGainTable[0];
+    }
+    if (index >= (OVERMOD_TABLE_POINTS - 1))
+    {
+        return overmodGainTable[OVERMOD_TABLE_POINTS - 1];
+    }
+    return overmodGainTable[index] + (int16_t)(__builtin_mulss(
+                overmodGainTable[index + 1] - overmodGainTable[index], frac) 
+                >> OVERMOD_TABLE_STEP_BITS);
+}
+
+/**
+* <B> Function: MCAPP_OvermodulationDuty(int32_t, int16_t, uint16_t) </B>
+*
+* @brief Duty cycle of a phase for a reference including zero sequence, in 
+* Q15 of the voltage of duty range, limited to 0..period.
+*
+*/
+inline static uint16_t MCAPP_OvermodulationDuty(int32_t reference, 
+                                            int16_t qGain, uint16_t period)
+{
+    int32_t duty;
+    
+    /* Limit reference to +-0.5 before multiplication, duty is 0 or 
+     * period beyond it */
+    if (reference > INT16_MAX)
+    {
+        reference = INT16_MAX;
+    }
+    else if (reference < INT16_MIN)
+    {
+        reference = INT16_MIN;
+    }
+    duty = __builtin_mulss((int16_t)reference, qGain) >> OVERMOD_GAIN_QVALUE;
+    if (duty > 16384)
+    {
+        duty = 16384;
+    }
+    else if (duty < -16384)
+    {
+        duty = -16384;
+    }
+    /* Offset to 0..1 so that duty is exactly 0 and period at the limits */
+    return (uint16_t)(__builtin_muluu((uint16_t)(duty + 16384), period) >> 15);
+}
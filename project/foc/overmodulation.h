@@ -0,0 +1,141 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file overmodulation.h
+ *
+ * @brief This module implements overmodulation, which extends the output voltage of
+ * space vector modulation up to six-step operation.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __OVERMODULATION_H
+#define __OVERMODULATION_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Reference gain table, points from voltage magnitude OVERMOD_TABLE_START 
+ * in steps of 2^OVERMOD_TABLE_STEP_BITS, Q15 of DC bus voltage */
+#define OVERMOD_TABLE_POINTS        17
+#define OVERMOD_TABLE_START         18919   /* 1/sqrt(3), linear limit */
+#define OVERMOD_TABLE_STEP_BITS     7
+/* Fractional bits of reference gain */
+#define OVERMOD_GAIN_QVALUE         12
+/* Fractional bits added to the voltage per duty count after scaling with 
+ * DC bus voltage */
+#define OVERMOD_VOLT_QVALUE         8
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to overmodulation. Duty 
+    cycles are limited to dutyMax instead of the PWM period, so that the low 
+    side switch of each phase is on long enough to sample phase current, 
+    which scales the voltages below by dutyMax/dutyHigh. Above the linear 
+    limit of space vector modulation, DC bus voltage/sqrt(3), the phase 
+    voltage references are multiplied by a gain and duty cycles are limited 
+    to 0..dutyMax. The gain is read from a table for the voltage magnitude, 
+    so that the fundamental of the output voltage follows the reference up 
+    to six-step operation, 2/pi*DC bus voltage. Output voltage 
+    has 5th and 7th harmonics in this range, the current controllers can use 
+    filtered currents to keep the 6th harmonic in D and Q axis currents out 
+    of the voltage reference. */
+
+typedef struct
+{
+    /* Present reference gain */
+    int16_t qGain;
+    /* Phase voltage per PWM count at full DC bus voltage, in Q27 of voltage 
+     * base */
+    int16_t qVoltPerCount;
+    
+    /* Current feedback filter constant and state variables */
+    int16_t qCurrentFilterConst;
+    int32_t idFiltStateVar,
+            iqFiltStateVar;
+    /* Filtered D and Q axis currents */
+    MC_DQ_T idqFilt;
+    
+    /* Voltage applied by the inverter during overmodulation */
+    MC_ALPHABETA_T valphabetaOut;
+    
+    uint16_t
+        enable,             /* Overmodulation enable */
+        active,             /* Voltage reference is above linear limit */
+        dutyHigh,           /* Duty at positive rail, PWM period */
+        dutyMax;            /* Highest duty, low side switch is on long 
+                             * enough to sample phase current, MAX_DUTY */
+    
+    /* Phase voltage references, Q15 of DC bus voltage */
+    const MC_ABC_T *pVabc;
+    const MC_DQ_T *pIdq;
+    const int16_t *pVdc;
+    
+} MCAPP_OVERMODULATION_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_OvermodulationInit(MCAPP_OVERMODULATION_T *);
+bool MCAPP_OvermodulationStep(MCAPP_OVERMODULATION_T *, MC_DUTYCYCLEOUT_T *);
+void MCAPP_OvermodulationCurrentFilter(MCAPP_OVERMODULATION_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __OVERMODULATION_H */
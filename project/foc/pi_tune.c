@@ -0,0 +1,265 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file pi_tune.c
+ *
+ * @brief This module calculates PI controller gains from motor parameters.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "pi_tune.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static int32_t MCAPP_PITuneMultiply(int32_t, int32_t, int16_t *);
+static uint16_t MCAPP_PITuneSqrt(uint32_t);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_PITuneGain(int32_t, int16_t, int16_t *, 
+*               int16_t *)  </B>
+*
+* @brief Function to convert a gain to the coefficient and normalizing term
+* of the PI controller, gain = k * 2^nk / 2^15. The normalizing term is 
+* chosen to place the coefficient between 0.5 and 1 in Q15, which keeps the
+* full resolution of the coefficient for small and large gains.
+*
+* @param    gain, positive.
+* @param    fractional bits of the gain.
+* @param    pointer to coefficient.
+* @param    pointer to normalizing term.
+* @return   none.
+* @example
+* <CODE> MCAPP_PITuneGain(gain, 20, &pi.kp, &pi.nkp); </CODE>
+*
+*/
+void MCAPP_PITuneGain(int32_t gain, int16_t qValue, int16_t *pK, int16_t *pN)
+{
+    int16_t scale = 15 - qValue;
+    
+    while (((gain > INT16_MAX) || (scale < PI_TUNE_SCALE_MIN)) && 
+            (scale < PI_TUNE_SCALE_MAX))
+    {
+        gain >>= 1;
+        scale++;
+    }
+    while ((gain > 0) && (gain <= (INT16_MAX >> 1)) && 
+            (scale > PI_TUNE_SCALE_MIN))
+    {
+        gain <<= 1;
+        scale--;
+    }
+    if (gain > INT16_MAX)
+    {
+        gain = INT16_MAX;
+    }
+    else if (gain < 0)
+    {
+        gain = 0;
+    }
+    
+    *pK = (int16_t)gain;
+    *pN = scale;
+}
+
+/**
+* <B> Function: void MCAPP_PITuneCurrent(MCAPP_PISTATE_T *, int16_t, 
+*               int16_t, int16_t, int16_t, int16_t)  </B>
+*
+* @brief Function to calculate current controller gains by pole zero 
+* cancellation. The controller zero is placed on the winding pole R/L, which
+* leaves an integrator with crossover at the bandwidth:
+*   Kp = bandwidth * L,  Ki = bandwidth * R * control period.
+* In per unit with L/dt scaled as NORM_LSDT and R as NORM_RS this becomes
+*   Kp = bandwidth*dt * L/dt,  Ki = bandwidth*dt * R.
+* Bandwidth is limited to PI_TUNE_BANDWIDTH_MAX.
+*
+* @param    pointer to the PI controller state.
+* @param    bandwidth, crossover frequency*control period in Q15.
+* @param    resistance, scaled as NORM_RS.
+* @param    fractional bits of resistance.
+* @param    inductance/control period, scaled as NORM_LSDT.
+* @param    fractional bits of inductance/control period.
+* @return   none.
+* @example
+* <CODE> MCAPP_PITuneCurrent(&piDCurrent, qBandwidth, qRs, rsScale, qLdDt,
+*                           lsDtScale); </CODE>
+*
+*/
+void MCAPP_PITuneCurrent(MCAPP_PISTATE_T *pPI, int16_t qBandwidth,
+                    int16_t qR, int16_t rScale, int16_t qLDt, int16_t lDtScale)
+{
+    if (qBandwidth > PI_TUNE_BANDWIDTH_MAX)
+    {
+        qBandwidth = PI_TUNE_BANDWIDTH_MAX;
+    }
+    
+    MCAPP_PITuneGain(__builtin_mulss(qBandwidth, qLDt), 15 + lDtScale,
+                        &pPI->kp, &pPI->nkp);
+    MCAPP_PITuneGain(__builtin_mulss(qBandwidth, qR), 15 + rScale,
+                        &pPI->ki, &pPI->nki);
+}
+
+/**
+* <B> Function: void MCAPP_PITuneSpeed(MCAPP_PISTATE_T *, 
+*               MCAPP_SPEED_TUNE_T *, int32_t, int16_t)  </B>
+*
+* @brief Function to calculate speed controller gains for the bandwidth and 
+* phase margin of the design from mechanical time constant and friction. 
+* Proportional gain sets the loop gain to 1 at the crossover frequency:
+*   Kp = gain factor * |tau*j*bandwidth + B|
+*   Ki = Kp * integral ratio
+* The controller zero is placed for the phase margin of a friction free 
+* plant, friction adds phase margin.
+*
+* @param    pointer to the PI controller state.
+* @param    pointer to the speed controller design.
+* @param    mechanical time constant, control periods to accelerate to 1 per
+*           unit speed with 1 per unit Q axis current.
+* @param    viscous friction, Q axis current at 1 per unit speed in Q15.
+* @return   none.
+* @example
+* <CODE> MCAPP_PITuneSpeed(&piSpeed, &speedTune, tauMech, qFriction); </CODE>
+*
+*/
+void MCAPP_PITuneSpeed(MCAPP_PISTATE_T *pPI, MCAPP_SPEED_TUNE_T *pTune,
+                            int32_t tauMech, int16_t qFriction)
+{
+    int32_t plant, friction, gain;
+    int16_t plantBits = 30, frictionBits = 15, gainBits;
+    uint16_t magnitude, factor;
+    
+    if (tauMech <= 0)
+    {
+        return;
+    }
+    friction = (qFriction > 0) ? qFriction : 0;
+    
+    /* tau*bandwidth and friction to common fractional bits, 14 bits */
+    plant = MCAPP_PITuneMultiply(tauMech, pTune->bandwidth, &plantBits);
+    while ((frictionBits < plantBits) && (friction <= (INT32_MAX >> 1)))
+    {
+        friction <<= 1;
+        frictionBits++;
+    }
+    while (frictionBits > plantBits)
+    {
+        friction >>= 1;
+        frictionBits--;
+    }
+    plant >>= (plantBits - frictionBits);
+    plantBits = frictionBits;
+    while ((plant > (INT16_MAX >> 1)) || (friction > (INT16_MAX >> 1)))
+    {
+        plant >>= 1;
+        friction >>= 1;
+        plantBits--;
+    }
+    magnitude = MCAPP_PITuneSqrt(
+                    (uint32_t)__builtin_mulss((int16_t)plant, (int16_t)plant) +
+                    (uint32_t)__builtin_mulss((int16_t)friction, 
+                                                        (int16_t)friction));
+    
+    /* Gain factor in Q14 */
+    factor = MCAPP_PITuneSqrt((uint32_t)pTune->gainSquare);
+    gain = (int32_t)__builtin_muluu(magnitude, factor);
+    MCAPP_PITuneGain(gain, plantBits + 14, &pPI->kp, &pPI->nkp);
+    
+    gainBits = plantBits + 14 + 30;
+    gain = MCAPP_PITuneMultiply(gain, pTune->integralRatio, &gainBits);
+    MCAPP_PITuneGain(gain, gainBits, &pPI->ki, &pPI->nki);
+    
+    pTune->tauMech = tauMech;
+}
+
+/**
+* <B> Function: int32_t MCAPP_PITuneMultiply(int32_t, int32_t, int16_t *) 
+* </B>
+*
+* @brief Multiplies two positive values, reducing each to 16 bits first. 
+* Fractional bits of the product are updated.
+*
+*/
+static int32_t MCAPP_PITuneMultiply(int32_t a, int32_t b, int16_t *pQ)
+{
+    while (a > INT16_MAX)
+    {
+        a >>= 1;
+        (*pQ)--;
+    }
+    while (b > INT16_MAX)
+    {
+        b >>= 1;
+        (*pQ)--;
+    }
+    return __builtin_mulss((int16_t)a, (int16_t)b);
+}
+
+/**
+* <B> Function: uint16_t MCAPP_PITuneSqrt(uint32_t)  </B>
+*
+* @brief Integer square root, bit by bit.
+*
+*/
+static uint16_t MCAPP_PITuneSqrt(uint32_t x)
+{
+    uint16_t root = 0;
+    uint16_t bit = 0x8000;
+    uint16_t trial;
+    
+    while (bit)
+    {
+        trial = root | bit;
+        if (__builtin_muluu(trial, trial) <= x)
+        {
+            root = trial;
+        }
+        bit >>= 1;
+    }
+    return root;
+}
@@ -0,0 +1,116 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file pi_tune.h
+ *
+ * @brief This module calculates PI controller gains from motor parameters.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __PI_TUNE_H
+#define __PI_TUNE_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "sat_pi/sat_pi.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Highest current loop bandwidth, crossover frequency*control period in Q15.
+ * With one and a half control periods of delay from sampling to PWM update,
+ * 0.35 leaves 60 degrees of phase margin */
+#define PI_TUNE_BANDWIDTH_MAX   (int16_t)11469
+/* Limits of the gain normalizing term, shift range of the accumulator */
+#define PI_TUNE_SCALE_MIN       (int16_t)(-15)
+#define PI_TUNE_SCALE_MAX       (int16_t)15
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host the speed controller design. The plant from Q 
+    axis current to speed is 1/(tau*s + B) with the mechanical time constant
+    tau and viscous friction B, followed by the lag of current controller and
+    speed filters. Bandwidth and phase margin give gain factor and integral 
+    ratio, which are constant, so gains scale with the identified tau. */
+
+typedef struct
+{
+    /* Bandwidth, crossover frequency*control period in Q30 */
+    int32_t bandwidth;
+    /* Square of gain factor, controller gain over plant gain at crossover
+     * frequency, in Q28 */
+    int32_t gainSquare;
+    /* Integral gain per control period over proportional gain in Q30 */
+    int32_t integralRatio;
+    /* Mechanical time constant the present gains are calculated for */
+    int32_t tauMech;
+    /* Speed controller gains follow identified mechanical time constant */
+    uint16_t enable;
+    
+} MCAPP_SPEED_TUNE_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_PITuneGain(int32_t, int16_t, int16_t *, int16_t *);
+void MCAPP_PITuneCurrent(MCAPP_PISTATE_T *, int16_t, int16_t, int16_t, 
+                            int16_t, int16_t);
+void MCAPP_PITuneSpeed(MCAPP_PISTATE_T *, MCAPP_SPEED_TUNE_T *, int32_t, 
+                            int16_t);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __PI_TUNE_H */
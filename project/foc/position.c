@@ -0,0 +1,527 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file position.c
+ *
+ * @brief This module implements position control on top of the speed controller
+ * with a multi-turn position from the estimated rotor angle.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "general.h"
+#include "position.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Distance to target used for the profile is limited to this many counts,
+ * which keeps the profile calculations in 32 bits */
+#define POSITION_ERROR_MAX          ((int32_t)1 << 30)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static void MCAPP_PositionRequest(MCAPP_POSITION_T *);
+static void MCAPP_PositionProfile(MCAPP_POSITION_T *);
+static void MCAPP_PositionHoming(MCAPP_POSITION_T *);
+static int32_t MCAPP_PositionStopDistance(int32_t, uint16_t);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_PositionInit(MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to reset position control at motor start. The position is
+* kept, the position reference is set to it and pending requests are 
+* dropped.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_PositionInit(&position); </CODE>
+*
+*/
+void MCAPP_PositionInit(MCAPP_POSITION_T *pPosition)
+{
+    pPosition->thetaLast = *pPosition->pTheta;
+    pPosition->positionRef = pPosition->position;
+    pPosition->positionRefFrac = 0;
+    pPosition->target = pPosition->position;
+    pPosition->velocity = 0;
+    pPosition->qIqFeedForward = 0;
+    pPosition->state = MCAPP_POSITION_HOLD;
+    pPosition->request = MCAPP_POSITION_REQUEST_NONE;
+    pPosition->active = 0;
+    pPosition->homeStallCount = 0;
+    pPosition->count = 0;
+}
+
+/**
+* <B> Function: void MCAPP_PositionAccumulate(MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to add the change of the rotor angle to the position. It
+* is called every control cycle with a valid rotor angle, so that the angle 
+* changes by less than half a revolution between calls.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_PositionAccumulate(&position); </CODE>
+*
+*/
+void MCAPP_PositionAccumulate(MCAPP_POSITION_T *pPosition)
+{
+    const int16_t theta = *pPosition->pTheta;
+    
+    pPosition->position += (int16_t)(theta - pPosition->thetaLast);
+    pPosition->thetaLast = theta;
+}
+
+/**
+* <B> Function: void MCAPP_PositionStep(MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to execute position control in place of the speed 
+* reference ramp. It is called every control cycle and executes once in 
+* countLimit cycles. Pending requests are accepted, the position reference 
+* is moved by the profile or homing, and the speed reference qVelRef, the 
+* speed controller output limits and the Q axis current feedforward are 
+* updated. In the first step after start-up the profile continues from the
+* present speed reference and stops at the acceleration limit.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_PositionStep(&position); </CODE>
+*
+*/
+void MCAPP_PositionStep(MCAPP_POSITION_T *pPosition)
+{
+    MCAPP_PISTATE_T *pPISpeed = pPosition->pPISpeed;
+    int32_t error, speed, velocityStep, velocityLast;
+    
+    pPosition->count++;
+    if (pPosition->count < pPosition->countLimit)
+    {
+        return;
+    }
+    pPosition->count = 0;
+    
+    if (pPosition->active == 0)
+    {
+        pPosition->positionRef = pPosition->position;
+        pPosition->positionRefFrac = 0;
+        pPosition->velocity = (int32_t)pPosition->pCtrlParam->qVelRef * 
+                                            pPosition->velocityPerSpeed;
+        pPosition->target = pPosition->positionRef + 
+                                MCAPP_PositionStopDistance(pPosition->velocity,
+                                                        pPosition->accel);
+        pPosition->state = MCAPP_POSITION_MOVE;
+        pPosition->active = 1;
+    }
+    
+    MCAPP_PositionRequest(pPosition);
+    
+    velocityLast = pPosition->velocity;
+    if (pPosition->state == MCAPP_POSITION_HOME)
+    {
+        MCAPP_PositionHoming(pPosition);
+    }
+    else
+    {
+        MCAPP_PositionProfile(pPosition);
+    }
+    
+    /* Speed reference is profile speed plus proportional correction of the
+     * position error, error is limited to half an electrical revolution */
+    error = pPosition->positionRef - pPosition->position;
+    if (error > INT16_MAX)
+    {
+        error = INT16_MAX;
+    }
+    else if (error < INT16_MIN)
+    {
+        error = INT16_MIN;
+    }
+    speed = (__builtin_mulsu((int16_t)(pPosition->velocity >> 
+                POSITION_VEL_QVALUE), pPosition->qSpeedScale) + 
+            (int32_t)(__builtin_muluu((uint16_t)(pPosition->velocity & 
+                ((1 << POSITION_VEL_QVALUE) - 1)), pPosition->qSpeedScale) >> 
+                POSITION_VEL_QVALUE) + 
+            __builtin_mulss((int16_t)error, pPosition->qKp)) >> 15;
+    pPosition->pCtrlParam->qVelRef = UTIL_SatShrS16(speed, 0);
+    
+    /* Current for the profile acceleration */
+    velocityStep = pPosition->velocity - velocityLast;
+    pPosition->qIqFeedForward = UTIL_SatShrS16(velocityStep * 
+                    pPosition->qAccelFFGain, POSITION_ACCEL_FF_QVALUE);
+    
+    if (pPosition->state == MCAPP_POSITION_HOME)
+    {
+        pPISpeed->outMax = pPosition->qIqHome;
+    }
+    else
+    {
+        pPISpeed->outMax = pPosition->qIqMax;
+    }
+    pPISpeed->outMin = -pPISpeed->outMax;
+}
+
+/**
+* <B> Function: bool MCAPP_PositionMoveAbsolute(MCAPP_POSITION_T *, 
+*               int32_t)  </B>
+*
+* @brief Function to request a move to a target position. A request 
+* replaces the target of a move in progress, it is accepted in the next 
+* position step while the motor runs in closed loop. Homing in progress is 
+* not interrupted.
+*
+* @param Pointer to the data structure containing position parameters.
+* @param Target position in electrical angle counts.
+* @return   true if the request is placed, false if a request is pending.
+* @example
+* <CODE> MCAPP_PositionMoveAbsolute(&position, 10*65536L); </CODE>
+*
+*/
+bool MCAPP_PositionMoveAbsolute(MCAPP_POSITION_T *pPosition, int32_t target)
+{
+    if (pPosition->request != MCAPP_POSITION_REQUEST_NONE)
+    {
+        return false;
+    }
+    pPosition->requestTarget = target;
+    pPosition->request = MCAPP_POSITION_REQUEST_ABSOLUTE;
+    return true;
+}
+
+/**
+* <B> Function: bool MCAPP_PositionMoveRelative(MCAPP_POSITION_T *, 
+*               int32_t)  </B>
+*
+* @brief Function to request a move of the target position by a distance. 
+* Distance is added to the target of a move in progress.
+*
+* @param Pointer to the data structure containing position parameters.
+* @param Distance in electrical angle counts.
+* @return   true if the request is placed, false if a request is pending.
+* @example
+* <CODE> MCAPP_PositionMoveRelative(&position, -65536L); </CODE>
+*
+*/
+bool MCAPP_PositionMoveRelative(MCAPP_POSITION_T *pPosition, int32_t distance)
+{
+    if (pPosition->request != MCAPP_POSITION_REQUEST_NONE)
+    {
+        return false;
+    }
+    pPosition->requestTarget = distance;
+    pPosition->request = MCAPP_POSITION_REQUEST_RELATIVE;
+    return true;
+}
+
+/**
+* <B> Function: bool MCAPP_PositionHome(MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to request homing. Rotor moves at homing velocity with 
+* limited current until it stalls, the position is then set to the home 
+* position.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   true if the request is placed, false if a request is pending.
+* @example
+* <CODE> MCAPP_PositionHome(&position); </CODE>
+*
+*/
+bool MCAPP_PositionHome(MCAPP_POSITION_T *pPosition)
+{
+    if (pPosition->request != MCAPP_POSITION_REQUEST_NONE)
+    {
+        return false;
+    }
+    pPosition->request = MCAPP_POSITION_REQUEST_HOME;
+    return true;
+}
+
+/**
+* <B> Function: bool MCAPP_PositionIsDone(const MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to check if the position reference is at the target with 
+* no request pending and no homing in progress.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   true if the move is done.
+* @example
+* <CODE> done = MCAPP_PositionIsDone(&position); </CODE>
+*
+*/
+bool MCAPP_PositionIsDone(const MCAPP_POSITION_T *pPosition)
+{
+    return ((pPosition->request == MCAPP_POSITION_REQUEST_NONE) &&
+            (pPosition->state == MCAPP_POSITION_HOLD));
+}
+
+/**
+* <B> Function: int32_t MCAPP_PositionGet(const MCAPP_POSITION_T *)  </B>
+*
+* @brief Function to read the rotor position outside the control interrupt,
+* the position is read again if the interrupt changed it between the reads 
+* of its two words.
+*
+* @param Pointer to the data structure containing position parameters.
+* @return   Rotor position in electrical angle counts.
+* @example
+* <CODE> position = MCAPP_PositionGet(&position); </CODE>
+*
+*/
+int32_t MCAPP_PositionGet(const MCAPP_POSITION_T *pPosition)
+{
+    int32_t position;
+    
+    do
+    {
+        position = pPosition->position;
+    } while (position != pPosition->position);
+    
+    return position;
+}
+
+/**
+* <B> Function: MCAPP_PositionRequest(MCAPP_POSITION_T *) </B>
+*
+* @brief Accepts a pending request.
+*
+*/
+static void MCAPP_PositionRequest(MCAPP_POSITION_T *pPosition)
+{
+    switch (pPosition->request)
+    {
+        case MCAPP_POSITION_REQUEST_ABSOLUTE:
+            if (pPosition->state != MCAPP_POSITION_HOME)
+            {
+                pPosition->target = pPosition->requestTarget;
+                pPosition->state = MCAPP_POSITION_MOVE;
+            }
+            break;
+            
+        case MCAPP_POSITION_REQUEST_RELATIVE:
+            if (pPosition->state != MCAPP_POSITION_HOME)
+            {
+                pPosition->target += pPosition->requestTarget;
+                pPosition->state = MCAPP_POSITION_MOVE;
+            }
+            break;
+            
+        case MCAPP_POSITION_REQUEST_HOME:
+            pPosition->homeStallCount = 0;
+            pPosition->homed = 0;
+            pPosition->state = MCAPP_POSITION_HOME;
+            break;
+            
+        default:
+            break;
+    }
+    pPosition->request = MCAPP_POSITION_REQUEST_NONE;
+}
+
+/**
+* <B> Function: MCAPP_PositionProfile(MCAPP_POSITION_T *) </B>
+*
+* @brief Moves the position reference towards the target with trapezoidal 
+* speed profile. Each step velocity is raised by acceleration if the 
+* reference still stops before the target when velocity is then reduced at 
+* the acceleration limit, held if it stops before the target at present 
+* velocity, and lowered otherwise.
+*
+*/
+static void MCAPP_PositionProfile(MCAPP_POSITION_T *pPosition)
+{
+    const int32_t accel = pPosition->accel;
+    int32_t error, velocity, sum;
+    
+    error = pPosition->target - pPosition->positionRef;
+    if (error > POSITION_ERROR_MAX)
+    {
+        error = POSITION_ERROR_MAX;
+    }
+    else if (error < -POSITION_ERROR_MAX)
+    {
+        error = -POSITION_ERROR_MAX;
+    }
+    
+    velocity = pPosition->velocity;
+    if (error >= MCAPP_PositionStopDistance(velocity, pPosition->accel))
+    {
+        if ((error - ((velocity + accel) >> POSITION_VEL_QVALUE)) >= 
+            MCAPP_PositionStopDistance(velocity + accel, pPosition->accel))
+        {
+            velocity += accel;
+        }
+        else if ((error - (velocity >> POSITION_VEL_QVALUE)) < 
+            MCAPP_PositionStopDistance(velocity, pPosition->accel))
+        {
+            velocity -= accel;
+        }
+    }
+    else
+    {
+        if ((error - ((velocity - accel) >> POSITION_VEL_QVALUE)) <= 
+            MCAPP_PositionStopDistance(velocity - accel, pPosition->accel))
+        {
+            velocity -= accel;
+        }
+        else if ((error - (velocity >> POSITION_VEL_QVALUE)) > 
+            MCAPP_PositionStopDistance(velocity, pPosition->accel))
+        {
+            velocity += accel;
+        }
+    }
+    
+    if (velocity > pPosition->velocityMax)
+    {
+        velocity = pPosition->velocityMax;
+    }
+    else if (velocity < -pPosition->velocityMax)
+    {
+        velocity = -pPosition->velocityMax;
+    }
+    
+    /* Settle on target once the remaining distance is too short to 
+     * accelerate and stop, two acceleration steps */
+    if ((velocity <= accel) && (velocity >= -accel) && 
+        (error <= ((accel >> (POSITION_VEL_QVALUE - 1)) + 2)) && 
+        (error >= -((accel >> (POSITION_VEL_QVALUE - 1)) + 2)))
+    {
+        pPosition->positionRef = pPosition->target;
+        pPosition->positionRefFrac = 0;
+        pPosition->velocity = 0;
+        pPosition->state = MCAPP_POSITION_HOLD;
+        return;
+    }
+    
+    pPosition->velocity = velocity;
+    sum = (int32_t)pPosition->positionRefFrac + velocity;
+    pPosition->positionRef += (sum >> POSITION_VEL_QVALUE);
+    pPosition->positionRefFrac = (uint16_t)sum & 
+                                        ((1 << POSITION_VEL_QVALUE) - 1);
+}
+
+/**
+* <B> Function: MCAPP_PositionHoming(MCAPP_POSITION_T *) </B>
+*
+* @brief Moves the position reference at homing velocity, reached with 
+* homeAccel that the limited current can follow. Position error above 
+* homeStallError for homeStallCountLimit steps is a stall, where the 
+* position is set to the home position.
+*
+*/
+static void MCAPP_PositionHoming(MCAPP_POSITION_T *pPosition)
+{
+    const int32_t accel = pPosition->homeAccel;
+    int32_t error, sum;
+    
+    if (pPosition->velocity < (pPosition->homeVelocity - accel))
+    {
+        pPosition->velocity += accel;
+    }
+    else if (pPosition->velocity > (pPosition->homeVelocity + accel))
+    {
+        pPosition->velocity -= accel;
+    }
+    else
+    {
+        pPosition->velocity = pPosition->homeVelocity;
+    }
+    sum = (int32_t)pPosition->positionRefFrac + pPosition->velocity;
+    pPosition->positionRef += (sum >> POSITION_VEL_QVALUE);
+    pPosition->positionRefFrac = (uint16_t)sum & 
+                                        ((1 << POSITION_VEL_QVALUE) - 1);
+    
+    error = pPosition->positionRef - pPosition->position;
+    if ((error > pPosition->homeStallError) || 
+        (error < -pPosition->homeStallError))
+    {
+        pPosition->homeStallCount++;
+    }
+    else
+    {
+        pPosition->homeStallCount = 0;
+    }
+    
+    if (pPosition->homeStallCount >= pPosition->homeStallCountLimit)
+    {
+        /* Rotor is at the end stop, release the stall current */
+        pPosition->position = pPosition->homePosition;
+        pPosition->positionRef = pPosition->homePosition;
+        pPosition->positionRefFrac = 0;
+        pPosition->target = pPosition->homePosition;
+        pPosition->velocity = 0;
+        MCAPP_ControllerPIReset(pPosition->pPISpeed, 0);
+        pPosition->homed = 1;
+        pPosition->state = MCAPP_POSITION_HOLD;
+    }
+}
+
+/**
+* <B> Function: MCAPP_PositionStopDistance(int32_t, uint16_t) </B>
+*
+* @brief Distance to stop from a velocity at the acceleration limit, 
+* velocity*(steps + 1)/2 in counts. Upper and lower bytes of velocity are 
+* multiplied separately to keep the full resolution.
+*
+*/
+static int32_t MCAPP_PositionStopDistance(int32_t velocity, uint16_t accel)
+{
+    const uint32_t velocityAbs = (velocity >= 0) ? velocity : -velocity;
+    const uint16_t steps = __builtin_divud(velocityAbs, accel) + 1;
+    uint32_t distance;
+    
+    distance = (__builtin_muluu((uint16_t)(velocityAbs >> POSITION_VEL_QVALUE),
+                    steps) + (__builtin_muluu((uint16_t)(velocityAbs & 
+                    ((1 << POSITION_VEL_QVALUE) - 1)), steps) >> 
+                    POSITION_VEL_QVALUE)) >> 1;
+    
+    return (velocity >= 0) ? (int32_t)distance : -(int32_t)distance;
+}
@@ -0,0 +1,191 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file position.h
+ *
+ * @brief This module implements position control on top of the speed controller
+ * with a multi-turn position from the estimated rotor angle.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __POSITION_H
+#define __POSITION_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "foc_control_types.h"
+#include "sat_pi/sat_pi.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Position in electrical angle counts, 65536 per electrical revolution */
+/* Fractional bits of profile velocity, counts per step, and acceleration, 
+ * counts per step squared */
+#define POSITION_VEL_QVALUE         8
+/* Fractional bits of acceleration feedforward gain */
+#define POSITION_ACCEL_FF_QVALUE    10
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="ENUMERATED CONSTANTS ">
+
+typedef enum
+{
+    MCAPP_POSITION_HOLD = 0,        /* Hold position reference */
+    MCAPP_POSITION_MOVE = 1,        /* Move to target position */
+    MCAPP_POSITION_HOME = 2,        /* Move until stall, set home position */
+            
+} MCAPP_POSITION_STATE_T;
+
+typedef enum
+{
+    MCAPP_POSITION_REQUEST_NONE = 0,
+    MCAPP_POSITION_REQUEST_ABSOLUTE = 1,   /* Move to requestTarget */
+    MCAPP_POSITION_REQUEST_RELATIVE = 2,   /* Move target by requestTarget */
+    MCAPP_POSITION_REQUEST_HOME = 3,
+            
+} MCAPP_POSITION_REQUEST_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to position control. Rotor
+    position is the estimated electrical angle unwrapped into 32 bits. A 
+    trapezoidal profile moves the position reference to the target with 
+    limited speed and acceleration, the target can be changed during a move.
+    Speed reference is the profile speed plus a proportional correction of 
+    the position error, and Q axis current reference is raised by the 
+    current needed for the profile acceleration. Homing moves at constant 
+    speed with limited current until the rotor stalls on an end stop, 
+    detected by position error, and sets the position there. */
+
+typedef struct
+{
+    /* Rotor position, read outside the control interrupt */
+    volatile int32_t position;
+    /* Position reference, fraction of a count in positionRefFrac */
+    int32_t positionRef;
+    /* Target position of present move */
+    int32_t target;
+    /* Target position or distance of a pending request */
+    int32_t requestTarget;
+    /* Position set at home */
+    int32_t homePosition;
+    /* Position error indicating a stall during homing */
+    int32_t homeStallError;
+    /* Profile velocity, limit and homing velocity, counts per step with 
+     * POSITION_VEL_QVALUE fractional bits */
+    int32_t velocity;
+    int32_t velocityMax;
+    int32_t homeVelocity;
+    /* Profile and homing acceleration, counts per step squared with 
+     * POSITION_VEL_QVALUE fractional bits */
+    uint16_t accel;
+    uint16_t homeAccel;
+    uint16_t positionRefFrac;
+    
+    /* Speed counts per count per step, Q15 */
+    uint16_t qSpeedScale;
+    /* Profile velocity per speed count, POSITION_VEL_QVALUE */
+    uint16_t velocityPerSpeed;
+    /* Position controller gain, speed counts per count, Q15 */
+    int16_t qKp;
+    /* Acceleration feedforward gain, POSITION_ACCEL_FF_QVALUE */
+    int16_t qAccelFFGain;
+    /* Q axis current feedforward */
+    int16_t qIqFeedForward;
+    /* Speed controller output limits in position control and homing */
+    int16_t qIqMax;
+    int16_t qIqHome;
+    /* Rotor angle at last position update */
+    int16_t thetaLast;
+    
+    uint16_t
+        state,              /* Position control state - 
+                             * MCAPP_POSITION_STATE_T */
+        active,             /* Position control sets the speed reference */
+        homed,              /* Home position is set */
+        homeStallCount,     /* Steps with position error above limit */
+        homeStallCountLimit,/* Steps to detect stall */
+        countLimit,         /* Control cycles per position step */
+        count,
+        enable;             /* Position control enable */
+    
+    /* Pending request - MCAPP_POSITION_REQUEST_T, set outside the control 
+     * interrupt and cleared when accepted */
+    volatile uint16_t request;
+    
+    const int16_t *pTheta;
+    MCAPP_CONTROL_T *pCtrlParam;
+    MCAPP_PISTATE_T *pPISpeed;
+    
+} MCAPP_POSITION_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_PositionInit(MCAPP_POSITION_T *);
+void MCAPP_PositionAccumulate(MCAPP_POSITION_T *);
+void MCAPP_PositionStep(MCAPP_POSITION_T *);
+bool MCAPP_PositionMoveAbsolute(MCAPP_POSITION_T *, int32_t);
+bool MCAPP_PositionMoveRelative(MCAPP_POSITION_T *, int32_t);
+bool MCAPP_PositionHome(MCAPP_POSITION_T *);
+bool MCAPP_PositionIsDone(const MCAPP_POSITION_T *);
+int32_t MCAPP_PositionGet(const MCAPP_POSITION_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __POSITION_H */
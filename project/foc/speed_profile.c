@@ -0,0 +1,232 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file speed_profile.c
+ *
+ * @brief This module implements a jerk limited S-curve speed reference profile
+ * with separate acceleration and deceleration limits.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "speed_profile.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed error used for the profile is limited to this many speed counts, 
+ * which keeps fractional calculations in 32 bits */
+#define SPEED_PROFILE_ERROR_MAX     16384
+/* Speed change limit, twice SPEED_PROFILE_ERROR_MAX with 8 fractional bits */
+#define SPEED_PROFILE_CHANGE_MAX    ((uint32_t)SPEED_PROFILE_ERROR_MAX << 9)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Function Declarations ">
+
+static int32_t MCAPP_SpeedProfileStopChange(int32_t, uint16_t);
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_SpeedProfileInit(MCAPP_SPEED_PROFILE_T *)  </B>
+*
+* @brief Function to reset the speed profile to standstill.
+*
+* @param Pointer to the data structure containing speed profile parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_SpeedProfileInit(&speedProfile); </CODE>
+*
+*/
+void MCAPP_SpeedProfileInit(MCAPP_SPEED_PROFILE_T *pProfile)
+{
+    pProfile->velocity = 0;
+    pProfile->accel = 0;
+    pProfile->velocityOut = 0;
+    pProfile->count = 0;
+}
+
+/**
+* <B> Function: void MCAPP_SpeedProfileStep(MCAPP_SPEED_PROFILE_T *)  </B>
+*
+* @brief Function to move the speed reference qVelRef towards the target 
+* speed qTargetVelocity. It is called every control cycle and executes once 
+* in countLimit cycles. Each step acceleration is raised by jerk if the speed
+* reference still does not overshoot the target when acceleration is then 
+* brought back to zero at the jerk limit, held if it does not overshoot at 
+* the present acceleration, and lowered by jerk otherwise. Speed reference 
+* set outside the profile, for example at the start of closed loop, is 
+* taken as the new starting point with zero acceleration.
+*
+* @param Pointer to the data structure containing speed profile parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_SpeedProfileStep(&speedProfile); </CODE>
+*
+*/
+void MCAPP_SpeedProfileStep(MCAPP_SPEED_PROFILE_T *pProfile)
+{
+    MCAPP_CONTROL_T *pCtrlParam = pProfile->pCtrlParam;
+    const int32_t jerk = pProfile->jerk;
+    int32_t speedError, error, accel, accelPosMax, accelNegMax;
+    
+    pProfile->count++;
+    if (pProfile->count < pProfile->countLimit)
+    {
+        return;
+    }
+    pProfile->count = 0;
+    
+    if (pCtrlParam->qVelRef != pProfile->velocityOut)
+    {
+        pProfile->velocity = (int32_t)pCtrlParam->qVelRef << 16;
+        pProfile->accel = 0;
+    }
+    
+    /* Speed error with 16 fractional bits */
+    speedError = (int32_t)pCtrlParam->qTargetVelocity - 
+                    (pProfile->velocity >> 16);
+    if (speedError > SPEED_PROFILE_ERROR_MAX)
+    {
+        speedError = SPEED_PROFILE_ERROR_MAX;
+    }
+    else if (speedError < -SPEED_PROFILE_ERROR_MAX)
+    {
+        speedError = -SPEED_PROFILE_ERROR_MAX;
+    }
+    error = (speedError << 16) - (pProfile->velocity & 0xFFFF);
+    
+    /* Deceleration limit applies while speed magnitude falls */
+    accelPosMax = (pProfile->velocity < 0) ? 
+                                pProfile->decelMax : pProfile->accelMax;
+    accelNegMax = (pProfile->velocity > 0) ? 
+                                -pProfile->decelMax : -pProfile->accelMax;
+    
+    accel = pProfile->accel;
+    if (error >= MCAPP_SpeedProfileStopChange(accel, pProfile->jerk))
+    {
+        if ((error - (accel + jerk)) >= 
+                    MCAPP_SpeedProfileStopChange(accel + jerk, pProfile->jerk))
+        {
+            accel += jerk;
+        }
+        else if ((error - accel) < 
+                    MCAPP_SpeedProfileStopChange(accel, pProfile->jerk))
+        {
+            accel -= jerk;
+        }
+    }
+    else
+    {
+        if ((error - (accel - jerk)) <= 
+                    MCAPP_SpeedProfileStopChange(accel - jerk, pProfile->jerk))
+        {
+            accel -= jerk;
+        }
+        else if ((error - accel) > 
+                    MCAPP_SpeedProfileStopChange(accel, pProfile->jerk))
+        {
+            accel += jerk;
+        }
+    }
+    
+    /* Limit changes with the direction of speed, acceleration above the 
+     * limit is brought down at the jerk limit */
+    if (accel > accelPosMax)
+    {
+        accel = ((pProfile->accel - jerk) > accelPosMax) ? 
+                                    (pProfile->accel - jerk) : accelPosMax;
+    }
+    else if (accel < accelNegMax)
+    {
+        accel = ((pProfile->accel + jerk) < accelNegMax) ? 
+                                    (pProfile->accel + jerk) : accelNegMax;
+    }
+    
+    /* Settle on target once the remaining error is within one jerk step,
+     * dropping an acceleration of at most one jerk step */
+    if ((pProfile->accel <= jerk) && (pProfile->accel >= -jerk) && 
+        (accel <= jerk) && (accel >= -jerk) && 
+        (error <= (jerk << 1)) && (error >= -(jerk << 1)))
+    {
+        pProfile->velocity = (int32_t)pCtrlParam->qTargetVelocity << 16;
+        accel = 0;
+    }
+    else
+    {
+        pProfile->velocity += accel;
+    }
+    pProfile->accel = accel;
+    
+    pCtrlParam->qVelRef = (int16_t)((pProfile->velocity + 0x8000) >> 16);
+    pProfile->velocityOut = pCtrlParam->qVelRef;
+}
+
+/**
+* <B> Function: MCAPP_SpeedProfileStopChange(int32_t, uint16_t) </B>
+*
+* @brief Speed change while acceleration is brought to zero at the jerk 
+* limit, accel*(steps + 1)/2 with 16 fractional bits, limited to the speed 
+* error range. Upper and lower bytes of acceleration are multiplied 
+* separately to keep the full resolution.
+*
+*/
+static int32_t MCAPP_SpeedProfileStopChange(int32_t accel, uint16_t jerk)
+{
+    const uint32_t accelAbs = (accel >= 0) ? accel : -accel;
+    const uint16_t steps = __builtin_divud(accelAbs, jerk) + 1;
+    uint32_t change;
+    
+    change = __builtin_muluu((uint16_t)(accelAbs >> 8), steps);
+    if (change > SPEED_PROFILE_CHANGE_MAX)
+    {
+        change = SPEED_PROFILE_CHANGE_MAX;
+    }
+    change = ((change << 8) + 
+                __builtin_muluu((uint16_t)(accelAbs & 0xFF), steps)) >> 1;
+    
+    return (accel >= 0) ? (int32_t)change : -(int32_t)change;
+}
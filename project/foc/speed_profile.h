@@ -0,0 +1,111 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file speed_profile.h
+ *
+ * @brief This module implements a jerk limited S-curve speed reference profile
+ * with separate acceleration and deceleration limits.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __SPEED_PROFILE_H
+#define __SPEED_PROFILE_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "foc_control_types.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to the S-curve speed profile.
+    Speed reference follows the target speed with acceleration limited to 
+    accelMax while speed magnitude rises and to decelMax while it falls, and
+    acceleration changing by at most jerk per step. Acceleration is reduced
+    in time to reach a new target without overshoot, so the target can be
+    changed at any time. Speed and acceleration carry 16 fractional bits 
+    below one speed count so that slow ramps are not rounded away. */
+
+typedef struct
+{
+    /* Speed reference, speed counts shifted left by 16 */
+    int32_t velocity;
+    /* Present acceleration, speed counts per step shifted left by 16 */
+    int32_t accel;
+    /* Acceleration limits, speed counts per step shifted left by 16 */
+    int32_t accelMax;
+    int32_t decelMax;
+    /* Change of acceleration per step, shifted left by 16 */
+    uint16_t jerk;
+    /* Control cycles per profile step */
+    uint16_t countLimit;
+    uint16_t count;
+    /* Speed reference written in the last step */
+    int16_t velocityOut;
+    /* S-curve profile enable flag */
+    uint16_t enable;
+    
+    MCAPP_CONTROL_T *pCtrlParam;
+    
+} MCAPP_SPEED_PROFILE_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_SpeedProfileInit(MCAPP_SPEED_PROFILE_T *);
+void MCAPP_SpeedProfileStep(MCAPP_SPEED_PROFILE_T *);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __SPEED_PROFILE_H */
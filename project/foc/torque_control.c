@@ -0,0 +1,217 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file torque_control.c
+ *
+ * @brief This module implements the torque mode, Q axis current command with rate
+ * limit and speed limit, and switching between torque and speed mode.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "general.h"
+#include "torque_control.h"
+
+// </editor-fold>
+
+/**
+* <B> Function: void MCAPP_TorqueControlInit(MCAPP_TORQUE_CONTROL_T *)  </B>
+*
+* @brief Function to reset the torque mode at motor start. Motor starts in 
+* speed mode, a requested torque mode is entered once the speed controller 
+* runs in closed loop.
+*
+* @param Pointer to the data structure containing torque mode parameters.
+* @return   none.
+* @example
+* <CODE> MCAPP_TorqueControlInit(&torqueControl); </CODE>
+*
+*/
+void MCAPP_TorqueControlInit(MCAPP_TORQUE_CONTROL_T *pTorque)
+{
+    pTorque->mode = MCAPP_TORQUE_CONTROL_SPEED_MODE;
+    pTorque->iqCommand = 0;
+    pTorque->speedLimitActive = 0;
+}
+
+/**
+* <B> Function: bool MCAPP_TorqueControlStep(MCAPP_TORQUE_CONTROL_T *)  </B>
+*
+* @brief Function to switch to the requested mode and set the Q axis current
+* reference in torque mode. It is called every control cycle in place of the
+* speed controller. Current command moves towards the target at the slew 
+* rate. Speed controller output with the speed limit as reference replaces 
+* the command when it is smaller in the direction of the command, and is 
+* reset to the command otherwise. Speed reference follows the estimated 
+* speed, so that speed mode continues from it.
+*
+* @param Pointer to the data structure containing torque mode parameters.
+* @return   true in torque mode, false in speed mode.
+* @example
+* <CODE> torqueMode = MCAPP_TorqueControlStep(&torqueControl); </CODE>
+*
+*/
+bool MCAPP_TorqueControlStep(MCAPP_TORQUE_CONTROL_T *pTorque)
+{
+    MCAPP_CONTROL_T *pCtrlParam = pTorque->pCtrlParam;
+    MCAPP_PISTATE_T *pPISpeed = pTorque->pPISpeed;
+    const int16_t velEstim = *pTorque->pVelEstim;
+    const int32_t slewRate = pTorque->slewRate;
+    int32_t error;
+    int16_t iqCommand, iqLimit, speedLimit;
+    
+    if (pTorque->mode != pTorque->modeRequest)
+    {
+        if (pTorque->modeRequest == MCAPP_TORQUE_CONTROL_TORQUE_MODE)
+        {
+            /* Current command starts from the speed controller output */
+            pTorque->iqCommand = (int32_t)pCtrlParam->qIqRef << 
+                                                TORQUE_CONTROL_SLEW_QVALUE;
+            pPISpeed->outMax = pTorque->qIqMax;
+            pPISpeed->outMin = -pTorque->qIqMax;
+        }
+        else
+        {
+            /* Speed controller starts from the present current reference */
+            MCAPP_ControllerPIReset(pPISpeed, pCtrlParam->qIqRef);
+            pCtrlParam->speedRampSkipCnt = 0;
+        }
+        pTorque->speedLimitActive = 0;
+        pTorque->mode = pTorque->modeRequest;
+    }
+    
+    if (pTorque->mode != MCAPP_TORQUE_CONTROL_TORQUE_MODE)
+    {
+        return false;
+    }
+    
+    error = ((int32_t)pTorque->qIqTarget << TORQUE_CONTROL_SLEW_QVALUE) - 
+                                                        pTorque->iqCommand;
+    if (error > slewRate)
+    {
+        pTorque->iqCommand += slewRate;
+    }
+    else if (error < -slewRate)
+    {
+        pTorque->iqCommand -= slewRate;
+    }
+    else
+    {
+        pTorque->iqCommand += error;
+    }
+    iqCommand = (int16_t)(pTorque->iqCommand >> TORQUE_CONTROL_SLEW_QVALUE);
+    
+    /* Speed is limited in the direction of the command, at zero command in
+     * the direction of rotation */
+    if ((iqCommand > 0) || ((iqCommand == 0) && (velEstim >= 0)))
+    {
+        speedLimit = pTorque->qSpeedLimit;
+    }
+    else
+    {
+        speedLimit = -pTorque->qSpeedLimit;
+    }
+    MCAPP_ControllerPIUpdate(speedLimit, velEstim, pPISpeed, MCAPP_SAT_NONE, 
+                                &iqLimit, speedLimit);
+    
+    if (((speedLimit > 0) && (iqLimit < iqCommand)) || 
+        ((speedLimit < 0) && (iqLimit > iqCommand)))
+    {
+        pCtrlParam->qIqRef = iqLimit;
+        pTorque->speedLimitActive = 1;
+    }
+    else
+    {
+        /* Speed controller tracks the command while below the speed limit */
+        MCAPP_ControllerPIReset(pPISpeed, iqCommand);
+        pCtrlParam->qIqRef = iqCommand;
+        pTorque->speedLimitActive = 0;
+    }
+    
+    pCtrlParam->qVelRef = velEstim;
+    
+    return true;
+}
+
+/**
+* <B> Function: void MCAPP_TorqueControlModeSet(MCAPP_TORQUE_CONTROL_T *, 
+*               uint16_t)  </B>
+*
+* @brief Function to request torque or speed mode. Mode is switched in the 
+* next control cycle in closed loop.
+*
+* @param Pointer to the data structure containing torque mode parameters.
+* @param Requested mode - MCAPP_TORQUE_CONTROL_MODE_T.
+* @return   none.
+* @example
+* <CODE> MCAPP_TorqueControlModeSet(&torqueControl, 
+*                                   MCAPP_TORQUE_CONTROL_TORQUE_MODE); </CODE>
+*
+*/
+void MCAPP_TorqueControlModeSet(MCAPP_TORQUE_CONTROL_T *pTorque, 
+                                uint16_t mode)
+{
+    pTorque->modeRequest = mode;
+}
+
+/**
+* <B> Function: void MCAPP_TorqueControlCommandSet(MCAPP_TORQUE_CONTROL_T *,
+*               int16_t)  </B>
+*
+* @brief Function to set the Q axis current command of torque mode, limited
+* to qIqMax.
+*
+* @param Pointer to the data structure containing torque mode parameters.
+* @param Q axis current command.
+* @return   none.
+* @example
+* <CODE> MCAPP_TorqueControlCommandSet(&torqueControl, 1000); </CODE>
+*
+*/
+void MCAPP_TorqueControlCommandSet(MCAPP_TORQUE_CONTROL_T *pTorque, 
+                                    int16_t qIqTarget)
+{
+    pTorque->qIqTarget = UTIL_LimitS16(qIqTarget, -pTorque->qIqMax, 
+                                        pTorque->qIqMax);
+}
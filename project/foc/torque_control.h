@@ -0,0 +1,138 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file torque_control.h
+ *
+ * @brief This module implements the torque mode, Q axis current command with rate
+ * limit and speed limit, and switching between torque and speed mode.
+ *
+ * Component: FOC
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __TORQUE_CONTROL_H
+#define __TORQUE_CONTROL_H
+
+#ifdef __cplusplus
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "foc_control_types.h"
+#include "sat_pi/sat_pi.h"
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Fractional bits of rate limited current command and slew rate */
+#define TORQUE_CONTROL_SLEW_QVALUE  8
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="ENUMERATED CONSTANTS ">
+
+typedef enum
+{
+    MCAPP_TORQUE_CONTROL_SPEED_MODE = 0,    /* Speed controller sets Iq */
+    MCAPP_TORQUE_CONTROL_TORQUE_MODE = 1,   /* Iq follows current command */
+            
+} MCAPP_TORQUE_CONTROL_MODE_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS">
+
+ /* Description:
+    This structure will host parameters related to the torque mode. In 
+    torque mode Q axis current reference follows the current command at 
+    limited slew rate, without the speed controller in between. Speed 
+    controller runs alongside with the speed limit in the direction of the
+    command as reference and tracks the command while it is not needed, so 
+    it takes over without a step once speed reaches the limit. Switching 
+    between modes is requested at any time and done in the control 
+    interrupt: torque mode starts from the present current reference and 
+    speed mode from the present speed and current reference. */
+
+typedef struct
+{
+    /* Q axis current command, set outside the control interrupt */
+    volatile int16_t qIqTarget;
+    /* Rate limited current command, TORQUE_CONTROL_SLEW_QVALUE */
+    int32_t iqCommand;
+    /* Current command change per control cycle, TORQUE_CONTROL_SLEW_QVALUE*/
+    uint16_t slewRate;
+    /* Current command limit */
+    int16_t qIqMax;
+    /* Speed magnitude limit in torque mode */
+    int16_t qSpeedLimit;
+    /* Mode in use - MCAPP_TORQUE_CONTROL_MODE_T */
+    uint16_t mode;
+    /* Requested mode, set outside the control interrupt */
+    volatile uint16_t modeRequest;
+    /* Current reference is set by the speed limit */
+    uint16_t speedLimitActive;
+    /* Torque mode enable flag */
+    uint16_t enable;
+    
+    const int16_t *pVelEstim;
+    MCAPP_CONTROL_T *pCtrlParam;
+    MCAPP_PISTATE_T *pPISpeed;
+    
+} MCAPP_TORQUE_CONTROL_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_TorqueControlInit(MCAPP_TORQUE_CONTROL_T *);
+bool MCAPP_TorqueControlStep(MCAPP_TORQUE_CONTROL_T *);
+void MCAPP_TorqueControlModeSet(MCAPP_TORQUE_CONTROL_T *, uint16_t);
+void MCAPP_TorqueControlCommandSet(MCAPP_TORQUE_CONTROL_T *, int16_t);
+
+// </editor-fold>
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* end of __TORQUE_CONTROL_H */
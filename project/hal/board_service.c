@@ -255,18 +255,7 @@ void HAL_MC1PWMDisableOutputs(void)
  */
 void HAL_MC1PWMSetDutyCycles(MC_DUTYCYCLEOUT_T *pdc)
 {
-    if(pdc->dutycycle3 < MIN_DUTY)
-    {
-        pdc->dutycycle3 = MIN_DUTY;
-    }
-    if(pdc->dutycycle2 < MIN_DUTY)
-    {
-        pdc->dutycycle2 = MIN_DUTY;
-    }
-    if(pdc->dutycycle1 < MIN_DUTY)
-    {
-        pdc->dutycycle1 = MIN_DUTY;
-    }
+    HAL_MC1PWMDutyLimit(pdc);
     
     MC1_PWM_PDC3 = pdc->dutycycle3;
     MC1_PWM_PDC2 = pdc->dutycycle2;
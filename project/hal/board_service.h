@@ -131,6 +131,28 @@ void HAL_TrapHandler(void);
 
 
 void GetDCLinkVoltage(int16_t *);
+
+/**
+ * Limits the duty cycles of Motor #1 to the PWM driver minimum. Zero duty 
+ * cycle is kept, it holds the phase at negative rail for discontinuous PWM.
+ * Shared by HAL_MC1PWMSetDutyCycles() and its host replacement.
+ * @param pdc Pointer to the array that holds duty cycle values
+ */
+inline static void HAL_MC1PWMDutyLimit(MC_DUTYCYCLEOUT_T *pdc)
+{
+    if((pdc->dutycycle3 < MIN_DUTY) && (pdc->dutycycle3 != 0))
+    {
+        pdc->dutycycle3 = MIN_DUTY;
+    }
+    if((pdc->dutycycle2 < MIN_DUTY) && (pdc->dutycycle2 != 0))
+    {
+        pdc->dutycycle2 = MIN_DUTY;
+    }
+    if((pdc->dutycycle1 < MIN_DUTY) && (pdc->dutycycle1 != 0))
+    {
+        pdc->dutycycle1 = MIN_DUTY;
+    }
+}
 // </editor-fold>
 
 #ifdef __cplusplus
@@ -0,0 +1,104 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file flash.c
+ *
+ * @brief This module implements the functions to erase, program and read the 
+ * program flash memory (NVM) used for non-volatile data.
+ *
+ * Component: FLASH
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "flash.h"
+
+// </editor-fold>
+
+void FLASH_PageErase(uint32_t address)
+{
+    NVMCON = FLASH_NVMCON_PAGE_ERASE;
+    NVMADR = (uint16_t)address;
+    NVMADRU = (uint16_t)(address >> 16);
+    
+    /* Unlock sequence with interrupts disabled and start of operation */
+    __builtin_write_NVM();
+    while(NVMCONbits.WR == 1);
+    
+    NVMCONbits.WREN = 0;
+}
+
+void FLASH_DoubleWordWrite(uint32_t address, uint16_t data0, uint16_t data1)
+{
+    uint16_t tblpagSave = TBLPAG;
+    
+    NVMCON = FLASH_NVMCON_DWORD_WRITE;
+    
+    /* Load the write latches */
+    TBLPAG = FLASH_WRITE_LATCH_PAGE;
+    __builtin_tblwtl(0, data0);
+    __builtin_tblwth(0, 0x00FF);
+    __builtin_tblwtl(2, data1);
+    __builtin_tblwth(2, 0x00FF);
+    
+    NVMADR = (uint16_t)address;
+    NVMADRU = (uint16_t)(address >> 16);
+    
+    /* Unlock sequence with interrupts disabled and start of operation */
+    __builtin_write_NVM();
+    while(NVMCONbits.WR == 1);
+    
+    NVMCONbits.WREN = 0;
+    TBLPAG = tblpagSave;
+}
+
+uint16_t FLASH_WordRead(uint32_t address)
+{
+    uint16_t tblpagSave = TBLPAG;
+    uint16_t data;
+    
+    TBLPAG = (uint16_t)(address >> 16);
+    data = __builtin_tblrdl((uint16_t)address);
+    TBLPAG = tblpagSave;
+    
+    return data;
+}
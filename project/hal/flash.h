@@ -0,0 +1,135 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file flash.h
+ *
+ * @brief This header file lists interface functions - to erase, program and read
+ * the program flash memory (NVM) used for non-volatile data.
+ * 
+ * Data is stored in the lower 16 bits of each instruction word, so one
+ * double word program stores two 16 bit data words and one page stores
+ * FLASH_PAGE_WORDS data words.
+ * 
+ * The host build of the unit tests links test/host/flash_sim.c, a RAM flash
+ * simulator with power fail injection, in place of flash.c.
+ *
+ * Component: FLASH
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef __FLASH_H
+#define __FLASH_H
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+    
+#ifdef __XC16__  // See comments at the top of this header file
+    #include <xc.h>
+#endif // __XC16__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// </editor-fold> 
+
+#ifdef __cplusplus  // Provide C++ Compatability
+    extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS or MACROS ">
+
+/* Page : 1024 instructions, 2 program counter addresses per instruction */
+#define FLASH_PAGE_SIZE_ADDRESS     0x800
+#define FLASH_PAGE_WORDS            1024
+/* Double word : 2 instructions */
+#define FLASH_DWORD_SIZE_ADDRESS    4
+
+/* NVMCON values : WREN = 1 and NVMOP<3:0> */
+#define FLASH_NVMCON_DWORD_WRITE    0x4001
+#define FLASH_NVMCON_PAGE_ERASE     0x4003
+/* Write latch address */
+#define FLASH_WRITE_LATCH_PAGE      0xFA
+
+// </editor-fold>    
+
+// <editor-fold defaultstate="collapsed" desc="INTERFACE FUNCTIONS ">
+
+/**
+ * Erases the flash page at page aligned program memory address. Instruction
+ * fetch from flash and hence all interrupts are stalled until completion.
+ * @param address page aligned program memory address
+ * @example
+ * <code>
+ * FLASH_PageErase(0x9800);
+ * </code>
+ */
+void FLASH_PageErase(uint32_t address);
+
+/**
+ * Programs two data words into two instructions at double word aligned 
+ * program memory address. Upper byte of the instructions is left erased.
+ * Instruction fetch from flash and hence all interrupts are stalled until
+ * completion.
+ * @param address double word aligned program memory address
+ * @param data0 data word for the first instruction
+ * @param data1 data word for the second instruction
+ * @example
+ * <code>
+ * FLASH_DoubleWordWrite(0x9800, 0x1234, 0x5678);
+ * </code>
+ */
+void FLASH_DoubleWordWrite(uint32_t address, uint16_t data0, uint16_t data1);
+
+/**
+ * Reads the data word(lower 16 bits) of instruction at program memory 
+ * address.
+ * @param address program memory address
+ * @return data word
+ * @example
+ * <code>
+ * data = FLASH_WordRead(0x9800);
+ * </code>
+ */
+uint16_t FLASH_WordRead(uint32_t address);
+
+// </editor-fold> 
+
+#ifdef __cplusplus  // Provide C++ Compatability
+    }
+#endif
+
+#endif /* __FLASH_H */
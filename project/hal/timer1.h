@@ -77,6 +77,9 @@
         
 #define TIMER1_PERIOD_COUNT  	(uint16_t)((TIMER1_CLOCK_SCALED * TIMER1_PERIOD_uSec)-1)          
         
+/* Duration of one Timer1 count in nano seconds, for time measurements */
+#define TIMER1_COUNT_nSec       (1000.0/TIMER1_CLOCK_SCALED)
+        
 // </editor-fold>    
         
 // <editor-fold defaultstate="collapsed" desc="TYPE DEFINITIONS ">  
@@ -164,6 +167,40 @@ inline static void TIMER1_ModuleStop(void)
     T1CONbits.TON = 0;  
 }
 
+/**
+ * Gets the Timer1 count.
+ * @return Timer1 count, 0 to TIMER1_PERIOD_COUNT
+ * @example
+ * <code>
+ * count = TIMER1_CountGet();
+ * </code>
+ */
+inline static uint16_t TIMER1_CountGet(void) 
+{
+    return TMR1;  
+}
+
+/**
+ * Gets the Timer1 counts elapsed between two Timer1 counts, for durations
+ * shorter than one Timer1 period.
+ * @param startCount Timer1 count at start
+ * @param endCount Timer1 count at end
+ * @return elapsed Timer1 counts
+ * @example
+ * <code>
+ * elapsed = TIMER1_ElapsedCountGet(startCount, TIMER1_CountGet());
+ * </code>
+ */
+inline static uint16_t TIMER1_ElapsedCountGet(uint16_t startCount, 
+                                                uint16_t endCount) 
+{
+    if(endCount >= startCount)
+    {
+        return (endCount - startCount);
+    }
+    return (endCount + TIMER1_PERIOD_COUNT + 1 - startCount);
+}
+
 /**
  * Sets the TImer1 Input Clock Select bits.
  * @example
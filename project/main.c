@@ -54,6 +54,8 @@
 #include "board_service.h"
 
 #include "diagnostics.h"
+#include "fault_recorder.h"
+#include "fault_log.h"
 
 #include "mc1_service.h"
 #include "pfc.h"
@@ -64,6 +66,11 @@
 // <editor-fold defaultstate="collapsed" desc=" Global Variables ">
 
 int16_t runCmdMC1, qTargetVelocityMC1;
+
+/* PWM fault ISR timing in Timer1 counts(TIMER1_COUNT_nSec) : from ISR entry
+ * to outputs disabled and to ISR exit, last and worst case */
+uint16_t pwmFaultGateOffTime, pwmFaultGateOffTimeMax, 
+         pwmFaultIsrTime, pwmFaultIsrTimeMax;
 // </editor-fold>
 
 /**
@@ -87,12 +94,25 @@ int main (void)
     DiagnosticsInit();
 #endif
     
+#ifdef ENABLE_FAULT_LOG
+    /* Log the reset cause and clear it for the next reset */
+    MCAPP_FaultLogInit(RCON);
+    RCON = 0;
+#endif
+    
     BoardServiceInit();
     
     PFC_ServiceInit();
         
     MCAPP_MC1ServiceInit();
     
+#ifdef ENABLE_FAULT_RECORDER
+    FaultRecorderInit();
+    MCAPP_MC1FaultRecorderConfig();
+    PFC_FaultRecorderConfig();
+    FaultRecorderArm();
+#endif
+    
     runCmdMC1  = 0;
     
     while(1)
@@ -101,6 +121,19 @@ int main (void)
     #ifdef ENABLE_DIAGNOSTICS
         DiagnosticsStepMain();
     #endif
+    #ifdef ENABLE_FAULT_RECORDER
+        FaultRecorderStepMain();
+    #endif
+        /* Re-initialize motor control after PWM fault outside the ISR */
+        MCAPP_MC1PWMFaultReinit();
+        
+    #ifdef ENABLE_FAULT_LOG
+        /* Flash operations stall the ISRs : program and erase only while 
+         * the motor is stopped and the PFC is not switching, a double word
+         * write(about 20us) already exceeds the PFC loop period */
+        MCAPP_FaultLogStepMain(MCAPP_MC1IsStopped() && !PFC_IsSwitching(), 
+                            MCAPP_MC1IsStopped() && !PFC_IsSwitching());
+    #endif
 
     }
 }
@@ -118,6 +151,10 @@ void __attribute__((__interrupt__,__auto_psv__)) _T1Interrupt (void)
 
 	
     BoardService();
+    
+#ifdef ENABLE_FAULT_LOG
+    MCAPP_FaultLogTimeTick();
+#endif
             
     if(IsPressed_Button1())
     {
@@ -144,14 +181,31 @@ void __attribute__((__interrupt__,__auto_psv__)) _T1Interrupt (void)
 /**
 * <B> Function: _PWMInterrupt()  </B>
 *
-* @brief PWM interrupt 
+* @brief PWM interrupt on PCI fault. Executes in fixed time : disables the 
+* PWM outputs first and latches the fault. Fault state is set in the next 
+* control loop ISR, motor control is re-initialized later from the main loop
+* by MCAPP_MC1PWMFaultReinit().
 * 
 */
 void __attribute__((__interrupt__,no_auto_psv)) _PWMInterrupt()
 {
-    LED2 = 1;
+    uint16_t entryCount = TIMER1_CountGet();
+    
     HAL_MC1PWMDisableOutputs();
+    pwmFaultGateOffTime = TIMER1_ElapsedCountGet(entryCount, TIMER1_CountGet());
+    
+    LED2 = 1;
     runCmdMC1 = 0;
-    MCAPP_MC1ServiceInit();
+    MCAPP_MC1PWMFaultSet();
     ClearPWMIF();
+    
+    if(pwmFaultGateOffTime > pwmFaultGateOffTimeMax)
+    {
+        pwmFaultGateOffTimeMax = pwmFaultGateOffTime;
+    }
+    pwmFaultIsrTime = TIMER1_ElapsedCountGet(entryCount, TIMER1_CountGet());
+    if(pwmFaultIsrTime > pwmFaultIsrTimeMax)
+    {
+        pwmFaultIsrTimeMax = pwmFaultIsrTime;
+    }
 }
@@ -73,8 +73,19 @@ extern "C" {
 #define MC1_NORM_DELTAT         MC1_PEAK_SPEED_RPM*POLEPAIRS*(1/30.0)*LOOPTIME_SEC*32768
   
 
+/* Maximum phase voltage per DC bus voltage, VOLTAGE_UTIL_FACTOR*Vdclink/root3 
+ * in the linear range of space vector modulation, OVERMOD_INDEX_MAX times 
+ * six-step voltage 2/pi*Vdclink with overmodulation. Overmodulation limits
+ * duty cycles to MAX_DUTY, six-step voltage is reduced by the same ratio */
+#ifdef OVERMODULATION
+#define VOLTAGE_LIMIT_RATIO     ((float)OVERMOD_INDEX_MAX*0.63662*\
+                                    (MAX_DUTY)/LOOPTIME_TCY)
+#else
+#define VOLTAGE_LIMIT_RATIO     ((float)VOLTAGE_UTIL_FACTOR*0.577)
+#endif
+
 /*Maximum utilizable Voltage Limit in closed loop control*/ /* 0.9* Vdclink/root3 */ 
-#define VMAX_CLOSEDLOOP_CONTROL     NORM_VALUE(VOLTAGE_UTIL_FACTOR*MC1_BASE_VOLTAGE*0.577, MC1_BASE_VOLTAGE)    
+#define VMAX_CLOSEDLOOP_CONTROL     NORM_VALUE(VOLTAGE_LIMIT_RATIO*MC1_BASE_VOLTAGE, MC1_BASE_VOLTAGE)    
 /* D Control Loop Maximum limit */
 #define Q_CURRCNTR_OUTMAX      VMAX_CLOSEDLOOP_CONTROL
 /* Q Control Loop Maximum limit */
@@ -84,11 +95,58 @@ extern "C" {
 #define MAX_VOLTAGE_SQUARE   (int16_t)( (float)VMAX_CLOSEDLOOP_CONTROL*VMAX_CLOSEDLOOP_CONTROL/32767 )
 
 /* Voltage factor for dynamic voltage limit calculation */    
-#define VMAX_FACTOR     (int16_t)((float)(0.577)*VOLTAGE_UTIL_FACTOR*32767*MC1_PEAK_VOLTAGE/MC1_BASE_VOLTAGE)        
+#define VMAX_FACTOR     (int16_t)(VOLTAGE_LIMIT_RATIO*32767*MC1_PEAK_VOLTAGE/MC1_BASE_VOLTAGE)        
 
     
 /* Flux weakening parameters */
 #define FD_WEAK_VOLTAGE_REF  (int16_t)((float)VMAX_CLOSEDLOOP_CONTROL*FW_VOLTAGE_REF_FACTOR)
+
+/* Inductance base in Henry, voltage base/(current base*electrical speed base)*/
+#define INDUCTANCE_BASE_H       ((float)MC1_BASE_VOLTAGE/(MC1_PEAK_CURRENT*\
+                                MC1_PEAK_SPEED_RPM*POLEPAIRS*2.0*3.14159265/60.0))
+/* Per unit flux linkage, 1/InvKfi */
+#define FLUX_LINKAGE_PU         ((float)(1 << NORM_INVKFI_CONST_QVALUE)/\
+                                NORM_INVKFI_CONST)
+
+/* Maximum torque per ampere parameters */
+/* Psi/(2*(Lq - Ld)) in Q15 per unit current */
+#define MTPA_CURRENT_CONST      (int32_t)(32768.0*FLUX_LINKAGE_PU*\
+                        INDUCTANCE_BASE_H/(2.0*((float)MOTOR_LQ_H - MOTOR_LD_H)))
+
+/* Current controller decoupling parameters */
+/* Fractional bits of per unit inductances and flux linkage */
+#define DECOUPLING_QVALUE       12
+#define DECOUPLING_LD           (int16_t)((float)MOTOR_LD_H/INDUCTANCE_BASE_H*\
+                                (1 << DECOUPLING_QVALUE))
+#define DECOUPLING_LQ           (int16_t)((float)MOTOR_LQ_H/INDUCTANCE_BASE_H*\
+                                (1 << DECOUPLING_QVALUE))
+#define DECOUPLING_FLUX         (int16_t)(FLUX_LINKAGE_PU*\
+                                (1 << DECOUPLING_QVALUE))
+
+/* Flux weakening feedforward table parameters */
+/* Lowest DC bus voltage of the table in Q15 of MC1_PEAK_VOLTAGE */
+#define FW_FF_VDC_MIN           Q15(0.5)
+/* Per unit voltage limit of the flux weakening controller at DC bus voltage 
+ * v in per unit of MC1_PEAK_VOLTAGE */
+#define FW_FF_VMAX(v)           ((float)(v)*MC1_PEAK_VOLTAGE/MC1_BASE_VOLTAGE*\
+                                VOLTAGE_LIMIT_RATIO*FW_VOLTAGE_REF_FACTOR)
+/* D axis current at per unit speed w and DC bus voltage v with zero Q axis 
+ * current, Id = (Vmax/w - Psi)/Ld, limited to ID_REF_MIN..0 */
+#define FW_FF_ID_PU(w,v)        (((w) > 0.0) ? ((FW_FF_VMAX(v)/(w) - \
+                                FLUX_LINKAGE_PU)*INDUCTANCE_BASE_H/MOTOR_LD_H):0.0)
+#define FW_FF_ID(w,v)           (int16_t)(32767.0*((FW_FF_ID_PU(w,v) > 0.0) ? \
+                                0.0 : ((FW_FF_ID_PU(w,v) < ID_REF_MIN/32768.0) ?\
+                                ID_REF_MIN/32768.0 : FW_FF_ID_PU(w,v))))
+/* Table row at DC bus voltage v, speed steps of 1/8 per unit */
+#define FW_FF_ROW(v)            {FW_FF_ID(0.0,v), FW_FF_ID(0.125,v), \
+                                FW_FF_ID(0.25,v), FW_FF_ID(0.375,v), \
+                                FW_FF_ID(0.5,v), FW_FF_ID(0.625,v), \
+                                FW_FF_ID(0.75,v), FW_FF_ID(0.875,v), \
+                                FW_FF_ID(1.0,v)}
+    
+/* Phase voltage per PWM count at full DC bus voltage, in Q27 of voltage base */
+#define PWM_VOLT_PER_COUNT      (int16_t)((float)MC1_PEAK_VOLTAGE/\
+                                (MC1_BASE_VOLTAGE*LOOPTIME_TCY)*(1UL << 27))
     
 /* DC bus compensation factor */ 
 #define DC_LINK_BASE_VOLTAGE    NORM_VALUE(MC1_BASE_VOLTAGE, MC1_PEAK_VOLTAGE)
@@ -99,8 +157,195 @@ extern "C" {
 /* BEMF filter for d-q components */
 #define KFILTER_ESDQ 1700 
     
+/** Open loop start-up Parameters */
+/* I-f load angle, 32768 per 180 electrical degrees */
+#define IF_LOAD_ANGLE   (int16_t)((float)IF_LOAD_ANGLE_DEG*32768.0/180.0)
+
 /** Fault Parameters  */
 #define PEAK_FAULT_CURRENT    NORM_VALUE(PEAK_FAULT_CURRENT_AMPS,MC1_PEAK_CURRENT)   
+#define DC_OVERVOLTAGE_FAULT  NORM_VALUE(DC_OVERVOLTAGE_FAULT_VOLT,MC1_PEAK_VOLTAGE)
+#define DC_UNDERVOLTAGE_FAULT NORM_VALUE(DC_UNDERVOLTAGE_FAULT_VOLT,MC1_PEAK_VOLTAGE)
+#define OVERSPEED_FAULT       NORM_VALUE(OVERSPEED_FAULT_RPM,MC1_PEAK_SPEED_RPM)
+#define PHASE_LOSS_CURRENT_MIN    NORM_VALUE(PHASE_LOSS_CURRENT_MIN_AMPS,MC1_PEAK_CURRENT)
+#define PHASE_LOSS_MIN_SPEED  NORM_VALUE(PHASE_LOSS_MIN_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+
+/** Estimator lock monitor Parameters */
+#define LOSS_OF_LOCK_SPEED_ERROR  NORM_VALUE(LOSS_OF_LOCK_SPEED_ERROR_RPM,MC1_PEAK_SPEED_RPM)
+#define STALL_SPEED           NORM_VALUE(STALL_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+#define LOCK_MONITOR_MIN_SPEED    NORM_VALUE(LOCK_MONITOR_MIN_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+/* Electrical angle accumulated over LOCK_MONITOR_ELEC_CYCLES, 65536 per cycle*/
+#define LOCK_MONITOR_ANGLE_LIMIT  ((uint32_t)LOCK_MONITOR_ELEC_CYCLES << 16)
+
+/** Extended EMF observer Parameters */
+/* EMF vector rotation per control period at peak speed in Q15 radian */
+#define EEMF_ROTATION_CONST   (int16_t)((float)NORM_DELTA_T*3.14159265)
+/* EMF at EEMF_EMAG_MIN_SPEED_RPM = Omega / InvKfi */
+#define EEMF_EMAG_MIN   (int16_t)((float)NORM_VALUE(EEMF_EMAG_MIN_SPEED_RPM,\
+            MC1_PEAK_SPEED_RPM)*(1 << NORM_INVKFI_CONST_QVALUE)/NORM_INVKFI_CONST)
+#define EEMF_THRESHOLD_SPEED  NORM_VALUE(EEMF_THRESHOLD_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+
+/** Estimator parameter adaptation Parameters */
+/* Limits at nominal scale, 1/Ke limit may exceed 16 bits */
+#define ADAPT_RS_MIN      (int32_t)((float)NORM_RS*ADAPT_RS_RATIO_MIN)
+#define ADAPT_RS_MAX      (int32_t)((float)NORM_RS*ADAPT_RS_RATIO_MAX)
+#define ADAPT_INVKFI_MIN  (int32_t)((float)NORM_INVKFI_CONST/ADAPT_KFI_RATIO_MAX)
+#define ADAPT_INVKFI_MAX  (int32_t)((float)NORM_INVKFI_CONST/ADAPT_KFI_RATIO_MIN)
+/* First order filter constant of adaptation step */
+#define ADAPT_KFILTER     (int16_t)(32768.0*ADAPT_DECIMATION_COUNT*\
+                                        LOOPTIME_SEC/ADAPT_TIME_CONST_SEC)
+
+/** Motor parameter identification Parameters */
+#define MOTOR_ID_SPIN_SPEED   NORM_VALUE(MOTOR_ID_SPIN_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+/* Forced speed increment per control period, shifted left by 15 */
+#define MOTOR_ID_RAMP_RATE    (int32_t)((float)MOTOR_ID_SPIN_SPEED*32768.0*\
+                                    LOOPTIME_SEC/MOTOR_ID_RAMP_TIME_SEC)
+/* Electrical angle per control period at peak speed in Q15 radian */
+#define MOTOR_ID_DELTA_THETA  (int16_t)((float)NORM_DELTA_T*3.14159265)
+
+/** Current controller tuning Parameters */
+/* Bandwidth as crossover frequency*control period in Q15 */
+#define CURRENT_LOOP_BANDWIDTH      Q15(2.0*3.14159265*\
+                                    CURRENT_LOOP_BANDWIDTH_HZ*LOOPTIME_SEC)
+#define CURRENT_LOOP_BANDWIDTH_MIN  Q15(2.0*3.14159265*\
+                                    CURRENT_LOOP_BANDWIDTH_MIN_HZ*LOOPTIME_SEC)
+
+/** Speed controller tuning Parameters */
+/* Crossover frequency*control period */
+#define SPEED_LOOP_WCTS     (2.0*3.14159265*SPEED_LOOP_BANDWIDTH_HZ*LOOPTIME_SEC)
+/* Lag of current loop, back EMF and speed filters in control periods, times
+ * crossover frequency */
+#define SPEED_LOOP_LAG      (SPEED_LOOP_WCTS*(32768.0/KFILTER_VELESTIM + \
+                            32768.0/KFILTER_ESDQ + 1.0/(2.0*3.14159265*\
+                            CURRENT_LOOP_BANDWIDTH_HZ*LOOPTIME_SEC)))
+/* tan(phase margin), rational approximation good to 1% up to 70 degrees */
+#define SPEED_LOOP_PM_RAD   (SPEED_LOOP_PHASE_MARGIN_DEG*3.14159265/180.0)
+#define SPEED_LOOP_TAN_PM   (SPEED_LOOP_PM_RAD*\
+                            (15.0 - SPEED_LOOP_PM_RAD*SPEED_LOOP_PM_RAD)/\
+                            (15.0 - 6.0*SPEED_LOOP_PM_RAD*SPEED_LOOP_PM_RAD))
+/* Crossover frequency*integral time, tan(phase margin + lag angle) */
+#define SPEED_LOOP_WCTI     ((SPEED_LOOP_TAN_PM + SPEED_LOOP_LAG)/\
+                            (1.0 - SPEED_LOOP_TAN_PM*SPEED_LOOP_LAG))
+/* Square of gain factor, (wcTi)^2*(1 + lag^2)/(1 + (wcTi)^2) in Q28 */
+#define SPEED_LOOP_GAIN_SQUARE  (int32_t)(268435456.0*\
+                            SPEED_LOOP_WCTI*SPEED_LOOP_WCTI*\
+                            (1.0 + SPEED_LOOP_LAG*SPEED_LOOP_LAG)/\
+                            (1.0 + SPEED_LOOP_WCTI*SPEED_LOOP_WCTI))
+#define SPEED_LOOP_BANDWIDTH    (int32_t)(1073741824.0*SPEED_LOOP_WCTS)
+#define SPEED_LOOP_INTEGRAL_RATIO  (int32_t)(1073741824.0*\
+                            SPEED_LOOP_WCTS/SPEED_LOOP_WCTI)
+/* Mechanical time constant in control periods to 1 per unit speed with 1 per
+ * unit current */
+#define SPEED_LOOP_TAU_MECH     (int32_t)(SPEED_LOOP_TAU_MECH_SEC/LOOPTIME_SEC)
+
+/** S-curve speed profile Parameters */
+#define SPEED_PROFILE_STEP_SEC  (LOOPTIME_SEC*SPEED_PROFILE_DECIMATION_COUNT)
+/* Acceleration in speed counts per step and jerk in speed counts per step 
+ * squared, shifted left by 16 */
+#define SPEED_PROFILE_ACCEL     (int32_t)((float)SPEED_PROFILE_ACCEL_RPM_S*\
+                    SPEED_PROFILE_STEP_SEC/(MC1_PEAK_SPEED_RPM)*2147483648.0)
+#define SPEED_PROFILE_DECEL     (int32_t)((float)SPEED_PROFILE_DECEL_RPM_S*\
+                    SPEED_PROFILE_STEP_SEC/(MC1_PEAK_SPEED_RPM)*2147483648.0)
+#define SPEED_PROFILE_JERK_COUNTS   ((float)SPEED_PROFILE_JERK_RPM_S2*\
+                    SPEED_PROFILE_STEP_SEC*SPEED_PROFILE_STEP_SEC/\
+                    (MC1_PEAK_SPEED_RPM)*2147483648.0)
+#define SPEED_PROFILE_JERK      (uint16_t)SPEED_PROFILE_JERK_COUNTS
+
+/** Position control Parameters */
+#define POSITION_STEP_SEC       (LOOPTIME_SEC*POSITION_DECIMATION_COUNT)
+/* Electrical angle counts per position step at 1 RPM */
+#define POSITION_COUNTS_PER_RPM ((float)POLEPAIRS*65536.0/60.0*POSITION_STEP_SEC)
+/* Speed counts per angle count per position step, Q15 */
+#define POSITION_SPEED_SCALE    (uint16_t)(32768.0*32768.0/\
+                                (MC1_PEAK_SPEED_RPM*POSITION_COUNTS_PER_RPM))
+/* Velocities in angle counts per step and acceleration in angle counts per 
+ * step squared, POSITION_VEL_QVALUE */
+#define POSITION_VELOCITY_MAX   (int32_t)(POSITION_SPEED_MAX_RPM*\
+                                POSITION_COUNTS_PER_RPM*256.0)
+#define POSITION_ACCEL          (uint16_t)(POSITION_ACCEL_RPM_S*\
+                                POSITION_COUNTS_PER_RPM*POSITION_STEP_SEC*256.0)
+#define POSITION_HOME_VELOCITY  (int32_t)(POSITION_HOME_SPEED_RPM*\
+                                POSITION_COUNTS_PER_RPM*256.0)
+/* Homing acceleration needs half of POSITION_HOME_CURRENT from the 
+ * mechanical time constant, the rest is left for load and friction */
+#define POSITION_HOME_ACCEL     (uint16_t)(0.5*POSITION_HOME_CURRENT/\
+                                MC1_PEAK_CURRENT*(MC1_PEAK_SPEED_RPM)/\
+                                SPEED_LOOP_TAU_MECH_SEC*\
+                                POSITION_COUNTS_PER_RPM*POSITION_STEP_SEC*256.0)
+#define POSITION_VELOCITY_PER_SPEED (uint16_t)(MC1_PEAK_SPEED_RPM*\
+                                POSITION_COUNTS_PER_RPM*256.0/32768.0)
+#define POSITION_KP             (int16_t)(2.0*3.14159265*\
+                                POSITION_LOOP_BANDWIDTH_HZ*POSITION_STEP_SEC*\
+                                POSITION_SPEED_SCALE)
+/* Q axis current per velocity change per step from the mechanical time 
+ * constant, POSITION_ACCEL_FF_QVALUE */
+#define POSITION_ACCEL_FF       (int16_t)(SPEED_LOOP_TAU_MECH_SEC*\
+                                POSITION_SPEED_SCALE*1024.0/\
+                                (256.0*32768.0*POSITION_STEP_SEC))
+#define POSITION_HOME_STALL_ERROR   (int32_t)(POSITION_HOME_STALL_REV*\
+                                POLEPAIRS*65536.0)
+
+/** Torque mode Parameters */
+/* Current command change per control cycle, TORQUE_CONTROL_SLEW_QVALUE */
+#define TORQUE_SLEW_RATE        (uint16_t)(TORQUE_SLEW_A_S*LOOPTIME_SEC*\
+                                32768.0*256.0/MC1_PEAK_CURRENT)
+#define TORQUE_SPEED_LIMIT      NORM_VALUE(TORQUE_SPEED_LIMIT_RPM,MC1_PEAK_SPEED_RPM)
+
+/** Load disturbance observer Parameters */
+#define DISTURBANCE_STEP_SEC    (LOOPTIME_SEC*DISTURBANCE_DECIMATION_COUNT)
+#define DISTURBANCE_WT          (2.0*3.14159265*DISTURBANCE_BANDWIDTH_HZ*\
+                                DISTURBANCE_STEP_SEC)
+/* Distance of the double observer pole from one */
+#define DISTURBANCE_POLE        (DISTURBANCE_WT/(1.0 + DISTURBANCE_WT))
+/* Speed change per step for one current count, DISTURBANCE_GAIN_QVALUE */
+#define DISTURBANCE_SPEED_GAIN  (uint16_t)(DISTURBANCE_STEP_SEC*1048576.0/\
+                                SPEED_LOOP_TAU_MECH_SEC)
+#define DISTURBANCE_SPEED_CORR  (uint16_t)(2.0*DISTURBANCE_POLE*32768.0)
+#define DISTURBANCE_LOAD_CORR   (uint16_t)(DISTURBANCE_POLE*DISTURBANCE_POLE*\
+                                SPEED_LOOP_TAU_MECH_SEC*256.0/\
+                                DISTURBANCE_STEP_SEC)
+
+/** High frequency injection Parameters */
+/* Ld/dt and Lq/dt in per unit */
+#define HFI_LDDT    ((float)MOTOR_LD_H*MC1_PEAK_CURRENT/(MC1_BASE_VOLTAGE*LOOPTIME_SEC))
+#define HFI_LQDT    ((float)MOTOR_LQ_H*MC1_PEAK_CURRENT/(MC1_BASE_VOLTAGE*LOOPTIME_SEC))
+#define HFI_VOLTAGE_AMPLITUDE   NORM_VALUE(HFI_VOLTAGE,MC1_BASE_VOLTAGE)
+/* Angle error / Q current response = 1/(Vh*(1/(Ld/dt) - 1/(Lq/dt))) */
+#define HFI_ERROR_GAIN_QVALUE   8
+#define HFI_ERROR_GAIN  (int16_t)((float)(1 << HFI_ERROR_GAIN_QVALUE)/\
+            ((float)HFI_VOLTAGE/MC1_BASE_VOLTAGE*(1/HFI_LDDT - 1/HFI_LQDT)))
+/* Response is caused by the last injection voltage for odd delay */
+#define HFI_DEMOD_POLARITY  ((HFI_INJECTION_DELAY & 1) ? 1 : -1)
+#define HFI_CROSSOVER_SPEED   NORM_VALUE(HFI_CROSSOVER_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+#define HFI_RETURN_SPEED      NORM_VALUE(HFI_RETURN_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+
+/** Initial position detection Parameters */
+#define IPD_RESPONSE_MIN    NORM_VALUE(IPD_RESPONSE_MIN_AMPS,MC1_PEAK_CURRENT)
+
+/** Flying start Parameters */
+#define FLYING_START_MIN_SPEED  NORM_VALUE(FLYING_START_MIN_SPEED_RPM,MC1_PEAK_SPEED_RPM)
+/* Back EMF at FLYING_START_EMAG_MIN_SPEED_RPM = Omega / InvKfi */
+#define FLYING_START_EMAG_MIN   (int16_t)((float)NORM_VALUE(\
+            FLYING_START_EMAG_MIN_SPEED_RPM,MC1_PEAK_SPEED_RPM)*\
+            (1 << NORM_INVKFI_CONST_QVALUE)/NORM_INVKFI_CONST)
+
+/** Dead time compensation Parameters */
+/* Duty correction in PWM counts, dead time as a fraction of PWM period */
+#define DEADTIME_COMP_COUNTS    (int16_t)(DEADTIME_COMP_FACTOR*\
+                                DEADTIME_MICROSEC*LOOPTIME_TCY/LOOPTIME_MICROSEC)
+#define DEADTIME_POLARITY_GAIN  (int16_t)(MC1_PEAK_CURRENT/DEADTIME_COMP_CURRENT)
+
+/** Discontinuous PWM Parameters */
+/* Voltage at modulation index m, m*DC bus voltage/sqrt(3), per unit DC bus 
+ * voltage */
+#define DPWM_VOLT_FACTOR(m)     (int16_t)((float)(m)*MC1_PEAK_VOLTAGE*0.57735/\
+                                MC1_BASE_VOLTAGE*32767)
+#define DPWM_VOLT_FACTOR_ON     DPWM_VOLT_FACTOR(DPWM_MODULATION_ON)
+#define DPWM_VOLT_FACTOR_OFF    DPWM_VOLT_FACTOR(DPWM_MODULATION_OFF)
+
+/** Overmodulation Parameters */
+#define OVERMOD_CURRENT_FILTER  (int16_t)(2*3.14159265*OVERMOD_CURRENT_FILTER_HZ*\
+                                LOOPTIME_SEC*32767)
+#define FD_WEAK_VOLTAGE_REF_FACTOR  Q15(FW_VOLTAGE_REF_FACTOR)
       
 // </editor-fold>
 
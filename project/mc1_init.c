@@ -58,11 +58,36 @@
 
 #include "board_service.h"
 #include "fault.h"
+#include "pi_tune.h"
 #include "generic_load.h"
 #include "generic_load_types.h"
 
 // </editor-fold>
 
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Phase A and B currents are measured by low side shunts, a phase clamped to
+ * positive rail has no current sample */
+#if (DPWM_MODE != MCAPP_DPWM_NONE) && (DPWM_MODE != MCAPP_DPWM_MIN)
+    #error "DPWM_MODE clamps to positive rail, phase current is not measured"
+#endif
+
+/* S-curve profile jerk must be 1...65535, and acceleration limits divided 
+ * by jerk below 65536. Parameters are floating point, which #if cannot 
+ * evaluate, bit-field width is negative and the build stops when a check 
+ * fails */
+typedef struct
+{
+    unsigned int jerkRange : 
+        (((int32_t)SPEED_PROFILE_JERK_COUNTS >= 1) && 
+         ((int32_t)SPEED_PROFILE_JERK_COUNTS <= UINT16_MAX)) ? 1 : -1;
+    unsigned int accelJerkRatio : 
+        (((SPEED_PROFILE_ACCEL >> 16) < SPEED_PROFILE_JERK) && 
+         ((SPEED_PROFILE_DECEL >> 16) < SPEED_PROFILE_JERK)) ? 1 : -1;
+} MCAPP_SPEED_PROFILE_CHECK_T;
+
+// </editor-fold>
+
 // <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
 
 static void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *);
@@ -73,6 +98,23 @@ static void MCAPP_MC1LoadStartTransition(MCAPP_CONTROL_SCHEME_T *,
 static void MCAPP_MC1LoadStopTransition(MCAPP_CONTROL_SCHEME_T *, 
                                             MCAPP_LOAD_T *);
 static void MCAPP_MC1OutputConfig(MC1APP_DATA_T *);
+static void MCAPP_MC1FaultConfig(MC1APP_DATA_T *);
+static void MCAPP_MC1IPDConfig(MC1APP_DATA_T *);
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Global Variables  ">
+
+/* Flux weakening feedforward Id, rows at DC bus voltages 0.5, 0.625, 0.75,
+ * 0.875 and 1.0 of MC1_PEAK_VOLTAGE */
+static const int16_t fluxFeedForwardTable[FW_FF_VDC_POINTS][FW_FF_SPEED_POINTS] = 
+{
+    FW_FF_ROW(0.5),
+    FW_FF_ROW(0.625),
+    FW_FF_ROW(0.75),
+    FW_FF_ROW(0.875),
+    FW_FF_ROW(1.0)
+};
 
 // </editor-fold>
 
@@ -110,6 +152,12 @@ void MCAPP_MC1ParamsInit(MC1APP_DATA_T *pMCData)
     
     /* Configure Outputs */
     MCAPP_MC1OutputConfig(pMCData);
+    
+    /* Configure Faults */
+    MCAPP_MC1FaultConfig(pMCData);
+    
+    /* Configure Initial Position Detection */
+    MCAPP_MC1IPDConfig(pMCData);
 
     /* Set motor control state as 'MTR_INIT' */
     pMCData->appState = MCAPP_INIT;
@@ -132,12 +180,10 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     MCAPP_CONTROL_SCHEME_T *pControlScheme;
     MCAPP_MEASURE_T *pMotorInputs;
     MCAPP_MOTOR_T *pMotor;
-    MCAPP_FAULT_T *pFault;
     
     pControlScheme = pMCData->pControlScheme;
     pMotorInputs = pMCData->pMotorInputs;
     pMotor = pMCData->pMotor;
-    pFault = &pMCData->fault;
     
     /* Configure Inputs */  
     pControlScheme->pIa = &pMotorInputs->measureCurrent.Ia;
@@ -157,10 +203,6 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     pMotor->qMinSpeed       = NORM_VALUE(MINIMUM_SPEED_RPM, MC1_PEAK_SPEED_RPM);
 
     pMotor->qRatedCurrent = NORM_VALUE(NOMINAL_CURRENT_PEAK, MC1_PEAK_CURRENT); 
-
-    /* Initialize fault parameters */
-    pFault->overCurrentFaultLimit = PEAK_FAULT_CURRENT;
-    
     
     /* Initialize FOC control parameters */
 #ifdef  OPEN_LOOP_FUNCTIONING
@@ -169,15 +211,40 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     pControlScheme->ctrlParam.openLoop = 0;
 #endif   
     
+#ifdef  HFI_STARTUP
+    pControlScheme->ctrlParam.hfiEnable = 1;
+#else
+    pControlScheme->ctrlParam.hfiEnable = 0;
+#endif
+    pControlScheme->ctrlParam.qHFICrossoverSpeed = HFI_CROSSOVER_SPEED;
+    pControlScheme->ctrlParam.qHFIReturnSpeed = HFI_RETURN_SPEED;
+    
+#ifdef  FLYING_START
+    pControlScheme->ctrlParam.flyingStartEnable = 1;
+#else
+    pControlScheme->ctrlParam.flyingStartEnable = 0;
+#endif
+    pControlScheme->ctrlParam.qFlyingStartMinSpeed = FLYING_START_MIN_SPEED;
+    pControlScheme->ctrlParam.flyingStartTimeLimit = FLYING_START_TIME_COUNT;
+    
     pControlScheme->ctrlParam.lockTimeLimit = LOCK_TIME_COUNT;
     pControlScheme->ctrlParam.lockCurrent = 
                     NORM_VALUE(LOCK_CURRENT, MC1_PEAK_CURRENT);
 
-    pControlScheme->ctrlParam.OLCurrent = 
+    pControlScheme->ctrlParam.OLCurrentStart = 
                     NORM_VALUE(MIN_OPENLOOP_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->ctrlParam.OLCurrent = 
+                    pControlScheme->ctrlParam.OLCurrentStart;
     pControlScheme->ctrlParam.OLCurrentMax = 
                     NORM_VALUE(MAX_OPENLOOP_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->ctrlParam.OLCurrentMin = 
+                    NORM_VALUE(IF_MIN_CURRENT, MC1_PEAK_CURRENT);
     pControlScheme->ctrlParam.OLCurrentRampRate = OL_CURRENT_RAMP_RATE_COUNT;
+    pControlScheme->ctrlParam.OLCurrentRampSkipCntLimit = 
+                    IF_CURRENT_RAMP_TIME_MULTIPLIER;
+    pControlScheme->ctrlParam.qIfLoadAngle = IF_LOAD_ANGLE;
+    pControlScheme->ctrlParam.handoverTimeLimit = HANDOVER_TIME_COUNT;
+    pControlScheme->ctrlParam.OLStallTimeLimit = OL_STALL_TIME_COUNT;
 
     pControlScheme->ctrlParam.speedRampSkipCntLimit = OL_SPEED_RAMP_TIME_MULTIPLIER;
     pControlScheme->ctrlParam.OLSpeedRampRate = OL_SPEED_RAMP_RATE_COUNT;
@@ -188,6 +255,77 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     pControlScheme->ctrlParam.speedRampIncLimit = RAMP_UP_TIME_MULTIPLIER;
     pControlScheme->ctrlParam.speedRampDecLimit = RAMP_DN_TIME_MULTIPLIER;   
     
+    /* S-curve speed profile */
+#ifdef SPEED_SCURVE_PROFILE
+    pControlScheme->speedProfile.enable = 1;
+#else
+    pControlScheme->speedProfile.enable = 0;
+#endif
+    pControlScheme->speedProfile.accelMax = SPEED_PROFILE_ACCEL;
+    pControlScheme->speedProfile.decelMax = SPEED_PROFILE_DECEL;
+    pControlScheme->speedProfile.jerk = SPEED_PROFILE_JERK;
+    pControlScheme->speedProfile.countLimit = SPEED_PROFILE_DECIMATION_COUNT;
+    pControlScheme->speedProfile.pCtrlParam = &pControlScheme->ctrlParam;
+    
+    /* Position control */
+#ifdef POSITION_CONTROL
+    pControlScheme->position.enable = 1;
+#else
+    pControlScheme->position.enable = 0;
+#endif
+    pControlScheme->position.position = 0;
+    pControlScheme->position.homed = 0;
+    pControlScheme->position.velocityMax = POSITION_VELOCITY_MAX;
+    pControlScheme->position.accel = POSITION_ACCEL;
+    pControlScheme->position.homeVelocity = POSITION_HOME_VELOCITY;
+    pControlScheme->position.homeAccel = POSITION_HOME_ACCEL;
+    pControlScheme->position.homePosition = POSITION_HOME_POSITION;
+    pControlScheme->position.homeStallError = POSITION_HOME_STALL_ERROR;
+    pControlScheme->position.homeStallCountLimit = POSITION_HOME_STALL_COUNT;
+    pControlScheme->position.qSpeedScale = POSITION_SPEED_SCALE;
+    pControlScheme->position.velocityPerSpeed = POSITION_VELOCITY_PER_SPEED;
+    pControlScheme->position.qKp = POSITION_KP;
+    pControlScheme->position.qAccelFFGain = POSITION_ACCEL_FF;
+    pControlScheme->position.qIqMax = SPEEDCNTR_OUTMAX;
+    pControlScheme->position.qIqHome = 
+                    NORM_VALUE(POSITION_HOME_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->position.countLimit = POSITION_DECIMATION_COUNT;
+    pControlScheme->position.pTheta = &pControlScheme->estimInterface.qTheta;
+    pControlScheme->position.pCtrlParam = &pControlScheme->ctrlParam;
+    pControlScheme->position.pPISpeed = &pControlScheme->piSpeed;
+    
+    /* Torque mode */
+#ifdef TORQUE_CONTROL
+    pControlScheme->torqueControl.enable = 1;
+#else
+    pControlScheme->torqueControl.enable = 0;
+#endif
+    pControlScheme->torqueControl.modeRequest = MCAPP_TORQUE_CONTROL_SPEED_MODE;
+    pControlScheme->torqueControl.qIqTarget = 0;
+    pControlScheme->torqueControl.slewRate = TORQUE_SLEW_RATE;
+    pControlScheme->torqueControl.qIqMax = SPEEDCNTR_OUTMAX;
+    pControlScheme->torqueControl.qSpeedLimit = TORQUE_SPEED_LIMIT;
+    pControlScheme->torqueControl.pVelEstim = 
+                                &pControlScheme->estimInterface.qVelEstim;
+    pControlScheme->torqueControl.pCtrlParam = &pControlScheme->ctrlParam;
+    pControlScheme->torqueControl.pPISpeed = &pControlScheme->piSpeed;
+    
+    /* Load disturbance observer */
+#ifdef DISTURBANCE_OBSERVER
+    pControlScheme->disturbance.enable = 1;
+#else
+    pControlScheme->disturbance.enable = 0;
+#endif
+    pControlScheme->disturbance.speedGain = DISTURBANCE_SPEED_GAIN;
+    pControlScheme->disturbance.qSpeedCorrGain = DISTURBANCE_SPEED_CORR;
+    pControlScheme->disturbance.loadCorrGain = DISTURBANCE_LOAD_CORR;
+    pControlScheme->disturbance.qIqMax = SPEEDCNTR_OUTMAX;
+    pControlScheme->disturbance.countLimit = DISTURBANCE_DECIMATION_COUNT;
+    pControlScheme->disturbance.pIq = &pControlScheme->idq.q;
+    pControlScheme->disturbance.pVelEstim = 
+                                &pControlScheme->estimInterface.qVelEstim;
+    pControlScheme->disturbance.pPISpeed = &pControlScheme->piSpeed;
+    
     pControlScheme->ctrlParam.normDeltaT = NORM_DELTA_T;
 
     
@@ -222,7 +360,8 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     /* Initialize PLL Estimator */
     pControlScheme->estimPLL.pCtrlParam  = &pControlScheme->ctrlParam;
     pControlScheme->estimPLL.pIAlphaBeta = &pControlScheme->ialphabeta;
-    pControlScheme->estimPLL.pVAlphaBeta = &pControlScheme->valphabeta;
+    pControlScheme->estimPLL.pVAlphaBeta = 
+                        &pControlScheme->deadTime.valphabetaOut;
     pControlScheme->estimPLL.pMotor      = pMCData->pMotor;
     pControlScheme->estimPLL.pIdq        = &pControlScheme->idq;
 
@@ -237,6 +376,171 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
                        = NORM_VALUE(DECIMATE_NOMINAL_SPEED, MC1_PEAK_SPEED_RPM);
     pControlScheme->estimPLL.qThresholdSpeedDerivative = pMotor->qNominalSpeed;
     
+    /* Initialize Extended EMF Observer Estimator */
+    pControlScheme->estimEEMF.pIAlphaBeta = &pControlScheme->ialphabeta;
+    pControlScheme->estimEEMF.pVAlphaBeta = 
+                        &pControlScheme->deadTime.valphabetaOut;
+    pControlScheme->estimEEMF.pMotor      = pMCData->pMotor;
+    
+    pControlScheme->estimEEMF.qDeltaT = NORM_DELTA_T;
+    pControlScheme->estimEEMF.qRotationConst = EEMF_ROTATION_CONST;
+    pControlScheme->estimEEMF.qK1Min = Q15(EEMF_OBSERVER_K1_MIN);
+    pControlScheme->estimEEMF.qK1Slope = Q15(EEMF_OBSERVER_K1_SLOPE);
+    pControlScheme->estimEEMF.qK2Min = Q15(EEMF_OBSERVER_K2_MIN);
+    pControlScheme->estimEEMF.qK2Slope = Q15(EEMF_OBSERVER_K2_SLOPE);
+    pControlScheme->estimEEMF.qKpPLL = Q15(EEMF_PLL_KP);
+    pControlScheme->estimEEMF.qKiPLL = Q15(EEMF_PLL_KI);
+    pControlScheme->estimEEMF.qEmagMin = EEMF_EMAG_MIN;
+    pControlScheme->estimEEMF.qOmegaFiltConst = KFILTER_VELESTIM;
+    pControlScheme->estimEEMF.qThresholdSpeed = EEMF_THRESHOLD_SPEED;
+    pControlScheme->estimEEMF.qInvKfiConst = NORM_INVKFI_CONST;
+    pControlScheme->estimEEMF.qInvKfiConstScale = NORM_INVKFI_CONST_QVALUE;
+    
+    /* Initialize Estimator Lock Monitor */
+    pControlScheme->estimMonitor.pCtrlParam = &pControlScheme->ctrlParam;
+    pControlScheme->estimMonitor.qBEMFRatioMin = 
+                                        Q15(LOCK_MONITOR_BEMF_RATIO_MIN);
+    pControlScheme->estimMonitor.qBEMFRatioExcess = 
+                                        Q15(LOCK_MONITOR_BEMF_RATIO_EXCESS);
+    pControlScheme->estimMonitor.qEsdRatioMax = Q15(LOCK_MONITOR_ESD_RATIO_MAX);
+    pControlScheme->estimMonitor.qSpeedErrorMax = LOSS_OF_LOCK_SPEED_ERROR;
+    pControlScheme->estimMonitor.qStallSpeed = STALL_SPEED;
+    pControlScheme->estimMonitor.qVelRefMin = LOCK_MONITOR_MIN_SPEED;
+    pControlScheme->estimMonitor.angleAccLimit = LOCK_MONITOR_ANGLE_LIMIT;
+    pControlScheme->estimMonitor.timeCountLimit = LOCK_MONITOR_TIME_COUNT;
+    pControlScheme->estimMonitor.qInvKfiConst = NORM_INVKFI_CONST;
+    pControlScheme->estimMonitor.qInvKfiConstScale = NORM_INVKFI_CONST_QVALUE;
+    pControlScheme->estimMonitor.qDeltaT = NORM_DELTA_T;
+    
+    /* Initialize Estimator Parameter Adaptation */
+#ifdef  ESTIMATOR_ADAPTATION
+    pControlScheme->estimAdapt.enable = 1;
+#else
+    pControlScheme->estimAdapt.enable = 0;
+#endif
+    pControlScheme->estimAdapt.pMotor = pMCData->pMotor;
+    pControlScheme->estimAdapt.pEstim = &pControlScheme->estimPLL;
+    pControlScheme->estimAdapt.pMonitor = &pControlScheme->estimMonitor;
+    pControlScheme->estimAdapt.pIdq = &pControlScheme->idq;
+    pControlScheme->estimAdapt.rsStateVar = (int32_t)NORM_RS << 15;
+    pControlScheme->estimAdapt.rsMin = ADAPT_RS_MIN;
+    pControlScheme->estimAdapt.rsMax = ADAPT_RS_MAX;
+    pControlScheme->estimAdapt.rsScaleNominal = NORM_RS_QVALUE;
+    pControlScheme->estimAdapt.invKfiStateVar = (int32_t)NORM_INVKFI_CONST << 15;
+    pControlScheme->estimAdapt.invKfiMin = ADAPT_INVKFI_MIN;
+    pControlScheme->estimAdapt.invKfiMax = ADAPT_INVKFI_MAX;
+    pControlScheme->estimAdapt.invKfiScaleNominal = NORM_INVKFI_CONST_QVALUE;
+    pControlScheme->estimAdapt.qRsMaxSpeed = 
+                    NORM_VALUE(ADAPT_RS_MAX_SPEED_RPM, MC1_PEAK_SPEED_RPM);
+    pControlScheme->estimAdapt.qRsMinCurrent = 
+                    NORM_VALUE(ADAPT_RS_MIN_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->estimAdapt.qKfiMinSpeed = 
+                    NORM_VALUE(ADAPT_KFI_MIN_SPEED_RPM, MC1_PEAK_SPEED_RPM);
+    pControlScheme->estimAdapt.qKfilter = ADAPT_KFILTER;
+    pControlScheme->estimAdapt.countLimit = ADAPT_DECIMATION_COUNT;
+    
+    /* Initialize High Frequency Injection Estimator */
+    pControlScheme->hfi.pIdq = &pControlScheme->idq;
+    pControlScheme->hfi.qVdInjectionAmp = HFI_VOLTAGE_AMPLITUDE;
+    pControlScheme->hfi.demodPolarity = HFI_DEMOD_POLARITY;
+    pControlScheme->hfi.qErrorGain = HFI_ERROR_GAIN;
+    pControlScheme->hfi.qErrorGainScale = HFI_ERROR_GAIN_QVALUE;
+    pControlScheme->hfi.qKpPLL = Q15(HFI_PLL_KP);
+    pControlScheme->hfi.qKiPLL = Q15(HFI_PLL_KI);
+    pControlScheme->hfi.qDeltaT = NORM_DELTA_T;
+    pControlScheme->hfi.qOmegaFiltConst = KFILTER_VELESTIM;
+    pControlScheme->hfi.qPolarityCurrent = 
+                    NORM_VALUE(HFI_POLARITY_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->hfi.alignTimeLimit = HFI_ALIGN_TIME_COUNT;
+    pControlScheme->hfi.polarityTimeLimit = HFI_POLARITY_TIME_COUNT;
+    
+    /* Initialize flying start */
+    pControlScheme->flyingStart.pIAlphaBeta = &pControlScheme->ialphabeta;
+    pControlScheme->flyingStart.pVAlphaBeta = 
+                        &pControlScheme->deadTime.valphabetaOut;
+    pControlScheme->flyingStart.pMotor = pMCData->pMotor;
+    pControlScheme->flyingStart.qKpPLL = Q15(FLYING_START_PLL_KP);
+    pControlScheme->flyingStart.qKiPLL = Q15(FLYING_START_PLL_KI);
+    pControlScheme->flyingStart.qDeltaT = NORM_DELTA_T;
+    pControlScheme->flyingStart.qOmegaFiltConst = KFILTER_VELESTIM;
+    pControlScheme->flyingStart.qKfilterEsdq = KFILTER_ESDQ;
+    pControlScheme->flyingStart.qInvKfiConst = NORM_INVKFI_CONST;
+    pControlScheme->flyingStart.qInvKfiConstScale = NORM_INVKFI_CONST_QVALUE;
+    pControlScheme->flyingStart.qEmagMin = FLYING_START_EMAG_MIN;
+    pControlScheme->flyingStart.qLockError = Q15(FLYING_START_LOCK_ERROR);
+    pControlScheme->flyingStart.lockCountLimit = FLYING_START_LOCK_COUNT;
+    
+    /* Initialize motor parameter identification */
+#ifdef  MOTOR_IDENTIFICATION
+    pControlScheme->motorId.request = 1;
+#else
+    pControlScheme->motorId.request = 0;
+#endif
+    pControlScheme->motorId.pIdq = &pControlScheme->idq;
+    pControlScheme->motorId.pVdq = &pControlScheme->vdq;
+    pControlScheme->motorId.pEstimInterface = &pControlScheme->estimInterface;
+    pControlScheme->motorId.qCurrentLow = 
+                    NORM_VALUE(MOTOR_ID_CURRENT_LOW, MC1_PEAK_CURRENT);
+    pControlScheme->motorId.qCurrentHigh = 
+                    NORM_VALUE(MOTOR_ID_CURRENT_HIGH, MC1_PEAK_CURRENT);
+    pControlScheme->motorId.qPulseVoltage = 
+                    NORM_VALUE(MOTOR_ID_PULSE_VOLTAGE, MC1_BASE_VOLTAGE);
+    pControlScheme->motorId.qSpinCurrent = 
+                    NORM_VALUE(MOTOR_ID_SPIN_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->motorId.qSpinSpeed = MOTOR_ID_SPIN_SPEED;
+    pControlScheme->motorId.qInertiaCurrent = 
+                    NORM_VALUE(MOTOR_ID_INERTIA_CURRENT, MC1_PEAK_CURRENT);
+    pControlScheme->motorId.qDeltaT = NORM_DELTA_T;
+    pControlScheme->motorId.qDeltaTheta = MOTOR_ID_DELTA_THETA;
+    pControlScheme->motorId.omegaRampRate = MOTOR_ID_RAMP_RATE;
+    pControlScheme->motorId.settleCountLimit = MOTOR_ID_SETTLE_COUNT;
+    pControlScheme->motorId.averageBits = MOTOR_ID_AVERAGE_BITS;
+    pControlScheme->motorId.pulseCountLimit = MOTOR_ID_PULSE_COUNT;
+    pControlScheme->motorId.pulseBits = MOTOR_ID_PULSE_BITS;
+    pControlScheme->motorId.decayCountLimit = MOTOR_ID_DECAY_COUNT;
+    pControlScheme->motorId.inertiaCountLimit = MOTOR_ID_INERTIA_COUNT;
+    pControlScheme->motorId.inertiaSettleCountLimit = 
+                                            MOTOR_ID_INERTIA_SETTLE_COUNT;
+    pControlScheme->motorId.rsScaleNominal = NORM_RS_QVALUE;
+    pControlScheme->motorId.lsDtScaleNominal = NORM_LSDT_QVALUE;
+    pControlScheme->motorId.invKfiConstScaleNominal = NORM_INVKFI_CONST_QVALUE;
+    pControlScheme->motorId.qCurrentBandwidth = CURRENT_LOOP_BANDWIDTH;
+    pControlScheme->motorId.qCurrentBandwidthMin = CURRENT_LOOP_BANDWIDTH_MIN;
+    pControlScheme->motorId.stepCountLimit = MOTOR_ID_STEP_COUNT;
+    pControlScheme->motorId.qOvershootMax = Q15(MOTOR_ID_STEP_OVERSHOOT);
+    
+#ifdef  CURRENT_LOOP_AUTOTUNE
+    /* Current controller gains from configured motor parameters */
+    MCAPP_PITuneCurrent(&pControlScheme->piDCurrent, CURRENT_LOOP_BANDWIDTH,
+                        NORM_RS, NORM_RS_QVALUE, NORM_LSDT, NORM_LSDT_QVALUE);
+    MCAPP_PITuneCurrent(&pControlScheme->piQCurrent, CURRENT_LOOP_BANDWIDTH,
+                        NORM_RS, NORM_RS_QVALUE, NORM_LSDT, NORM_LSDT_QVALUE);
+    pControlScheme->motorId.currentTuneEnable = 1;
+#else
+    pControlScheme->motorId.currentTuneEnable = 0;
+#endif
+#ifdef  CURRENT_LOOP_STEP_TEST
+    pControlScheme->motorId.stepTestEnable = 1;
+#else
+    pControlScheme->motorId.stepTestEnable = 0;
+#endif
+    
+    /* Initialize speed controller tuning */
+    pControlScheme->speedTune.bandwidth = SPEED_LOOP_BANDWIDTH;
+    pControlScheme->speedTune.gainSquare = SPEED_LOOP_GAIN_SQUARE;
+    pControlScheme->speedTune.integralRatio = SPEED_LOOP_INTEGRAL_RATIO;
+    pControlScheme->speedTune.tauMech = 0;
+#ifdef  SPEED_LOOP_AUTOTUNE
+    pControlScheme->speedTune.enable = 1;
+    MCAPP_PITuneSpeed(&pControlScheme->piSpeed, &pControlScheme->speedTune,
+                        SPEED_LOOP_TAU_MECH, 0);
+#else
+    pControlScheme->speedTune.enable = 0;
+#endif
+    
+    /* Connect the estimator used by FOC */
+    MCAPP_FOCEstimatorSelect(pControlScheme, ESTIMATOR_SELECT);
+    
     
     /* Initialize field weakening controller 2*/ 
     pControlScheme->fluxControl.feedBackFW.pCtrlParam = &pControlScheme->ctrlParam;
@@ -252,6 +556,93 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     pControlScheme->fluxControl.feedBackFW.FWeakPI.outMin = ID_REF_MIN;
     pControlScheme->fluxControl.feedBackFW.IdRefFiltConst = FD_WEAK_IDREF_FILT_CONST;
     pControlScheme->fluxControl.feedBackFW.IdRefMin = ID_REF_MIN;
+    pControlScheme->fluxControl.feedBackFW.pVdc = pControlScheme->pVdc;
+    pControlScheme->fluxControl.feedBackFW.pVoltageMax = 
+                                            &pControlScheme->vPhaseMax;
+    pControlScheme->fluxControl.feedBackFW.qVoltageRefFactor = 
+                                            FD_WEAK_VOLTAGE_REF_FACTOR;
+#ifdef OVERMODULATION
+    pControlScheme->fluxControl.feedBackFW.voltageRefTrack = 1;
+#else
+    pControlScheme->fluxControl.feedBackFW.voltageRefTrack = 0;
+#endif
+    pControlScheme->fluxControl.feedBackFW.pFeedForwardTable = 
+                                        &fluxFeedForwardTable[0][0];
+    pControlScheme->fluxControl.feedBackFW.vdcTableMin = FW_FF_VDC_MIN;
+#ifdef  FLUX_WEAKENING_FEEDFORWARD
+    pControlScheme->fluxControl.feedBackFW.feedForwardEnable = 1;
+#else
+    pControlScheme->fluxControl.feedBackFW.feedForwardEnable = 0;
+#endif
+    
+    /* Initialize maximum torque per ampere control */
+#ifdef  MTPA_CONTROL
+    pControlScheme->fluxControl.mtpa.enable = 1;
+#else
+    pControlScheme->fluxControl.mtpa.enable = 0;
+#endif
+    pControlScheme->fluxControl.mtpa.currentConst = MTPA_CURRENT_CONST;
+    pControlScheme->fluxControl.mtpa.pCtrlParam = &pControlScheme->ctrlParam;
+    
+    /* Current controller decoupling */
+#ifdef  CURRENT_LOOP_DECOUPLING
+    pControlScheme->decoupling.enable = 1;
+#else
+    pControlScheme->decoupling.enable = 0;
+#endif
+    pControlScheme->decoupling.qLd = DECOUPLING_LD;
+    pControlScheme->decoupling.qLq = DECOUPLING_LQ;
+    pControlScheme->decoupling.qFlux = DECOUPLING_FLUX;
+    pControlScheme->decoupling.qValue = DECOUPLING_QVALUE;
+    pControlScheme->decoupling.pOmega = &pControlScheme->estimInterface.qVelEstim;
+    pControlScheme->decoupling.pIdq = &pControlScheme->idq;
+    
+    /* Dead time compensation */
+#ifdef  DEADTIME_COMPENSATION
+    pControlScheme->deadTime.enable = 1;
+#else
+    pControlScheme->deadTime.enable = 0;
+#endif
+#ifdef  DEADTIME_ESTIMATOR_CORRECTION
+    pControlScheme->deadTime.estimatorEnable = 1;
+#else
+    pControlScheme->deadTime.estimatorEnable = 0;
+#endif
+    pControlScheme->deadTime.compCounts = DEADTIME_COMP_COUNTS;
+    pControlScheme->deadTime.polarityGain = DEADTIME_POLARITY_GAIN;
+    pControlScheme->deadTime.qVoltPerCount = PWM_VOLT_PER_COUNT;
+    pControlScheme->deadTime.dutyMin = MIN_DUTY;
+    pControlScheme->deadTime.dutyMax = MAX_DUTY;
+    pControlScheme->deadTime.dutyHigh = MC1_LOOPTIME_TCY;
+    pControlScheme->deadTime.pIabc = &pControlScheme->iabc;
+    pControlScheme->deadTime.pVAlphaBeta = &pControlScheme->valphabeta;
+    pControlScheme->deadTime.pVdc = pControlScheme->pVdc;
+    
+    /* Discontinuous PWM */
+    pControlScheme->dpwm.mode = DPWM_MODE;
+    pControlScheme->dpwm.qVoltFactorOn = DPWM_VOLT_FACTOR_ON;
+    pControlScheme->dpwm.qVoltFactorOff = DPWM_VOLT_FACTOR_OFF;
+    pControlScheme->dpwm.dutyMin = MIN_DUTY;
+    pControlScheme->dpwm.dutyHigh = MC1_LOOPTIME_TCY;
+    pControlScheme->dpwm.dutyRefresh = MAX_DUTY;
+    pControlScheme->dpwm.refreshCountLimit = DPWM_REFRESH_COUNT;
+    pControlScheme->dpwm.pVabc = &pControlScheme->vabc;
+    pControlScheme->dpwm.pVAlphaBeta = &pControlScheme->valphabeta;
+    pControlScheme->dpwm.pVdc = pControlScheme->pVdc;
+    
+    /* Overmodulation */
+#ifdef OVERMODULATION
+    pControlScheme->overmod.enable = 1;
+#else
+    pControlScheme->overmod.enable = 0;
+#endif
+    pControlScheme->overmod.qVoltPerCount = PWM_VOLT_PER_COUNT;
+    pControlScheme->overmod.qCurrentFilterConst = OVERMOD_CURRENT_FILTER;
+    pControlScheme->overmod.dutyHigh = MC1_LOOPTIME_TCY;
+    pControlScheme->overmod.dutyMax = MAX_DUTY;
+    pControlScheme->overmod.pVabc = &pControlScheme->vabcCompDC;
+    pControlScheme->overmod.pIdq = &pControlScheme->idq;
+    pControlScheme->overmod.pVdc = pControlScheme->pVdc;
     
 
     /* Output Initializations */
@@ -261,6 +652,7 @@ void MCAPP_MC1ControlSchemeConfig(MC1APP_DATA_T *pMCData)
     /* Initialize application structure */
     pMCData->MCAPP_ControlSchemeInit = MCAPP_FOCInit;
     pMCData->MCAPP_ControlStateMachine = MCAPP_FOCStateMachine;
+    pMCData->MCAPP_ControlStartFromAngle = MCAPP_FOCStartFromAngle;
 
     pMCData->MCAPP_InputsInit = MCAPP_MeasureCurrentInit;
     pMCData->MCAPP_MeasureOffset = MCAPP_MeasureCurrentOffset;
@@ -297,7 +689,18 @@ void MCAPP_MC1LoadConfig(MC1APP_DATA_T *pMCData)
 void MCAPP_MC1LoadStartTransition(MCAPP_CONTROL_SCHEME_T *pControlScheme, 
                                     MCAPP_LOAD_T *pLoad)
 {
-    pControlScheme->focState =  FOC_RTR_LOCK; 
+    if (pControlScheme->ctrlParam.flyingStartEnable)
+    {
+        pControlScheme->focState =  FOC_FLYING_START;
+    }
+    else if (pControlScheme->ctrlParam.hfiEnable)
+    {
+        pControlScheme->focState =  FOC_HFI;
+    }
+    else
+    {
+        pControlScheme->focState =  FOC_RTR_LOCK; 
+    }
 }
 
 void MCAPP_MC1LoadStopTransition(MCAPP_CONTROL_SCHEME_T *pControlScheme, 
@@ -312,4 +715,108 @@ void MCAPP_MC1OutputConfig(MC1APP_DATA_T *pMCData)
     pMCData->HAL_PWMEnableOutputs = HAL_MC1PWMEnableOutputs;
     pMCData->HAL_PWMDisableOutputs = HAL_MC1PWMDisableOutputs;
     pMCData->MCAPP_HALSetVoltageVector = HAL_MC1SetVoltageVector;
-}
\ No newline at end of file
+}
+
+/**
+* <B> Function: MCAPP_MC1FaultConfig (MC1APP_DATA_T *)  </B>
+*
+* @brief Function to configure fault limits, debounce, severity and restart
+* policy of the fault detectors.
+*
+* @param Pointer to the Application data structure required for 
+* controlling motor 1.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1FaultConfig(&mc1); </CODE>
+*
+*/
+void MCAPP_MC1FaultConfig(MC1APP_DATA_T *pMCData)
+{
+    MCAPP_FAULT_T *pFault = &pMCData->fault;
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = pMCData->pControlScheme;
+    MCAPP_FAULT_DETECT_T *pDetect = pFault->detect;
+    
+    /* Configure Inputs */
+    pFault->pIa = &pMCData->motorInputs.measureCurrent.Ia;
+    pFault->pIb = &pMCData->motorInputs.measureCurrent.Ib;
+    pFault->pVdc = &pMCData->motorInputs.measureVdc.value;
+    pFault->pVelEstim = &pControlScheme->estimInterface.qVelEstim;
+    pFault->pLossOfLock = &pControlScheme->estimMonitor.lossOfLock;
+    pFault->pStall = &pControlScheme->estimMonitor.stall;
+    
+    /* Initialize fault limits */
+    pFault->overCurrentFaultLimit = PEAK_FAULT_CURRENT;
+    pFault->dcOverVoltageLimit = DC_OVERVOLTAGE_FAULT;
+    pFault->dcUnderVoltageLimit = DC_UNDERVOLTAGE_FAULT;
+    pFault->overSpeedLimit = OVERSPEED_FAULT;
+    pFault->phaseLossCurrentMin = PHASE_LOSS_CURRENT_MIN;
+    pFault->phaseLossSpeedMin = PHASE_LOSS_MIN_SPEED;
+    
+    /* Initialize fault debounce and severity */
+    pDetect[MCAPP_FAULT_ID_OVERCURRENT].countLimit = OVERCURRENT_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_OVERCURRENT].severity = OVERCURRENT_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_DC_OVERVOLTAGE].countLimit = 
+                                            DC_OVERVOLTAGE_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_DC_OVERVOLTAGE].severity = 
+                                            DC_OVERVOLTAGE_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_DC_UNDERVOLTAGE].countLimit = 
+                                            DC_UNDERVOLTAGE_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_DC_UNDERVOLTAGE].severity = 
+                                            DC_UNDERVOLTAGE_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_LOSS_OF_LOCK].countLimit = 
+                                            LOSS_OF_LOCK_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_LOSS_OF_LOCK].severity = LOSS_OF_LOCK_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_STALL].countLimit = STALL_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_STALL].severity = STALL_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_PHASE_LOSS].countLimit = PHASE_LOSS_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_PHASE_LOSS].severity = PHASE_LOSS_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_OVERSPEED].countLimit = OVERSPEED_FAULT_DEBOUNCE;
+    pDetect[MCAPP_FAULT_ID_OVERSPEED].severity = OVERSPEED_FAULT_SEVERITY;
+    
+    pDetect[MCAPP_FAULT_ID_PWM_PCI].countLimit = 1;
+    pDetect[MCAPP_FAULT_ID_PWM_PCI].severity = PWM_PCI_FAULT_SEVERITY;
+    
+    /* Initialize restart policy */
+    pFault->restartDelayLimit = FAULT_RESTART_DELAY_COUNT;
+    pFault->restartCountMax = FAULT_RESTART_COUNT_MAX;
+    pFault->runTimeLimit = FAULT_RESTART_RESET_COUNT;
+    
+    MCAPP_FaultClear(pFault);
+}
+
+/**
+* <B> Function: MCAPP_MC1IPDConfig (MC1APP_DATA_T *)  </B>
+*
+* @brief Function to configure initial position detection.
+*
+* @param Pointer to the Application data structure required for 
+* controlling motor 1.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1IPDConfig(&mc1); </CODE>
+*
+*/
+void MCAPP_MC1IPDConfig(MC1APP_DATA_T *pMCData)
+{
+    MCAPP_IPD_T *pIPD = &pMCData->ipd;
+    
+    /* Configure Inputs */
+    pIPD->pIa = &pMCData->motorInputs.measureCurrent.Ia;
+    pIPD->pIb = &pMCData->motorInputs.measureCurrent.Ib;
+    
+#if defined(IPD_STARTUP) && !defined(FLYING_START)
+    pIPD->enable = 1;
+#else
+    pIPD->enable = 0;
+#endif
+    pIPD->bootstrapCountLimit = IPD_BOOTSTRAP_COUNT;
+    pIPD->pulseCountLimit = IPD_PULSE_COUNT;
+    pIPD->decayCountLimit = IPD_DECAY_COUNT;
+    pIPD->qResponseMin = IPD_RESPONSE_MIN;
+}
@@ -64,6 +64,7 @@ extern "C" {
 #include "foc.h"
 #include "fault.h"
 #include "generic_load.h"
+#include "ipd.h"
     
 // </editor-fold>
 
@@ -82,7 +83,16 @@ typedef struct
         runCmd,                     /* Run command for motor */
         runCmdBuffer,               /* Run command buffer for validation */
         qTargetVelocity,            /* Target motor Velocity */
-        qMaxSpeedFactor;            /* Maximum speed to peak speed ratio */
+        qTargetCurrent,             /* Target Q axis current in torque mode */
+        qMaxSpeedFactor,            /* Maximum speed to peak speed ratio */
+        runCmdBufferPrev,           /* Previous run command buffer */
+        faultClearRequest,          /* Request to clear motor faults */
+        faultAckRequest,            /* Request to acknowledge unlatched faults*/
+        appStatePrev,               /* Application State in last ISR */
+        pwmFaultReinitRequest;      /* Re-initialize after PWM fault */
+    
+    volatile int16_t
+        pwmFaultLatch;              /* PWM fault from the PWM fault ISR */
     
     MCAPP_MEASURE_T
         motorInputs;
@@ -102,6 +112,9 @@ typedef struct
     MCAPP_FAULT_T
         fault;
     
+    MCAPP_IPD_T
+        ipd;                        /* Initial position detection */
+    
     MCAPP_MEASURE_T *pMotorInputs;
     MCAPP_MOTOR_T *pMotor;
     MCAPP_CONTROL_SCHEME_T *pControlScheme;
@@ -118,6 +131,7 @@ typedef struct
     /* Function pointers for control scheme */
     void (*MCAPP_ControlSchemeInit) (MCAPP_CONTROL_SCHEME_T *);
     void (*MCAPP_ControlStateMachine) (MCAPP_CONTROL_SCHEME_T *);
+    void (*MCAPP_ControlStartFromAngle) (MCAPP_CONTROL_SCHEME_T *, int16_t);
     
     /* Function pointers for load */
     void (*MCAPP_LoadStateMachine) (MCAPP_LOAD_T *);
@@ -58,6 +58,8 @@
 #include "foc.h"
 #include "general.h"
 #include "diagnostics.h"
+#include "fault_recorder.h"
+#include "fault_log.h"
 // </editor-fold>
 
 // <editor-fold defaultstate="collapsed" desc="Definitions ">
@@ -76,6 +78,7 @@ MC1APP_DATA_T *pMC1Data = &mc1;
 
 static void MC1APP_StateMachine(MC1APP_DATA_T *);
 static void MCAPP_MC1ReceivedDataProcess(MC1APP_DATA_T *);
+static void MCAPP_MC1PWMFaultProcess(MC1APP_DATA_T *);
 
 // </editor-fold>
 
@@ -109,6 +112,7 @@ static void MC1APP_StateMachine(MC1APP_DATA_T *pMCData)
         pMCData->MCAPP_ControlSchemeInit(pControlScheme);
         pMCData->MCAPP_InputsInit(pMotorInputs);
         pMCData->MCAPP_LoadInit(pLoad);       
+        MCAPP_FaultInit(&pMCData->fault);
         
         pMCData->appState = MCAPP_CMD_WAIT;
 
@@ -138,7 +142,22 @@ static void MC1APP_StateMachine(MC1APP_DATA_T *pMCData)
         pMCData->MCAPP_GetProcessedInputs(pMotorInputs);
         pMCData->MCAPP_LoadStateMachine(pLoad);
         
-        if(pMCData->MCAPP_IsLoadReadyToStart(pLoad))
+        if(pMCData->MCAPP_IsLoadReadyToStart(pLoad) && 
+            pControlScheme->motorId.request)
+        {
+            /* Load is ready, identify motor parameters instead of start */
+            pMCData->HAL_PWMEnableOutputs();
+            MCAPP_FOCMotorIdStart(pControlScheme);
+            pMCData->appState = MCAPP_MOTOR_ID;
+        }
+        else if(pMCData->MCAPP_IsLoadReadyToStart(pLoad) && pMCData->ipd.enable)
+        {
+            /* Load is ready, find rotor angle before start */
+            MCAPP_IPDInit(&pMCData->ipd);
+            pMCData->MCAPP_HALSetVoltageVector(pMCData->ipd.vector);
+            pMCData->appState = MCAPP_IPD;
+        }
+        else if(pMCData->MCAPP_IsLoadReadyToStart(pLoad))
         {
             /* Load is ready, start the motor */
             pMCData->HAL_PWMEnableOutputs();
@@ -148,13 +167,78 @@ static void MC1APP_StateMachine(MC1APP_DATA_T *pMCData)
             pMCData->appState = MCAPP_RUN;
         }
         break;
+        
+    case MCAPP_IPD:
+        
+        pMCData->MCAPP_GetProcessedInputs(pMotorInputs);
+        pMCData->fault.speedMonitorEnable = 0;
+        if (MCAPP_FaultDetect(&pMCData->fault) == 1)
+        {
+            pMCData->appState = MCAPP_FAULT;
+            break;
+        }
+        
+        MCAPP_IPDStep(&pMCData->ipd);
+        if (pMCData->ipd.outputUpdate)
+        {
+            if (pMCData->ipd.vector == IPD_VECTOR_OFF)
+            {
+                pMCData->HAL_PWMDisableOutputs();
+            }
+            else
+            {
+                pMCData->MCAPP_HALSetVoltageVector(pMCData->ipd.vector);
+            }
+        }
+        
+        if (MCAPP_IPDIsComplete(&pMCData->ipd))
+        {
+            pMCData->HAL_PWMEnableOutputs();
+
+            pMCData->MCAPP_LoadStartTransition(pControlScheme, pLoad);
+            if (pMCData->ipd.angleValid)
+            {
+                pMCData->MCAPP_ControlStartFromAngle(pControlScheme, 
+                                                    pMCData->ipd.qTheta);
+            }
+            
+            pMCData->appState = MCAPP_RUN;
+        }
+        break;
+        
+    case MCAPP_MOTOR_ID:
+        
+        pMCData->MCAPP_GetProcessedInputs(pMotorInputs);
+        pMCData->fault.speedMonitorEnable = 0;
+        if (MCAPP_FaultDetect(&pMCData->fault) == 1)
+        {
+            pMCData->appState = MCAPP_FAULT;
+            break;
+        }
+        
+        pMCData->MCAPP_ControlStateMachine(pControlScheme);
+        
+        if (MCAPP_MotorIdIsComplete(&pControlScheme->motorId))
+        {
+            /* Motor coasts, next run command starts it with identified 
+             * parameters */
+            pControlScheme->motorId.request = 0;
+            pMCData->appState = MCAPP_STOP;
+        }
+        else if (pMCData->runCmd == 0)
+        {
+            pMCData->appState = MCAPP_STOP;
+        }
+        break;
             
     case MCAPP_RUN:
         
         /* Compensate motor current offsets */
         pMCData->MCAPP_GetProcessedInputs(pMotorInputs);
-        /* Check for control scheme faults */
-        if (MCAPP_OverCurrentFault_Detect(pMotorInputs, &pMCData->fault) == 1)
+        /* Check for motor faults, speed based checks only in closed loop */
+        pMCData->fault.speedMonitorEnable = 
+                            (pControlScheme->focState == FOC_CLOSE_LOOP);
+        if (MCAPP_FaultDetect(&pMCData->fault) == 1)
         {
             pMCData->appState = MCAPP_FAULT;
             break;
@@ -202,6 +286,29 @@ static void MC1APP_StateMachine(MC1APP_DATA_T *pMCData)
         
     case MCAPP_FAULT:
         pMCData->HAL_PWMDisableOutputs();
+        
+        if(pMCData->faultClearRequest == 1)
+        {
+            /* Faults cleared on request, including latched faults */
+            pMCData->faultClearRequest = 0;
+            pMCData->faultAckRequest = 0;
+            MCAPP_FaultClear(&pMCData->fault);
+            pMCData->appState = MCAPP_INIT;
+        }
+        else if(pMCData->faultAckRequest == 1)
+        {
+            /* Faults acknowledged by run command, latched faults remain */
+            pMCData->faultAckRequest = 0;
+            if(MCAPP_FaultAcknowledge(&pMCData->fault) == 1)
+            {
+                pMCData->appState = MCAPP_INIT;
+            }
+        }
+        else if(MCAPP_FaultRestartCheck(&pMCData->fault) == 1)
+        {
+            /* Automatic restart as per restart policy */
+            pMCData->appState = MCAPP_INIT;
+        }
         break;
         
     default:
@@ -240,9 +347,35 @@ void __attribute__((__interrupt__,no_auto_psv)) MC1_ADC_INTERRUPT()
 
     pMC1Data->HAL_MotorInputsRead(pMC1Data->pMotorInputs);
     
+    MCAPP_MC1PWMFaultProcess(pMC1Data);
     MC1APP_StateMachine(pMC1Data);
+    /* PWM fault ISR may have interrupted a state enabling the outputs */
+    MCAPP_MC1PWMFaultProcess(pMC1Data);
 
     pMC1Data->HAL_PWMSetDutyCycles(pMC1Data->pPWMDuty);
+    
+    #ifdef ENABLE_FAULT_LOG
+        if((pMC1Data->appState == MCAPP_FAULT) && 
+            (pMC1Data->appStatePrev != MCAPP_FAULT))
+        {
+            MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_MC1_FAULT, 
+                pMC1Data->fault.faultState,
+                pMC1Data->pControlScheme->estimInterface.qVelEstim,
+                pMC1Data->pMotorInputs->measureVdc.value,
+                pMC1Data->pControlScheme->ctrlParam.qIqRef,
+                pMC1Data->fault.restartCount);
+        }
+    #endif
+    pMC1Data->appStatePrev = pMC1Data->appState;
+    
+    #ifdef ENABLE_FAULT_RECORDER
+        if(pMC1Data->appState == MCAPP_FAULT)
+        {
+            FaultRecorderTrigger(FAULT_RECORDER_SOURCE_MC1, 
+                                    pMC1Data->fault.faultState);
+        }
+        FaultRecorderStepIsr();
+    #endif
         
     adcBuffer = MC1_ClearADCIF_ReadADCBUF();
 	MC1_ClearADCIF();
@@ -272,6 +405,346 @@ void MCAPP_MC1InputBufferSet(int16_t runCmd, int16_t qTargetVelocity)
     MCAPP_MC1ReceivedDataProcess(pMCData);
 }
 
+/**
+* <B> Function: void MCAPP_MC1FaultClear(void)  </B>
+*
+* @brief Function to request clearing of all motor faults including latched
+* faults. The faults are cleared in the next control cycle and the motor 
+* restarts if the run command is active.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1FaultClear(); </CODE>
+*
+*/
+void MCAPP_MC1FaultClear(void)
+{
+    if(pMC1Data->appState == MCAPP_FAULT)
+    {
+        pMC1Data->faultClearRequest = 1;
+    }
+}
+
+/**
+* <B> Function: void MCAPP_MC1PWMFaultSet(void)  </B>
+*
+* @brief Function to latch PWM PCI fault, executes in fixed time from the 
+* PWM fault ISR after the outputs are disabled. The fault manager and the 
+* application state are owned by the control loop ISR, which it may have 
+* interrupted; they are updated there by MCAPP_MC1PWMFaultProcess().
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1PWMFaultSet(); </CODE>
+*
+*/
+void MCAPP_MC1PWMFaultSet(void)
+{
+    pMC1Data->pwmFaultLatch = 1;
+}
+
+/**
+* <B> Function: void MCAPP_MC1PWMFaultProcess(MC1APP_DATA_T *)  </B>
+*
+* @brief Function to report the PWM PCI fault latched by the PWM fault ISR 
+* to the fault manager and put the motor in fault state. Executes in the 
+* control loop ISR before and after the state machine, the outputs enabled 
+* by a state interrupted by the PWM fault ISR are disabled again. The 
+* re-initialization is requested from MCAPP_MC1PWMFaultReinit().
+*
+* @param Pointer to the data structure containing Application parameters.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1PWMFaultProcess(&mc); </CODE>
+*
+*/
+static void MCAPP_MC1PWMFaultProcess(MC1APP_DATA_T *pMCData)
+{
+    if(pMCData->pwmFaultLatch == 0)
+    {
+        return;
+    }
+    pMCData->pwmFaultLatch = 0;
+    
+    pMCData->HAL_PWMDisableOutputs();
+    MCAPP_FaultSet(&pMCData->fault, MCAPP_FAULT_ID_PWM_PCI);
+    pMCData->appState = MCAPP_FAULT;
+    pMCData->pwmFaultReinitRequest = 1;
+}
+
+/**
+* <B> Function: void MCAPP_MC1PWMFaultReinit(void)  </B>
+*
+* @brief Function to re-initialize motor control state after PWM PCI fault, 
+* executes in the main loop. Control loop and Timer1 interrupts are disabled
+* while the controllers, estimators, inputs and load are initialized as in 
+* MCAPP_INIT state. Configuration is not initialized again : identified motor
+* parameters, tuned gains, adapted estimator parameters and the fault manager 
+* state with the latched PCI fault are kept.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1PWMFaultReinit(); </CODE>
+*
+*/
+void MCAPP_MC1PWMFaultReinit(void)
+{
+    if(pMC1Data->pwmFaultReinitRequest == 0)
+    {
+        return;
+    }
+    
+    /* Control loop and Timer1 ISRs access the parameters */
+    MC1_DisableADCInterrupt();
+    TIMER1_InterruptDisable();
+    
+    pMC1Data->pwmFaultReinitRequest = 0;
+    pMC1Data->HAL_PWMDisableOutputs();
+    pMC1Data->runCmd = 0;
+    
+    pMC1Data->MCAPP_ControlSchemeInit(pMC1Data->pControlScheme);
+    pMC1Data->MCAPP_InputsInit(pMC1Data->pMotorInputs);
+    pMC1Data->MCAPP_LoadInit(pMC1Data->pLoad);
+    pMC1Data->appState = MCAPP_FAULT;
+    
+    MC1_ClearADCIF_ReadADCBUF();
+    MC1_ClearADCIF();
+    MC1_EnableADCInterrupt();
+    TIMER1_InterruptEnable();
+}
+
+/**
+* <B> Function: uint16_t MCAPP_MC1FaultStateGet(void)  </B>
+*
+* @brief Function to read the active motor faults.
+*
+* @param none.
+* @return Active faults as MCAPP_FAULT_STATE_T bits.
+* @example
+* <CODE> faultState = MCAPP_MC1FaultStateGet(); </CODE>
+*
+*/
+uint16_t MCAPP_MC1FaultStateGet(void)
+{
+    return pMC1Data->fault.faultState;
+}
+
+/**
+* <B> Function: bool MCAPP_MC1EstimatorSelect(uint16_t)  </B>
+*
+* @brief Function to select the estimator used for motor control, e.g. at 
+* start-up. Selection is accepted only while waiting for run command.
+*
+* @param Estimator - MCAPP_ESTIMATOR_ID_T.
+* @return true if the estimator is selected.
+* @example
+* <CODE> MCAPP_MC1EstimatorSelect(MCAPP_ESTIMATOR_PLL); </CODE>
+*
+*/
+bool MCAPP_MC1EstimatorSelect(uint16_t estimatorId)
+{
+    if(pMC1Data->appState != MCAPP_CMD_WAIT)
+    {
+        return false;
+    }
+    return MCAPP_FOCEstimatorSelect(pMC1Data->pControlScheme, estimatorId);
+}
+
+/**
+* <B> Function: bool MCAPP_MC1IsStopped(void)  </B>
+*
+* @brief Function to check if the motor is stopped with PWM outputs disabled,
+* waiting for run command or in fault.
+*
+* @param none.
+* @return true if the motor is stopped.
+* @example
+* <CODE> stopped = MCAPP_MC1IsStopped(); </CODE>
+*
+*/
+bool MCAPP_MC1IsStopped(void)
+{
+    return ((pMC1Data->appState == MCAPP_CMD_WAIT) || 
+            (pMC1Data->appState == MCAPP_FAULT));
+}
+
+/**
+* <B> Function: void MCAPP_MC1FaultRecorderConfig(void)  </B>
+*
+* @brief Function to add the motor signals to the fault recorder. Edit this
+* list to change the recorded signals.
+*
+* @param none.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1FaultRecorderConfig(); </CODE>
+*
+*/
+void MCAPP_MC1FaultRecorderConfig(void)
+{
+    MCAPP_MEASURE_T *pMotorInputs = pMC1Data->pMotorInputs;
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = pMC1Data->pControlScheme;
+    
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_IA, 
+                            &pMotorInputs->measureCurrent.Ia);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_IB, 
+                            &pMotorInputs->measureCurrent.Ib);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_ID, &pControlScheme->idq.d);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_IQ, &pControlScheme->idq.q);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_VD, &pControlScheme->vdq.d);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_VQ, &pControlScheme->vdq.q);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_THETA, 
+                            &pControlScheme->estimInterface.qTheta);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_OMEGA, 
+                            &pControlScheme->estimInterface.qVelEstim);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_VDC, 
+                            &pMotorInputs->measureVdc.value);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_MC1_STATE, &pMC1Data->appState);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_FOC_STATE, 
+                            &pControlScheme->focState);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_MC1_FAULT, 
+                            (const int16_t *)&pMC1Data->fault.faultState);
+}
+
+/**
+* <B> Function: bool MCAPP_MC1PositionMove(int32_t, bool)  </B>
+*
+* @brief Function to request a move in position control. Target is in 
+* electrical angle counts, 65536 per electrical revolution. A relative move 
+* adds the distance to the present target. The request replaces the target 
+* of a move in progress and is accepted once the motor runs in closed loop.
+*
+* @param Target position, or distance for a relative move.
+* @param true for a relative move.
+* @return true if the request is placed, false if position control is 
+* disabled or a previous request is still pending.
+* @example
+* <CODE> MCAPP_MC1PositionMove(POLEPAIRS*65536L, true); </CODE>
+*
+*/
+bool MCAPP_MC1PositionMove(int32_t target, bool relative)
+{
+    MCAPP_POSITION_T *pPosition = &pMC1Data->pControlScheme->position;
+    
+    if (pPosition->enable == 0)
+    {
+        return false;
+    }
+    if (relative)
+    {
+        return MCAPP_PositionMoveRelative(pPosition, target);
+    }
+    return MCAPP_PositionMoveAbsolute(pPosition, target);
+}
+
+/**
+* <B> Function: bool MCAPP_MC1PositionHome(void)  </B>
+*
+* @brief Function to request homing by stall at an end stop in position 
+* control. Position is set to POSITION_HOME_POSITION at the end stop.
+*
+* @param none.
+* @return true if the request is placed, false if position control is 
+* disabled or a previous request is still pending.
+* @example
+* <CODE> MCAPP_MC1PositionHome(); </CODE>
+*
+*/
+bool MCAPP_MC1PositionHome(void)
+{
+    MCAPP_POSITION_T *pPosition = &pMC1Data->pControlScheme->position;
+    
+    if (pPosition->enable == 0)
+    {
+        return false;
+    }
+    return MCAPP_PositionHome(pPosition);
+}
+
+/**
+* <B> Function: bool MCAPP_MC1PositionIsDone(void)  </B>
+*
+* @brief Function to check if the last position move or homing is done.
+*
+* @param none.
+* @return true if the position reference is at the target.
+* @example
+* <CODE> done = MCAPP_MC1PositionIsDone(); </CODE>
+*
+*/
+bool MCAPP_MC1PositionIsDone(void)
+{
+    return MCAPP_PositionIsDone(&pMC1Data->pControlScheme->position);
+}
+
+/**
+* <B> Function: int32_t MCAPP_MC1PositionGet(void)  </B>
+*
+* @brief Function to read the rotor position in electrical angle counts.
+*
+* @param none.
+* @return Rotor position.
+* @example
+* <CODE> position = MCAPP_MC1PositionGet(); </CODE>
+*
+*/
+int32_t MCAPP_MC1PositionGet(void)
+{
+    return MCAPP_PositionGet(&pMC1Data->pControlScheme->position);
+}
+
+/**
+* <B> Function: bool MCAPP_MC1TorqueModeSet(bool)  </B>
+*
+* @brief Function to switch between torque and speed mode at runtime. The 
+* switch is made in the control interrupt while the motor runs in closed 
+* loop; torque mode starts from the present current reference and speed mode
+* from the present speed. A requested torque mode is entered again after a 
+* restart.
+*
+* @param true for torque mode, false for speed mode.
+* @return true if the request is placed, false if torque mode is disabled.
+* @example
+* <CODE> MCAPP_MC1TorqueModeSet(true); </CODE>
+*
+*/
+bool MCAPP_MC1TorqueModeSet(bool torqueMode)
+{
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->pControlScheme->torqueControl;
+    
+    if (pTorque->enable == 0)
+    {
+        return false;
+    }
+    MCAPP_TorqueControlModeSet(pTorque, torqueMode ? 
+        MCAPP_TORQUE_CONTROL_TORQUE_MODE : MCAPP_TORQUE_CONTROL_SPEED_MODE);
+    return true;
+}
+
+/**
+* <B> Function: void MCAPP_MC1TorqueCommandSet(int16_t)  </B>
+*
+* @brief Function to set the Q axis current command of torque mode, as a 
+* Q15 fraction of the speed controller current limit SPEEDCNTR_OUTMAX.
+*
+* @param Current command, negative for reverse torque.
+* @return none.
+* @example
+* <CODE> MCAPP_MC1TorqueCommandSet(Q15(0.5)); </CODE>
+*
+*/
+void MCAPP_MC1TorqueCommandSet(int16_t qTargetCurrent)
+{
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->pControlScheme->torqueControl;
+    
+    pMC1Data->qTargetCurrent = (int16_t)(__builtin_mulss(pTorque->qIqMax, 
+                                                    qTargetCurrent) >> 15);
+    MCAPP_TorqueControlCommandSet(pTorque, pMC1Data->qTargetCurrent);
+}
+
 int16_t potFilt;
 int32_t potFiltStateVar;
 int16_t MCAPP_MC1GetTargetVelocity(void)
@@ -311,11 +784,21 @@ static void MCAPP_MC1ReceivedDataProcess(MC1APP_DATA_T *pMCData)
     }
     
     if( (pMotorInputs->measureVdc.value >= pMotorInputs->measureVdc.dcMinRun) && 
-                                            (pControlScheme->faultStatus == 0) )
+                                            (pControlScheme->faultStatus == 0) &&
+                            (pMCData->fault.faultState == MCAPP_FAULT_NONE) )
     {
         pMCData->runCmd = pMCData->runCmdBuffer;
     }        
 
+    /* Run command re-issued in fault state acknowledges the faults which 
+     * are not latched */
+    if((pMCData->runCmdBuffer == 1) && (pMCData->runCmdBufferPrev == 0) &&
+        (pMCData->appState == MCAPP_FAULT))
+    {
+        pMCData->faultAckRequest = 1;
+    }
+    pMCData->runCmdBufferPrev = pMCData->runCmdBuffer;
+
     if(pMotorInputs->measureVdc.value < pMotorInputs->measureVdc.dcMaxStop)
     {
         pMCData->runCmd = 0;
@@ -63,6 +63,19 @@ extern "C" {
 
 void    MCAPP_MC1ServiceInit(void);
 void    MCAPP_MC1InputBufferSet(int16_t, int16_t);
+void    MCAPP_MC1FaultClear(void);
+void    MCAPP_MC1PWMFaultSet(void);
+uint16_t MCAPP_MC1FaultStateGet(void);
+bool MCAPP_MC1IsStopped(void);
+bool MCAPP_MC1EstimatorSelect(uint16_t);
+void MCAPP_MC1PWMFaultReinit(void);
+void MCAPP_MC1FaultRecorderConfig(void);
+bool MCAPP_MC1PositionMove(int32_t, bool);
+bool MCAPP_MC1PositionHome(void);
+bool MCAPP_MC1PositionIsDone(void);
+int32_t MCAPP_MC1PositionGet(void);
+bool MCAPP_MC1TorqueModeSet(bool);
+void MCAPP_MC1TorqueCommandSet(int16_t);
 
 int16_t MCAPP_MC1GetTargetVelocity(void);
 
@@ -64,6 +64,94 @@ extern "C" {
 /* Define OPEN_LOOP_FUNCTIONING for Open loop continuous functioning, 
  * undefine OPEN_LOOP_FUNCTIONING for closed loop functioning  */
 #undef OPEN_LOOP_FUNCTIONING 
+/* Define HFI_STARTUP to start from standstill with high frequency injection
+ * instead of rotor lock and open loop ramp, undefine HFI_STARTUP for rotor
+ * lock start-up. HFI needs a salient motor(Lq > Ld), see HFI parameters */
+#undef HFI_STARTUP
+/* Define IPD_STARTUP to detect the rotor angle with voltage pulses before 
+ * start-up, rotor lock is skipped if the angle is detected. See IPD 
+ * parameters, undefine IPD_STARTUP for start-up from rotor lock */
+#undef IPD_STARTUP
+/* Define FLYING_START to catch a spinning rotor at start-up and close the loop
+ * without stopping it, rotor at standstill is started as usual. Initial 
+ * position detection is not used with FLYING_START */
+#undef FLYING_START
+/* Define ESTIMATOR_ADAPTATION to adapt resistance and back EMF constant of the
+ * PLL estimator online to winding and magnet temperature, see estimator 
+ * adaptation parameters */
+#undef ESTIMATOR_ADAPTATION
+/* Define MOTOR_IDENTIFICATION to measure Rs, Ld, Lq, back EMF constant and 
+ * inertia with the first run command after reset. The motor coasts to stop 
+ * afterwards and runs with the measured parameters from the next run command,
+ * see motor identification parameters */
+#undef MOTOR_IDENTIFICATION
+/* Define CURRENT_LOOP_AUTOTUNE to calculate current controller gains from 
+ * NORM_RS, NORM_LSDT and CURRENT_LOOP_BANDWIDTH_HZ instead of the CURRCNTR 
+ * tuning values, and from the identified Rs, Ld and Lq when 
+ * MOTOR_IDENTIFICATION is defined. Define CURRENT_LOOP_STEP_TEST to check 
+ * the tuned gains with a current step during motor identification */
+#undef CURRENT_LOOP_AUTOTUNE
+#undef CURRENT_LOOP_STEP_TEST
+/* Define SPEED_LOOP_AUTOTUNE to calculate speed controller gains for 
+ * SPEED_LOOP_BANDWIDTH_HZ and SPEED_LOOP_PHASE_MARGIN_DEG from 
+ * SPEED_LOOP_TAU_MECH_SEC instead of the SPEEDCNTR tuning values, and from 
+ * the identified inertia and friction when MOTOR_IDENTIFICATION is defined */
+#undef SPEED_LOOP_AUTOTUNE
+/* Define MTPA_CONTROL for maximum torque per ampere D axis current on salient
+ * motors(Lq > Ld) instead of zero D axis current below field weakening, see 
+ * MOTOR_LD_H and MOTOR_LQ_H */
+#undef MTPA_CONTROL
+/* Define FLUX_WEAKENING_FEEDFORWARD to set field weakening D axis current 
+ * from a table of speed reference and DC bus voltage, calculated at build 
+ * time from MOTOR_LD_H and the back EMF constant. The voltage controller 
+ * trims the remaining error */
+#undef FLUX_WEAKENING_FEEDFORWARD
+/* Define CURRENT_LOOP_DECOUPLING to feed forward the cross coupling and back
+ * EMF voltages to the current controllers in closed loop, calculated from 
+ * MOTOR_LD_H, MOTOR_LQ_H and the back EMF constant */
+#undef CURRENT_LOOP_DECOUPLING
+/* Define DEADTIME_COMPENSATION to correct PWM duty cycles for the voltage 
+ * lost in inverter dead time. Define DEADTIME_ESTIMATOR_CORRECTION to feed 
+ * estimators the voltage applied by the inverter, i.e. commanded voltage with
+ * the dead time error left after duty correction */
+#undef DEADTIME_COMPENSATION
+#undef DEADTIME_ESTIMATOR_CORRECTION
+/* Select discontinuous PWM mode used above DPWM_MODULATION_ON, see 
+ * MCAPP_DPWM_MODE_T in dpwm.h. MCAPP_DPWM_NONE keeps continuous space vector
+ * modulation. Modes clamping to positive rail keep the low side switch of 
+ * the clamped phase off. Phase A and B currents are measured by low side 
+ * shunts on this board, so only MCAPP_DPWM_MIN is accepted by the build */
+#define DPWM_MODE           MCAPP_DPWM_NONE
+/* Define OVERMODULATION to raise the voltage limit of current controllers 
+ * and flux weakening from VOLTAGE_UTIL_FACTOR*Vdc/sqrt(3) to 
+ * OVERMOD_INDEX_MAX times six-step voltage 2/pi*Vdc. Flux weakening voltage 
+ * reference follows the limit at the present DC bus voltage. A phase at 
+ * positive rail keeps the low side switch off, phase A and B currents are 
+ * measured by low side shunts on this board, so overmodulation limits duty 
+ * cycles to MAX_DUTY and the six-step voltage to MAX_DUTY/LOOPTIME_TCY of 
+ * 2/pi*Vdc */
+#undef OVERMODULATION
+/* Define SPEED_SCURVE_PROFILE to ramp the closed loop speed reference with 
+ * jerk limited S-curve profile of SPEED_PROFILE_ACCEL_RPM_S, 
+ * SPEED_PROFILE_DECEL_RPM_S and SPEED_PROFILE_JERK_RPM_S2 instead of the 
+ * fixed rate ramp of SPEED_RAMP_RATE_COUNT */
+#undef SPEED_SCURVE_PROFILE
+/* Define POSITION_CONTROL to set the closed loop speed reference from the 
+ * position controller instead of the potentiometer. Moves and homing are 
+ * requested with MCAPP_MC1PositionMove() and MCAPP_MC1PositionHome(). Holding
+ * position near standstill needs an estimator working at low speed, see 
+ * HFI_STARTUP */
+#undef POSITION_CONTROL
+/* Define TORQUE_CONTROL to allow torque mode, where Q axis current reference
+ * follows the command of MCAPP_MC1TorqueCommandSet() at TORQUE_SLEW_A_S 
+ * with speed limited to TORQUE_SPEED_LIMIT_RPM. Torque and speed mode are 
+ * switched at runtime with MCAPP_MC1TorqueModeSet() */
+#undef TORQUE_CONTROL
+/* Define DISTURBANCE_OBSERVER to estimate load torque from Q axis current, 
+ * estimated speed and SPEED_LOOP_TAU_MECH_SEC, and feed it forward to the Q 
+ * axis current reference so that load steps are corrected before the speed
+ * controller acts on the speed error */
+#undef DISTURBANCE_OBSERVER
 
     
 /** Board Parameters */
@@ -137,6 +225,10 @@ extern "C" {
     
     /* Estimated speed filter constant */
     #define KFILTER_VELESTIM    500   
+    
+    /* Estimator used at power up - MCAPP_ESTIMATOR_ID_T, can be changed with
+     * MCAPP_MC1EstimatorSelect() while the motor is stopped */
+    #define ESTIMATOR_SELECT    MCAPP_ESTIMATOR_PLL
 
     /* Flux weakening parameters */
     /* Voltage reference factor during field weakening = FW_Voltage_Ref/Nominal_Max_utilizable_voltage
@@ -160,6 +252,54 @@ extern "C" {
 /* Speed rampe rate(rpm/sec) = 
  * (SPEED_CHANGE_RATE_COUNT/(LOOPTIME_SEC*TIME_MULTIPLIER)) *(MC1_PEAK_SPEED_RPM/32767) */
 
+/* S-curve speed profile parameters - speed_profile.c */
+/* Acceleration and deceleration limits in RPM/s, below 
+ * MC1_PEAK_SPEED_RPM/(256*SPEED_PROFILE_STEP_SEC), and jerk limit in RPM/s^2.
+ * Acceleration limits divided by jerk limit must be below 10 seconds */
+#define SPEED_PROFILE_ACCEL_RPM_S       (float)200
+#define SPEED_PROFILE_DECEL_RPM_S       (float)200
+#define SPEED_PROFILE_JERK_RPM_S2       (float)1000
+/* Control loop counts(62.5us) per profile step */
+#define SPEED_PROFILE_DECIMATION_COUNT  16
+
+/* Position control parameters - position.c */
+/* Move speed limit in RPM, below 0.8*MC1_PEAK_SPEED_RPM, and acceleration
+ * limit in RPM/s */
+#define POSITION_SPEED_MAX_RPM          (float)2000
+#define POSITION_ACCEL_RPM_S            (float)10000
+/* Position controller bandwidth in Hz, below a fifth of the speed controller
+ * bandwidth */
+#define POSITION_LOOP_BANDWIDTH_HZ      (float)5
+/* Homing speed in RPM, negative to home in reverse, and speed controller 
+ * current limit during homing in Amps, homing speed is reached with half of 
+ * the current limit */
+#define POSITION_HOME_SPEED_RPM         (float)(-300)
+#define POSITION_HOME_CURRENT           (NOMINAL_CURRENT_PEAK*0.3)
+/* Position error in mechanical revolutions and time in position steps to 
+ * detect the stall at the end stop, and position set there in electrical 
+ * angle counts(65536 per electrical revolution) */
+#define POSITION_HOME_STALL_REV         (float)0.1
+#define POSITION_HOME_STALL_COUNT       50
+#define POSITION_HOME_POSITION          0
+/* Control loop counts(62.5us) per position step */
+#define POSITION_DECIMATION_COUNT       16
+
+/* Torque mode parameters - torque_control.c */
+/* Current command slew rate in A/s, below 
+ * MC1_PEAK_CURRENT/(128*LOOPTIME_SEC) */
+#define TORQUE_SLEW_A_S                 (float)200
+/* Speed limit in RPM, speed controller limits the current command above it*/
+#define TORQUE_SPEED_LIMIT_RPM          (float)NOMINAL_SPEED_RPM
+
+/* Load disturbance observer parameters - disturbance_observer.c */
+/* Observer bandwidth in Hz, above the speed controller bandwidth. Higher 
+ * bandwidth reduces the speed dip further, but passes more speed estimate 
+ * noise and overshoots load steps with the lag of the speed estimate filter
+ * KFILTER_VELESTIM. SPEED_LOOP_TAU_MECH_SEC must include the load inertia */
+#define DISTURBANCE_BANDWIDTH_HZ        (float)50
+/* Control loop counts(62.5us) per observer step */
+#define DISTURBANCE_DECIMATION_COUNT    4
+
 /* Open loop startup parameters */
 /* Lock time for motor's poles alignment 
  * LOCK_TIME_COUNT = Lock_time_sec*PWF_frequency */
@@ -174,11 +314,254 @@ extern "C" {
 #define     MIN_OPENLOOP_CURRENT    (float)(1.0)
 #define     MAX_OPENLOOP_CURRENT    (float)(1.0)
 #define     OL_CURRENT_RAMP_RATE_COUNT      1
+/* I-f current regulation: once the estimator is locked, open loop current is
+ * adjusted by OL_CURRENT_RAMP_RATE_COUNT every IF_CURRENT_RAMP_TIME_MULTIPLIER
+ * samples, between IF_MIN_CURRENT and MAX_OPENLOOP_CURRENT, to hold the 
+ * estimated rotor angle IF_LOAD_ANGLE_DEG electrical degrees ahead of the 
+ * forced current angle. The rotor swings around the forced angle with little
+ * damping, the current must change slowly compared to the swing period or the
+ * regulation pumps the swing until the rotor pulls out */
+#define     IF_CURRENT_RAMP_TIME_MULTIPLIER 64
+#define     IF_LOAD_ANGLE_DEG       (float)(30.0)
+#define     IF_MIN_CURRENT          (float)(0.3)
+/* Time to blend angle and d axis current from open loop to closed loop
+ * HANDOVER_TIME_COUNT = Handover_time_sec*PWF_frequency */
+#define     HANDOVER_TIME_COUNT     1600
+/* Time at maximum open loop speed without estimator lock after which the start
+ * is reported as stall, e.g. load torque above what MAX_OPENLOOP_CURRENT holds
+ * OL_STALL_TIME_COUNT = Stall_time_sec*PWF_frequency */
+#define     OL_STALL_TIME_COUNT     16000
  
 /** Fault Parameters  */
 /* Phase Over-current fault limit in Amps*/
 #define PEAK_FAULT_CURRENT_AMPS     (NOMINAL_CURRENT_PEAK*1.6)
+/* DC bus over-voltage and under-voltage fault limits in Volts */
+#define DC_OVERVOLTAGE_FAULT_VOLT   420
+#define DC_UNDERVOLTAGE_FAULT_VOLT  90
+/* Over-speed fault limit in RPM */
+#define OVERSPEED_FAULT_RPM         (MAXIMUM_SPEED_RPM*1.2)
+/* Phase loss - minimum mean phase current in Amps for the check to apply */
+#define PHASE_LOSS_CURRENT_MIN_AMPS (float)(0.3)
+/* Phase loss - minimum speed in RPM for the check to apply. The accumulation
+ * window must span an electrical cycle, at standstill a phase can legitimately
+ * carry no current */
+#define PHASE_LOSS_MIN_SPEED_RPM    (MINIMUM_SPEED_RPM*0.5)
+    
+/* Fault debounce limits in control loop counts(62.5us), phase loss debounce
+ * limit is in accumulation windows of PHASE_LOSS_WINDOW_COUNT counts.
+ * Loss of lock and stall are debounced by the estimator lock monitor */
+#define OVERCURRENT_FAULT_DEBOUNCE      1
+#define DC_OVERVOLTAGE_FAULT_DEBOUNCE   16
+#define DC_UNDERVOLTAGE_FAULT_DEBOUNCE  160
+#define LOSS_OF_LOCK_FAULT_DEBOUNCE     1
+#define STALL_FAULT_DEBOUNCE            1
+#define PHASE_LOSS_FAULT_DEBOUNCE       2
+#define OVERSPEED_FAULT_DEBOUNCE        160
+
+/* Fault severity : MCAPP_FAULT_SEVERITY_WARNING - report only,
+ * MCAPP_FAULT_SEVERITY_RESTART - stop motor and restart automatically, or 
+ * when the run command is re-issued once restarts are used up,
+ * MCAPP_FAULT_SEVERITY_LATCH - stop motor until MCAPP_MC1FaultClear() */
+#define OVERCURRENT_FAULT_SEVERITY      MCAPP_FAULT_SEVERITY_RESTART
+#define DC_OVERVOLTAGE_FAULT_SEVERITY   MCAPP_FAULT_SEVERITY_RESTART
+#define DC_UNDERVOLTAGE_FAULT_SEVERITY  MCAPP_FAULT_SEVERITY_RESTART
+#define LOSS_OF_LOCK_FAULT_SEVERITY     MCAPP_FAULT_SEVERITY_RESTART
+#define STALL_FAULT_SEVERITY            MCAPP_FAULT_SEVERITY_RESTART
+#define PHASE_LOSS_FAULT_SEVERITY       MCAPP_FAULT_SEVERITY_LATCH
+#define OVERSPEED_FAULT_SEVERITY        MCAPP_FAULT_SEVERITY_RESTART
+#define PWM_PCI_FAULT_SEVERITY          MCAPP_FAULT_SEVERITY_LATCH
+
+/* Fault restart policy : Faults with restart severity are cleared and the
+ * motor is restarted after FAULT_RESTART_DELAY_COUNT control loop counts. 
+ * Automatic restart is stopped after FAULT_RESTART_COUNT_MAX restarts, unless
+ * motor runs without fault for FAULT_RESTART_RESET_COUNT control loop counts */
+#define FAULT_RESTART_DELAY_COUNT   16000
+#define FAULT_RESTART_COUNT_MAX     3
+#define FAULT_RESTART_RESET_COUNT   48000
+
+/** Estimator lock monitor parameters */
+/* Allowed band of BEMF magnitude(converted to speed) w.r.t speed reference */
+#define LOCK_MONITOR_BEMF_RATIO_MIN     (float)0.5
+#define LOCK_MONITOR_BEMF_RATIO_EXCESS  (float)0.5
+/* Maximum |Esd|/|Esq| ratio, i.e. tan(estimator angle error) */
+#define LOCK_MONITOR_ESD_RATIO_MAX      (float)0.5
+/* Maximum error between speed reference and estimated speed in RPM */
+#define LOSS_OF_LOCK_SPEED_ERROR_RPM    1000
+/* Electrical cycles with inconsistent estimate to flag loss of lock */
+#define LOCK_MONITOR_ELEC_CYCLES        3
+/* Maximum time with inconsistent estimate in control loop counts(62.5us) */
+#define LOCK_MONITOR_TIME_COUNT         1600
+/* Loss of lock with BEMF speed below STALL_SPEED_RPM is reported as stall */
+#define STALL_SPEED_RPM                 (MINIMUM_SPEED_RPM*0.5)
+/* Monitor is blanked below this reference speed, where the BEMF is too small
+ * for the residual checks e.g. position hold or homing at low speed */
+#define LOCK_MONITOR_MIN_SPEED_RPM      (MINIMUM_SPEED_RPM*0.5)
+
+/** Extended EMF observer estimator parameters - estim_eemf.c */
+/* Observer gains K = K_MIN + K_SLOPE*|speed|/MC1_PEAK_SPEED_RPM, observer
+ * poles move from 0.97 at standstill to 0.9 at peak speed */
+/* Current observer gain */
+#define EEMF_OBSERVER_K1_MIN            (float)0.06
+#define EEMF_OBSERVER_K1_SLOPE          (float)0.14
+/* EMF observer gain */
+#define EEMF_OBSERVER_K2_MIN            (float)0.003
+#define EEMF_OBSERVER_K2_SLOPE          (float)0.031
+/* Quadrature PLL gains, about 40Hz bandwidth */
+#define EEMF_PLL_KP                     (float)0.064
+#define EEMF_PLL_KI                     (float)0.0005
+/* Speed below which EMF is too small for the PLL phase detector in RPM */
+#define EEMF_EMAG_MIN_SPEED_RPM         20
+/* Minimum speed for closed loop control with this estimator in RPM */
+#define EEMF_THRESHOLD_SPEED_RPM        60
   
+/** High frequency injection parameters - hfi.c */
+/* D and Q axis inductance in Henry, also used for MTPA */
+#define MOTOR_LD_H                      (float)0.0024
+#define MOTOR_LQ_H                      (float)0.0036
+/* Injection voltage amplitude in Volts, square wave at PWMFREQUENCY_HZ/2 */
+#define HFI_VOLTAGE                     (float)30
+/* Control cycles from duty cycle calculation to the current sample it 
+ * affects, duty cycle is updated at the start of the next PWM cycle */
+#define HFI_INJECTION_DELAY             2
+/* PLL gains, about 100Hz bandwidth */
+#define HFI_PLL_KP                      (float)0.16
+#define HFI_PLL_KI                      (float)0.0016
+/* Angle convergence time and time of each magnet polarity check in control
+ * loop counts(62.5us) */
+#define HFI_ALIGN_TIME_COUNT            160
+#define HFI_POLARITY_TIME_COUNT         80
+/* D axis current for magnet polarity check in Amps */
+#define HFI_POLARITY_CURRENT            NOMINAL_CURRENT_PEAK
+/* Speed to hand over to back EMF estimator and speed to return to HFI in RPM*/
+#define HFI_CROSSOVER_SPEED_RPM         END_SPEED_RPM
+#define HFI_RETURN_SPEED_RPM            (END_SPEED_RPM*0.5)
+
+/** Initial position detection parameters - ipd.c */
+/* Bootstrap capacitor charging time before the pulses in control loop 
+ * counts(62.5us) */
+#define IPD_BOOTSTRAP_COUNT             16
+/* Voltage pulse duration in PWM periods(62.5us), peak pulse current is about
+ * 2/3*Vdc*IPD_PULSE_COUNT*62.5us/Ls and must stay well below fault limit */
+#define IPD_PULSE_COUNT                 1
+/* Current decay time after each pulse in control loop counts(62.5us) */
+#define IPD_DECAY_COUNT                 4
+/* Minimum current difference due to saturation to accept the angle in Amps */
+#define IPD_RESPONSE_MIN_AMPS           (float)0.1
+
+/** Flying start parameters - flying_start.c */
+/* PLL gains, about 100Hz bandwidth */
+#define FLYING_START_PLL_KP             (float)0.16
+#define FLYING_START_PLL_KI             (float)0.0016
+/* Minimum speed to catch a spinning rotor and close the loop in RPM */
+#define FLYING_START_MIN_SPEED_RPM      END_SPEED_RPM
+/* Speed below which back EMF is too small for the PLL phase detector in RPM*/
+#define FLYING_START_EMAG_MIN_SPEED_RPM (END_SPEED_RPM*0.25)
+/* PLL phase error(sin of angle error) and time within it to catch the rotor,
+ * time in control loop counts(62.5us) */
+#define FLYING_START_LOCK_ERROR         (float)0.1
+#define FLYING_START_LOCK_COUNT         64
+/* Time to catch the rotor before starting from standstill in control loop 
+ * counts(62.5us) */
+#define FLYING_START_TIME_COUNT         480
+
+/** Estimator parameter adaptation parameters - estim_adapt.c */
+/* Limits of resistance and back EMF constant as ratio of nominal value, 
+ * winding resistance rises by about 40% from cold to hot */
+#define ADAPT_RS_RATIO_MIN              (float)0.7
+#define ADAPT_RS_RATIO_MAX              (float)1.6
+#define ADAPT_KFI_RATIO_MIN             (float)0.8
+#define ADAPT_KFI_RATIO_MAX             (float)1.2
+/* Resistance is adapted below ADAPT_RS_MAX_SPEED_RPM with Q axis current above
+ * ADAPT_RS_MIN_CURRENT in Amps, back EMF constant above 
+ * ADAPT_KFI_MIN_SPEED_RPM */
+#define ADAPT_RS_MAX_SPEED_RPM          (NOMINAL_SPEED_RPM*0.3)
+#define ADAPT_RS_MIN_CURRENT            (NOMINAL_CURRENT_PEAK*0.2)
+#define ADAPT_KFI_MIN_SPEED_RPM         (NOMINAL_SPEED_RPM*0.5)
+/* Control loop counts(62.5us) per adaptation step and adaptation time 
+ * constant in seconds */
+#define ADAPT_DECIMATION_COUNT          16
+#define ADAPT_TIME_CONST_SEC            (float)2.0
+
+/** Motor parameter identification parameters - motor_id.c */
+/* D axis currents for resistance measurement in Amps */
+#define MOTOR_ID_CURRENT_LOW            (NOMINAL_CURRENT_PEAK*0.25)
+#define MOTOR_ID_CURRENT_HIGH           (NOMINAL_CURRENT_PEAK*0.5)
+/* Settling time before each measurement in control loop counts(62.5us) and
+ * number of samples averaged, 2^MOTOR_ID_AVERAGE_BITS */
+#define MOTOR_ID_SETTLE_COUNT           4000
+#define MOTOR_ID_AVERAGE_BITS           10
+/* Inductance voltage pulses in Volts, pulse length and current decay time 
+ * after each pulse in control loop counts(62.5us), number of pulses per axis
+ * 2^MOTOR_ID_PULSE_BITS. Peak pulse current is about
+ * Vpulse*MOTOR_ID_PULSE_COUNT*62.5us/L */
+#define MOTOR_ID_PULSE_VOLTAGE          (float)30
+#define MOTOR_ID_PULSE_COUNT            4
+#define MOTOR_ID_DECAY_COUNT            64
+#define MOTOR_ID_PULSE_BITS             4
+/* Open loop spin for back EMF constant : Q axis current in Amps, speed in RPM
+ * and speed ramp time in seconds */
+#define MOTOR_ID_SPIN_CURRENT           (NOMINAL_CURRENT_PEAK*0.5)
+#define MOTOR_ID_SPIN_SPEED_RPM         (NOMINAL_SPEED_RPM*0.3)
+#define MOTOR_ID_RAMP_TIME_SEC          (float)2.0
+/* Inertia and friction : Q axis current step in Amps and maximum duration of
+ * each step in control loop counts(62.5us). Acceleration ends at 1.5 times,
+ * deceleration at 0.5 times and coast at 0.25 times MOTOR_ID_SPIN_SPEED_RPM*/
+#define MOTOR_ID_INERTIA_CURRENT        (NOMINAL_CURRENT_PEAK*0.3)
+#define MOTOR_ID_INERTIA_COUNT          4000
+/* Control loop counts at the start of each step before acceleration is 
+ * measured, the estimated speed lags the current step by its filters */
+#define MOTOR_ID_INERTIA_SETTLE_COUNT   320
+/* Current step test : duration in control loop counts(62.5us) and largest 
+ * overshoot as a fraction of the step, bandwidth is halved down to 
+ * CURRENT_LOOP_BANDWIDTH_MIN_HZ while the step overshoots */
+#define MOTOR_ID_STEP_COUNT             160
+#define MOTOR_ID_STEP_OVERSHOOT         (float)0.1
+
+/** Current controller tuning parameters - pi_tune.c */
+/* Current loop bandwidth in Hz with CURRENT_LOOP_AUTOTUNE, limited in 
+ * pi_tune.h to 0.35/(2*pi*62.5us) = 890Hz for stability */
+#define CURRENT_LOOP_BANDWIDTH_HZ       (float)600
+#define CURRENT_LOOP_BANDWIDTH_MIN_HZ   (float)100
+
+/** Speed controller tuning parameters - pi_tune.c */
+/* Speed loop bandwidth in Hz and phase margin in degrees. Phase margin plus
+ * the phase lag of current loop and speed filters at the bandwidth must stay
+ * below 90 degrees */
+#define SPEED_LOOP_BANDWIDTH_HZ         (float)10
+#define SPEED_LOOP_PHASE_MARGIN_DEG     (float)60
+/* Mechanical time constant of motor and load in seconds, time to accelerate
+ * from standstill to MC1_PEAK_SPEED_RPM with MC1_PEAK_CURRENT. Used until
+ * it is identified with MOTOR_IDENTIFICATION */
+#define SPEED_LOOP_TAU_MECH_SEC         (float)0.1
+
+/** Dead time compensation parameters - deadtime.c */
+/* Compensated time as a fraction of DEADTIME_MICROSEC, raise above 1 to 
+ * include switching delays of the inverter */
+#define DEADTIME_COMP_FACTOR            (float)1.0
+/* Phase current in Amps at which polarity reaches 1, polarity changes 
+ * linearly between -DEADTIME_COMP_CURRENT and DEADTIME_COMP_CURRENT */
+#define DEADTIME_COMP_CURRENT           (float)0.2
+
+/** Discontinuous PWM parameters - dpwm.c */
+/* Modulation index to start and to stop discontinuous PWM, 1 is the linear 
+ * limit of space vector modulation, DC bus voltage/sqrt(3) */
+#define DPWM_MODULATION_ON              (float)0.6
+#define DPWM_MODULATION_OFF             (float)0.5
+/* Longest time at positive rail in PWM periods(62.5us), followed by one 
+ * period which turns the low side switch on to recharge the bootstrap 
+ * capacitor */
+#define DPWM_REFRESH_COUNT              32
+
+/** Overmodulation parameters - overmodulation.c */
+/* Highest voltage as a fraction of six-step voltage in the duty range of 
+ * overmodulation, MAX_DUTY/LOOPTIME_TCY*2/pi*Vdc. Space vector
+ * modulation is linear up to 0.907, current harmonics and torque ripple rise 
+ * steeply above 0.98 */
+#define OVERMOD_INDEX_MAX               (float)0.97
+/* Cut off frequency of D and Q axis currents used by current controllers 
+ * during overmodulation, below 6 times the highest electrical frequency */
+#define OVERMOD_CURRENT_FILTER_HZ       (float)1000
+    
 /* End speed rpm for open loop to closed loop transition */
 #define     END_SPEED_RPM       MINIMUM_SPEED_RPM
 
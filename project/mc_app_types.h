@@ -64,6 +64,8 @@ typedef enum
     MCAPP_LOAD_STOP_READY_CHECK = 5,    /* Wait for load to be ready to stop */
     MCAPP_STOP = 6,                     /* Stop the motor */
     MCAPP_FAULT = 7,                    /* Motor is in Fault mode */
+    MCAPP_IPD = 8,                      /* Detect initial rotor position */
+    MCAPP_MOTOR_ID = 9,                 /* Identify motor parameters */
 
 }MCAPP_STATE_T;
 
@@ -53,6 +53,8 @@
 #include "pfc.h"
 #include "board_service.h"
 #include "pfc_pi.h"
+#include "fault_recorder.h"
+#include "fault_log.h"
 
 #include "board_service.h"
 // </editor-fold> 
@@ -102,6 +104,13 @@ void __attribute__((__interrupt__,no_auto_psv)) PFC_ADCInterrupt()
     GetDCLinkVoltage(&pfcParam.pfcVoltage.vdc);
     
     PFC_StateMachine(&pfcParam);
+    
+#ifdef ENABLE_FAULT_RECORDER
+    if(pfcParam.state == PFC_FAULT)
+    {
+        FaultRecorderTrigger(FAULT_RECORDER_SOURCE_PFC, pfcParam.faultStatus);
+    }
+#endif
 
 #ifdef DEBUG_BOOST
     PFC_ENABLE_SIGNAL = 1;
@@ -230,6 +239,11 @@ void PFC_StateMachine(PFC_T *pfcData)
             else
             {
                 pfcState = PFC_FAULT; 
+#ifdef ENABLE_FAULT_LOG
+                MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_PFC_FAULT, 
+                    pfcData->faultStatus, pfcData->rectifiedVac, 
+                    pVoltage->vdc, pfcData->iL, 0);
+#endif
             }
             break;
         case PFC_FAULT:
@@ -282,6 +296,40 @@ void PFC_ServiceInit(void)
     ClearPFCADCIF_ReadADCBUF();
     EnablePFCADCInterrupt(); 
 }
+/**
+* <B> Function: PFC_IsSwitching()     </B>
+* 
+* @brief Function to check if the PFC PWM outputs are enabled.      
+* @param none.
+* @return true if PFC is switching.
+* @example
+* <CODE> switching = PFC_IsSwitching();        </CODE>
+*
+*/
+bool PFC_IsSwitching(void)
+{
+    return (pfcParam.state == PFC_CTRL_RUN);
+}
+/**
+* <B> Function: PFC_FaultRecorderConfig()     </B>
+* 
+* @brief Function to add the PFC signals to the fault recorder. Edit this 
+*       list to change the recorded signals.
+* @param none.
+* @return none.
+* @example
+* <CODE> PFC_FaultRecorderConfig();        </CODE>
+*
+*/
+void PFC_FaultRecorderConfig(void)
+{
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_PFC_IL, &pfcParam.iL);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_PFC_VAC, &pfcParam.rectifiedVac);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_PFC_STATE, 
+                            (const int16_t *)&pfcParam.state);
+    FaultRecorderChannelAdd(FAULT_RECORDER_CH_PFC_FAULT, 
+                            (const int16_t *)&pfcParam.faultStatus);
+}
 /**
  * <B> Function: PFC_ParamsInit(PFC_T *pfcData)  </B>
  * 
@@ -132,6 +132,8 @@ typedef struct
 
 // <editor-fold defaultstate="collapsed" desc="INTERFACE FUNCTIONS ">
 void PFC_ServiceInit(void);
+void PFC_FaultRecorderConfig(void);
+bool PFC_IsSwitching(void);
 
 // </editor-fold>
 
@@ -0,0 +1,323 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file bench_estimators.c
+ *
+ * @brief Host benchmark of the PLL estimator and the extended EMF observer. 
+ * Each estimator runs the simulated motor in closed loop and the benchmark 
+ * reports:
+ *   - execution time of one estimator step on the host, in ns. This is host
+ *     time for a relative comparison, not dsPIC33 cycles.
+ *   - angle error against the motor model at steady speed, mean and RMS
+ *   - transient lag: peak deviation of the angle error from its steady 
+ *     value after a load torque step, and during a fast speed ramp
+ *   - minimum usable speed: lowest speed reference which runs in closed 
+ *     loop without fault with an RMS angle error below BENCH_USABLE_ERROR_DEG
+ * The motor model has no measurement noise, dead time or parameter error, 
+ * the minimum usable speed is a lower bound of the speed on real hardware.
+ * Build and run with 'make bench', the benchmark does not check limits.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#include "estim_interface.h"
+#include "mc_app_types.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Steady speeds of the angle error measurement */
+#define BENCH_SPEED_COUNT       3
+#define BENCH_SPEEDS_RPM        {1000.0, 2000.0, 3000.0}
+
+/* Speed and q axis current equivalent of the load torque step */
+#define BENCH_LOAD_SPEED_RPM    2000.0
+#define BENCH_LOAD_CURRENT      3.0
+
+/* Fast speed ramp, speed reference counts per ramp step */
+#define BENCH_RAMP_START_RPM    1000.0
+#define BENCH_RAMP_END_RPM      3000.0
+#define BENCH_RAMP_RATE_COUNT   20
+
+/* Speed references of the minimum usable speed search, descending */
+#define BENCH_LOW_SPEED_COUNT   11
+#define BENCH_LOW_SPEEDS_RPM    {500.0, 400.0, 300.0, 250.0, 200.0, 150.0, \
+                                    100.0, 75.0, 50.0, 25.0, 10.0}
+
+/* Limits of a usable speed: RMS angle error and speed error */
+#define BENCH_USABLE_ERROR_DEG  10.0
+#define BENCH_USABLE_SPEED_ERR  0.1
+
+/* Time limit to reach a speed, settling and measurement time */
+#define BENCH_START_TIME_SEC    30.0
+#define BENCH_SETTLE_TIME_SEC   1.0
+#define BENCH_MEASURE_TIME_SEC  0.5
+
+/* Estimator steps of the execution time measurement */
+#define BENCH_TIMING_STEPS      1000000UL
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        mean,               /* Mean angle error in electrical degrees */
+        rms,                /* RMS angle error in electrical degrees */
+        peak;               /* Peak deviation from the given reference */
+}BENCH_ERROR_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static const char *BenchName(uint16_t estimatorId)
+{
+    return (estimatorId == MCAPP_ESTIMATOR_PLL) ? "PLL" : "EEMF";
+}
+
+static double BenchAngleErrorDeg(void)
+{
+    const MCAPP_ESTIMATOR_T *pEstimInterface = 
+                                &pMC1Data->controlScheme.estimInterface;
+    
+    return SIM_AngleErrorGet(pEstimInterface->pOutput->qTheta)*360.0/65536.0;
+}
+
+static bool BenchIsRunning(void)
+{
+    return (pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) && 
+            (pMC1Data->fault.faultState == 0);
+}
+
+/* Runs until the reference speed is reached, then settles */
+static bool BenchSpeedSet(double rpm)
+{
+    const int16_t qTarget = SIM_NormFromRpm(rpm);
+    uint32_t cycles = 0;
+    
+    SIM_SpeedCommandSet(true, rpm);
+    while((cycles < SIM_CYCLES(BENCH_START_TIME_SEC)) && 
+        ((pMC1Data->controlScheme.focState != FOC_CLOSE_LOOP) ||
+        (pMC1Data->controlScheme.ctrlParam.qVelRef != qTarget)))
+    {
+        SIM_Run(1);
+        cycles++;
+        if(pMC1Data->appState == MCAPP_FAULT)
+        {
+            return false;
+        }
+    }
+    SIM_Run(SIM_CYCLES(BENCH_SETTLE_TIME_SEC));
+    
+    return BenchIsRunning();
+}
+
+static bool BenchStart(uint16_t estimatorId, double rpm)
+{
+    SIM_Init();
+    SIM_Run(1);
+    if(!MCAPP_MC1EstimatorSelect(estimatorId))
+    {
+        return false;
+    }
+    return BenchSpeedSet(rpm);
+}
+
+/* Angle error statistics, peak deviation is relative to reference */
+static BENCH_ERROR_T BenchAngleErrorMeasure(uint32_t cycles, double reference)
+{
+    BENCH_ERROR_T result = {0.0, 0.0, 0.0};
+    double error, sum = 0.0, sumSquare = 0.0;
+    uint32_t count;
+    
+    for(count = 0; count < cycles; count++)
+    {
+        SIM_Run(1);
+        error = BenchAngleErrorDeg();
+        sum += error;
+        sumSquare += error*error;
+        if(fabs(error - reference) > result.peak)
+        {
+            result.peak = fabs(error - reference);
+        }
+    }
+    result.mean = sum/cycles;
+    result.rms = sqrt(sumSquare/cycles);
+    
+    return result;
+}
+
+/* Host time of one estimator step on a copy of the running estimator */
+static double BenchStepTimeNs(uint16_t estimatorId)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_ESTIMATOR_PLL_T estimPLL = pControlScheme->estimPLL;
+    MCAPP_ESTIMATOR_EEMF_T estimEEMF = pControlScheme->estimEEMF;
+    struct timespec start, stop;
+    uint32_t step;
+    
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for(step = 0; step < BENCH_TIMING_STEPS; step++)
+    {
+        if(estimatorId == MCAPP_ESTIMATOR_PLL)
+        {
+            MCAPP_EstimatorPLL(&estimPLL);
+        }
+        else
+        {
+            MCAPP_EstimatorEEMF(&estimEEMF);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &stop);
+    
+    return ((stop.tv_sec - start.tv_sec)*1e9 + 
+            (stop.tv_nsec - start.tv_nsec))/BENCH_TIMING_STEPS;
+}
+
+static void BenchEstimator(uint16_t estimatorId)
+{
+    const double speeds[BENCH_SPEED_COUNT] = BENCH_SPEEDS_RPM;
+    const double lowSpeeds[BENCH_LOW_SPEED_COUNT] = BENCH_LOW_SPEEDS_RPM;
+    const uint32_t measureCycles = SIM_CYCLES(BENCH_MEASURE_TIME_SEC);
+    BENCH_ERROR_T steady, step;
+    double speedError, minSpeed = -1.0;
+    uint16_t index;
+    
+    printf("%s estimator\n", BenchName(estimatorId));
+    
+    if(!BenchStart(estimatorId, speeds[0]))
+    {
+        printf("  no closed loop start\n");
+        return;
+    }
+    printf("  step time %.1f ns (host time, not dsPIC33 cycles)\n", 
+        BenchStepTimeNs(estimatorId));
+    
+    for(index = 0; index < BENCH_SPEED_COUNT; index++)
+    {
+        if(!BenchSpeedSet(speeds[index]))
+        {
+            printf("  %4.0f rpm: not reached\n", speeds[index]);
+            continue;
+        }
+        steady = BenchAngleErrorMeasure(measureCycles, 0.0);
+        printf("  %4.0f rpm: angle error mean %6.2f deg, RMS %6.2f deg\n",
+            speeds[index], steady.mean, steady.rms);
+    }
+    
+    /* Load torque step at steady speed */
+    if(BenchSpeedSet(BENCH_LOAD_SPEED_RPM))
+    {
+        steady = BenchAngleErrorMeasure(measureCycles, 0.0);
+        sim.motor.loadTorque = 1.5*sim.motor.polePairs*sim.motor.flux*
+                                    BENCH_LOAD_CURRENT;
+        step = BenchAngleErrorMeasure(measureCycles, steady.mean);
+        printf("  load step %.2f Nm at %.0f rpm: transient lag %6.2f deg\n",
+            sim.motor.loadTorque, BENCH_LOAD_SPEED_RPM, step.peak);
+        sim.motor.loadTorque = 0.0;
+    }
+    
+    /* Fast speed ramp, ramp rate is changed for the measurement only */
+    if(BenchSpeedSet(BENCH_RAMP_START_RPM))
+    {
+        MCAPP_CONTROL_T *pCtrlParam = &pMC1Data->controlScheme.ctrlParam;
+        const uint16_t rampRate = pCtrlParam->CLSpeedRampRate;
+        
+        steady = BenchAngleErrorMeasure(measureCycles, 0.0);
+        pCtrlParam->CLSpeedRampRate = BENCH_RAMP_RATE_COUNT;
+        SIM_SpeedCommandSet(true, BENCH_RAMP_END_RPM);
+        step = BenchAngleErrorMeasure(measureCycles, steady.mean);
+        printf("  ramp %.0f rpm/s from %.0f rpm: transient lag %6.2f deg\n",
+            SIM_RpmFromNorm(BENCH_RAMP_RATE_COUNT)/
+                (pCtrlParam->speedRampIncLimit*LOOPTIME_SEC), 
+            BENCH_RAMP_START_RPM, step.peak);
+        pCtrlParam->CLSpeedRampRate = rampRate;
+    }
+    
+    /* Minimum speed of the motor is lowered for the search only */
+    BenchStart(estimatorId, speeds[0]);
+    pMC1Data->motor.qMinSpeed = 
+        SIM_NormFromRpm(lowSpeeds[BENCH_LOW_SPEED_COUNT - 1]);
+    for(index = 0; index < BENCH_LOW_SPEED_COUNT; index++)
+    {
+        if(!BenchSpeedSet(lowSpeeds[index]))
+        {
+            break;
+        }
+        steady = BenchAngleErrorMeasure(measureCycles, 0.0);
+        speedError = fabs(PMSM_ModelSpeedRpm(&sim.motor) - lowSpeeds[index])/
+                        lowSpeeds[index];
+        if(!BenchIsRunning() || (steady.rms > BENCH_USABLE_ERROR_DEG) || 
+            (speedError > BENCH_USABLE_SPEED_ERR))
+        {
+            break;
+        }
+        minSpeed = lowSpeeds[index];
+    }
+    if(minSpeed > 0.0)
+    {
+        printf("  minimum usable speed %.0f rpm\n", minSpeed);
+    }
+    else
+    {
+        printf("  minimum usable speed above %.0f rpm\n", lowSpeeds[0]);
+    }
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    BenchEstimator(MCAPP_ESTIMATOR_PLL);
+    BenchEstimator(MCAPP_ESTIMATOR_EEMF);
+    
+    return 0;
+}
@@ -0,0 +1,171 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file flash_sim.c
+ *
+ * @brief Host flash simulator in place of hal/flash.c. Keeps the data word of
+ * each instruction, programming only clears bits, and a power fail can be 
+ * injected to interrupt an operation half way.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "flash_sim.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+/* Simulated flash : data word of each instruction */
+static uint16_t flashSim[FLASH_SIM_SIZE_ADDRESS >> 1];
+static uint16_t flashSimOperations;
+static bool flashSimPowerFailEnable;
+static bool flashSimPowerDown;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Returns true if the operation is to be executed, sets *pPartial if power
+ * fails during the operation */
+static bool FLASH_SimOperationStart(bool *pPartial)
+{
+    *pPartial = false;
+    if(flashSimPowerDown)
+    {
+        return false;
+    }
+    if(flashSimPowerFailEnable)
+    {
+        if(flashSimOperations == 0)
+        {
+            flashSimPowerDown = true;
+            *pPartial = true;
+        }
+        else
+        {
+            flashSimOperations--;
+        }
+    }
+    return true;
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void FLASH_SimInit(void)
+{
+    uint16_t index;
+    
+    for(index = 0; index < (FLASH_SIM_SIZE_ADDRESS >> 1); index++)
+    {
+        flashSim[index] = 0xFFFF;
+    }
+    flashSimPowerFailEnable = false;
+    flashSimPowerDown = false;
+}
+
+void FLASH_SimPowerFailSet(uint16_t operations)
+{
+    flashSimOperations = operations;
+    flashSimPowerFailEnable = true;
+    flashSimPowerDown = false;
+}
+
+void FLASH_SimPowerRestore(void)
+{
+    flashSimPowerFailEnable = false;
+    flashSimPowerDown = false;
+}
+
+void FLASH_PageErase(uint32_t address)
+{
+    uint16_t index = (uint16_t)(address >> 1) & ~(FLASH_PAGE_WORDS - 1);
+    uint16_t count = FLASH_PAGE_WORDS;
+    bool partial;
+    
+    if((address >= FLASH_SIM_SIZE_ADDRESS) || 
+        !FLASH_SimOperationStart(&partial))
+    {
+        return;
+    }
+    if(partial)
+    {
+        count = count >> 1;
+    }
+    while(count > 0)
+    {
+        flashSim[index++] = 0xFFFF;
+        count--;
+    }
+}
+
+void FLASH_DoubleWordWrite(uint32_t address, uint16_t data0, uint16_t data1)
+{
+    uint16_t index = (uint16_t)(address >> 1) & ~1;
+    bool partial;
+    
+    if((address >= FLASH_SIM_SIZE_ADDRESS) || 
+        !FLASH_SimOperationStart(&partial))
+    {
+        return;
+    }
+    /* NOR flash : programming only clears bits */
+    flashSim[index] &= data0;
+    if(!partial)
+    {
+        flashSim[index + 1] &= data1;
+    }
+}
+
+uint16_t FLASH_WordRead(uint32_t address)
+{
+    if(address >= FLASH_SIM_SIZE_ADDRESS)
+    {
+        return 0xFFFF;
+    }
+    return flashSim[address >> 1];
+}
+
+// </editor-fold>
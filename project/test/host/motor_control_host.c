@@ -0,0 +1,209 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file motor_control_host.c
+ *
+ * @brief Host implementation of the Motor Control library functions used by the 
+ * application. Transforms follow the fixed point arithmetic of the inline C 
+ * versions in library/motor/motor_control_inline_dspic.h, space vector 
+ * modulation is implemented as the equivalent min-max zero sequence 
+ * modulation.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <math.h>
+#include "motor_control.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define HOST_SINE_TABLE_SIZE    128
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+static int16_t sineTable[HOST_SINE_TABLE_SIZE];
+static uint16_t sineTableReady = 0;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static int16_t HostSat16(int64_t x)
+{
+    return (x > INT16_MAX) ? INT16_MAX : ((x < INT16_MIN) ? INT16_MIN : x);
+}
+
+/* a*b + c*d in 1.31 with biased rounding and saturation of the result */
+static int16_t HostMac2(int16_t a, int16_t b, int16_t c, int16_t d)
+{
+    int64_t acc = (((int64_t)a*b) << 1) + (((int64_t)c*d) << 1);
+    
+    acc = (acc > INT32_MAX) ? INT32_MAX : ((acc < INT32_MIN) ? INT32_MIN : acc);
+    return HostSat16((acc + 0x8000) >> 16);
+}
+
+static void HostSineTableInit(void)
+{
+    uint16_t index;
+    
+    for(index = 0; index < HOST_SINE_TABLE_SIZE; index++)
+    {
+        sineTable[index] = (int16_t)lround(32767.0*
+                            sin(2.0*M_PI*index/HOST_SINE_TABLE_SIZE));
+    }
+    sineTableReady = 1;
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+uint16_t MC_CalculateSineCosine_Assembly_Ram(int16_t angle, 
+                                                MC_SINCOS_T *pSinCos)
+{
+    const uint32_t result = (uint32_t)(uint16_t)angle * HOST_SINE_TABLE_SIZE;
+    const uint16_t remainder = (uint16_t)result;
+    uint16_t index = (uint16_t)(result >> 16);
+    int16_t y0, y1;
+    
+    if(sineTableReady == 0)
+    {
+        HostSineTableInit();
+    }
+    
+    /* Linear interpolation on the 128 point table */
+    y0 = sineTable[index];
+    y1 = sineTable[(index + 1) & (HOST_SINE_TABLE_SIZE - 1)];
+    pSinCos->sin = y0 + (int16_t)(((int32_t)remainder*(y1 - y0)) >> 16);
+    
+    index = (index + 32) & (HOST_SINE_TABLE_SIZE - 1);
+    y0 = sineTable[index];
+    y1 = sineTable[(index + 1) & (HOST_SINE_TABLE_SIZE - 1)];
+    pSinCos->cos = y0 + (int16_t)(((int32_t)remainder*(y1 - y0)) >> 16);
+    
+    return (remainder == 0) ? 1 : 2;
+}
+
+uint16_t MC_TransformPark_Assembly(const MC_ALPHABETA_T *pAlphaBeta, 
+                        const MC_SINCOS_T *pSinCos, MC_DQ_T *pDQ)
+{
+    pDQ->d = HostMac2(pAlphaBeta->alpha, pSinCos->cos, 
+                        pAlphaBeta->beta, pSinCos->sin);
+    pDQ->q = HostMac2(pAlphaBeta->beta, pSinCos->cos, 
+                        pAlphaBeta->alpha, -pSinCos->sin);
+    return 1;
+}
+
+uint16_t MC_TransformParkInverse_Assembly(const MC_DQ_T *pDQ, 
+                        const MC_SINCOS_T *pSinCos, MC_ALPHABETA_T *pAlphaBeta)
+{
+    pAlphaBeta->alpha = HostMac2(pDQ->d, pSinCos->cos, 
+                                    pDQ->q, -pSinCos->sin);
+    pAlphaBeta->beta = HostMac2(pDQ->d, pSinCos->sin, 
+                                    pDQ->q, pSinCos->cos);
+    return 1;
+}
+
+uint16_t MC_TransformClarke_Assembly(const MC_ABC_T *pABC, 
+                                        MC_ALPHABETA_T *pAlphaBeta)
+{
+    const int16_t oneBySqrt3 = 18919;
+    int64_t acc;
+    
+    pAlphaBeta->alpha = pABC->a;
+    
+    /* beta = a/sqrt(3) + 2*b/sqrt(3) */
+    acc = (((int64_t)pABC->a*oneBySqrt3) << 1) + 
+            (((int64_t)pABC->b*oneBySqrt3) << 2);
+    acc = (acc > INT32_MAX) ? INT32_MAX : ((acc < INT32_MIN) ? INT32_MIN : acc);
+    pAlphaBeta->beta = HostSat16((acc + 0x8000) >> 16);
+    return 1;
+}
+
+uint16_t MC_TransformClarkeInverse_Assembly(const MC_ALPHABETA_T *pAlphaBeta,
+                                                MC_ABC_T *pABC)
+{
+    const int16_t sqrt3By2 = 28378;
+    const int16_t negHalf = (int16_t)0xC000;
+    
+    pABC->a = pAlphaBeta->alpha;
+    pABC->b = HostMac2(pAlphaBeta->alpha, negHalf, pAlphaBeta->beta, sqrt3By2);
+    pABC->c = HostMac2(pAlphaBeta->alpha, negHalf, pAlphaBeta->beta, 
+                        -sqrt3By2);
+    return 1;
+}
+
+uint16_t MC_CalculateSpaceVector_Assembly(const MC_ABC_T *pABC, 
+                    uint16_t iPwmPeriod, MC_DUTYCYCLEOUT_T *pDutyCycleOut)
+{
+    /* Inputs are phase references scaled by sqrt(3), the line to line duty
+     * difference is (a - b)/sqrt(3) of the period */
+    const double scale = (double)iPwmPeriod/(32768.0*sqrt(3.0));
+    const int16_t max = (pABC->a > pABC->b) ? 
+            ((pABC->a > pABC->c) ? pABC->a : pABC->c) : 
+            ((pABC->b > pABC->c) ? pABC->b : pABC->c);
+    const int16_t min = (pABC->a < pABC->b) ? 
+            ((pABC->a < pABC->c) ? pABC->a : pABC->c) : 
+            ((pABC->b < pABC->c) ? pABC->b : pABC->c);
+    const double mid = 0.5*((double)max + min);
+    const double half = 0.5*iPwmPeriod;
+    double duty[3];
+    uint16_t index;
+    
+    duty[0] = half + scale*(pABC->a - mid);
+    duty[1] = half + scale*(pABC->b - mid);
+    duty[2] = half + scale*(pABC->c - mid);
+    for(index = 0; index < 3; index++)
+    {
+        duty[index] = (duty[index] < 0) ? 0 : 
+                ((duty[index] > iPwmPeriod) ? iPwmPeriod : duty[index]);
+    }
+    pDutyCycleOut->dutycycle1 = (uint16_t)lround(duty[0]);
+    pDutyCycleOut->dutycycle2 = (uint16_t)lround(duty[1]);
+    pDutyCycleOut->dutycycle3 = (uint16_t)lround(duty[2]);
+    return 1;
+}
+
+// </editor-fold>
@@ -0,0 +1,144 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file sat_pi_host.c
+ *
+ * @brief Host implementation of the PI controller in foc/sat_pi/sat_pi.c. The DSP
+ * accumulator operations are emulated in 64 bit integer arithmetic with the
+ * CORCON mode set by HAL_CORCON_Initialize(): normal (1.31) accumulator
+ * saturation, data space write saturation and biased rounding.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "sat_pi.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Accumulator saturation to 1.31 */
+static int64_t HostAccSat(int64_t acc)
+{
+    if(acc > INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if(acc < INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+    return acc;
+}
+
+/* Fractional multiply into accumulator, MPY/MAC with IF = 0 */
+static int64_t HostAccMpy(int16_t a, int16_t b)
+{
+    return ((int64_t)a * b) << 1;
+}
+
+/* Shift accumulator, SFTAC with negative count shifts left */
+static int64_t HostAccShift(int64_t acc, int16_t shift)
+{
+    return HostAccSat((shift < 0) ? (acc << -shift) : (acc >> shift));
+}
+
+/* Rounded and saturated store of the accumulator high word, SAC.R */
+static int16_t HostAccStoreRound(int64_t acc)
+{
+    const int64_t out = (acc + 0x8000) >> 16;
+    
+    if(out > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    if(out < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+    return (int16_t)out;
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void MCAPP_ControllerPIUpdate(int16_t in_Ref, int16_t in_Meas, 
+        MCAPP_PISTATE_T *state, MCAPP_SAT_STATE_T sat_State, int16_t *out,
+        int16_t direction)
+{
+    int16_t error, out_nonsat, out_sat;
+    int64_t accA;
+    const int64_t accB = state->integrator;
+    
+    error = HostAccStoreRound(((int64_t)in_Ref << 16) - 
+                                ((int64_t)in_Meas << 16));
+    
+    accA = HostAccShift(HostAccMpy(error, state->kp), -state->nkp);
+    accA = HostAccSat(accA + accB);
+    out_nonsat = HostAccStoreRound(accA);
+    
+    out_sat = UTIL_LimitS16(out_nonsat, state->outMin, state->outMax);
+    *out = out_sat;
+    
+    if ((sat_State == MCAPP_SAT_NONE)
+         || (UTIL_DirectedLessThanEqual(in_Ref, in_Meas, direction)))
+    {
+        accA = HostAccShift(HostAccMpy(error, state->ki), -state->nki);
+        error = (int16_t)(out_nonsat - out_sat);
+        accA = HostAccSat(accA - HostAccMpy(error, state->kc));
+        accA = HostAccSat(accA + accB);
+        state->integrator = (int32_t)accA;
+    }
+}
+
+void MCAPP_ControllerPIReset(MCAPP_PISTATE_T *state, int16_t value)
+{
+    state->integrator = (((int32_t)value)<<16);
+}
+
+void MCAPP_ControllerPIInit(MCAPP_PISTATE_T *state)
+{
+    state->integrator = 0 ;
+}
+
+// </editor-fold>
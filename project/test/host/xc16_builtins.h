@@ -0,0 +1,81 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file xc16_builtins.h
+ *
+ * @brief XC16 compiler built-in functions emulated in C for the host build of
+ * the unit tests. The file is force included (gcc -include) in every translation
+ * unit of the host build.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef XC16_BUILTINS_H
+#define	XC16_BUILTINS_H
+
+#ifndef __XC16__
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* 16 x 16 bit multiplication with 32 bit result */
+#define __builtin_mulss(a, b)   ((int32_t)(int16_t)(a) * (int32_t)(int16_t)(b))
+#define __builtin_mulsu(a, b)   ((int32_t)(int16_t)(a) * (int32_t)(uint16_t)(b))
+#define __builtin_mulus(a, b)   ((int32_t)(uint16_t)(a) * (int32_t)(int16_t)(b))
+#define __builtin_muluu(a, b)   ((uint32_t)(uint16_t)(a) * (uint32_t)(uint16_t)(b))
+
+/* 32 / 16 bit division with 16 bit quotient, the quotient is truncated to 
+ * 16 bits like the REPEAT/DIV sequence does on overflow */
+#define __builtin_divsd(a, b)   ((int16_t)((int32_t)(a) / (int16_t)(b)))
+#define __builtin_divud(a, b)   ((uint16_t)((uint32_t)(a) / (uint16_t)(b)))
+#define __builtin_divf(a, b)    \
+            ((int16_t)(((int32_t)(int16_t)(a) << 15) / (int16_t)(b)))
+
+/* Interrupt disable for a number of instruction cycles, no effect on host */
+#define __builtin_disi(cycles)  ((void)(cycles))
+
+// </editor-fold>
+
+#endif // __XC16__
+
+#endif	/* XC16_BUILTINS_H */
@@ -0,0 +1,72 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file xc_host.c
+ *
+ * @brief Special function register variables declared in host/xc.h.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include "xc.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+volatile HOST_SFR_BITS_T 
+    INTCON2bits, LATCbits, LATDbits, PORTCbits, T1CONbits, NVMCONbits,
+    PG1IOCONLbits, PG2IOCONLbits, PG3IOCONLbits, PG4IOCONLbits, 
+    PG1STATbits, PG2STATbits, PG3STATbits, PG1FPCILbits, SRbits,
+    U1MODEbits, U1STAbits, U1STAHbits, U1TXREGbits;
+
+volatile uint16_t 
+    PG1IOCONL, PG2IOCONL, PG3IOCONL, PG1DC, PG2DC, PG3DC, PG4DC, PG1TMR,
+    ADCBUF0, ADCBUF1, ADCBUF10, ADCBUF11, ADCBUF12, ADCBUF15, TMR1, PR1,
+    NVMCON, NVMADR, NVMADRU, NVMKEY, TBLPAG, U1RXREG, U1TXREG, U1BRG, U1MODE,
+    U1STA, U1STAH, CORCON, ACCAL, ACCAH, ACCBL, RCON, SR;
+
+volatile uint16_t 
+    _ADCAN11IE, _ADCAN11IF, _ADCAN11IP, _ADCAN15IE, _ADCAN15IF, _ADCAN15IP,
+    _PWM1IE, _PWM1IF, _PWM1IP, _T1IE, _T1IF, _T1IP, _U1RXIE, _U1RXIF, 
+    _U1TXIE, _U1TXIF;
+
+// </editor-fold>
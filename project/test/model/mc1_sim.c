@@ -0,0 +1,256 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file mc1_sim.c
+ *
+ * @brief Host simulation of motor 1: runs the motor control application of 
+ * mc1_service.c in closed loop with the PMSM model, in place of the ADC 
+ * interrupt, Timer1 interrupt and the PWM hardware.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "board_service.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Timer1 period and control loop period in 0.1us */
+#define SIM_TIMER1_PERIOD       (uint16_t)(TIMER1_PERIOD_uSec*10)
+#define SIM_LOOPTIME            (uint16_t)(LOOPTIME_MICROSEC*10)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+SIM_T sim;
+
+static uint16_t timer1Count;
+
+/* Top switches on for each vector of HAL_MC1SetVoltageVector() in the order 
+ * of c-b-a, vectors 1 to 6 are 60 degrees apart starting on phase A axis */
+static const uint16_t simVectorSwitches[8] = 
+    {0x0, 0x1, 0x3, 0x2, 0x6, 0x4, 0x5, 0x7};
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static int16_t SIM_Normalize(double value, double base)
+{
+    const double norm = value/base*32768.0;
+    
+    return (norm >= 32767.0) ? INT16_MAX : 
+            ((norm <= -32768.0) ? INT16_MIN : (int16_t)lround(norm));
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="HAL FUNCTIONS ">
+
+void HAL_MC1MotorInputsRead(MCAPP_MEASURE_T *pMotorInputs)
+{
+    double ia, ib;
+    
+    PMSM_ModelPhaseCurrents(&sim.motor, &ia, &ib);
+    pMotorInputs->measureCurrent.Ia = SIM_Normalize(ia, MC1_PEAK_CURRENT);
+    pMotorInputs->measureCurrent.Ib = SIM_Normalize(ib, MC1_PEAK_CURRENT);
+    pMotorInputs->measureVdc.value = SIM_Normalize(sim.motor.vdc, 
+                                                    MC1_PEAK_VOLTAGE);
+    pMotorInputs->measurePot = 0;
+}
+
+void HAL_MC1PWMEnableOutputs(void)
+{
+    sim.dutyPending[0] = 0;
+    sim.dutyPending[1] = 0;
+    sim.dutyPending[2] = 0;
+    sim.vectorPending = SIM_VECTOR_NONE;
+    sim.outputsEnabledPending = 1;
+}
+
+void HAL_MC1PWMDisableOutputs(void)
+{
+    sim.dutyPending[0] = 0;
+    sim.dutyPending[1] = 0;
+    sim.dutyPending[2] = 0;
+    sim.vectorPending = SIM_VECTOR_NONE;
+    sim.outputsEnabledPending = 0;
+}
+
+void HAL_MC1PWMSetDutyCycles(MC_DUTYCYCLEOUT_T *pdc)
+{
+    HAL_MC1PWMDutyLimit(pdc);
+    sim.dutyPending[0] = pdc->dutycycle1;
+    sim.dutyPending[1] = pdc->dutycycle2;
+    sim.dutyPending[2] = pdc->dutycycle3;
+}
+
+void HAL_MC1SetVoltageVector(int16_t vector)
+{
+    sim.vectorPending = vector & 0x7;
+    sim.outputsEnabledPending = 1;
+}
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+/**
+ * <B> Function: SIM_Init(void)  </B>
+ * 
+ * @brief Function to reset the motor model at standstill and initialize 
+ * the motor control application as done at power up in main().
+ */
+void SIM_Init(void)
+{
+    PMSM_ModelInit(&sim.motor);
+    sim.time = 0;
+    sim.runCmd = 0;
+    sim.qTargetVelocity = 0;
+    sim.outputsEnabledPending = 0;
+    sim.vectorPending = SIM_VECTOR_NONE;
+    timer1Count = 0;
+    
+    MCAPP_MC1ServiceInit();
+}
+
+/**
+ * <B> Function: SIM_Run(uint32_t cycles)  </B>
+ * 
+ * @brief Function to run the given number of control cycles. Each cycle 
+ * executes the ADC interrupt with the sampled currents, then the model 
+ * integrates one PWM period with the duty cycles of the previous cycle. The
+ * Timer1 interrupt updates the run command and speed target every 100us.
+ */
+void SIM_Run(uint32_t cycles)
+{
+    uint16_t switches;
+    
+    while(cycles > 0)
+    {
+        timer1Count += SIM_LOOPTIME;
+        if(timer1Count >= SIM_TIMER1_PERIOD)
+        {
+            timer1Count -= SIM_TIMER1_PERIOD;
+            MCAPP_MC1InputBufferSet(sim.runCmd, sim.qTargetVelocity);
+        }
+        
+        MC1_ADC_INTERRUPT();
+        
+        PMSM_ModelStep(&sim.motor, LOOPTIME_SEC);
+        
+        sim.motor.outputsEnabled = sim.outputsEnabledPending;
+        if(sim.vectorPending != SIM_VECTOR_NONE)
+        {
+            switches = simVectorSwitches[sim.vectorPending];
+            sim.motor.duty[0] = (switches & 0x1) ? 1.0 : 0.0;
+            sim.motor.duty[1] = (switches & 0x2) ? 1.0 : 0.0;
+            sim.motor.duty[2] = (switches & 0x4) ? 1.0 : 0.0;
+        }
+        else
+        {
+            sim.motor.duty[0] = (double)sim.dutyPending[0]/LOOPTIME_TCY;
+            sim.motor.duty[1] = (double)sim.dutyPending[1]/LOOPTIME_TCY;
+            sim.motor.duty[2] = (double)sim.dutyPending[2]/LOOPTIME_TCY;
+        }
+        
+        sim.time++;
+        cycles--;
+    }
+}
+
+/**
+ * <B> Function: SIM_SpeedCommandSet(bool run, double rpm)  </B>
+ * 
+ * @brief Function to set the run command and the speed target, as set by 
+ * the push button and potentiometer.
+ */
+void SIM_SpeedCommandSet(bool run, double rpm)
+{
+    const MCAPP_MOTOR_T *pMotor = pMC1Data->pMotor;
+    double target = ((double)SIM_NormFromRpm(rpm) - pMotor->qMinSpeed)/
+                        (pMotor->qMaxSpeed - pMotor->qMinSpeed)*32768.0;
+    
+    sim.runCmd = run;
+    sim.qTargetVelocity = (target < 0) ? 0 : 
+                    ((target > 32767.0) ? INT16_MAX : (int16_t)lround(target));
+}
+
+/**
+ * <B> Function: SIM_AngleGet(void)  </B>
+ * 
+ * @brief Function to return the electrical angle of the model in the 
+ * format of the estimators, -32768 to 32767 for -pi to pi.
+ */
+int16_t SIM_AngleGet(void)
+{
+    return (int16_t)(uint16_t)lround(sim.motor.thetaElec/(2.0*M_PI)*65536.0);
+}
+
+/**
+ * <B> Function: SIM_AngleErrorGet(int16_t qTheta)  </B>
+ * 
+ * @brief Function to return the error of an estimated electrical angle.
+ */
+int16_t SIM_AngleErrorGet(int16_t qTheta)
+{
+    return (int16_t)(qTheta - SIM_AngleGet());
+}
+
+double SIM_RpmFromNorm(int16_t qSpeed)
+{
+    return (double)qSpeed*MC1_PEAK_SPEED_RPM/32768.0;
+}
+
+int16_t SIM_NormFromRpm(double rpm)
+{
+    return SIM_Normalize(rpm, MC1_PEAK_SPEED_RPM);
+}
+
+// </editor-fold>
@@ -0,0 +1,133 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file mc1_sim.h
+ *
+ * @brief Host simulation of motor 1: runs the motor control application of 
+ * mc1_service.c in closed loop with the PMSM model, in place of the ADC 
+ * interrupt, Timer1 interrupt and the PWM hardware.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef MC1_SIM_H
+#define	MC1_SIM_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "motor_control.h"
+#include "board_service.h"
+#include "mc1_init.h"
+#include "pmsm_model.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Control cycles per second */
+#define SIM_CYCLES_PER_SEC      (uint32_t)(1.0/LOOPTIME_SEC + 0.5)
+
+/* Control cycles of a duration in seconds */
+#define SIM_CYCLES(sec)         (uint32_t)((sec)*SIM_CYCLES_PER_SEC + 0.5)
+
+/* No voltage vector override, the duty cycles drive the outputs */
+#define SIM_VECTOR_NONE         (int16_t)-1
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    /* Motor, inverter and load */
+    PMSM_MODEL_T motor;
+    
+    /* Control cycles executed since SIM_Init() */
+    uint32_t time;
+    
+    /* Inputs of MCAPP_MC1InputBufferSet(), updated every Timer1 period */
+    int16_t runCmd;
+    int16_t qTargetVelocity;
+    
+    /* Duty cycles calculated in the last control cycle, loaded into the PWM 
+     * generators at the start of the next PWM period */
+    uint16_t dutyPending[3];
+    bool outputsEnabledPending;
+    
+    /* Voltage vector set by HAL_MC1SetVoltageVector(), overrides the duty 
+     * cycles as the PWM output override does, SIM_VECTOR_NONE if not set */
+    int16_t vectorPending;
+    
+}SIM_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+extern SIM_T sim;
+extern MC1APP_DATA_T *pMC1Data;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+/* Control interrupt of mc1_service.c, executed by SIM_Run() */
+void MC1_ADC_INTERRUPT(void);
+
+void SIM_Init(void);
+void SIM_Run(uint32_t);
+void SIM_SpeedCommandSet(bool, double);
+int16_t SIM_AngleGet(void);
+int16_t SIM_AngleErrorGet(int16_t);
+double SIM_RpmFromNorm(int16_t);
+int16_t SIM_NormFromRpm(double);
+
+// </editor-fold>
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* MC1_SIM_H */
@@ -0,0 +1,237 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file pmsm_model.c
+ *
+ * @brief Continuous time model of a salient pole PMSM with inverter and mechanical
+ * load for the host simulation of the motor control application. The default
+ * parameters are calculated from the parameters of mc1_user_params.h.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <math.h>
+
+#include "mc1_calc_params.h"
+#include "pmsm_model.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Integration steps per call of PMSM_ModelStep() */
+#define PMSM_MODEL_SUBSTEPS     8
+
+/* Peak electrical speed of the normalized speed in rad/s */
+#define PMSM_OMEGA_ELEC_PEAK    ((double)MC1_PEAK_SPEED_RPM*POLEPAIRS*\
+                                    2.0*M_PI/60.0)
+
+/* Limits of incremental Ld relative to Ld with saturation */
+#define PMSM_LD_INC_MIN         0.5
+#define PMSM_LD_INC_MAX         1.5
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+/**
+ * <B> Function: PMSM_ModelInit(PMSM_MODEL_T *pModel)  </B>
+ * 
+ * @brief Function to set the motor parameters used by the firmware (Rs from
+ * NORM_RS, flux from NORM_INVKFI_CONST, Ld and Lq, inertia from 
+ * SPEED_LOOP_TAU_MECH_SEC) and reset the states to standstill.
+ */
+void PMSM_ModelInit(PMSM_MODEL_T *pModel)
+{
+    memset(pModel, 0, sizeof(PMSM_MODEL_T));
+    
+    pModel->rs = (double)NORM_RS/(1L << NORM_RS_QVALUE)*
+                    MC1_BASE_VOLTAGE/MC1_PEAK_CURRENT;
+    pModel->ld = MOTOR_LD_H;
+    pModel->lq = MOTOR_LQ_H;
+    pModel->flux = MC1_BASE_VOLTAGE/((double)NORM_INVKFI_CONST/
+                    (1L << NORM_INVKFI_CONST_QVALUE)*PMSM_OMEGA_ELEC_PEAK);
+    pModel->polePairs = POLEPAIRS;
+    pModel->inertia = 1.5*POLEPAIRS*pModel->flux*MC1_PEAK_CURRENT*
+                    SPEED_LOOP_TAU_MECH_SEC/(PMSM_OMEGA_ELEC_PEAK/POLEPAIRS);
+    pModel->ldSaturation = 0;
+    pModel->friction = 0;
+    pModel->loadTorque = 0;
+    pModel->vdc = 325;
+    pModel->deadTime = 0;
+}
+
+/**
+ * <B> Function: PMSM_ModelStep(PMSM_MODEL_T *pModel, double time)  </B>
+ * 
+ * @brief Function to integrate the model over the given time with the
+ * present duty cycles. Phase voltages are the average over the PWM period.
+ * With dead time, a switching phase loses the dead time of voltage when its
+ * current flows out of the inverter and gains it when current flows in.
+ */
+void PMSM_ModelStep(PMSM_MODEL_T *pModel, double time)
+{
+    const double dt = time/PMSM_MODEL_SUBSTEPS;
+    double va, vb, vc, valpha, vbeta, vd, vq, omegaElec, cosTheta, sinTheta;
+    double load, omegaNew, ldInc, iabc[3], duty[3];
+    uint16_t step, phase;
+    
+    PMSM_ModelPhaseCurrents(pModel, &iabc[0], &iabc[1]);
+    iabc[2] = -iabc[0] - iabc[1];
+    for(phase = 0; phase < 3; phase++)
+    {
+        duty[phase] = pModel->duty[phase];
+        if(pModel->outputsEnabled && (duty[phase] > 0) && (duty[phase] < 1)
+            && (iabc[phase] != 0))
+        {
+            duty[phase] -= (iabc[phase] > 0) ? pModel->deadTime : 
+                                -pModel->deadTime;
+        }
+    }
+    va = duty[0]*pModel->vdc;
+    vb = duty[1]*pModel->vdc;
+    vc = duty[2]*pModel->vdc;
+    valpha = (2.0*va - vb - vc)/3.0;
+    vbeta = (vb - vc)/sqrt(3.0);
+    
+    for(step = 0; step < PMSM_MODEL_SUBSTEPS; step++)
+    {
+        omegaElec = pModel->omega*pModel->polePairs;
+        cosTheta = cos(pModel->thetaElec);
+        sinTheta = sin(pModel->thetaElec);
+        
+        if(pModel->outputsEnabled)
+        {
+            vd = valpha*cosTheta + vbeta*sinTheta;
+            vq = -valpha*sinTheta + vbeta*cosTheta;
+            
+            /* Incremental Ld falls with D axis current along the magnet 
+             * flux, as the iron saturates. Flux linkage and torque use the
+             * nominal Ld. */
+            ldInc = pModel->ld*(1.0 - pModel->ldSaturation*pModel->id);
+            if(ldInc < PMSM_LD_INC_MIN*pModel->ld)
+            {
+                ldInc = PMSM_LD_INC_MIN*pModel->ld;
+            }
+            else if(ldInc > PMSM_LD_INC_MAX*pModel->ld)
+            {
+                ldInc = PMSM_LD_INC_MAX*pModel->ld;
+            }
+            pModel->id += dt*(vd - pModel->rs*pModel->id + 
+                            omegaElec*pModel->lq*pModel->iq)/ldInc;
+            pModel->iq += dt*(vq - pModel->rs*pModel->iq - 
+                            omegaElec*(pModel->ld*pModel->id + pModel->flux))/
+                            pModel->lq;
+        }
+        else
+        {
+            pModel->id = 0;
+            pModel->iq = 0;
+        }
+        
+        pModel->torque = 1.5*pModel->polePairs*(pModel->flux*pModel->iq + 
+                    (pModel->ld - pModel->lq)*pModel->id*pModel->iq);
+        
+        if(pModel->locked)
+        {
+            pModel->omega = 0;
+        }
+        else
+        {
+            /* Load torque opposes the rotation and holds the rotor at 
+             * standstill while the motor torque is below the load */
+            load = pModel->loadTorque;
+            if((pModel->omega < 0) || 
+                ((pModel->omega == 0) && (pModel->torque < 0)))
+            {
+                load = -load;
+            }
+            omegaNew = pModel->omega + dt*(pModel->torque - load - 
+                            pModel->friction*pModel->omega)/pModel->inertia;
+            if((fabs(pModel->torque) <= pModel->loadTorque) && 
+                ((pModel->omega == 0) || (omegaNew*pModel->omega < 0)))
+            {
+                omegaNew = 0;
+            }
+            pModel->omega = omegaNew;
+        }
+        
+        pModel->thetaElec += dt*pModel->omega*pModel->polePairs;
+        pModel->position += dt*pModel->omega/(2.0*M_PI);
+        pModel->thetaElec = fmod(pModel->thetaElec, 2.0*M_PI);
+        if(pModel->thetaElec < 0)
+        {
+            pModel->thetaElec += 2.0*M_PI;
+        }
+    }
+}
+
+/**
+ * <B> Function: PMSM_ModelPhaseCurrents(const PMSM_MODEL_T *, double *, 
+ * double *)  </B>
+ * 
+ * @brief Function to calculate phase A and B currents in A.
+ */
+void PMSM_ModelPhaseCurrents(const PMSM_MODEL_T *pModel, double *pIa, 
+                                double *pIb)
+{
+    const double cosTheta = cos(pModel->thetaElec);
+    const double sinTheta = sin(pModel->thetaElec);
+    const double ialpha = pModel->id*cosTheta - pModel->iq*sinTheta;
+    const double ibeta = pModel->id*sinTheta + pModel->iq*cosTheta;
+    
+    *pIa = ialpha;
+    *pIb = -0.5*ialpha + 0.5*sqrt(3.0)*ibeta;
+}
+
+/**
+ * <B> Function: PMSM_ModelSpeedRpm(const PMSM_MODEL_T *)  </B>
+ * 
+ * @brief Function to return the mechanical speed in RPM.
+ */
+double PMSM_ModelSpeedRpm(const PMSM_MODEL_T *pModel)
+{
+    return pModel->omega*60.0/(2.0*M_PI);
+}
+
+// </editor-fold>
@@ -0,0 +1,116 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file pmsm_model.h
+ *
+ * @brief Continuous time model of a salient pole PMSM with inverter and mechanical
+ * load for the host simulation of the motor control application.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+#ifndef PMSM_MODEL_H
+#define	PMSM_MODEL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    /* Motor parameters in SI units */
+    double
+        rs,                 /* Phase resistance in Ohm */
+        ld,                 /* D axis inductance in H */
+        lq,                 /* Q axis inductance in H */
+        flux,               /* Permanent magnet flux linkage in Vs */
+        polePairs,          /* Number of pole pairs */
+        inertia,            /* Inertia of motor and load in kgm^2 */
+        ldSaturation,       /* Decrease of incremental Ld per Amp of D axis
+                             * current along the magnet flux, 0 = linear */
+        friction,           /* Viscous friction in Nm/(rad/s) */
+        loadTorque,         /* Load torque opposing the rotation in Nm */
+        vdc,                /* DC bus voltage in V */
+        deadTime;           /* Inverter dead time as a fraction of PWM 
+                             * period, 0 = ideal inverter */
+    
+    /* Inverter duty cycles of phase A, B and C as a fraction of period */
+    double duty[3];
+    
+    /* Inverter outputs enabled, otherwise phase currents are zero */
+    bool outputsEnabled;
+    
+    /* Rotor held at standstill, e.g. locked rotor test */
+    bool locked;
+    
+    /* States */
+    double
+        id,                 /* D axis current in A */
+        iq,                 /* Q axis current in A */
+        omega,              /* Mechanical speed in rad/s */
+        thetaElec,          /* Electrical angle in rad, 0 to 2*pi */
+        position,           /* Mechanical position in revolutions */
+        torque;             /* Electromagnetic torque in Nm */
+    
+}PMSM_MODEL_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="expanded" desc="INTERFACE FUNCTIONS ">
+
+void PMSM_ModelInit(PMSM_MODEL_T *);
+void PMSM_ModelStep(PMSM_MODEL_T *, double);
+void PMSM_ModelPhaseCurrents(const PMSM_MODEL_T *, double *, double *);
+double PMSM_ModelSpeedRpm(const PMSM_MODEL_T *);
+
+// </editor-fold>
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* PMSM_MODEL_H */
@@ -0,0 +1,249 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_deadtime.c
+ *
+ * @brief Host test of the inverter dead time compensation. Runs the motor model
+ * with 30% load at 200 to 1000 rpm, switches on the dead time of the model
+ * inverter and compares current ripple and estimator angle error without
+ * compensation, with duty correction and with estimator voltage correction.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Start speed, the speed command is lowered to the test speed with a 
+ * lower minimum speed */
+#define TEST_START_RPM          1000.0
+#define TEST_MIN_RPM            100.0
+
+/* Load as fraction of nominal torque */
+#define TEST_LOAD               0.3
+
+#define TEST_START_TIME_SEC     5.0
+#define TEST_SPEED_TIME_SEC     5.0
+#define TEST_LOAD_RAMP_SEC      1.0
+#define TEST_SETTLE_TIME_SEC    2.0
+#define TEST_MEASURE_TIME_SEC   1.0
+
+/* Limits with duty correction: current ripple as rms of D and Q axis 
+ * current variation per current, estimator angle error in degree and 
+ * speed error in rpm */
+#define TEST_RIPPLE_MAX         0.15
+#define TEST_ANGLE_MEAN_MAX     6.0
+#define TEST_ANGLE_PEAK_MAX     10.0
+#define TEST_SPEED_ERROR_MAX    2.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef enum
+{
+    TEST_IDEAL = 0,         /* Inverter without dead time */
+    TEST_UNCOMPENSATED,     /* Dead time, no compensation */
+    TEST_DUTY,              /* Dead time, duty correction */
+    TEST_ESTIMATOR,         /* Dead time, estimator voltage correction only */
+    TEST_CASES
+}TEST_CASE_T;
+
+typedef struct
+{
+    double
+        ripple,             /* Current ripple per current */
+        angleMean,          /* Mean estimator angle error in degree */
+        anglePeak,          /* Largest estimator angle error in degree */
+        speedError;         /* Mean speed error in rpm */
+    
+    bool
+        running;            /* Closed loop without fault at the end */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+static const char *testCaseName[TEST_CASES] = 
+{
+    "ideal inverter",
+    "no compensation",
+    "duty correction",
+    "estimator correction"
+};
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Dead time of the model and compensation are switched on together while
+ * running with load, duty correction with an ideal inverter would itself
+ * be a voltage error */
+static TEST_RESULT_T TestRun(TEST_CASE_T testCase, double rpm)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    TEST_RESULT_T result = {0, 0, 0, 0, false};
+    double loadTorque, angle, sumId = 0, sumId2 = 0, sumIq = 0, sumIq2 = 0;
+    double sumAngle = 0, sumSpeed = 0, id, iq;
+    uint32_t cycles, count = SIM_CYCLES(TEST_MEASURE_TIME_SEC);
+    
+    SIM_Init();
+    SIM_Run(1);
+    SIM_SpeedCommandSet(true, TEST_START_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    pMC1Data->pMotor->qMinSpeed = SIM_NormFromRpm(TEST_MIN_RPM);
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_SPEED_TIME_SEC));
+    loadTorque = TEST_LOAD*1.5*sim.motor.polePairs*sim.motor.flux*
+                    NOMINAL_CURRENT_PEAK;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    
+    if(testCase != TEST_IDEAL)
+    {
+        sim.motor.deadTime = DEADTIME_MICROSEC/LOOPTIME_MICROSEC;
+    }
+    pControlScheme->deadTime.enable = (testCase == TEST_DUTY);
+    pControlScheme->deadTime.estimatorEnable = (testCase == TEST_ESTIMATOR);
+    SIM_Run(SIM_CYCLES(TEST_SETTLE_TIME_SEC));
+    
+    for(cycles = 0; cycles < count; cycles++)
+    {
+        SIM_Run(1);
+        id = sim.motor.id;
+        iq = sim.motor.iq;
+        sumId += id;
+        sumId2 += id*id;
+        sumIq += iq;
+        sumIq2 += iq*iq;
+        angle = SIM_AngleErrorGet(
+                    pControlScheme->estimInterface.pOutput->qTheta)*
+                    180.0/32768.0;
+        sumAngle += angle;
+        result.anglePeak = fmax(result.anglePeak, fabs(angle));
+        sumSpeed += PMSM_ModelSpeedRpm(&sim.motor);
+    }
+    id = sumId/count;
+    iq = sumIq/count;
+    result.ripple = sqrt(fmax(sumId2/count - id*id, 0) + 
+                        fmax(sumIq2/count - iq*iq, 0))/fmax(hypot(id, iq), 
+                        1e-3);
+    result.angleMean = sumAngle/count;
+    result.speedError = sumSpeed/count - rpm;
+    result.running = (pControlScheme->focState == FOC_CLOSE_LOOP) &&
+                        (pMC1Data->fault.faultState == 0) && 
+                        (fabs(result.speedError) < TEST_SPEED_ERROR_MAX);
+    return result;
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    const double rpm[] = {200.0, 500.0, 1000.0};
+    TEST_RESULT_T result[TEST_CASES];
+    TEST_CASE_T testCase;
+    uint16_t index;
+    
+    for(index = 0; index < sizeof(rpm)/sizeof(rpm[0]); index++)
+    {
+        for(testCase = TEST_IDEAL; testCase < TEST_CASES; testCase++)
+        {
+            result[testCase] = TestRun(testCase, rpm[index]);
+            if(result[testCase].running)
+            {
+                printf("  %4.0f rpm, %-20s: ripple %4.1f%%, angle error "
+                    "%4.1f deg mean, %4.1f deg peak\n", rpm[index], 
+                    testCaseName[testCase], 100.0*result[testCase].ripple,
+                    result[testCase].angleMean, result[testCase].anglePeak);
+            }
+            else
+            {
+                printf("  %4.0f rpm, %-20s: lost, speed error %.0f rpm\n", 
+                    rpm[index], testCaseName[testCase], 
+                    result[testCase].speedError);
+            }
+        }
+        
+        TEST_CHECK(result[TEST_DUTY].running && 
+            (result[TEST_DUTY].ripple < TEST_RIPPLE_MAX) && 
+            (fabs(result[TEST_DUTY].angleMean) < TEST_ANGLE_MEAN_MAX) &&
+            (result[TEST_DUTY].anglePeak < TEST_ANGLE_PEAK_MAX),
+            "%.0f rpm: duty correction ripple %.3f, angle error %.1f deg "
+            "mean, %.1f deg peak", rpm[index], result[TEST_DUTY].ripple, 
+            result[TEST_DUTY].angleMean, result[TEST_DUTY].anglePeak);
+        TEST_CHECK((result[TEST_DUTY].ripple < 
+                        result[TEST_UNCOMPENSATED].ripple) && 
+            (result[TEST_DUTY].anglePeak < 
+                        result[TEST_UNCOMPENSATED].anglePeak),
+            "%.0f rpm: duty correction not better than no compensation", 
+            rpm[index]);
+        /* Estimator correction alone keeps the angle where the current 
+         * controllers can still follow the current */
+        TEST_CHECK((rpm[index] < 500.0) || 
+            (result[TEST_ESTIMATOR].running && 
+            (fabs(result[TEST_ESTIMATOR].angleMean) < TEST_ANGLE_MEAN_MAX)),
+            "%.0f rpm: estimator correction angle error %.1f deg", 
+            rpm[index], result[TEST_ESTIMATOR].angleMean);
+    }
+    
+    return TEST_RESULT("test_deadtime");
+}
@@ -0,0 +1,229 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_decoupling.c
+ *
+ * @brief Host test of the current controller decoupling feedforward. Steps the
+ * Q axis current reference at 500 to 2500 rpm with and without decoupling
+ * and compares the D axis current disturbance and the Q axis current rise
+ * time, then switches decoupling on and off while running.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed step of the speed reference in one ramp increment, the speed 
+ * controller steps the Q axis current reference */
+#define TEST_STEP_RPM           1000.0
+
+#define TEST_START_TIME_SEC     6.0
+#define TEST_STEP_TIME_SEC      0.005
+
+/* D axis current disturbance per ampere of Q axis current step with 
+ * decoupling, and the reduction against no decoupling above 1000 rpm */
+#define TEST_ID_ERROR_MAX       0.1
+#define TEST_ID_ERROR_RATIO     0.5
+
+/* Spread of the Q axis current rise time over speed with decoupling */
+#define TEST_RISE_SPREAD_CYCLES 1
+
+/* Load of the on/off switching test, fraction of nominal torque, and the
+ * voltage step limit at switching */
+#define TEST_SWITCH_LOAD        0.5
+#define TEST_SWITCH_VOLTAGE     200
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        iqStep,             /* Q axis current reference step in A */
+        idError;            /* Largest D axis current error per A of step */
+    
+    int32_t
+        riseCycles;         /* Q axis current rise time to 90% in cycles */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static double TestCurrentA(int16_t current)
+{
+    return current*MC1_PEAK_CURRENT/32768.0;
+}
+
+/* Q axis current step at speed, currents as seen by the current 
+ * controllers */
+static TEST_RESULT_T TestStep(bool decoupling, double rpm)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_CONTROL_T *pCtrlParam = &pControlScheme->ctrlParam;
+    TEST_RESULT_T result = {0, 0, -1};
+    double iqStart, idError;
+    int32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pControlScheme->decoupling.enable = decoupling;
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    iqStart = TestCurrentA(pControlScheme->idq.q);
+    
+    SIM_SpeedCommandSet(true, rpm + TEST_STEP_RPM);
+    SIM_Run(1);
+    pCtrlParam->CLSpeedRampRate = 
+                (int16_t)pCtrlParam->qTargetVelocity - pCtrlParam->qVelRef;
+    pCtrlParam->speedRampSkipCnt = pCtrlParam->speedRampIncLimit;
+    SIM_Run(1);
+    result.iqStep = TestCurrentA(pCtrlParam->qIqRef) - iqStart;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_STEP_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        idError = fabs(TestCurrentA(pControlScheme->idq.d) - 
+                        TestCurrentA(pCtrlParam->qIdRef))/result.iqStep;
+        result.idError = fmax(result.idError, idError);
+        if((result.riseCycles < 0) && (TestCurrentA(pControlScheme->idq.q) >
+                                        (iqStart + 0.9*result.iqStep)))
+        {
+            result.riseCycles = cycles + 1;
+        }
+    }
+    return result;
+}
+
+/* Largest voltage change in one cycle around switching decoupling on or
+ * off at the current controller voltage */
+static int16_t TestSwitch(double rpm)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MC_DQ_T vdqLast;
+    int16_t step = 0;
+    int16_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    sim.motor.loadTorque = TEST_SWITCH_LOAD*1.5*sim.motor.polePairs*
+                            sim.motor.flux*NOMINAL_CURRENT_PEAK;
+    SIM_Run(SIM_CYCLES(1.0));
+    for(cycles = 0; cycles < 4; cycles++)
+    {
+        pControlScheme->decoupling.enable = ((cycles & 1) == 0);
+        vdqLast = pControlScheme->vdq;
+        SIM_Run(1);
+        TEST_CHECK(pControlScheme->decoupling.active == 
+            pControlScheme->decoupling.enable, "decoupling not switched");
+        step = (int16_t)fmax(step, fmax(abs(pControlScheme->vdq.d - vdqLast.d),
+                                    abs(pControlScheme->vdq.q - vdqLast.q)));
+        SIM_Run(SIM_CYCLES(0.5));
+    }
+    return step;
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    const double rpm[] = {500.0, 1500.0, 2500.0};
+    TEST_RESULT_T on, off;
+    int32_t riseMin = INT32_MAX, riseMax = 0;
+    int16_t voltageStep;
+    uint16_t index;
+    
+    for(index = 0; index < sizeof(rpm)/sizeof(rpm[0]); index++)
+    {
+        off = TestStep(false, rpm[index]);
+        on = TestStep(true, rpm[index]);
+        TEST_CHECK(on.idError < TEST_ID_ERROR_MAX, 
+            "%.0f rpm: Id error %.3f A/A with decoupling", rpm[index], 
+            on.idError);
+        TEST_CHECK((rpm[index] < 1000.0) || 
+            (on.idError < TEST_ID_ERROR_RATIO*off.idError),
+            "%.0f rpm: Id error %.3f A/A with, %.3f A/A without decoupling",
+            rpm[index], on.idError, off.idError);
+        TEST_CHECK((on.riseCycles > 0) && 
+            (on.riseCycles <= off.riseCycles),
+            "%.0f rpm: Iq rise %d cycles with, %d without decoupling",
+            rpm[index], on.riseCycles, off.riseCycles);
+        riseMin = (on.riseCycles < riseMin) ? on.riseCycles : riseMin;
+        riseMax = (on.riseCycles > riseMax) ? on.riseCycles : riseMax;
+        printf("  %4.0f rpm, Iq step %.2f A: Id error %.3f / %.3f A/A, "
+            "Iq rise %d / %d cycles with / without decoupling\n", 
+            rpm[index], on.iqStep, on.idError, off.idError, on.riseCycles, 
+            off.riseCycles);
+    }
+    TEST_CHECK((riseMax - riseMin) <= TEST_RISE_SPREAD_CYCLES,
+        "Iq rise %d to %d cycles over speed with decoupling", riseMin,
+        riseMax);
+    
+    voltageStep = TestSwitch(rpm[2]);
+    TEST_CHECK(voltageStep < TEST_SWITCH_VOLTAGE, 
+        "voltage step %d switching decoupling", voltageStep);
+    printf("  decoupling on/off at %.0f rpm: voltage step %d\n", rpm[2],
+        voltageStep);
+    
+    return TEST_RESULT("test_decoupling");
+}
@@ -0,0 +1,187 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_disturbance.c
+ *
+ * @brief Host test of the load disturbance observer. Applies load steps in closed
+ * loop speed control, with and without the observer and with the model 
+ * inertia off from the value of SPEED_LOOP_TAU_MECH_SEC, and compares the 
+ * speed deviation and the load estimate.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define TEST_SPEED_RPM          1000.0
+#define TEST_START_TIME_SEC     8.0
+#define TEST_STEP_TIME_SEC      1.0
+
+/* Load before and after the step as fraction of nominal torque */
+#define TEST_LOAD_LOW           0.1
+#define TEST_LOAD_HIGH          0.3
+
+/* Speed deviation with the observer as fraction of that without it, load 
+ * estimate error and speed error at the end of the step */
+#define TEST_DEVIATION_RATIO    0.25
+#define TEST_LOAD_ERROR         0.02
+#define TEST_SPEED_ERROR_RPM    2.0
+
+#define TEST_INERTIA_COUNT      3
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        dip,                /* Speed below reference after the load rise */
+        rise,               /* Speed above reference after the load drop */
+        load,               /* Load estimate after the load rise in A */
+        speed;              /* Speed error at the end in RPM */
+    uint16_t fault;
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+/* Model inertia relative to SPEED_LOOP_TAU_MECH_SEC */
+static const double inertiaFactor[TEST_INERTIA_COUNT] = {0.67, 1.0, 1.5};
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Returns the largest speed deviation over the step, below or above the 
+ * reference */
+static double TestLoadStep(double load, bool below)
+{
+    const double loadTorque = 1.5*sim.motor.polePairs*sim.motor.flux*
+                                NOMINAL_CURRENT_PEAK;
+    double error, errorMax = 0;
+    uint32_t cycles;
+    
+    sim.motor.loadTorque = load*loadTorque;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_STEP_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        error = PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM;
+        errorMax = below ? fmin(errorMax, error) : fmax(errorMax, error);
+    }
+    return fabs(errorMax);
+}
+
+static TEST_RESULT_T TestRun(double inertia, bool enable)
+{
+    MCAPP_DISTURBANCE_OBSERVER_T *pObserver = 
+                                &pMC1Data->controlScheme.disturbance;
+    TEST_RESULT_T result;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pObserver->enable = enable;
+    sim.motor.inertia *= inertia;
+    sim.motor.loadTorque = TEST_LOAD_LOW*1.5*sim.motor.polePairs*
+                            sim.motor.flux*NOMINAL_CURRENT_PEAK;
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    
+    result.dip = TestLoadStep(TEST_LOAD_HIGH, true);
+    result.load = (pObserver->load >> 16)*MC1_PEAK_CURRENT/32768.0;
+    result.rise = TestLoadStep(TEST_LOAD_LOW, false);
+    result.speed = PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM;
+    result.fault = pMC1Data->fault.faultState;
+    return result;
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TEST_RESULT_T without, with;
+    uint16_t index;
+    
+    for(index = 0; index < TEST_INERTIA_COUNT; index++)
+    {
+        without = TestRun(inertiaFactor[index], false);
+        with = TestRun(inertiaFactor[index], true);
+        
+        TEST_CHECK((without.fault == 0) && (with.fault == 0), 
+            "inertia %.2f: faults 0x%04x, 0x%04x", inertiaFactor[index],
+            without.fault, with.fault);
+        TEST_CHECK((with.dip < TEST_DEVIATION_RATIO*without.dip) && 
+            (with.rise < TEST_DEVIATION_RATIO*without.rise), 
+            "inertia %.2f: dip %.1f, %.1f rpm, rise %.1f, %.1f rpm", 
+            inertiaFactor[index], with.dip, without.dip, with.rise, 
+            without.rise);
+        TEST_CHECK(fabs(with.load/(TEST_LOAD_HIGH*NOMINAL_CURRENT_PEAK) - 1)
+            < TEST_LOAD_ERROR, "inertia %.2f: load estimate %.3f A, "
+            "load %.3f A", inertiaFactor[index], with.load, 
+            TEST_LOAD_HIGH*NOMINAL_CURRENT_PEAK);
+        TEST_CHECK(fabs(with.speed) < TEST_SPEED_ERROR_RPM, 
+            "inertia %.2f: speed error %.1f rpm", inertiaFactor[index], 
+            with.speed);
+        printf("  inertia %.2f: speed dip %.1f rpm (%.1f rpm without), "
+            "rise %.1f rpm (%.1f rpm without), load estimate %.3f A of "
+            "%.3f A\n", inertiaFactor[index], with.dip, without.dip, 
+            with.rise, without.rise, with.load, 
+            TEST_LOAD_HIGH*NOMINAL_CURRENT_PEAK);
+    }
+    
+    return TEST_RESULT("test_disturbance");
+}
@@ -0,0 +1,316 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_dpwm.c
+ *
+ * @brief Host test of discontinuous PWM. Runs the motor model at high modulation
+ * index in all modes and compares switching periods, applied voltage and
+ * currents against continuous space vector modulation, then checks the
+ * modulation index hysteresis and the bootstrap refresh.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* DC bus voltage and speeds of the modulation index, about 0.72 at 
+ * TEST_HIGH_RPM, 0.55 at TEST_MID_RPM and 0.29 at TEST_LOW_RPM */
+#define TEST_VDC                160.0
+#define TEST_HIGH_RPM           2500.0
+#define TEST_MID_RPM            1900.0
+#define TEST_LOW_RPM            1000.0
+
+/* Load as fraction of nominal torque */
+#define TEST_LOAD               0.5
+
+/* Speed ramp of one count every 2 control periods */
+#define TEST_RAMP_MULTIPLIER    2
+
+/* Periods at positive rail before refresh in the refresh test, below the
+ * 26 periods of the 120 degree clamping of MCAPP_DPWM_MAX at TEST_HIGH_RPM.
+ * DPWM_REFRESH_COUNT is longer than the clamping at speeds where the 
+ * modulation index reaches DPWM_MODULATION_ON with the lowest DC bus 
+ * voltage of DC link compensation */
+#define TEST_REFRESH_COUNT      16
+
+#define TEST_START_TIME_SEC     6.0
+#define TEST_LOAD_RAMP_SEC      1.0
+#define TEST_SETTLE_TIME_SEC    1.0
+#define TEST_MEASURE_TIME_SEC   0.5
+
+/* Switching phase periods of discontinuous PWM, 2/3 with the refresh 
+ * periods and the periods held at MIN_DUTY, and difference of mean D and Q axis currents against space 
+ * vector modulation in A */
+#define TEST_SWITCHING_MAX      0.72
+#define TEST_CURRENT_ERROR      0.03
+
+/* Applied voltage error in V counted as changed */
+#define TEST_VOLTAGE_ERROR      0.5
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        switching,          /* Switching phase periods per phase period */
+        active,             /* Periods with discontinuous PWM active */
+        id,                 /* Mean D axis current in A */
+        iq,                 /* Mean Q axis current in A */
+        voltageRatio,       /* Mean applied voltage per commanded voltage */
+        voltageError,       /* Largest applied voltage error in V */
+        errorPeriods;       /* Periods with applied voltage changed */
+    
+    uint16_t
+        highRunMax,         /* Longest run of a phase at positive rail */
+        refreshCount,       /* Refresh periods */
+        faultState;         /* Faults at the end */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+/* Applied voltage per commanded voltage of space vector modulation */
+static double voltageRatio;
+
+static const char *testModeName[] = 
+{
+    "SVPWM", "DPWM0", "DPWM1", "DPWM2", "DPWMMIN", "DPWMMAX"
+};
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static void TestStart(MCAPP_DPWM_MODE_T mode, double rpm)
+{
+    double loadTorque;
+    uint32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pMC1Data->controlScheme.dpwm.mode = mode;
+    pMC1Data->controlScheme.ctrlParam.speedRampIncLimit = TEST_RAMP_MULTIPLIER;
+    sim.motor.vdc = TEST_VDC;
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    loadTorque = TEST_LOAD*1.5*sim.motor.polePairs*sim.motor.flux*
+                    NOMINAL_CURRENT_PEAK;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    SIM_Run(SIM_CYCLES(TEST_SETTLE_TIME_SEC));
+}
+
+/* Measures the model duty cycles, the applied voltage is compared with 
+ * the commanded voltage times voltageRatio of space vector modulation */
+static TEST_RESULT_T TestMeasure(void)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    TEST_RESULT_T result = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    const double dutyRefresh = (double)(MAX_DUTY)/LOOPTIME_TCY;
+    uint32_t cycles, count = SIM_CYCLES(TEST_MEASURE_TIME_SEC);
+    uint16_t phase, highRun[3] = {0, 0, 0};
+    double duty, valpha, vbeta, error, vCommand;
+    
+    for(cycles = 0; cycles < count; cycles++)
+    {
+        SIM_Run(1);
+        for(phase = 0; phase < 3; phase++)
+        {
+            duty = sim.motor.duty[phase];
+            result.switching += ((duty > 0) && (duty < 1));
+            if(duty >= 1)
+            {
+                highRun[phase]++;
+                if(highRun[phase] > result.highRunMax)
+                {
+                    result.highRunMax = highRun[phase];
+                }
+            }
+            else
+            {
+                if((highRun[phase] > 0) && (duty == dutyRefresh))
+                {
+                    result.refreshCount++;
+                }
+                highRun[phase] = 0;
+            }
+        }
+        valpha = (2.0*sim.motor.duty[0] - sim.motor.duty[1] - 
+                    sim.motor.duty[2])/3.0*sim.motor.vdc;
+        vbeta = (sim.motor.duty[1] - sim.motor.duty[2])/sqrt(3.0)*
+                    sim.motor.vdc;
+        vCommand = hypot(pControlScheme->valphabeta.alpha, 
+                            pControlScheme->valphabeta.beta);
+        result.voltageRatio += hypot(valpha, vbeta)/vCommand;
+        error = hypot(valpha - 
+                    voltageRatio*pControlScheme->valphabeta.alpha, 
+                    vbeta - voltageRatio*pControlScheme->valphabeta.beta);
+        result.voltageError = fmax(result.voltageError, error);
+        result.errorPeriods += (error > TEST_VOLTAGE_ERROR);
+        result.active += pControlScheme->dpwm.active;
+        result.id += sim.motor.id;
+        result.iq += sim.motor.iq;
+    }
+    result.switching /= 3.0*count;
+    result.active /= count;
+    result.id /= count;
+    result.iq /= count;
+    result.voltageRatio /= count;
+    result.errorPeriods /= count;
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+static void TestModes(void)
+{
+    TEST_RESULT_T svpwm, dpwm;
+    MCAPP_DPWM_MODE_T mode;
+    
+    TestStart(MCAPP_DPWM_NONE, TEST_HIGH_RPM);
+    voltageRatio = 0;
+    voltageRatio = TestMeasure().voltageRatio;
+    svpwm = TestMeasure();
+    TEST_CHECK((svpwm.switching == 1.0) && (svpwm.active == 0) && 
+        (svpwm.errorPeriods == 0), "SVPWM switching %.3f, active %.2f, "
+        "voltage error %.2f V", svpwm.switching, svpwm.active, 
+        svpwm.voltageError);
+    
+    for(mode = MCAPP_DPWM_0; mode <= MCAPP_DPWM_MAX; mode++)
+    {
+        TestStart(mode, TEST_HIGH_RPM);
+        dpwm = TestMeasure();
+        TEST_CHECK((dpwm.faultState == 0) && (dpwm.active == 1.0) && 
+            (dpwm.switching < TEST_SWITCHING_MAX), 
+            "%s: switching %.3f, active %.2f, faults 0x%04x", 
+            testModeName[mode], dpwm.switching, dpwm.active, 
+            dpwm.faultState);
+        TEST_CHECK((fabs(dpwm.id - svpwm.id) < TEST_CURRENT_ERROR) && 
+            (fabs(dpwm.iq - svpwm.iq) < TEST_CURRENT_ERROR),
+            "%s: Id %.3f A, Iq %.3f A against %.3f A, %.3f A", 
+            testModeName[mode], dpwm.id, dpwm.iq, svpwm.id, svpwm.iq);
+        TEST_CHECK(dpwm.errorPeriods == 0, "%s: voltage error %.2f V", 
+            testModeName[mode], dpwm.voltageError);
+        TEST_CHECK(dpwm.highRunMax <= DPWM_REFRESH_COUNT, 
+            "%s: %d periods at positive rail", testModeName[mode], 
+            dpwm.highRunMax);
+        printf("  %-8s switching %.3f, voltage error %.2f V, Id %.3f A, "
+            "Iq %.3f A\n", testModeName[mode], dpwm.switching, 
+            dpwm.voltageError, dpwm.id, dpwm.iq);
+    }
+    printf("  %-8s switching %.3f, Id %.3f A, Iq %.3f A\n", 
+        testModeName[MCAPP_DPWM_NONE], svpwm.switching, svpwm.id, svpwm.iq);
+}
+
+/* Discontinuous PWM starts above DPWM_MODULATION_ON and stops below 
+ * DPWM_MODULATION_OFF */
+static void TestHysteresis(void)
+{
+    const double rpm[] = {TEST_MID_RPM, TEST_HIGH_RPM, TEST_MID_RPM, 
+                            TEST_LOW_RPM};
+    const bool active[] = {false, true, true, false};
+    TEST_RESULT_T result;
+    uint16_t index;
+    
+    TestStart(MCAPP_DPWM_1, rpm[0]);
+    for(index = 0; index < sizeof(rpm)/sizeof(rpm[0]); index++)
+    {
+        SIM_SpeedCommandSet(true, rpm[index]);
+        SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+        result = TestMeasure();
+        TEST_CHECK(result.active == (active[index] ? 1.0 : 0.0), 
+            "%.0f rpm: active %.2f", rpm[index], result.active);
+    }
+}
+
+/* A phase at positive rail gets a refresh period after refreshCountLimit
+ * periods, line voltages are unchanged */
+static void TestRefresh(void)
+{
+    TEST_RESULT_T result;
+    
+    TestStart(MCAPP_DPWM_MAX, TEST_HIGH_RPM);
+    pMC1Data->controlScheme.dpwm.refreshCountLimit = TEST_REFRESH_COUNT;
+    result = TestMeasure();
+    TEST_CHECK((result.faultState == 0) && (result.active == 1.0) && 
+        (result.highRunMax == TEST_REFRESH_COUNT) && 
+        (result.refreshCount > 0) && (result.errorPeriods == 0), 
+        "refresh: %d periods at positive rail, %d refresh periods, voltage"
+        " error %.2f V, faults 0x%04x", result.highRunMax, 
+        result.refreshCount, result.voltageError, result.faultState);
+    printf("  refresh after %d periods: longest run at positive rail %d "
+        "periods, %d refresh periods in %.1f s, voltage error %.2f V\n", 
+        TEST_REFRESH_COUNT, result.highRunMax, result.refreshCount, 
+        TEST_MEASURE_TIME_SEC, result.voltageError);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestModes();
+    TestHysteresis();
+    TestRefresh();
+    
+    return TEST_RESULT("test_dpwm");
+}
@@ -0,0 +1,242 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_estim_adapt.c
+ *
+ * @brief Host test of the online Rs and back EMF constant adaptation of the PLL 
+ * estimator. Changes the resistance of the motor model as from cold to hot 
+ * winding at low speed with load, and the flux linkage at high speed, and checks
+ * that the adapted values converge to the motor values, and the angle error and 
+ * torque per amp against the same run without adaptation.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Resistance is adapted below ADAPT_RS_MAX_SPEED_RPM with Q axis current above
+ * ADAPT_RS_MIN_CURRENT, 40% load gives about 1.7 A */
+#define TEST_RS_SPEED_RPM       600.0
+#define TEST_RS_LOAD            0.4
+
+/* Back EMF constant is adapted above ADAPT_KFI_MIN_SPEED_RPM */
+#define TEST_KFI_SPEED_RPM      2000.0
+#define TEST_KFI_LOAD           0.2
+
+/* Start and speed ramp time before the motor parameter is changed */
+#define TEST_START_TIME_SEC     7.0
+
+/* Load is ramped, a step of this size dips the speed a lot with the default
+ * speed controller gains */
+#define TEST_LOAD_RAMP_SEC      2.0
+
+/* Time for adaptation, several ADAPT_TIME_CONST_SEC */
+#define TEST_ADAPT_TIME_SEC     (ADAPT_TIME_CONST_SEC*8)
+
+/* Angle error and torque per amp are averaged over the last second */
+#define TEST_AVERAGE_TIME_SEC   1.0
+
+/* Limit of the adapted value error relative to the motor value. Adapted Rs
+ * settles 2 to 5% below the motor value, also with Ld equal to Lq */
+#define TEST_RS_ERROR           0.05
+#define TEST_KFI_ERROR          0.03
+
+/* Angle error limit with adaptation in electrical degrees. It includes the 
+ * error from the estimator inductance being below the motor Lq, about 1.5 deg
+ * at 40% load with nominal parameters and 0.3 deg with Lq set to it */
+#define TEST_ANGLE_ERROR_DEG    2.5
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        rsRatio,            /* Adapted Rs relative to the configured value */
+        kfiRatio,           /* Adapted Ke relative to the configured value */
+        angleError,         /* Mean absolute angle error in degrees */
+        torquePerAmp;       /* Mean torque per current magnitude in Nm/A */
+    
+    uint16_t
+        faultState;         /* Faults at the end of the run */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Runs at speed with load, with the motor resistance and flux changed by the 
+ * given ratios from the configured values */
+static TEST_RESULT_T TestAdapt(bool enable, double rpm, double load, 
+                                double rsRatio, double fluxRatio)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    const MCAPP_MOTOR_T *pMotor;
+    TEST_RESULT_T result = {0, 0, 0, 0, 0};
+    double loadTorque, torque = 0, current = 0;
+    uint32_t cycles, averageCycles = SIM_CYCLES(TEST_AVERAGE_TIME_SEC);
+    
+    SIM_Init();
+    SIM_Run(1);
+    pMotor = pMC1Data->pMotor;
+    pControlScheme->estimAdapt.enable = enable;
+    loadTorque = load*1.5*sim.motor.polePairs*sim.motor.flux*
+                                NOMINAL_CURRENT_PEAK;
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    
+    sim.motor.rs *= rsRatio;
+    sim.motor.flux *= fluxRatio;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    SIM_Run(SIM_CYCLES(TEST_ADAPT_TIME_SEC));
+    
+    for(cycles = 0; cycles < averageCycles; cycles++)
+    {
+        SIM_Run(1);
+        result.angleError += fabs(SIM_AngleErrorGet(
+                    pControlScheme->estimInterface.qTheta))*360.0/65536.0;
+        torque += sim.motor.torque;
+        current += hypot(sim.motor.id, sim.motor.iq);
+    }
+    result.angleError /= averageCycles;
+    result.torquePerAmp = torque/current;
+    result.rsRatio = ((double)pMotor->qRs/(1L << pMotor->qRsScale))/
+                        ((double)NORM_RS/(1L << NORM_RS_QVALUE));
+    result.kfiRatio = ((double)NORM_INVKFI_CONST/
+                        (1L << NORM_INVKFI_CONST_QVALUE))/
+                        ((double)pControlScheme->estimPLL.qInvKfiConst/
+                        (1L << pControlScheme->estimPLL.qInvKfiConstScale));
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+static void TestResistance(double rsRatio)
+{
+    TEST_RESULT_T fixed = TestAdapt(false, TEST_RS_SPEED_RPM, TEST_RS_LOAD,
+                                        rsRatio, 1.0);
+    TEST_RESULT_T adapt = TestAdapt(true, TEST_RS_SPEED_RPM, TEST_RS_LOAD, 
+                                        rsRatio, 1.0);
+    
+    TEST_CHECK((fixed.faultState == 0) && (adapt.faultState == 0), 
+        "Rs x%.2f: faults 0x%04x without, 0x%04x with adaptation", rsRatio,
+        fixed.faultState, adapt.faultState);
+    TEST_CHECK(fabs(adapt.rsRatio/rsRatio - 1.0) < TEST_RS_ERROR, 
+        "Rs x%.2f: adapted to x%.3f", rsRatio, adapt.rsRatio);
+    TEST_CHECK(adapt.angleError < TEST_ANGLE_ERROR_DEG, 
+        "Rs x%.2f: angle error %.2f deg with adaptation", rsRatio, 
+        adapt.angleError);
+    /* With cold winding the Rs error happens to cancel part of the error 
+     * from the inductance, only hot winding must improve */
+    TEST_CHECK((rsRatio < 1.0) || (adapt.angleError < fixed.angleError), 
+        "Rs x%.2f: angle error %.2f deg with, %.2f deg without adaptation",
+        rsRatio, adapt.angleError, fixed.angleError);
+    TEST_CHECK(adapt.kfiRatio == 1.0, 
+        "Rs x%.2f: Ke adapted to x%.3f below the Ke speed", rsRatio, 
+        adapt.kfiRatio);
+    printf("  Rs x%.2f at %.0f rpm: adapted x%.3f, angle error %.2f deg "
+            "(%.2f deg fixed), %.4f Nm/A (%.4f Nm/A fixed)\n", rsRatio, 
+            TEST_RS_SPEED_RPM, adapt.rsRatio, adapt.angleError, 
+            fixed.angleError, adapt.torquePerAmp, fixed.torquePerAmp);
+}
+
+static void TestBackEMFConstant(double fluxRatio)
+{
+    TEST_RESULT_T fixed = TestAdapt(false, TEST_KFI_SPEED_RPM, TEST_KFI_LOAD,
+                                        1.0, fluxRatio);
+    TEST_RESULT_T adapt = TestAdapt(true, TEST_KFI_SPEED_RPM, TEST_KFI_LOAD, 
+                                        1.0, fluxRatio);
+    
+    TEST_CHECK((fixed.faultState == 0) && (adapt.faultState == 0), 
+        "Ke x%.2f: faults 0x%04x without, 0x%04x with adaptation", fluxRatio,
+        fixed.faultState, adapt.faultState);
+    TEST_CHECK(fabs(adapt.kfiRatio/fluxRatio - 1.0) < TEST_KFI_ERROR, 
+        "Ke x%.2f: adapted to x%.3f", fluxRatio, adapt.kfiRatio);
+    TEST_CHECK((adapt.angleError < TEST_ANGLE_ERROR_DEG) && 
+        (adapt.angleError < fixed.angleError), 
+        "Ke x%.2f: angle error %.2f deg with, %.2f deg without adaptation", 
+        fluxRatio, adapt.angleError, fixed.angleError);
+    TEST_CHECK(adapt.torquePerAmp > fixed.torquePerAmp, 
+        "Ke x%.2f: %.4f Nm/A with, %.4f Nm/A without adaptation", 
+        fluxRatio, adapt.torquePerAmp, fixed.torquePerAmp);
+    printf("  Ke x%.2f at %.0f rpm: adapted x%.3f, angle error %.2f deg "
+            "(%.2f deg fixed), %.4f Nm/A (%.4f Nm/A fixed)\n", fluxRatio, 
+            TEST_KFI_SPEED_RPM, adapt.kfiRatio, adapt.angleError, 
+            fixed.angleError, adapt.torquePerAmp, fixed.torquePerAmp);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    /* Cold and hot winding, within ADAPT_RS_RATIO_MIN and MAX */
+    TestResistance(0.75);
+    TestResistance(1.4);
+    TestBackEMFConstant(0.9);
+    TestBackEMFConstant(1.1);
+    
+    return TEST_RESULT("test_estim_adapt");
+}
@@ -0,0 +1,168 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_estim_eemf.c
+ *
+ * @brief Host test of the extended EMF observer estimator on the simulated 
+ * motor. Starts with the observer selected, checks the angle error at steady
+ * speed against the angle travelled in one control period and checks that the
+ * estimator can not be changed while the motor runs. Comparison with the PLL
+ * estimator is printed by bench_estimators.c.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "estim_interface.h"
+#include "mc_app_types.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Steady speeds of the angle error check */
+#define TEST_SPEED_COUNT        3
+#define TEST_SPEEDS_RPM         {1000.0, 2000.0, 3000.0}
+
+/* Time limit to reach a speed, settling and measurement time */
+#define TEST_START_TIME_SEC     30.0
+#define TEST_SETTLE_TIME_SEC    1.0
+#define TEST_MEASURE_TIME_SEC   0.5
+
+/* RMS angle error limit, as part of the electrical angle travelled in one
+ * control period. The angle is compared with the model after the period. */
+#define TEST_ERROR_MAX_PERIODS  0.6
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Runs until the reference speed is reached, then settles */
+static bool TestSpeedSet(double rpm)
+{
+    const int16_t qTarget = SIM_NormFromRpm(rpm);
+    uint32_t cycles = 0;
+    
+    SIM_SpeedCommandSet(true, rpm);
+    while((cycles < SIM_CYCLES(TEST_START_TIME_SEC)) && 
+        (pMC1Data->appState != MCAPP_FAULT) &&
+        ((pMC1Data->controlScheme.focState != FOC_CLOSE_LOOP) ||
+        (pMC1Data->controlScheme.ctrlParam.qVelRef != qTarget)))
+    {
+        SIM_Run(1);
+        cycles++;
+    }
+    SIM_Run(SIM_CYCLES(TEST_SETTLE_TIME_SEC));
+    
+    return (pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) && 
+            (pMC1Data->fault.faultState == 0);
+}
+
+/* RMS angle error of the selected estimator in electrical degrees */
+static double TestAngleErrorRms(void)
+{
+    const MCAPP_ESTIMATOR_T *pEstimInterface = 
+                                &pMC1Data->controlScheme.estimInterface;
+    double error, sumSquare = 0.0;
+    uint32_t cycles;
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_MEASURE_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        error = SIM_AngleErrorGet(pEstimInterface->pOutput->qTheta)*
+                    360.0/65536.0;
+        sumSquare += error*error;
+    }
+    return sqrt(sumSquare/SIM_CYCLES(TEST_MEASURE_TIME_SEC));
+}
+
+static void TestAngleError(void)
+{
+    const double speeds[TEST_SPEED_COUNT] = TEST_SPEEDS_RPM;
+    double rms, period;
+    uint16_t index;
+    
+    SIM_Init();
+    SIM_Run(1);
+    TEST_CHECK(MCAPP_MC1EstimatorSelect(MCAPP_ESTIMATOR_EEMF),
+        "estimator not selected");
+    
+    for(index = 0; index < TEST_SPEED_COUNT; index++)
+    {
+        TEST_CHECK(TestSpeedSet(speeds[index]), 
+            "%.0f rpm not reached, focState %d fault 0x%04x", speeds[index],
+            pMC1Data->controlScheme.focState, pMC1Data->fault.faultState);
+        
+        /* Electrical degrees travelled in one control period */
+        period = speeds[index]/60.0*sim.motor.polePairs*360.0*LOOPTIME_SEC;
+        rms = TestAngleErrorRms();
+        printf("EEMF at %.0f rpm: RMS angle error %.2f deg, %.2f periods\n",
+            speeds[index], rms, rms/period);
+        TEST_CHECK(rms <= TEST_ERROR_MAX_PERIODS*period, 
+            "RMS angle error %.2f deg at %.0f rpm", rms, speeds[index]);
+    }
+    
+    TEST_CHECK(!MCAPP_MC1EstimatorSelect(MCAPP_ESTIMATOR_PLL), 
+        "estimator changed while running");
+    TEST_CHECK(pMC1Data->controlScheme.estimInterface.estimatorId == 
+        MCAPP_ESTIMATOR_EEMF, "estimator changed while running");
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestAngleError();
+    
+    return TEST_RESULT("test_estim_eemf");
+}
@@ -0,0 +1,219 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_estim_monitor.c
+ *
+ * @brief Host test of the estimator lock monitor. Locks the rotor of the 
+ * simulated motor in closed loop and measures the time to the stall or loss
+ * of lock fault, checks that normal running does not trip the monitor, and
+ * checks the blanking at low reference speed and the saturation of the BEMF 
+ * speed limit at high reference speed.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "mc1_calc_params.h"
+#include "estim_monitor.h"
+#include "fault.h"
+#include "mc_app_types.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Closed loop speed when the rotor is locked */
+#define TEST_SPEED_RPM          1000.0
+
+/* Time to start the motor and reach TEST_SPEED_RPM */
+#define TEST_START_TIME_SEC     6.0
+
+/* Detection time limit: time count of the monitor, fault debounce and the 
+ * time the estimate takes to leave the residual limits */
+#define TEST_DETECT_CYCLES_MAX  (LOCK_MONITOR_TIME_COUNT + \
+                                    LOSS_OF_LOCK_FAULT_DEBOUNCE + 800)
+
+/* Time running fault free at steady speed */
+#define TEST_RUN_TIME_SEC       2.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static bool TestStartClosedLoop(double rpm)
+{
+    SIM_Init();
+    SIM_SpeedCommandSet(true, rpm);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    
+    return (pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) && 
+            (pMC1Data->fault.faultState == 0);
+}
+
+/* Rotor locked while running in closed loop */
+static void TestLockedRotor(void)
+{
+    const uint16_t faultMask = MCAPP_STALL_FAULT | MCAPP_LOSS_OF_LOCK_FAULT;
+    uint32_t cycles = 0;
+    
+    TEST_CHECK(TestStartClosedLoop(TEST_SPEED_RPM), 
+        "closed loop not reached, focState %d fault 0x%04x", 
+        pMC1Data->controlScheme.focState, pMC1Data->fault.faultState);
+    
+    sim.motor.locked = 1;
+    while((pMC1Data->appState != MCAPP_FAULT) && 
+            (cycles < 4*TEST_DETECT_CYCLES_MAX))
+    {
+        SIM_Run(1);
+        cycles++;
+    }
+    
+    printf("locked rotor at %.0f rpm: fault 0x%04x after %u cycles "
+        "(%.1f ms), limit %u\n", TEST_SPEED_RPM, pMC1Data->fault.faultState,
+        (unsigned)cycles, cycles*LOOPTIME_SEC*1000.0, 
+        (unsigned)TEST_DETECT_CYCLES_MAX);
+    
+    TEST_CHECK(pMC1Data->appState == MCAPP_FAULT, "locked rotor not detected");
+    TEST_CHECK(pMC1Data->fault.faultState & faultMask,
+        "fault 0x%04x is not stall or loss of lock", pMC1Data->fault.faultState);
+    TEST_CHECK(cycles <= TEST_DETECT_CYCLES_MAX, 
+        "detection took %u cycles", (unsigned)cycles);
+    TEST_CHECK(sim.motor.outputsEnabled == 0, "outputs enabled in fault");
+}
+
+/* Free running rotor at steady speed */
+static void TestNoFalseTrip(void)
+{
+    const MCAPP_ESTIMATOR_MONITOR_T *pMonitor = 
+                                    &pMC1Data->controlScheme.estimMonitor;
+    uint32_t cycles, violations = 0;
+    
+    TEST_CHECK(TestStartClosedLoop(TEST_SPEED_RPM), 
+        "closed loop not reached, focState %d fault 0x%04x", 
+        pMC1Data->controlScheme.focState, pMC1Data->fault.faultState);
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_RUN_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        violations += pMonitor->violation;
+    }
+    
+    printf("free running at %.0f rpm: %u violating cycles in %.1f s\n",
+        PMSM_ModelSpeedRpm(&sim.motor), (unsigned)violations, 
+        TEST_RUN_TIME_SEC);
+    
+    TEST_CHECK(pMC1Data->fault.faultState == 0, 
+        "fault 0x%04x while running", pMC1Data->fault.faultState);
+    TEST_CHECK(violations == 0, "%u violating cycles", (unsigned)violations);
+}
+
+/* Monitor configured as in closed loop, fed with the given signals */
+static int16_t TestMonitorStep(int16_t velRef, int16_t omega, int16_t esd, 
+                                int16_t esq, uint16_t steps)
+{
+    MCAPP_ESTIMATOR_MONITOR_T monitor = pMC1Data->controlScheme.estimMonitor;
+    MCAPP_ESTIMATOR_OUTPUT_T output;
+    MCAPP_CONTROL_T ctrlParam;
+    
+    output.qTheta = 0;
+    output.qOmega = omega;
+    output.qEsd = esd;
+    output.qEsq = esq;
+    ctrlParam.qVelRef = velRef;
+    monitor.pOutput = &output;
+    monitor.pCtrlParam = &ctrlParam;
+    MCAPP_EstimatorMonitorInit(&monitor);
+    
+    while(steps > 0)
+    {
+        MCAPP_EstimatorMonitor(&monitor);
+        steps--;
+    }
+    
+    return monitor.lossOfLock | monitor.stall;
+}
+
+static void TestMonitorLimits(void)
+{
+    const MCAPP_ESTIMATOR_MONITOR_T *pMonitor = 
+                                    &pMC1Data->controlScheme.estimMonitor;
+    const uint16_t steps = 2*LOCK_MONITOR_TIME_COUNT;
+    int16_t esq;
+    
+    SIM_Init();
+    
+    /* Position hold: zero reference, no BEMF, estimate of a still rotor */
+    TEST_CHECK(TestMonitorStep(0, 0, 0, 0, steps) == 0, 
+        "tripped at zero reference");
+    TEST_CHECK(TestMonitorStep(pMonitor->qVelRefMin - 1, 0, 0, 0, steps) == 0,
+        "tripped below minimum reference");
+    /* Same signals above the minimum reference are a stall */
+    TEST_CHECK(TestMonitorStep(pMonitor->qVelRefMin, 0, 0, 0, steps) != 0,
+        "no stall at minimum reference");
+    
+    /* BEMF of the reference speed at the highest reference: the upper BEMF 
+     * limit exceeds the Q15 range and must saturate, not wrap negative */
+    esq = (int16_t)(((int32_t)INT16_MAX << pMonitor->qInvKfiConstScale)/
+                        pMonitor->qInvKfiConst);
+    TEST_CHECK(TestMonitorStep(INT16_MAX, INT16_MAX, 0, esq, steps) == 0,
+        "tripped at full speed with matching BEMF");
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestLockedRotor();
+    TestNoFalseTrip();
+    TestMonitorLimits();
+    
+    return TEST_RESULT("test_estim_monitor");
+}
@@ -0,0 +1,158 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_estim_reset.c
+ *
+ * @brief Host test of the estimator reset, e.g. for flying start. Resets the PLL
+ * estimator and the extended EMF observer over the whole speed range and 
+ * checks that the back EMF states follow the speed with the correct sign and
+ * saturate at high speed instead of overflowing the 16 bit division.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "estim_pll.h"
+#include "estim_eemf.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed step of the reset sweep */
+#define TEST_SPEED_STEP         256
+
+/* Inverse back EMF constant is divided by 1, 2, 4 and 8, as after the 
+ * identification of a motor with higher back EMF constant. The quotient of
+ * the reset exceeds 16 bits at high speed. */
+#define TEST_INVKFI_DIVIDERS    4
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Back EMF expected at the speed, saturated to the Q15 range */
+static int16_t TestEsExpected(int16_t qOmega, int16_t qInvKfiConst, 
+                                uint16_t qInvKfiConstScale)
+{
+    int32_t es = ((int32_t)qOmega << qInvKfiConstScale)/qInvKfiConst;
+    
+    if(es > INT16_MAX)
+    {
+        es = INT16_MAX;
+    }
+    else if(es < -INT16_MAX)
+    {
+        es = -INT16_MAX;
+    }
+    return (int16_t)es;
+}
+
+/* Resets both estimators over the speed range, returns the number of speeds
+ * with saturated back EMF */
+static int16_t TestResetSweep(int16_t qInvKfiConst)
+{
+    MCAPP_ESTIMATOR_PLL_T *pPLL = &pMC1Data->controlScheme.estimPLL;
+    MCAPP_ESTIMATOR_EEMF_T *pEEMF = &pMC1Data->controlScheme.estimEEMF;
+    int16_t expected, saturated = 0;
+    int32_t omega;
+    
+    pPLL->qInvKfiConst = qInvKfiConst;
+    pEEMF->qInvKfiConst = qInvKfiConst;
+    
+    for(omega = -INT16_MAX; omega <= INT16_MAX; omega += TEST_SPEED_STEP)
+    {
+        MCAPP_EstimatorPLLReset(pPLL, 0, (int16_t)omega);
+        expected = TestEsExpected((int16_t)omega, pPLL->qInvKfiConst, 
+                                    pPLL->qInvKfiConstScale);
+        TEST_CHECK(abs(pPLL->qEsqf - expected) <= 1, 
+            "PLL reset at speed %d, 1/Kfi %d: Esq %d, expected %d", 
+            (int)omega, qInvKfiConst, pPLL->qEsqf, expected);
+        
+        MCAPP_EstimatorEEMFReset(pEEMF, 0, (int16_t)omega);
+        expected = TestEsExpected((int16_t)omega, pEEMF->qInvKfiConst, 
+                                    pEEMF->qInvKfiConstScale);
+        TEST_CHECK(abs(pEEMF->EMFdq.q - expected) <= 1, 
+            "EEMF reset at speed %d, 1/Kfi %d: Eq %d, expected %d", 
+            (int)omega, qInvKfiConst, pEEMF->EMFdq.q, expected);
+        
+        saturated += (abs(expected) == INT16_MAX);
+    }
+    return saturated;
+}
+
+static void TestResetRange(void)
+{
+    int16_t invKfi, saturated = 0;
+    uint16_t divider;
+    
+    SIM_Init();
+    invKfi = pMC1Data->controlScheme.estimPLL.qInvKfiConst;
+    
+    for(divider = 0; divider < TEST_INVKFI_DIVIDERS; divider++)
+    {
+        saturated += TestResetSweep(invKfi >> divider);
+    }
+    
+    printf("estimator reset: %d of %d resets with saturated back EMF\n",
+        saturated, TEST_INVKFI_DIVIDERS*(2*INT16_MAX/TEST_SPEED_STEP + 1));
+    TEST_CHECK(saturated > 0, "back EMF saturation not covered");
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestResetRange();
+    
+    return TEST_RESULT("test_estim_reset");
+}
@@ -0,0 +1,456 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_fault.c
+ *
+ * @brief Host unit test of the fault manager. Measures the detection latency of 
+ * every fault detector against its configured debounce and checks that latched
+ * faults are kept until an explicit fault clear.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "mc1_calc_params.h"
+#include "mc1_init.h"
+#include "fault.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Nominal operating point, well inside all fault limits */
+#define TEST_VDC            NORM_VALUE(325, MC1_PEAK_VOLTAGE)
+#define TEST_CURRENT_AMPS   (NOMINAL_CURRENT_PEAK*0.5)
+#define TEST_CURRENT        NORM_VALUE(TEST_CURRENT_AMPS, MC1_PEAK_CURRENT)
+#define TEST_VELOCITY       NORM_VALUE(NOMINAL_SPEED_RPM, MC1_PEAK_SPEED_RPM)
+
+/* Phase current amplitude of the phase loss at high current, mean phase 
+ * currents add up to above full scale */
+#define TEST_HIGH_CURRENT   (double)Q15(0.8)
+
+/* Electrical frequency of the simulated phase currents */
+#define TEST_CURRENT_FREQ_HZ    50.0
+
+/* Samples run fault free before a fault is injected, multiple of the phase
+ * loss window so that the fault starts at the beginning of a window */
+#define TEST_WARMUP_SAMPLES     (4*PHASE_LOSS_WINDOW_COUNT)
+
+/* Upper bound for the latency measurement */
+#define TEST_SAMPLES_MAX        (16*PHASE_LOSS_WINDOW_COUNT)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef enum
+{
+    TEST_INJECT_NONE = 0,
+    TEST_INJECT_OVERCURRENT,
+    TEST_INJECT_DC_OVERVOLTAGE,
+    TEST_INJECT_DC_UNDERVOLTAGE,
+    TEST_INJECT_LOSS_OF_LOCK,
+    TEST_INJECT_STALL,
+    TEST_INJECT_PHASE_LOSS,
+    TEST_INJECT_OVERSPEED,
+
+} TEST_INJECT_T;
+
+typedef struct
+{
+    int16_t
+        ia,
+        ib,
+        vdc,
+        velEstim,
+        lossOfLock,
+        stall;
+
+    uint32_t
+        sample;
+
+}TEST_SIGNALS_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+static MCAPP_FAULT_T fault;
+static TEST_SIGNALS_T signals;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Configuration of MCAPP_MC1ParamsInit(), with the inputs from the test 
+ * signals */
+static void TestFaultConfig(void)
+{
+    static MC1APP_DATA_T mc1;
+    
+    MCAPP_MC1ParamsInit(&mc1);
+    fault = mc1.fault;
+    
+    fault.pIa = &signals.ia;
+    fault.pIb = &signals.ib;
+    fault.pVdc = &signals.vdc;
+    fault.pVelEstim = &signals.velEstim;
+    fault.pLossOfLock = &signals.lossOfLock;
+    fault.pStall = &signals.stall;
+    
+    MCAPP_FaultClear(&fault);
+    signals.sample = 0;
+}
+
+/* Generates one sample of the fault detector inputs */
+static void TestSignalsUpdate(TEST_INJECT_T inject)
+{
+    const double theta = 2.0*M_PI*TEST_CURRENT_FREQ_HZ*LOOPTIME_SEC*
+                            (double)signals.sample;
+    
+    signals.ia = (int16_t)(TEST_CURRENT*cos(theta));
+    signals.ib = (int16_t)(TEST_CURRENT*cos(theta - 2.0*M_PI/3.0));
+    signals.vdc = TEST_VDC;
+    signals.velEstim = TEST_VELOCITY;
+    signals.lossOfLock = 0;
+    signals.stall = 0;
+    
+    switch(inject)
+    {
+        case TEST_INJECT_OVERCURRENT:
+            signals.ia = PEAK_FAULT_CURRENT + 100;
+            signals.ib = -(signals.ia >> 1);
+            break;
+        case TEST_INJECT_DC_OVERVOLTAGE:
+            signals.vdc = DC_OVERVOLTAGE_FAULT + 100;
+            break;
+        case TEST_INJECT_DC_UNDERVOLTAGE:
+            signals.vdc = DC_UNDERVOLTAGE_FAULT - 100;
+            break;
+        case TEST_INJECT_LOSS_OF_LOCK:
+            signals.lossOfLock = 1;
+            break;
+        case TEST_INJECT_STALL:
+            signals.stall = 1;
+            break;
+        case TEST_INJECT_PHASE_LOSS:
+            /* Phase C open, Ib = -Ia */
+            signals.ia = (int16_t)(TEST_CURRENT*cos(theta));
+            signals.ib = -signals.ia;
+            break;
+        case TEST_INJECT_OVERSPEED:
+            signals.velEstim = OVERSPEED_FAULT + 100;
+            break;
+        default:
+            break;
+    }
+    signals.sample++;
+}
+
+/* One control cycle of the running motor, see MCAPP_MC1StateMachine() */
+static bool TestFaultStep(TEST_INJECT_T inject)
+{
+    TestSignalsUpdate(inject);
+    fault.speedMonitorEnable = 1;
+    return MCAPP_FaultDetect(&fault);
+}
+
+/* Number of samples from the fault injection until the fault is reported */
+static uint32_t TestFaultLatency(TEST_INJECT_T inject, uint16_t faultMask)
+{
+    uint32_t samples;
+    
+    TestFaultConfig();
+    for(samples = 0; samples < TEST_WARMUP_SAMPLES; samples++)
+    {
+        TestFaultStep(TEST_INJECT_NONE);
+    }
+    TEST_CHECK((fault.faultState | fault.warningState) == MCAPP_FAULT_NONE,
+                "false fault 0x%04x at nominal operation", fault.faultState);
+    
+    for(samples = 1; samples <= TEST_SAMPLES_MAX; samples++)
+    {
+        TestFaultStep(inject);
+        if((fault.faultState | fault.warningState) & faultMask)
+        {
+            TEST_CHECK((fault.faultState | fault.warningState) == faultMask,
+                    "unexpected faults 0x%04x", fault.faultState);
+            return samples;
+        }
+    }
+    return 0;
+}
+
+static void TestDetectionLatency(void)
+{
+    static const struct
+    {
+        const char *name;
+        TEST_INJECT_T inject;
+        uint16_t faultId;
+        uint32_t expected;
+    } detector[] =
+    {
+        {"over current", TEST_INJECT_OVERCURRENT, 
+            MCAPP_FAULT_ID_OVERCURRENT, OVERCURRENT_FAULT_DEBOUNCE},
+        {"DC over voltage", TEST_INJECT_DC_OVERVOLTAGE, 
+            MCAPP_FAULT_ID_DC_OVERVOLTAGE, DC_OVERVOLTAGE_FAULT_DEBOUNCE},
+        {"DC under voltage", TEST_INJECT_DC_UNDERVOLTAGE, 
+            MCAPP_FAULT_ID_DC_UNDERVOLTAGE, DC_UNDERVOLTAGE_FAULT_DEBOUNCE},
+        {"loss of lock", TEST_INJECT_LOSS_OF_LOCK, 
+            MCAPP_FAULT_ID_LOSS_OF_LOCK, LOSS_OF_LOCK_FAULT_DEBOUNCE},
+        {"stall", TEST_INJECT_STALL, 
+            MCAPP_FAULT_ID_STALL, STALL_FAULT_DEBOUNCE},
+        {"phase loss", TEST_INJECT_PHASE_LOSS, MCAPP_FAULT_ID_PHASE_LOSS, 
+            PHASE_LOSS_FAULT_DEBOUNCE*PHASE_LOSS_WINDOW_COUNT},
+        {"over speed", TEST_INJECT_OVERSPEED, 
+            MCAPP_FAULT_ID_OVERSPEED, OVERSPEED_FAULT_DEBOUNCE},
+    };
+    uint16_t index;
+    uint32_t latency;
+    
+    for(index = 0; index < sizeof(detector)/sizeof(detector[0]); index++)
+    {
+        latency = TestFaultLatency(detector[index].inject, 
+                                    (1 << detector[index].faultId));
+        printf("  %-18s latency %5u samples (%7.2f ms)\n", 
+                detector[index].name, (unsigned)latency, 
+                latency*LOOPTIME_SEC*1000.0);
+        TEST_CHECK(latency == detector[index].expected, 
+                "%s latency %u, expected %u", detector[index].name,
+                (unsigned)latency, (unsigned)detector[index].expected);
+    }
+}
+
+static void TestPhaseLossUnalignedOnset(void)
+{
+    uint32_t samples, latency = 0;
+    
+    /* Fault starts in the middle of an accumulation window */
+    TestFaultConfig();
+    for(samples = 0; samples < TEST_WARMUP_SAMPLES + 
+                                (PHASE_LOSS_WINDOW_COUNT >> 1); samples++)
+    {
+        TestFaultStep(TEST_INJECT_NONE);
+    }
+    for(samples = 1; samples <= TEST_SAMPLES_MAX; samples++)
+    {
+        if(TestFaultStep(TEST_INJECT_PHASE_LOSS))
+        {
+            latency = samples;
+            break;
+        }
+    }
+    TEST_CHECK((latency > 0) && (latency <= 
+        (PHASE_LOSS_FAULT_DEBOUNCE + 1)*PHASE_LOSS_WINDOW_COUNT),
+        "phase loss latency %u exceeds debounce plus one window", 
+        (unsigned)latency);
+}
+
+static void TestPhaseLossStandstill(void)
+{
+    uint32_t samples;
+    
+    /* Stationary current vector along the A-B axis, phase C carries no 
+     * current without being open, as when holding position at standstill */
+    TestFaultConfig();
+    for(samples = 0; samples < TEST_SAMPLES_MAX; samples++)
+    {
+        TestSignalsUpdate(TEST_INJECT_NONE);
+        signals.ia = TEST_CURRENT;
+        signals.ib = -TEST_CURRENT;
+        signals.velEstim = 0;
+        fault.speedMonitorEnable = 0;
+        MCAPP_FaultDetect(&fault);
+    }
+    TEST_CHECK(fault.faultState == MCAPP_FAULT_NONE, 
+            "phase loss tripped at standstill, faults 0x%04x", 
+            fault.faultState);
+    
+    /* Same currents above the minimum speed are a phase loss */
+    for(samples = 0; samples < TEST_SAMPLES_MAX; samples++)
+    {
+        TestSignalsUpdate(TEST_INJECT_NONE);
+        signals.ia = TEST_CURRENT;
+        signals.ib = -TEST_CURRENT;
+        signals.velEstim = PHASE_LOSS_MIN_SPEED;
+        fault.speedMonitorEnable = 0;
+        MCAPP_FaultDetect(&fault);
+    }
+    TEST_CHECK(fault.faultState == MCAPP_PHASE_LOSS_FAULT, 
+            "phase loss not detected above minimum speed, faults 0x%04x", 
+            fault.faultState);
+}
+
+static void TestPhaseLossHighCurrent(void)
+{
+    const uint32_t samplesMax = (PHASE_LOSS_FAULT_DEBOUNCE + 1)*
+                                    PHASE_LOSS_WINDOW_COUNT;
+    uint32_t samples;
+    
+    /* Sum of the mean phase currents above full scale, with the over current
+     * limit raised out of the way */
+    TestFaultConfig();
+    fault.overCurrentFaultLimit = Q15(0.99);
+    for(samples = 0; samples < samplesMax; samples++)
+    {
+        TestSignalsUpdate(TEST_INJECT_PHASE_LOSS);
+        signals.ia = (int16_t)(signals.ia*(TEST_HIGH_CURRENT/TEST_CURRENT));
+        signals.ib = -signals.ia;
+        fault.speedMonitorEnable = 1;
+        MCAPP_FaultDetect(&fault);
+    }
+    TEST_CHECK(fault.faultState == MCAPP_PHASE_LOSS_FAULT, 
+            "phase loss not detected at high current, faults 0x%04x", 
+            fault.faultState);
+}
+
+static void TestDebounceGlitch(void)
+{
+    uint16_t samples;
+    
+    /* Over voltage for one sample less than the debounce is ignored */
+    TestFaultConfig();
+    for(samples = 0; samples < DC_OVERVOLTAGE_FAULT_DEBOUNCE - 1; samples++)
+    {
+        TestFaultStep(TEST_INJECT_DC_OVERVOLTAGE);
+    }
+    for(samples = 0; samples < DC_OVERVOLTAGE_FAULT_DEBOUNCE; samples++)
+    {
+        TestFaultStep(TEST_INJECT_NONE);
+    }
+    TEST_CHECK(fault.faultState == MCAPP_FAULT_NONE, 
+            "over voltage glitch tripped, faults 0x%04x", fault.faultState);
+    TEST_CHECK(fault.detect[MCAPP_FAULT_ID_DC_OVERVOLTAGE].count == 0,
+            "debounce counter not decremented");
+}
+
+static void TestLatchedFault(void)
+{
+    uint32_t samples;
+    bool restart = 0;
+    
+    /* Phase loss is latched: acknowledge and restart policy keep it */
+    TestFaultLatency(TEST_INJECT_PHASE_LOSS, MCAPP_PHASE_LOSS_FAULT);
+    TEST_CHECK(fault.faultState == MCAPP_PHASE_LOSS_FAULT, 
+            "phase loss not reported");
+    for(samples = 0; samples <= FAULT_RESTART_DELAY_COUNT + 1; samples++)
+    {
+        restart |= MCAPP_FaultRestartCheck(&fault);
+    }
+    TEST_CHECK(restart == 0, "latched fault restarted automatically");
+    TEST_CHECK(MCAPP_FaultAcknowledge(&fault) == 0, 
+            "acknowledge cleared latched fault");
+    TEST_CHECK(fault.faultState == MCAPP_PHASE_LOSS_FAULT, 
+            "latched fault lost on acknowledge, faults 0x%04x", 
+            fault.faultState);
+    
+    MCAPP_FaultClear(&fault);
+    TEST_CHECK(fault.faultState == MCAPP_FAULT_NONE, 
+            "fault clear did not clear latched fault");
+    
+    /* PWM PCI fault is set without debounce and latched */
+    TestFaultConfig();
+    MCAPP_FaultSet(&fault, MCAPP_FAULT_ID_PWM_PCI);
+    TEST_CHECK(fault.faultState == MCAPP_PWM_PCI_FAULT, "PCI fault not set");
+    TEST_CHECK(MCAPP_FaultAcknowledge(&fault) == 0, 
+            "acknowledge cleared PCI fault");
+    
+    /* Restart faults are cleared by acknowledge, latched faults stay */
+    TestFaultStep(TEST_INJECT_OVERCURRENT);
+    TEST_CHECK(fault.faultState == (MCAPP_PWM_PCI_FAULT | 
+            MCAPP_OVERCURRENT_FAULT), "faults 0x%04x", fault.faultState);
+    TEST_CHECK(MCAPP_FaultAcknowledge(&fault) == 0, 
+            "acknowledge with latched fault returned 1");
+    TEST_CHECK(fault.faultState == MCAPP_PWM_PCI_FAULT, 
+            "acknowledge result 0x%04x", fault.faultState);
+}
+
+static void TestRestartPolicy(void)
+{
+    uint16_t restarts = 0;
+    uint32_t samples;
+    
+    TestFaultConfig();
+    for(samples = 0; samples < (uint32_t)(FAULT_RESTART_COUNT_MAX + 1)*
+                                (FAULT_RESTART_DELAY_COUNT + 2); samples++)
+    {
+        if(fault.faultState == MCAPP_FAULT_NONE)
+        {
+            TestFaultStep(TEST_INJECT_OVERCURRENT);
+        }
+        else
+        {
+            restarts += MCAPP_FaultRestartCheck(&fault);
+        }
+    }
+    TEST_CHECK(restarts == FAULT_RESTART_COUNT_MAX, 
+            "%u automatic restarts, expected %u", restarts, 
+            FAULT_RESTART_COUNT_MAX);
+    TEST_CHECK(fault.faultState == MCAPP_OVERCURRENT_FAULT, 
+            "fault not kept after restarts are used up");
+    
+    /* Run command re-issued: restart fault acknowledged, restarts reset */
+    TEST_CHECK(MCAPP_FaultAcknowledge(&fault) == 1, "acknowledge failed");
+    TEST_CHECK(fault.faultState == MCAPP_FAULT_NONE, 
+            "faults 0x%04x after acknowledge", fault.faultState);
+    TEST_CHECK(fault.restartCount == 0, "restart counter not reset");
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestDetectionLatency();
+    TestPhaseLossUnalignedOnset();
+    TestPhaseLossStandstill();
+    TestPhaseLossHighCurrent();
+    TestDebounceGlitch();
+    TestLatchedFault();
+    TestRestartPolicy();
+    
+    return TEST_RESULT("test_fault");
+}
@@ -0,0 +1,287 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_fault_log.c
+ *
+ * @brief Host unit test of the fault log with the flash simulator of hal/flash.c.
+ * Checks the record contents, the queue overflow count, and the recovery 
+ * after a power fail at every flash operation of a record write and of a 
+ * page erase: complete records survive, the interrupted record is skipped 
+ * and logging continues after the next power up.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "flash_sim.h"
+#include "fault_log.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Flash operations to write one record */
+#define TEST_RECORD_OPERATIONS  (FAULT_LOG_RECORD_WORDS/2)
+
+/* Main loop calls to write all queued records */
+#define TEST_STEPS_MAX          1000
+
+/* Records in the log area */
+#define TEST_LOG_SLOTS          (FAULT_LOG_PAGE_COUNT*FAULT_LOG_PAGE_SLOTS)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+extern MCAPP_FAULT_LOG_T faultLog;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Main loop with flash operations allowed until the queue is written */
+static void TestLogDrain(void)
+{
+    uint16_t step;
+    
+    for(step = 0; step < TEST_STEPS_MAX; step++)
+    {
+        if((faultLog.queueHead == faultLog.queueTail) && 
+            (faultLog.writeActive == 0) && (faultLog.erasePending == 0))
+        {
+            break;
+        }
+        MCAPP_FaultLogStepMain(true, true);
+    }
+}
+
+static void TestEventSet(uint16_t code)
+{
+    MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_MC1_FAULT, code, 100, 200, 300, 1);
+}
+
+/* Event code of the record, 0 if the record does not exist */
+static uint16_t TestRecordCode(uint16_t index)
+{
+    MCAPP_FAULT_LOG_RECORD_T record;
+    
+    if(!MCAPP_FaultLogRecordRead(index, &record))
+    {
+        return 0;
+    }
+    return record.code;
+}
+
+static void TestRecordContents(void)
+{
+    MCAPP_FAULT_LOG_RECORD_T record;
+    uint32_t tick;
+    
+    FLASH_SimInit();
+    MCAPP_FaultLogInit(0x0003);
+    TestLogDrain();
+    
+    for(tick = 0; tick < 3UL*FAULT_LOG_TIME_TICKS; tick++)
+    {
+        MCAPP_FaultLogTimeTick();
+    }
+    MCAPP_FaultLogEventSet(MCAPP_FAULT_LOG_MC1_FAULT, 0x0008, 1000, 2000, 
+                            -300, 2);
+    TestLogDrain();
+    
+    TEST_CHECK(MCAPP_FaultLogRecordRead(0, &record), "no newest record");
+    TEST_CHECK((record.event == MCAPP_FAULT_LOG_MC1_FAULT) && 
+        (record.code == 0x0008) && (record.sequence == 1) &&
+        (record.timeLow == 3) && (record.timeHigh == 0) &&
+        (record.operatingPoint[0] == 1000) && 
+        (record.operatingPoint[1] == 2000) && 
+        (record.operatingPoint[2] == -300) && (record.counter == 2),
+        "fault record: event %u code 0x%04x sequence %u time %u", 
+        record.event, record.code, record.sequence, record.timeLow);
+    TEST_CHECK(MCAPP_FaultLogRecordRead(1, &record), "no boot record");
+    TEST_CHECK((record.event == MCAPP_FAULT_LOG_BOOT) && 
+        (record.code == 0x0003) && (record.sequence == 0) && 
+        (record.bootCount == 0), 
+        "boot record: event %u code 0x%04x sequence %u", 
+        record.event, record.code, record.sequence);
+    TEST_CHECK(!MCAPP_FaultLogRecordRead(2, &record), "extra record");
+    
+    /* Power up again */
+    MCAPP_FaultLogInit(0x0001);
+    TestLogDrain();
+    TEST_CHECK(MCAPP_FaultLogRecordRead(0, &record) && 
+        (record.event == MCAPP_FAULT_LOG_BOOT) && (record.sequence == 2) && 
+        (record.bootCount == 1), 
+        "second boot record: sequence %u boot count %u", 
+        record.sequence, record.bootCount);
+}
+
+static void TestQueueOverflow(void)
+{
+    MCAPP_FAULT_LOG_RECORD_T record;
+    uint16_t event;
+    
+    FLASH_SimInit();
+    MCAPP_FaultLogInit(0);
+    
+    /* Boot event and FAULT_LOG_QUEUE_SIZE faults before the main loop */
+    for(event = 1; event <= FAULT_LOG_QUEUE_SIZE; event++)
+    {
+        TestEventSet(event);
+    }
+    TestLogDrain();
+    
+    TEST_CHECK(TestRecordCode(0) == (FAULT_LOG_QUEUE_SIZE - 1), 
+        "newest record code %u", TestRecordCode(0));
+    TEST_CHECK(MCAPP_FaultLogRecordRead(FAULT_LOG_QUEUE_SIZE - 1, &record) && 
+        (record.event == MCAPP_FAULT_LOG_BOOT) && (record.dropped == 1), 
+        "oldest record: event %u dropped %u", record.event, record.dropped);
+}
+
+/* Power fails after the given flash operations while writing the record of 
+ * event 2, logs event 3 after the next power up. Returns true if the log 
+ * holds a consistent history. */
+static bool TestPowerFailWrite(uint16_t operations)
+{
+    MCAPP_FAULT_LOG_RECORD_T record;
+    bool written = (operations >= TEST_RECORD_OPERATIONS);
+    bool pass;
+    
+    FLASH_SimInit();
+    MCAPP_FaultLogInit(0);
+    TestEventSet(1);
+    TestLogDrain();
+    
+    FLASH_SimPowerFailSet(operations);
+    TestEventSet(2);
+    TestLogDrain();
+    FLASH_SimPowerRestore();
+    
+    MCAPP_FaultLogInit(0);
+    TestEventSet(3);
+    TestLogDrain();
+    
+    /* Newest first : event 3, boot, event 2 if completed, event 1, boot */
+    pass = (TestRecordCode(0) == 3);
+    pass = pass && MCAPP_FaultLogRecordRead(1, &record) && 
+            (record.event == MCAPP_FAULT_LOG_BOOT) && (record.bootCount == 1);
+    if(written)
+    {
+        pass = pass && (TestRecordCode(2) == 2) && (TestRecordCode(3) == 1);
+    }
+    else
+    {
+        pass = pass && (TestRecordCode(2) == 1);
+    }
+    return pass;
+}
+
+static void TestPowerFailDuringWrite(void)
+{
+    uint16_t operations, failed = 0;
+    
+    for(operations = 0; operations <= TEST_RECORD_OPERATIONS; operations++)
+    {
+        if(!TestPowerFailWrite(operations))
+        {
+            failed++;
+            TEST_CHECK(false, "power fail after %u of %u write operations", 
+                operations, TEST_RECORD_OPERATIONS);
+        }
+    }
+    printf("power fail during record write: %u of %u cases recovered\n",
+        TEST_RECORD_OPERATIONS + 1 - failed, TEST_RECORD_OPERATIONS + 1);
+}
+
+static void TestPowerFailDuringErase(void)
+{
+    MCAPP_FAULT_LOG_RECORD_T record;
+    uint16_t event;
+    
+    /* Fill the log area, the next record needs the oldest page erased */
+    FLASH_SimInit();
+    MCAPP_FaultLogInit(0);
+    for(event = 1; event < TEST_LOG_SLOTS; event++)
+    {
+        TestEventSet(event);
+        TestLogDrain();
+    }
+    TEST_CHECK((faultLog.erasePending == 1) || (faultLog.slot == 0),
+        "log area not full, page %u slot %u", faultLog.page, faultLog.slot);
+    
+    /* Power fails half way through the page erase */
+    FLASH_SimPowerFailSet(0);
+    TestEventSet(TEST_LOG_SLOTS);
+    TestLogDrain();
+    FLASH_SimPowerRestore();
+    
+    MCAPP_FaultLogInit(0);
+    TestEventSet(TEST_LOG_SLOTS + 1);
+    TestLogDrain();
+    
+    TEST_CHECK(TestRecordCode(0) == (TEST_LOG_SLOTS + 1), 
+        "newest record code %u after erase power fail", TestRecordCode(0));
+    TEST_CHECK(MCAPP_FaultLogRecordRead(1, &record) && 
+        (record.event == MCAPP_FAULT_LOG_BOOT) && (record.bootCount == 1), 
+        "no boot record after erase power fail");
+    /* Records of the other page are kept */
+    TEST_CHECK(TestRecordCode(2) == (TEST_LOG_SLOTS - 1), 
+        "last record before power fail has code %u", TestRecordCode(2));
+    TEST_CHECK(faultLog.writeErrors == 0, 
+        "%u write errors", faultLog.writeErrors);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestRecordContents();
+    TestQueueOverflow();
+    TestPowerFailDuringWrite();
+    TestPowerFailDuringErase();
+    
+    return TEST_RESULT("test_fault_log");
+}
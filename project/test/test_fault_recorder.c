@@ -0,0 +1,209 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_fault_recorder.c
+ *
+ * @brief Host unit test of the fault recorder. Checks the recording length of 
+ * the default buffer with all channels configured, that the first trigger 
+ * wins and restores the CPU priority, and the pre and post trigger split of 
+ * the frozen buffer.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <xc.h>
+
+#include "fault_recorder.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Control loop period in seconds */
+#define TEST_LOOPTIME_SEC       0.0000625
+
+#ifdef FAULT_RECORDER_SHARE_X2C_BUFFER
+/* Shortest useful recording, several electrical periods of the motor and 
+ * line cycles of the PFC around the fault */
+#define TEST_RECORD_TIME_MIN    0.030
+#else
+/* Dedicated buffer next to X2CScope is limited by DIAGNOSTICS_RAM_BUDGET, 
+ * two electrical periods of the motor at nominal speed */
+#define TEST_RECORD_TIME_MIN    0.008
+#endif
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+extern FAULT_RECORDER_T faultRecorder;
+
+static int16_t signal[FAULT_RECORDER_CHANNELS_MAX];
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static void TestRecorderArm(void)
+{
+    uint16_t channel;
+    
+    FaultRecorderInit();
+    for(channel = 0; channel < FAULT_RECORDER_CHANNELS_MAX; channel++)
+    {
+        FaultRecorderChannelAdd(channel, &signal[channel]);
+    }
+    FaultRecorderArm();
+}
+
+/* Runs one control loop ISR step with a sample counter on every channel */
+static void TestRecorderStep(int16_t value)
+{
+    uint16_t channel;
+    
+    for(channel = 0; channel < FAULT_RECORDER_CHANNELS_MAX; channel++)
+    {
+        signal[channel] = value;
+    }
+    FaultRecorderStepIsr();
+}
+
+static void TestRecordLength(void)
+{
+    double recordTime;
+    
+    TestRecorderArm();
+    recordTime = faultRecorder.sampleCapacity*FAULT_RECORDER_SAMPLE_DIVIDER*
+                    TEST_LOOPTIME_SEC;
+    
+    printf("buffer %u words, %u channels: %u samples, %.1f ms\n", 
+        faultRecorder.bufferWords, faultRecorder.channelCount,
+        faultRecorder.sampleCapacity, recordTime*1000.0);
+    
+    TEST_CHECK(faultRecorder.state == FAULT_RECORDER_ARMED, "not armed");
+    TEST_CHECK(recordTime >= TEST_RECORD_TIME_MIN, 
+        "recording of %.1f ms", recordTime*1000.0);
+}
+
+static void TestFirstTriggerWins(void)
+{
+    TestRecorderArm();
+    
+    /* MC1 fault in the IP6 interrupt, PFC fault follows in IP7 */
+    SRbits.IPL = 6;
+    FaultRecorderTrigger(FAULT_RECORDER_SOURCE_MC1, 0x0001);
+    TEST_CHECK(SRbits.IPL == 6, "CPU priority %u after trigger", SRbits.IPL);
+    SRbits.IPL = 7;
+    FaultRecorderTrigger(FAULT_RECORDER_SOURCE_PFC, 0x0002);
+    TEST_CHECK(SRbits.IPL == 7, "CPU priority %u after trigger", SRbits.IPL);
+    SRbits.IPL = 0;
+    
+    TEST_CHECK(faultRecorder.state == FAULT_RECORDER_TRIGGERED, 
+        "state %u after trigger", faultRecorder.state);
+    TEST_CHECK(faultRecorder.source == FAULT_RECORDER_SOURCE_MC1, 
+        "source %u, first trigger was MC1", faultRecorder.source);
+    TEST_CHECK(faultRecorder.faultCode == 0x0001, 
+        "fault code 0x%04x", faultRecorder.faultCode);
+}
+
+static void TestTriggerPosition(void)
+{
+    uint32_t step = 0;
+    uint16_t oldest, sampleTrigger, postSamples;
+    int16_t stepTrigger;
+    
+    TestRecorderArm();
+    
+    /* Fill the buffer more than once before the trigger */
+    while(step < 3UL*faultRecorder.sampleCapacity*FAULT_RECORDER_SAMPLE_DIVIDER)
+    {
+        TestRecorderStep((int16_t)step++);
+    }
+    stepTrigger = (int16_t)step;
+    FaultRecorderTrigger(FAULT_RECORDER_SOURCE_MC1, 0x0001);
+    while((faultRecorder.state == FAULT_RECORDER_TRIGGERED) && 
+            (step < 6UL*faultRecorder.sampleCapacity*FAULT_RECORDER_SAMPLE_DIVIDER))
+    {
+        TestRecorderStep((int16_t)step++);
+    }
+    
+    TEST_CHECK(faultRecorder.state == FAULT_RECORDER_FROZEN, 
+        "state %u, buffer not frozen", faultRecorder.state);
+    
+    /* Oldest sample is at the write index once the buffer has wrapped */
+    oldest = faultRecorder.writeIndex;
+    sampleTrigger = (oldest + faultRecorder.triggerSample) % 
+                        faultRecorder.sampleCapacity;
+    postSamples = faultRecorder.sampleCapacity - faultRecorder.triggerSample;
+    
+    printf("trigger at sample %u of %u, %u post trigger samples\n",
+        faultRecorder.triggerSample, faultRecorder.sampleCapacity, 
+        postSamples);
+    
+    TEST_CHECK(postSamples == faultRecorder.postTrigger, 
+        "%u post trigger samples, expected %u", postSamples, 
+        faultRecorder.postTrigger);
+    /* First sample after the trigger holds the value of the trigger step */
+    TEST_CHECK((int16_t)(faultRecorder.pBuffer[sampleTrigger*
+        faultRecorder.channelCount] - stepTrigger) >= 0 &&
+        (int16_t)(faultRecorder.pBuffer[sampleTrigger*
+        faultRecorder.channelCount] - stepTrigger) < 
+        FAULT_RECORDER_SAMPLE_DIVIDER, 
+        "sample %d at trigger position, trigger at step %d", 
+        faultRecorder.pBuffer[sampleTrigger*faultRecorder.channelCount],
+        stepTrigger);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestRecordLength();
+    TestFirstTriggerWins();
+    TestTriggerPosition();
+    
+    return TEST_RESULT("test_fault_recorder");
+}
@@ -0,0 +1,250 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_flying_start.c
+ *
+ * @brief Host test of the flying start. Spins the motor model freely at speeds 
+ * from above the minimum catch speed up to the maximum speed and checks the 
+ * catch time, the angle and speed error handed to the back EMF estimator, and 
+ * that the speed controller takes over without a fault. Below the minimum catch
+ * speed the normal start must be used.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Number of initial rotor angles per speed */
+#define TEST_ANGLE_COUNT        6
+
+/* Catch time limit from the start of FOC_FLYING_START to closed loop */
+#define TEST_CATCH_TIME_SEC     0.016
+
+/* Angle error limit at catch in electrical degrees */
+#define TEST_ANGLE_ERROR_DEG    5.0
+
+/* Peak phase current limit while catching, current controllers hold zero
+ * current but the outputs start with zero voltage on a spinning motor */
+#define TEST_CURRENT_MAX_AMPS   (NOMINAL_CURRENT_PEAK*1.25)
+
+/* Speed error limit of the caught speed */
+#define TEST_SPEED_ERROR        0.05
+
+/* Run time after the start command */
+#define TEST_RUN_TIME_SEC       1.0
+
+/* Rotor speed below the minimum catch speed */
+#define TEST_SLOW_RPM           (FLYING_START_MIN_SPEED_RPM*0.6)
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    int16_t
+        nextState;          /* FOC state after FOC_FLYING_START */
+    
+    uint32_t
+        catchCycles;        /* Control cycles in FOC_FLYING_START */
+    
+    double
+        angleError,         /* Angle error at catch in degrees */
+        rpm,                /* Caught speed in RPM */
+        currentMax;         /* Peak phase current while catching in A */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static double TestPhaseCurrentMax(void)
+{
+    double ia, ib, ic;
+    
+    PMSM_ModelPhaseCurrents(&sim.motor, &ia, &ib);
+    ic = -ia - ib;
+    ia = fabs(ia);
+    ib = fabs(ib);
+    ic = fabs(ic);
+    return (ia > ib) ? ((ia > ic) ? ia : ic) : ((ib > ic) ? ib : ic);
+}
+
+/* Starts with the rotor spinning freely at the given speed and angle */
+static TEST_RESULT_T TestCatch(double rpm, double thetaElec)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    TEST_RESULT_T result = {-1, 0, 0, 0, 0};
+    uint32_t cycles;
+    double current;
+    double target = (rpm < MINIMUM_SPEED_RPM) ? MINIMUM_SPEED_RPM : rpm;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pControlScheme->ctrlParam.flyingStartEnable = 1;
+    sim.motor.omega = rpm*2.0*M_PI/60.0;
+    sim.motor.thetaElec = thetaElec;
+    SIM_SpeedCommandSet(true, target);
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_RUN_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if(pControlScheme->focState == FOC_FLYING_START)
+        {
+            result.catchCycles++;
+            current = TestPhaseCurrentMax();
+            result.currentMax = (current > result.currentMax) ? 
+                                    current : result.currentMax;
+        }
+        else if((result.catchCycles > 0) && (result.nextState < 0))
+        {
+            result.nextState = pControlScheme->focState;
+            result.angleError = SIM_AngleErrorGet(
+                    pControlScheme->estimInterface.qTheta)*360.0/65536.0;
+            result.rpm = SIM_RpmFromNorm(
+                    pControlScheme->estimInterface.qVelEstim);
+        }
+    }
+    return result;
+}
+
+static void TestCatchSpeedRange(void)
+{
+    static const double speedRpm[] = 
+        {FLYING_START_MIN_SPEED_RPM*1.5, 1000, 2000, 3000, 4000, 
+            MAXIMUM_SPEED_RPM};
+    TEST_RESULT_T result;
+    uint16_t speedIndex, index;
+    double rpm, thetaElec, errorMax, currentMax;
+    uint32_t catchCyclesMax;
+    
+    for(speedIndex = 0; speedIndex < sizeof(speedRpm)/sizeof(speedRpm[0]);
+            speedIndex++)
+    {
+        rpm = speedRpm[speedIndex];
+        errorMax = 0;
+        currentMax = 0;
+        catchCyclesMax = 0;
+        for(index = 0; index < TEST_ANGLE_COUNT; index++)
+        {
+            thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.1;
+            result = TestCatch(rpm, thetaElec);
+            
+            TEST_CHECK(result.nextState == FOC_CLOSE_LOOP, 
+                "%.0f rpm, rotor at %.0f deg: state %d after flying start", 
+                rpm, thetaElec*180.0/M_PI, result.nextState);
+            TEST_CHECK(result.catchCycles <= 
+                                    SIM_CYCLES(TEST_CATCH_TIME_SEC), 
+                "%.0f rpm, rotor at %.0f deg: catch took %.2f ms", rpm, 
+                thetaElec*180.0/M_PI, 
+                result.catchCycles*LOOPTIME_SEC*1000.0);
+            TEST_CHECK(fabs(result.angleError) < TEST_ANGLE_ERROR_DEG, 
+                "%.0f rpm, rotor at %.0f deg: angle error %.1f deg", rpm, 
+                thetaElec*180.0/M_PI, result.angleError);
+            TEST_CHECK(result.currentMax < TEST_CURRENT_MAX_AMPS, 
+                "%.0f rpm, rotor at %.0f deg: peak current %.2f A", rpm, 
+                thetaElec*180.0/M_PI, result.currentMax);
+            TEST_CHECK(fabs(result.rpm - rpm) < TEST_SPEED_ERROR*rpm, 
+                "%.0f rpm, rotor at %.0f deg: caught speed %.0f rpm", rpm, 
+                thetaElec*180.0/M_PI, result.rpm);
+            TEST_CHECK((pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) 
+                && (pMC1Data->fault.faultState == 0) &&
+                (fabs(PMSM_ModelSpeedRpm(&sim.motor) - rpm) < 50.0), 
+                "%.0f rpm, rotor at %.0f deg: focState %d, %.0f rpm, "
+                "fault 0x%04x", rpm, thetaElec*180.0/M_PI, 
+                pMC1Data->controlScheme.focState, 
+                PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+            
+            errorMax = (fabs(result.angleError) > errorMax) ? 
+                            fabs(result.angleError) : errorMax;
+            currentMax = (result.currentMax > currentMax) ? 
+                            result.currentMax : currentMax;
+            catchCyclesMax = (result.catchCycles > catchCyclesMax) ? 
+                            result.catchCycles : catchCyclesMax;
+        }
+        printf("  %5.0f rpm: catch %5.2f ms max, angle error %.1f deg max, "
+                "peak current %.2f A\n", rpm, 
+                catchCyclesMax*LOOPTIME_SEC*1000.0, errorMax, currentMax);
+    }
+}
+
+static void TestSlowRotor(void)
+{
+    TEST_RESULT_T result;
+    
+    /* Back EMF is too small to catch, the normal start is used */
+    result = TestCatch(TEST_SLOW_RPM, 0.1);
+    TEST_CHECK((result.nextState == FOC_RTR_LOCK) && 
+        (result.catchCycles == FLYING_START_TIME_COUNT), 
+        "%.0f rpm: state %d after %u cycles of flying start", TEST_SLOW_RPM, 
+        result.nextState, (unsigned)result.catchCycles);
+    printf("  %5.0f rpm: rotor lock start after %.2f ms\n", TEST_SLOW_RPM,
+            result.catchCycles*LOOPTIME_SEC*1000.0);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestCatchSpeedRange();
+    TestSlowRotor();
+    
+    return TEST_RESULT("test_flying_start");
+}
@@ -0,0 +1,212 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_fw_feedforward.c
+ *
+ * @brief Host test of the flux weakening feedforward table. Ramps the motor
+ * model with load from 1500 rpm into flux weakening with and without the
+ * feedforward, at nominal and reduced DC bus voltage, and compares voltage
+ * saturation, Q axis current and speed.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Start speed, and ramp end speed below OVERSPEED_FAULT_RPM with the speed 
+ * overshoot at the end of the ramp. The speed limit of the speed command is
+ * raised for it */
+#define TEST_START_RPM          1500.0
+#define TEST_END_RPM            5800.0
+
+/* Speed ramp of one count every 2 control periods, about 1800 rpm/s, ten 
+ * times the SPEED_RAMP_RATE_COUNT and RAMP_UP_TIME_MULTIPLIER ramp */
+#define TEST_RAMP_MULTIPLIER    2
+
+/* Start, load ramp, settling and speed ramp time */
+#define TEST_START_TIME_SEC     10.0
+#define TEST_LOAD_RAMP_SEC      2.0
+#define TEST_SETTLE_TIME_SEC    2.0
+#define TEST_RAMP_TIME_SEC      12.0
+
+/* Voltage within this of the current controller limit is saturated */
+#define TEST_VOLTAGE_MARGIN     100
+
+/* Saturation time limit with feedforward */
+#define TEST_SATURATION_SEC     0.2
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        saturationTime,     /* Time at the voltage limit in s */
+        iqMin,              /* Lowest Q axis current during the ramp in A */
+        endTime,            /* Time to reach the end speed in s, -1 if not */
+        rpm;                /* Speed at the end */
+    
+    int16_t
+        voltageMax;         /* Largest voltage magnitude */
+    
+    uint16_t
+        faultState;         /* Faults at the end of the run */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Speed ramp into flux weakening with the load as fraction of nominal 
+ * torque and the given DC bus voltage */
+static TEST_RESULT_T TestRamp(bool feedForward, double load, double vdc)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_CONTROL_T *pCtrlParam = &pControlScheme->ctrlParam;
+    TEST_RESULT_T result = {0, 1e9, -1, 0, 0, 0};
+    double loadTorque;
+    int16_t voltage;
+    uint32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pControlScheme->fluxControl.feedBackFW.feedForwardEnable = feedForward;
+    pMC1Data->pMotor->qMaxSpeed = SIM_NormFromRpm(TEST_END_RPM);
+    sim.motor.vdc = vdc;
+    loadTorque = load*1.5*sim.motor.polePairs*sim.motor.flux*
+                    NOMINAL_CURRENT_PEAK;
+    SIM_SpeedCommandSet(true, TEST_START_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    SIM_Run(SIM_CYCLES(TEST_SETTLE_TIME_SEC));
+    
+    pCtrlParam->speedRampIncLimit = TEST_RAMP_MULTIPLIER;
+    SIM_SpeedCommandSet(true, TEST_END_RPM);
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_RAMP_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        voltage = (int16_t)sqrt((double)pControlScheme->vdq.d*
+                    pControlScheme->vdq.d + (double)pControlScheme->vdq.q*
+                    pControlScheme->vdq.q);
+        if(voltage >= (pControlScheme->vPhaseMax - TEST_VOLTAGE_MARGIN))
+        {
+            result.saturationTime += LOOPTIME_SEC;
+        }
+        if(voltage > result.voltageMax)
+        {
+            result.voltageMax = voltage;
+        }
+        result.iqMin = fmin(result.iqMin, sim.motor.iq);
+        if((result.endTime < 0) && 
+            (PMSM_ModelSpeedRpm(&sim.motor) > (TEST_END_RPM - 20.0)))
+        {
+            result.endTime = cycles*LOOPTIME_SEC;
+        }
+    }
+    result.rpm = PMSM_ModelSpeedRpm(&sim.motor);
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+static void TestFeedForward(double load, double vdc)
+{
+    TEST_RESULT_T off = TestRamp(false, load, vdc);
+    TEST_RESULT_T on = TestRamp(true, load, vdc);
+    /* Q axis current for the load, the lowest may dip with the ramp end */
+    double iqLoad = load*NOMINAL_CURRENT_PEAK;
+    
+    TEST_CHECK((on.faultState == 0) && (on.endTime > 0) && 
+        (fabs(on.rpm - TEST_END_RPM) < 20.0),
+        "load %.1f, %.0f V: %.0f rpm after %.2f s, faults 0x%04x", load, 
+        vdc, on.rpm, on.endTime, on.faultState);
+    TEST_CHECK((on.saturationTime < TEST_SATURATION_SEC) && 
+        (on.saturationTime <= off.saturationTime) && 
+        (on.voltageMax < off.voltageMax),
+        "load %.1f, %.0f V: saturated %.3f s with, %.3f s without "
+        "feedforward", load, vdc, on.saturationTime, off.saturationTime);
+    TEST_CHECK(on.iqMin > 0.8*iqLoad, 
+        "load %.1f, %.0f V: Iq down to %.2f A", load, vdc, on.iqMin);
+    printf("  load %.1f, %.0f V: with feedforward %.2f s to %.0f rpm, "
+            "%.3f s saturated, voltage %d, Iq min %.2f A\n", load, vdc,
+            on.endTime, TEST_END_RPM, on.saturationTime, on.voltageMax, 
+            on.iqMin);
+    printf("    without feedforward %.2f s, %.0f rpm at end, %.3f s "
+            "saturated, voltage %d, Iq min %.2f A\n", off.endTime, off.rpm, 
+            off.saturationTime, off.voltageMax, off.iqMin);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestFeedForward(0.3, 325.0);
+    TestFeedForward(0.6, 325.0);
+    /* Voltage limit falls below FD_WEAK_VOLTAGE_REF */
+    TestFeedForward(0.3, 280.0);
+    
+    return TEST_RESULT("test_fw_feedforward");
+}
@@ -0,0 +1,243 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_hfi.c
+ *
+ * @brief Host test of the high frequency injection start-up on a salient motor 
+ * model with saturating D axis inductance. Checks magnet polarity detection and
+ * the time to speed control at eight initial rotor angles, nominal torque at 
+ * standstill and the start under load up to the crossover to the back EMF 
+ * estimator.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Decrease of the incremental D axis inductance per Amp, the HFI polarity
+ * detection relies on it */
+#define TEST_LD_SATURATION      0.03
+
+/* Number of initial rotor angles, equally spaced over an electrical cycle */
+#define TEST_ANGLE_COUNT        8
+
+/* Speed command, above the crossover to the back EMF estimator */
+#define TEST_SPEED_RPM          1000.0
+
+/* Load torque as a fraction of the torque at nominal current */
+#define TEST_LOAD_HOLD          1.0
+#define TEST_LOAD_START         0.8
+
+/* Angle error limit of the HFI estimate in electrical degrees */
+#define TEST_ANGLE_ERROR_DEG    10.0
+
+/* Speed control starts after alignment and the two polarity pulses */
+#define TEST_HFI_RUN_COUNT      (HFI_ALIGN_TIME_COUNT + \
+                                    2*HFI_POLARITY_TIME_COUNT)
+
+/* Run time of the hold and start tests */
+#define TEST_HOLD_TIME_SEC      4.0
+#define TEST_START_TIME_SEC     7.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static double TestRatedTorque(void)
+{
+    return 1.5*sim.motor.polePairs*sim.motor.flux*NOMINAL_CURRENT_PEAK;
+}
+
+/* Starts the motor with HFI from the given electrical angle and load */
+static void TestStart(double thetaElec, double load)
+{
+    SIM_Init();
+    SIM_Run(1);
+    pMC1Data->controlScheme.ctrlParam.hfiEnable = 1;
+    sim.motor.ldSaturation = TEST_LD_SATURATION;
+    sim.motor.thetaElec = thetaElec;
+    sim.motor.loadTorque = load*TestRatedTorque();
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+}
+
+/* Runs until the HFI estimator starts speed control, returns the number of 
+ * control cycles in HFI before it */
+static uint32_t TestHFIRunWait(void)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    uint32_t cycles, hfiCycles = 0;
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_HOLD_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if(pControlScheme->focState == FOC_HFI)
+        {
+            if(pControlScheme->hfi.state == HFI_RUN)
+            {
+                break;
+            }
+            hfiCycles++;
+        }
+    }
+    return hfiCycles;
+}
+
+static double TestAngleErrorDeg(void)
+{
+    return SIM_AngleErrorGet(pMC1Data->controlScheme.hfi.qTheta)*
+                360.0/65536.0;
+}
+
+static void TestPolarity(void)
+{
+    uint16_t index;
+    uint32_t hfiCycles;
+    double thetaElec, error;
+    
+    for(index = 0; index < TEST_ANGLE_COUNT; index++)
+    {
+        thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.1;
+        TestStart(thetaElec, TEST_LOAD_HOLD);
+        hfiCycles = TestHFIRunWait();
+        error = TestAngleErrorDeg();
+        
+        printf("  rotor at %5.1f deg: speed control after %5.1f ms, "
+                "angle error %6.1f deg\n", thetaElec*180.0/M_PI, 
+                hfiCycles*LOOPTIME_SEC*1000.0, error);
+        TEST_CHECK(fabs(error) < TEST_ANGLE_ERROR_DEG, 
+            "rotor at %.1f deg: angle error %.1f deg, polarity not resolved", 
+            thetaElec*180.0/M_PI, error);
+        TEST_CHECK(hfiCycles <= TEST_HFI_RUN_COUNT, 
+            "rotor at %.1f deg: speed control after %u cycles, expected %u", 
+            thetaElec*180.0/M_PI, (unsigned)hfiCycles, 
+            (unsigned)TEST_HFI_RUN_COUNT);
+    }
+}
+
+static void TestHoldNominalTorque(void)
+{
+    uint16_t index;
+    uint32_t cycles;
+    double thetaElec, error, errorMax, errorMaxAll = 0;
+    
+    /* The load equals the torque at the current limit of the speed 
+     * controller, the rotor stays at standstill */
+    for(index = 0; index < TEST_ANGLE_COUNT; index++)
+    {
+        thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.1;
+        TestStart(thetaElec, TEST_LOAD_HOLD);
+        TestHFIRunWait();
+        
+        errorMax = 0;
+        for(cycles = 0; cycles < SIM_CYCLES(TEST_HOLD_TIME_SEC); cycles++)
+        {
+            SIM_Run(1);
+            error = fabs(TestAngleErrorDeg());
+            errorMax = (error > errorMax) ? error : errorMax;
+        }
+        
+        TEST_CHECK((pMC1Data->controlScheme.focState == FOC_HFI) && 
+            (pMC1Data->fault.faultState == 0), 
+            "rotor at %.1f deg: focState %d fault 0x%04x", 
+            thetaElec*180.0/M_PI, pMC1Data->controlScheme.focState, 
+            pMC1Data->fault.faultState);
+        TEST_CHECK(errorMax < TEST_ANGLE_ERROR_DEG, 
+            "rotor at %.1f deg: angle error %.1f deg at standstill", 
+            thetaElec*180.0/M_PI, errorMax);
+        TEST_CHECK(sim.motor.torque > 0.95*TestRatedTorque(), 
+            "rotor at %.1f deg: torque %.3f Nm, nominal %.3f Nm", 
+            thetaElec*180.0/M_PI, sim.motor.torque, TestRatedTorque());
+        errorMaxAll = (errorMax > errorMaxAll) ? errorMax : errorMaxAll;
+    }
+    printf("  nominal torque %.3f Nm held at standstill, angle error "
+            "%.1f deg max\n", TestRatedTorque(), errorMaxAll);
+}
+
+static void TestStartUnderLoad(void)
+{
+    uint16_t index;
+    double thetaElec;
+    
+    for(index = 0; index < TEST_ANGLE_COUNT; index++)
+    {
+        thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.1;
+        TestStart(thetaElec, TEST_LOAD_START);
+        SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+        
+        TEST_CHECK((pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) && 
+            (pMC1Data->fault.faultState == 0) &&
+            (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM) < 50.0), 
+            "rotor at %.1f deg: focState %d, %.0f rpm, fault 0x%04x", 
+            thetaElec*180.0/M_PI, pMC1Data->controlScheme.focState, 
+            PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+    }
+    printf("  start with %.0f%% load: %.0f rpm in closed loop\n", 
+            TEST_LOAD_START*100.0, PMSM_ModelSpeedRpm(&sim.motor));
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestPolarity();
+    TestHoldNominalTorque();
+    TestStartUnderLoad();
+    
+    return TEST_RESULT("test_hfi");
+}
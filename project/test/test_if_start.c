@@ -0,0 +1,243 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_if_start.c
+ *
+ * @brief Host test of the I-f open loop start. Starts the motor model from 
+ * standstill without load, with load and with high inertia and checks that the 
+ * I-f regulation lowers the open loop current without load, that the handover to
+ * closed loop holds speed and current, and that a load the open loop current 
+ * cannot move is reported as stall instead of forcing current forever.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed command, above the open loop to closed loop handover speed */
+#define TEST_SPEED_RPM              1000.0
+
+/* Run time after the start command */
+#define TEST_RUN_TIME_SEC           7.0
+
+/* Speed error limit after the handover, rotor speed against reference */
+#define TEST_HANDOVER_SPEED_ERROR_RPM   75.0
+
+/* Time after the handover over which speed and current are checked */
+#define TEST_HANDOVER_CYCLES        (2*HANDOVER_TIME_COUNT)
+
+/* I-f must have lowered the open loop current by the handover without load */
+#define TEST_IF_CURRENT_AMPS        (MIN_OPENLOOP_CURRENT*0.9)
+
+/* Current limit after the handover, no step above the open loop current */
+#define TEST_HANDOVER_CURRENT_AMPS  (MAX_OPENLOOP_CURRENT*1.1)
+
+/* Final speed error limit */
+#define TEST_SPEED_ERROR_RPM        50.0
+
+/* Load torque in per unit of the nominal torque */
+#define TEST_LOAD_LIGHT             0.2
+#define TEST_LOAD_HEAVY             0.3
+
+/* Inertia multiplier of the high inertia start */
+#define TEST_INERTIA_HIGH           10.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    uint32_t
+        openLoopCycles,     /* Control cycles in FOC_OPEN_LOOP */
+        stallCycles;        /* Cycles from start to stall fault, 0 if none */
+    
+    bool
+        closedLoop;         /* Open loop handed over to closed loop */
+    
+    double
+        handoverCurrent,    /* Open loop current at handover in A */
+        speedErrorMax,      /* Peak speed error after handover in RPM */
+        currentMax;         /* Peak current magnitude after handover in A */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Starts from standstill with the given inertia multiplier and load torque in 
+ * per unit of nominal torque */
+static TEST_RESULT_T TestStart(double inertia, double load)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    TEST_RESULT_T result = {0, 0, false, 0, 0, 0};
+    uint32_t cycles, handoverCycles = 0;
+    double speedError, current;
+    
+    SIM_Init();
+    SIM_Run(1);
+    sim.motor.inertia *= inertia;
+    sim.motor.loadTorque = load*1.5*sim.motor.polePairs*sim.motor.flux*
+                                NOMINAL_CURRENT_PEAK;
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_RUN_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if((result.stallCycles == 0) && 
+            (pMC1Data->fault.faultState & MCAPP_STALL_FAULT))
+        {
+            result.stallCycles = cycles;
+        }
+        if(pControlScheme->focState == FOC_OPEN_LOOP)
+        {
+            result.openLoopCycles++;
+            result.handoverCurrent = pControlScheme->ctrlParam.OLCurrent*
+                                            MC1_PEAK_CURRENT/32768.0;
+        }
+        else if((pControlScheme->focState == FOC_CLOSE_LOOP) && 
+                (handoverCycles < TEST_HANDOVER_CYCLES))
+        {
+            result.closedLoop = true;
+            handoverCycles++;
+            speedError = fabs(PMSM_ModelSpeedRpm(&sim.motor) - 
+                    SIM_RpmFromNorm(pControlScheme->ctrlParam.qVelRef));
+            current = hypot(sim.motor.id, sim.motor.iq);
+            result.speedErrorMax = (speedError > result.speedErrorMax) ?
+                                        speedError : result.speedErrorMax;
+            result.currentMax = (current > result.currentMax) ?
+                                        current : result.currentMax;
+        }
+    }
+    return result;
+}
+
+static void TestStartCase(const char *name, double inertia, double load)
+{
+    TEST_RESULT_T result = TestStart(inertia, load);
+    
+    TEST_CHECK(result.closedLoop && (result.stallCycles == 0), 
+        "%s: closed loop %d, stall after %u cycles", name, result.closedLoop,
+        (unsigned)result.stallCycles);
+    TEST_CHECK(result.speedErrorMax < TEST_HANDOVER_SPEED_ERROR_RPM, 
+        "%s: speed error %.1f rpm after handover", name, 
+        result.speedErrorMax);
+    TEST_CHECK(result.currentMax < TEST_HANDOVER_CURRENT_AMPS, 
+        "%s: current %.2f A after handover", name, result.currentMax);
+    TEST_CHECK((pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) &&
+        (pMC1Data->fault.faultState == 0) &&
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM) < 
+                                                    TEST_SPEED_ERROR_RPM), 
+        "%s: focState %d, %.0f rpm, fault 0x%04x", name, 
+        pMC1Data->controlScheme.focState, PMSM_ModelSpeedRpm(&sim.motor), 
+        pMC1Data->fault.faultState);
+    printf("  %s: open loop %.2f s, current %.2f A at handover, "
+            "speed error %.1f rpm and current %.2f A after handover\n", name, 
+            result.openLoopCycles*LOOPTIME_SEC, result.handoverCurrent,
+            result.speedErrorMax, result.currentMax);
+}
+
+static void TestNoLoad(void)
+{
+    TEST_RESULT_T result;
+    
+    TestStartCase("no load", 1.0, 0);
+    
+    /* Rotor runs ahead of the forced angle, I-f lowers the current */
+    result = TestStart(1.0, 0);
+    TEST_CHECK(result.handoverCurrent < TEST_IF_CURRENT_AMPS, 
+        "no load: open loop current %.2f A at handover", 
+        result.handoverCurrent);
+}
+
+static void TestLoadInertia(void)
+{
+    TestStartCase("light load", 1.0, TEST_LOAD_LIGHT);
+    TestStartCase("high inertia", TEST_INERTIA_HIGH, 0);
+}
+
+static void TestHeavyLoad(void)
+{
+    TEST_RESULT_T result = TestStart(1.0, TEST_LOAD_HEAVY);
+    /* Open loop ramps the forced speed to the handover speed first */
+    double rampSec = (END_SPEED_RPM/(MC1_PEAK_SPEED_RPM)*32768.0)/
+            OL_SPEED_RAMP_RATE_COUNT*(OL_SPEED_RAMP_TIME_MULTIPLIER + 1)*
+            LOOPTIME_SEC;
+    uint32_t stallLimit = LOCK_TIME_COUNT + SIM_CYCLES(rampSec + 0.1) + 
+                            OL_STALL_TIME_COUNT;
+    
+    TEST_CHECK(!result.closedLoop && (result.stallCycles > 0) && 
+        (result.stallCycles < stallLimit),
+        "heavy load: closed loop %d, stall after %u cycles, limit %u",
+        result.closedLoop, (unsigned)result.stallCycles, (unsigned)stallLimit);
+    printf("  heavy load: stall reported after %.2f s\n", 
+            result.stallCycles*LOOPTIME_SEC);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestNoLoad();
+    TestLoadInertia();
+    TestHeavyLoad();
+    
+    return TEST_RESULT("test_if_start");
+}
@@ -0,0 +1,247 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_ipd.c
+ *
+ * @brief Host test of the initial rotor position detection by voltage vector 
+ * pulses. Checks the detected angle and detection time on a salient and a 
+ * non-salient motor model with saturating D axis inductance, the start without
+ * reverse rotation from the detected angle and the fallback to rotor lock when
+ * the motor does not saturate.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Decrease of the incremental D axis inductance per Amp */
+#define TEST_LD_SATURATION      0.03
+
+/* Number of initial rotor angles, equally spaced over an electrical cycle */
+#define TEST_ANGLE_COUNT        24
+
+/* Speed command after detection */
+#define TEST_SPEED_RPM          1000.0
+
+/* Angle error limit of the detected angle in electrical degrees */
+#define TEST_ANGLE_ERROR_DEG    5.0
+
+/* Detection time: bootstrap, then six pulses each followed by the measure 
+ * cycle and the decay */
+#define TEST_IPD_COUNT          (IPD_BOOTSTRAP_COUNT + IPD_DECAY_COUNT + \
+                    IPD_VECTOR_COUNT*(IPD_PULSE_COUNT + 1 + IPD_DECAY_COUNT))
+
+/* Reverse rotation allowed at start in mechanical revolutions */
+#define TEST_REVERSE_MAX_REV    0.001
+
+/* Run time from the start command to closed loop at TEST_SPEED_RPM */
+#define TEST_START_TIME_SEC     5.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    uint32_t
+        ipdCycles;          /* Control cycles in MCAPP_IPD */
+    
+    double
+        angleError,         /* Error of the detected angle in degrees */
+        reverseMax;         /* Reverse rotation after detection in rev */
+    
+    uint16_t
+        angleValid,         /* Angle detected */
+        rotorLock;          /* Start used rotor lock */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Runs the detection and the start from the given electrical angle */
+static TEST_RESULT_T TestStart(double thetaElec, double ldSaturation, 
+                                bool salient)
+{
+    TEST_RESULT_T result = {0, 0, 0, 0, 0};
+    uint32_t cycles;
+    bool detected = false;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pMC1Data->ipd.enable = 1;
+    sim.motor.ldSaturation = ldSaturation;
+    if(!salient)
+    {
+        sim.motor.lq = sim.motor.ld;
+    }
+    sim.motor.thetaElec = thetaElec;
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_START_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if(pMC1Data->appState == MCAPP_IPD)
+        {
+            result.ipdCycles++;
+        }
+        else if((!detected) && (pMC1Data->appState == MCAPP_RUN))
+        {
+            detected = true;
+            result.angleValid = pMC1Data->ipd.angleValid;
+            result.angleError = SIM_AngleErrorGet(pMC1Data->ipd.qTheta)*
+                                    360.0/65536.0;
+        }
+        if(pMC1Data->controlScheme.focState == FOC_RTR_LOCK)
+        {
+            result.rotorLock = 1;
+        }
+        if(-sim.motor.position > result.reverseMax)
+        {
+            result.reverseMax = -sim.motor.position;
+        }
+    }
+    return result;
+}
+
+static bool TestClosedLoop(void)
+{
+    return (pMC1Data->controlScheme.focState == FOC_CLOSE_LOOP) && 
+        (pMC1Data->fault.faultState == 0) &&
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM) < 50.0);
+}
+
+static void TestDetection(const char *name, bool salient)
+{
+    TEST_RESULT_T result;
+    uint16_t index;
+    double thetaElec, errorMax = 0, reverseMax = 0;
+    uint32_t ipdCyclesMax = 0;
+    
+    for(index = 0; index < TEST_ANGLE_COUNT; index++)
+    {
+        thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.05;
+        result = TestStart(thetaElec, TEST_LD_SATURATION, salient);
+        
+        TEST_CHECK(result.angleValid && 
+            (fabs(result.angleError) < TEST_ANGLE_ERROR_DEG), 
+            "%s, rotor at %.1f deg: angle valid %u, error %.1f deg", name,
+            thetaElec*180.0/M_PI, result.angleValid, result.angleError);
+        TEST_CHECK(result.ipdCycles <= TEST_IPD_COUNT, 
+            "%s, rotor at %.1f deg: detection took %u cycles, expected %u", 
+            name, thetaElec*180.0/M_PI, (unsigned)result.ipdCycles, 
+            (unsigned)TEST_IPD_COUNT);
+        TEST_CHECK(result.rotorLock == 0, 
+            "%s, rotor at %.1f deg: rotor lock used", name, 
+            thetaElec*180.0/M_PI);
+        TEST_CHECK(result.reverseMax < TEST_REVERSE_MAX_REV, 
+            "%s, rotor at %.1f deg: %.4f rev reverse rotation at start", 
+            name, thetaElec*180.0/M_PI, result.reverseMax);
+        TEST_CHECK(TestClosedLoop(), 
+            "%s, rotor at %.1f deg: focState %d, %.0f rpm, fault 0x%04x", 
+            name, thetaElec*180.0/M_PI, pMC1Data->controlScheme.focState, 
+            PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+        
+        errorMax = (fabs(result.angleError) > errorMax) ? 
+                        fabs(result.angleError) : errorMax;
+        reverseMax = (result.reverseMax > reverseMax) ? 
+                        result.reverseMax : reverseMax;
+        ipdCyclesMax = (result.ipdCycles > ipdCyclesMax) ? 
+                        result.ipdCycles : ipdCyclesMax;
+    }
+    printf("  %s: angle error %.1f deg max, detection %.2f ms, "
+            "reverse rotation %.4f rev max\n", name, errorMax, 
+            ipdCyclesMax*LOOPTIME_SEC*1000.0, reverseMax);
+}
+
+static void TestNoSaturation(void)
+{
+    TEST_RESULT_T result;
+    uint16_t index, started = 0;
+    double thetaElec;
+    
+    /* Without saturation the polarity is unknown, rotor lock is used. The 
+     * model has no friction to damp the rotor swinging into the lock angle,
+     * so the start itself is only reported */
+    for(index = 0; index < TEST_ANGLE_COUNT; index++)
+    {
+        thetaElec = 2.0*M_PI*index/TEST_ANGLE_COUNT + 0.05;
+        result = TestStart(thetaElec, 0, true);
+        
+        TEST_CHECK((result.angleValid == 0) && result.rotorLock, 
+            "rotor at %.1f deg: angle valid %u, rotor lock %u without "
+            "saturation", thetaElec*180.0/M_PI, result.angleValid, 
+            result.rotorLock);
+        started += TestClosedLoop();
+    }
+    printf("  no saturation: angle not valid, rotor lock start reached "
+            "closed loop from %u of %u angles\n", started, TEST_ANGLE_COUNT);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestDetection("salient", true);
+    TestDetection("non-salient", false);
+    TestNoSaturation();
+    
+    return TEST_RESULT("test_ipd");
+}
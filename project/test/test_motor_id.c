@@ -0,0 +1,210 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_motor_id.c
+ *
+ * @brief Host test of the offline motor parameter identification. Runs the
+ * identification on the motor model with the configured parameters and with
+ * changed resistance, inductance, flux linkage, inertia, friction and load, and
+ * checks the identified values against the model, then starts the motor with
+ * them.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Electrical base speed of the normalised speed in rad/s */
+#define TEST_BASE_OMEGA         ((double)(MC1_PEAK_SPEED_RPM)*POLEPAIRS* \
+                                    2.0*M_PI/60.0)
+
+/* Identification time limit */
+#define TEST_ID_TIME_SEC        20.0
+
+/* Start after identification. Load with the model changes stays below the 
+ * load the I-f start accelerates with MAX_OPENLOOP_CURRENT */
+#define TEST_START_RPM          1000.0
+#define TEST_START_TIME_SEC     8.0
+
+/* Limits of the identified value error relative to the model value */
+#define TEST_RS_ERROR           0.05
+#define TEST_LS_ERROR           0.02
+#define TEST_KE_ERROR           0.03
+#define TEST_TAU_ERROR          0.10
+
+/* Limit of the friction current at base speed and of the load current 
+ * error, fraction of peak current. Both are the small difference of the 
+ * three step accelerations */
+#define TEST_MECH_ERROR         0.01
+
+/* Angle error limit after the start with the identified parameters */
+#define TEST_ANGLE_ERROR_DEG    3.0
+#define TEST_SPEED_ERROR_RPM    20.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Ratio of the identified to the expected value, reported and checked */
+static void TestRatio(const char *name, double value, double expected, 
+                        double limit)
+{
+    TEST_CHECK(fabs(value/expected - 1.0) < limit, 
+        "%s identified %.4f, model %.4f", name, value, expected);
+    printf("    %-5s %.5g (model %.5g, %+.1f%%)\n", name, value, expected,
+            100.0*(value/expected - 1.0));
+}
+
+/* Identifies the model with the parameters changed by the given ratios, 
+ * friction and load given as Q axis current fraction of peak current at 
+ * base speed */
+static void TestMotorId(double rsRatio, double lsRatio, double fluxRatio, 
+                        double inertiaRatio, double friction, double load)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_MOTOR_ID_T *pId = &pControlScheme->motorId;
+    double kt, lsScale, value;
+    uint32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    sim.motor.rs *= rsRatio;
+    sim.motor.ld *= lsRatio;
+    sim.motor.lq *= lsRatio;
+    sim.motor.flux *= fluxRatio;
+    sim.motor.inertia *= inertiaRatio;
+    kt = 1.5*sim.motor.polePairs*sim.motor.flux;
+    sim.motor.friction = friction*kt*MC1_PEAK_CURRENT/
+                            (TEST_BASE_OMEGA/POLEPAIRS);
+    sim.motor.loadTorque = load*kt*MC1_PEAK_CURRENT;
+    
+    printf("  Rs x%.2f, L x%.2f, flux x%.2f, inertia x%.1f, friction %.3f, "
+            "load %.3f:\n", rsRatio, lsRatio, fluxRatio, inertiaRatio, 
+            friction, load);
+    pId->request = 1;
+    SIM_SpeedCommandSet(true, TEST_START_RPM);
+    for(cycles = 0; (cycles < SIM_CYCLES(TEST_ID_TIME_SEC)) && 
+                        !MCAPP_MotorIdIsComplete(pId); cycles++)
+    {
+        SIM_Run(1);
+    }
+    TEST_CHECK(MCAPP_MotorIdIsComplete(pId) && 
+        (pId->resultValid == (MOTOR_ID_RS_VALID | MOTOR_ID_LD_VALID | 
+        MOTOR_ID_LQ_VALID | MOTOR_ID_KE_VALID | MOTOR_ID_INERTIA_VALID)),
+        "identification not complete, results 0x%04x", pId->resultValid);
+    
+    /* Per unit resistance and inductance per control period */
+    TestRatio("Rs", (double)pId->qRs/(1L << pId->rsScale), 
+                sim.motor.rs*MC1_PEAK_CURRENT/MC1_BASE_VOLTAGE, 
+                TEST_RS_ERROR);
+    lsScale = MC1_PEAK_CURRENT/(MC1_BASE_VOLTAGE*LOOPTIME_SEC);
+    TestRatio("Ld", (double)pId->qLdDt/(1L << pId->lsDtScale), 
+                sim.motor.ld*lsScale, TEST_LS_ERROR);
+    TestRatio("Lq", (double)pId->qLqDt/(1L << pId->lsDtScale), 
+                sim.motor.lq*lsScale, TEST_LS_ERROR);
+    TestRatio("1/Ke", (double)pId->qInvKfiConst/(1L << pId->invKfiConstScale),
+                MC1_BASE_VOLTAGE/(sim.motor.flux*TEST_BASE_OMEGA), 
+                TEST_KE_ERROR);
+    /* Control periods to reach base speed with peak current */
+    TestRatio("tau", pId->tauMech, sim.motor.inertia*
+                (TEST_BASE_OMEGA/POLEPAIRS)/(kt*MC1_PEAK_CURRENT*LOOPTIME_SEC),
+                TEST_TAU_ERROR);
+    
+    value = pId->qFriction/32768.0;
+    TEST_CHECK(fabs(value - friction) < TEST_MECH_ERROR,
+        "friction identified %.4f, model %.4f", value, friction);
+    printf("    fric  %.4f (model %.4f)\n", value, friction);
+    value = pId->qIqLoad/32768.0;
+    TEST_CHECK(fabs(value - load) < TEST_MECH_ERROR,
+        "load identified %.4f, model %.4f", value, load);
+    printf("    load  %.4f (model %.4f)\n", value, load);
+    
+    /* Start with the identified parameters from standstill at the lock 
+     * angle. The model without friction still coasts after the last inertia
+     * step and its rotor lock swing does not decay */
+    SIM_SpeedCommandSet(false, TEST_START_RPM);
+    SIM_Run(SIM_CYCLES(0.5));
+    sim.motor.omega = 0;
+    sim.motor.thetaElec = 0;
+    SIM_SpeedCommandSet(true, TEST_START_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    value = fabs(SIM_AngleErrorGet(pControlScheme->estimInterface.qTheta))*
+                360.0/65536.0;
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        (pControlScheme->focState == FOC_CLOSE_LOOP) && 
+        (value < TEST_ANGLE_ERROR_DEG) && 
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_START_RPM) < 
+                                                TEST_SPEED_ERROR_RPM),
+        "start: state %d, faults 0x%04x, angle error %.2f deg, %.0f rpm",
+        pControlScheme->focState, pMC1Data->fault.faultState, value,
+        PMSM_ModelSpeedRpm(&sim.motor));
+    printf("    start %.0f rpm, angle error %.2f deg\n", 
+            PMSM_ModelSpeedRpm(&sim.motor), value);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestMotorId(1.0, 1.0, 1.0, 1.0, 0.0, 0.0);
+    TestMotorId(1.3, 1.2, 1.1, 2.0, 0.02, 0.02);
+    TestMotorId(0.8, 0.9, 0.9, 0.5, 0.01, 0.0);
+    
+    return TEST_RESULT("test_motor_id");
+}
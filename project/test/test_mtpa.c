@@ -0,0 +1,301 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_mtpa.c
+ *
+ * @brief Host test of the maximum torque per ampere D axis current. Runs the
+ * motor model with load with and without MTPA and compares the phase current
+ * per torque with the lowest current for the torque of the model, for the
+ * configured motor and one with twice the Q axis inductance, and checks the
+ * transition into flux weakening.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed and load as fraction of nominal torque. At nominal torque the Q axis
+ * current without MTPA is at the speed controller limit */
+#define TEST_SPEED_RPM          1500.0
+#define TEST_LOAD_LOW           0.5
+#define TEST_LOAD_HIGH          0.9
+
+/* Start, load ramp, settling and averaging time */
+#define TEST_START_TIME_SEC     10.0
+#define TEST_LOAD_RAMP_SEC      2.0
+#define TEST_SETTLE_TIME_SEC    3.0
+#define TEST_AVERAGE_TIME_SEC   1.0
+
+/* Fractional bits of the estimator inductance for the higher Lq */
+#define TEST_LSDT_QVALUE        11
+
+/* Limit of the current with MTPA above the lowest current for the torque */
+#define TEST_CURRENT_ERROR      0.01
+
+/* Lowest current reduction at TEST_LOAD_HIGH with twice the Q axis 
+ * inductance */
+#define TEST_REDUCTION_MIN      0.03
+
+/* Speed ramp into flux weakening, below OVERSPEED_FAULT_RPM, the speed 
+ * limit of the speed command is raised for it */
+#define TEST_FW_SPEED_RPM       5800.0
+#define TEST_FW_TIME_SEC        40.0
+
+/* Largest change of the D axis current reference per control period */
+#define TEST_IDREF_STEP_MAX     32
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        current,            /* Mean phase current magnitude in A */
+        torque,             /* Mean torque in Nm */
+        id;                 /* Mean D axis current in A */
+    
+    uint16_t
+        faultState;         /* Faults at the end of the run */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Torque of the model for a current magnitude at angle beta from Q axis */
+static double TestTorque(double current, double beta)
+{
+    return 1.5*sim.motor.polePairs*current*cos(beta)*(sim.motor.flux + 
+                (sim.motor.lq - sim.motor.ld)*current*sin(beta));
+}
+
+/* Lowest current magnitude for the torque, by bisection on the current for
+ * each current angle */
+static double TestCurrentMin(double torque)
+{
+    double beta, low, high, current, currentMin = 1e9;
+    uint16_t step;
+    
+    for(beta = 0; beta < M_PI/4; beta += 1e-3)
+    {
+        low = 0;
+        high = MC1_PEAK_CURRENT;
+        for(step = 0; step < 40; step++)
+        {
+            current = 0.5*(low + high);
+            if(TestTorque(current, beta) < torque)
+            {
+                low = current;
+            }
+            else
+            {
+                high = current;
+            }
+        }
+        currentMin = fmin(currentMin, high);
+    }
+    return currentMin;
+}
+
+/* Sets the estimator inductance to the Q axis inductance of the model, so 
+ * the estimated angle has no error from saliency under load and the Id 
+ * reference is the D axis current of the motor */
+static void TestEstimatorLq(void)
+{
+    MCAPP_MOTOR_T *pMotor = pMC1Data->pMotor;
+    
+    pMotor->qLsDtScale = TEST_LSDT_QVALUE;
+    pMotor->qLsDt = (int16_t)lround(sim.motor.lq/LOOPTIME_SEC*
+                MC1_PEAK_CURRENT/MC1_BASE_VOLTAGE*(1L << TEST_LSDT_QVALUE));
+}
+
+/* MTPA current constant Psi/(2*(Lq - Ld)) of the model */
+static int32_t TestCurrentConst(void)
+{
+    return (int32_t)(32768.0*sim.motor.flux/
+                (2.0*(sim.motor.lq - sim.motor.ld))/MC1_PEAK_CURRENT);
+}
+
+/* Runs at speed with load, the model Lq changed by the given ratio */
+static TEST_RESULT_T TestLoad(bool mtpa, double lqRatio, double load)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    TEST_RESULT_T result = {0, 0, 0, 0};
+    double loadTorque;
+    uint32_t cycles, averageCycles = SIM_CYCLES(TEST_AVERAGE_TIME_SEC);
+    
+    SIM_Init();
+    SIM_Run(1);
+    sim.motor.lq *= lqRatio;
+    TestEstimatorLq();
+    pControlScheme->fluxControl.mtpa.enable = mtpa;
+    pControlScheme->fluxControl.mtpa.currentConst = TestCurrentConst();
+    loadTorque = load*1.5*sim.motor.polePairs*sim.motor.flux*
+                    NOMINAL_CURRENT_PEAK;
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    SIM_Run(SIM_CYCLES(TEST_SETTLE_TIME_SEC));
+    
+    for(cycles = 0; cycles < averageCycles; cycles++)
+    {
+        SIM_Run(1);
+        result.current += hypot(sim.motor.id, sim.motor.iq);
+        result.torque += sim.motor.torque;
+        result.id += sim.motor.id;
+    }
+    result.current /= averageCycles;
+    result.torque /= averageCycles;
+    result.id /= averageCycles;
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+static void TestTorquePerAmp(double lqRatio, double load, double reductionMin)
+{
+    TEST_RESULT_T off = TestLoad(false, lqRatio, load);
+    TEST_RESULT_T on = TestLoad(true, lqRatio, load);
+    double currentMin = TestCurrentMin(on.torque);
+    double currentZero = on.torque/(1.5*sim.motor.polePairs*sim.motor.flux);
+    double reduction = 1.0 - (on.current/on.torque)/(off.current/off.torque);
+    
+    TEST_CHECK((off.faultState == 0) && (on.faultState == 0), 
+        "Lq x%.0f, load %.1f: faults 0x%04x without, 0x%04x with MTPA", 
+        lqRatio, load, off.faultState, on.faultState);
+    TEST_CHECK(on.current < currentMin*(1.0 + TEST_CURRENT_ERROR),
+        "Lq x%.0f, load %.1f: %.3f A with MTPA, lowest %.3f A", lqRatio, 
+        load, on.current, currentMin);
+    TEST_CHECK(reduction >= reductionMin, 
+        "Lq x%.0f, load %.1f: A/Nm %.4f with, %.4f without MTPA", lqRatio, 
+        load, on.current/on.torque, off.current/off.torque);
+    printf("  Lq x%.0f, load %.1f: %.4f A/Nm with, %.4f A/Nm without MTPA "
+            "(%.1f%% lower), Id %.2f A; lowest current %.3f A, %.3f A with "
+            "Id 0\n", lqRatio, load, on.current/on.torque, 
+            off.current/off.torque, 100.0*reduction, on.id, currentMin, 
+            currentZero);
+}
+
+/* Speed ramp with load from MTPA into flux weakening */
+static void TestFluxWeakening(void)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    const MCAPP_FLUX_WEAKENING_VOLT_FB_T *pFeedBackFW = 
+                                &pControlScheme->fluxControl.feedBackFW;
+    const MCAPP_MTPA_T *pMTPA = &pControlScheme->fluxControl.mtpa;
+    int16_t idRef, idRefStepMax = 0;
+    uint32_t cycles;
+    
+    (void)TestLoad(true, 1.0, TEST_LOAD_LOW);
+    pMC1Data->pMotor->qMaxSpeed = SIM_NormFromRpm(TEST_FW_SPEED_RPM);
+    SIM_SpeedCommandSet(true, TEST_FW_SPEED_RPM);
+    idRef = pFeedBackFW->IdRef;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_FW_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if(abs(pFeedBackFW->IdRef - idRef) > idRefStepMax)
+        {
+            idRefStepMax = abs(pFeedBackFW->IdRef - idRef);
+        }
+        idRef = pFeedBackFW->IdRef;
+    }
+    
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_FW_SPEED_RPM) < 20.0),
+        "flux weakening: %.0f rpm, faults 0x%04x", 
+        PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+    TEST_CHECK(idRefStepMax <= TEST_IDREF_STEP_MAX, 
+        "flux weakening: Id reference step %d", idRefStepMax);
+    TEST_CHECK(pFeedBackFW->IdRef < pMTPA->IdRef, 
+        "flux weakening: Id reference %d, MTPA %d", pFeedBackFW->IdRef, 
+        pMTPA->IdRef);
+    printf("  %.0f to %.0f rpm: Id reference %.2f A (MTPA %.2f A), largest "
+            "step %.4f A\n", TEST_SPEED_RPM, TEST_FW_SPEED_RPM, 
+            pFeedBackFW->IdRef*MC1_PEAK_CURRENT/32768.0, 
+            pMTPA->IdRef*MC1_PEAK_CURRENT/32768.0, 
+            idRefStepMax*MC1_PEAK_CURRENT/32768.0);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    /* MTPA_CURRENT_CONST from the configured motor parameters */
+    SIM_Init();
+    TEST_CHECK(labs(TestCurrentConst() - MTPA_CURRENT_CONST) <= 
+        (MTPA_CURRENT_CONST >> 8), "current constant %ld, model %ld",
+        (long)MTPA_CURRENT_CONST, (long)TestCurrentConst());
+    
+    /* Configured motor gains little, a is about 5 times nominal current */
+    TestTorquePerAmp(1.0, TEST_LOAD_LOW, 0.0);
+    TestTorquePerAmp(1.0, TEST_LOAD_HIGH, 0.0);
+    TestTorquePerAmp(2.0, TEST_LOAD_LOW, 0.0);
+    TestTorquePerAmp(2.0, TEST_LOAD_HIGH, TEST_REDUCTION_MIN);
+    TestFluxWeakening();
+    
+    return TEST_RESULT("test_mtpa");
+}
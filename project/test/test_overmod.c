@@ -0,0 +1,266 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_overmod.c
+ *
+ * @brief Host test of overmodulation. Sweeps the voltage reference magnitude
+ * from 0.55 of DC bus voltage to six-step and compares the fundamental of the 
+ * phase voltage from the duty cycles with the reference, checks the voltage 
+ * fed to the estimators and the step response of the current filter.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Voltage magnitudes in fraction of the voltage of duty range 0..dutyMax, 
+ * linear limit of space vector modulation 1/sqrt(3) and six-step 2/pi */
+#define TEST_MAG_START          0.55
+#define TEST_MAG_STEP           0.005
+#define TEST_LINEAR_LIMIT       0.57735
+#define TEST_SIX_STEP           0.63662
+
+#define TEST_VDC                300.0
+
+/* Scaling of space vector modulation input, as in MCAPP_FOC */
+#define TEST_Q14_SQRT_3         28377
+
+/* Reference angles per electrical revolution */
+#define TEST_ANGLES             3600
+
+/* Fundamental error per reference magnitude, and voltage fed to the 
+ * estimators against the voltage from the duty cycles per magnitude */
+#define TEST_FUNDAMENTAL_ERROR  0.002
+#define TEST_VOLTAGE_OUT_ERROR  0.002
+
+/* Current step of the filter test, Q15 */
+#define TEST_CURRENT_STEP       10000
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        fundamental,        /* Phase voltage fundamental per voltage of duty 
+                             * range */
+        voltageOutError;    /* Largest estimator voltage error per magnitude */
+    
+    uint16_t
+        activeCount,        /* Angles with overmodulation active */
+        dutyHighest;        /* Highest duty with overmodulation active */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Runs the modulation of MCAPP_FOC for one electrical revolution of the 
+ * reference, space vector modulation when overmodulation is not active */
+static TEST_RESULT_T TestModulate(double magnitude)
+{
+    MCAPP_OVERMODULATION_T *pOvermod = &pMC1Data->controlScheme.overmod;
+    TEST_RESULT_T result = {0, 0, 0, 0};
+    const double period = pOvermod->dutyHigh;
+    const double range = (double)pOvermod->dutyMax/pOvermod->dutyHigh;
+    const double voltBase = TEST_VDC/MC1_BASE_VOLTAGE*32768;
+    int16_t vdc = (int16_t)(TEST_VDC/MC1_PEAK_VOLTAGE*32768);
+    MC_ABC_T vabc, vabcScaled;
+    MC_DUTYCYCLEOUT_T duty;
+    double angle, da, db, dc, valpha, vbeta, cosSum = 0, sinSum = 0, error;
+    uint16_t index;
+    
+    pOvermod->pVabc = &vabc;
+    pOvermod->pVdc = &vdc;
+    for(index = 0; index < TEST_ANGLES; index++)
+    {
+        angle = 2*M_PI*index/TEST_ANGLES;
+        vabc.a = (int16_t)lround(magnitude*range*32768*cos(angle));
+        vabc.b = (int16_t)lround(magnitude*range*32768*
+                                                cos(angle - 2*M_PI/3));
+        vabc.c = (int16_t)lround(magnitude*range*32768*
+                                                cos(angle + 2*M_PI/3));
+        if(!MCAPP_OvermodulationStep(pOvermod, &duty))
+        {
+            vabcScaled.a = (int16_t)(__builtin_mulss(vabc.a, 
+                                                TEST_Q14_SQRT_3) >> 14);
+            vabcScaled.b = (int16_t)(__builtin_mulss(vabc.b, 
+                                                TEST_Q14_SQRT_3) >> 14);
+            vabcScaled.c = (int16_t)(__builtin_mulss(vabc.c, 
+                                                TEST_Q14_SQRT_3) >> 14);
+            MC_CalculateSpaceVector_Assembly(&vabcScaled, pOvermod->dutyHigh,
+                                                                    &duty);
+        }
+        da = duty.dutycycle1/period;
+        db = duty.dutycycle2/period;
+        dc = duty.dutycycle3/period;
+        valpha = da - (da + db + dc)/3;
+        vbeta = (db - dc)/sqrt(3.0);
+        cosSum += valpha*cos(angle);
+        sinSum += valpha*sin(angle);
+        if(pOvermod->active)
+        {
+            result.activeCount++;
+            error = hypot(pOvermod->valphabetaOut.alpha - valpha*voltBase,
+                        pOvermod->valphabetaOut.beta - vbeta*voltBase)/
+                        (magnitude*range*voltBase);
+            result.voltageOutError = fmax(result.voltageOutError, error);
+            result.dutyHighest = (uint16_t)fmax(result.dutyHighest, 
+                fmax(duty.dutycycle1, fmax(duty.dutycycle2, duty.dutycycle3)));
+        }
+    }
+    result.fundamental = 2*hypot(cosSum, sinSum)/TEST_ANGLES/range;
+    return result;
+}
+
+/* Fundamental follows the reference from the linear range to six-step 
+ * voltage, in fraction of the voltage of duty range, 
+ * Vr = Vdc*dutyMax/dutyHigh */
+static void TestFundamental(void)
+{
+    TEST_RESULT_T result;
+    double magnitude, error, errorMax = 0;
+    uint16_t index;
+    
+    SIM_Init();
+    pMC1Data->controlScheme.overmod.enable = 1;
+    for(index = 0; ; index++)
+    {
+        magnitude = fmin(TEST_MAG_START + index*TEST_MAG_STEP, TEST_SIX_STEP);
+        result = TestModulate(magnitude);
+        error = (result.fundamental - magnitude)/magnitude;
+        errorMax = fmax(errorMax, fabs(error));
+        TEST_CHECK(fabs(error) < TEST_FUNDAMENTAL_ERROR, 
+            "%.4f Vr: fundamental %.5f Vr", magnitude, result.fundamental);
+        TEST_CHECK(result.activeCount == 
+            ((magnitude > TEST_LINEAR_LIMIT) ? TEST_ANGLES : 0), 
+            "%.4f Vr: active at %d angles", magnitude, result.activeCount);
+        TEST_CHECK(result.voltageOutError < TEST_VOLTAGE_OUT_ERROR, 
+            "%.4f Vr: estimator voltage error %.4f", magnitude, 
+            result.voltageOutError);
+        /* Low side switch of each phase is on for current sampling */
+        TEST_CHECK(result.dutyHighest <= 
+            pMC1Data->controlScheme.overmod.dutyMax, 
+            "%.4f Vr: duty %u above %u", magnitude, result.dutyHighest,
+            pMC1Data->controlScheme.overmod.dutyMax);
+        printf("  %.4f Vr: fundamental %.5f Vr, error %+.3f%%, %s, "
+            "estimator voltage error %.3f%%\n", magnitude, 
+            result.fundamental, error*100, 
+            result.activeCount ? "overmodulation" : "SVPWM",
+            result.voltageOutError*100);
+        if(magnitude == TEST_SIX_STEP)
+        {
+            break;
+        }
+    }
+    printf("  largest fundamental error %.3f%%\n", errorMax*100);
+    
+    /* Disabled overmodulation leaves the duty cycles to space vector 
+     * modulation */
+    pMC1Data->controlScheme.overmod.enable = 0;
+    result = TestModulate(TEST_SIX_STEP);
+    TEST_CHECK(result.activeCount == 0, "disabled: active at %d angles", 
+        result.activeCount);
+}
+
+/* Filtered currents follow a step with the time constant of 
+ * OVERMOD_CURRENT_FILTER_HZ */
+static void TestCurrentFilter(void)
+{
+    MCAPP_OVERMODULATION_T *pOvermod = &pMC1Data->controlScheme.overmod;
+    const double timeConstant = 1/(2*M_PI*OVERMOD_CURRENT_FILTER_HZ*
+                                    LOOPTIME_SEC);
+    MC_DQ_T idq = {TEST_CURRENT_STEP, -TEST_CURRENT_STEP};
+    uint16_t cycles, riseCycles = 0;
+    
+    SIM_Init();
+    MCAPP_OvermodulationInit(pOvermod);
+    pOvermod->pIdq = &idq;
+    for(cycles = 1; cycles <= 10*timeConstant; cycles++)
+    {
+        MCAPP_OvermodulationCurrentFilter(pOvermod);
+        if((riseCycles == 0) && 
+            (pOvermod->idqFilt.d >= TEST_CURRENT_STEP*(1 - exp(-1))))
+        {
+            riseCycles = cycles;
+        }
+    }
+    TEST_CHECK(fabs(riseCycles - timeConstant) <= 1, 
+        "filter: 63%% after %d cycles, time constant %.1f cycles", 
+        riseCycles, timeConstant);
+    TEST_CHECK((abs(pOvermod->idqFilt.d - idq.d) <= 2) && 
+        (abs(pOvermod->idqFilt.q - idq.q) <= 2), 
+        "filter: Id %d, Iq %d after %d cycles", pOvermod->idqFilt.d, 
+        pOvermod->idqFilt.q, cycles);
+    printf("  current filter: 63%% after %d cycles, time constant %.1f "
+        "cycles\n", riseCycles, timeConstant);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestFundamental();
+    TestCurrentFilter();
+    
+    return TEST_RESULT("test_overmod");
+}
@@ -0,0 +1,276 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_pi_tune.c
+ *
+ * @brief Host test of the current controller tuning. Checks the gains from
+ * the configured motor parameters against the hand tuned CURRCNTR values, the
+ * resolution of the coefficient and normalizing term, and the current step
+ * response of the tuned controllers on the motor model through the step test of
+ * the motor identification.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "pi_tune.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Crossover frequency*control period in Q15 */
+#define TEST_BANDWIDTH(hz)      Q15(2.0*M_PI*(hz)*LOOPTIME_SEC)
+
+/* Bandwidth the hand tuned CURRCNTR gains correspond to for NORM_RS and 
+ * NORM_LSDT, and the limit of the gain error against them */
+#define TEST_CURRCNTR_HZ        294.0
+#define TEST_CURRCNTR_ERROR     0.01
+
+/* Time limit for the motor identification to reach the current step */
+#define TEST_STEP_TIME_SEC      5.0
+
+/* Limits of the 90% rise time relative to the first order response with 
+ * the bandwidth as pole, ln(10)/bandwidth. The loop delay makes the tuned 
+ * loop rise faster than the first order response and overshoot near 
+ * PI_TUNE_BANDWIDTH_MAX */
+#define TEST_RISE_RATIO_MIN     0.5
+#define TEST_RISE_RATIO_MAX     1.1
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    int16_t
+        bandwidth;          /* Bandwidth after the step test */
+    
+    uint16_t
+        steps,              /* Current steps applied */
+        riseCount,          /* Control periods to 90% of the last step */
+        resultValid;        /* Identification results */
+    
+    double
+        overshoot;          /* Overshoot of the last step, fraction of step */
+    
+}TEST_STEP_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Gain of the controller coefficient and normalizing term */
+static double TestGain(int16_t k, int16_t n)
+{
+    return k*pow(2.0, n)/32768.0;
+}
+
+static void TestCurrcntr(void)
+{
+    MCAPP_PISTATE_T pi;
+    double kp, ki, kpRef, kiRef;
+    
+    MCAPP_PITuneCurrent(&pi, TEST_BANDWIDTH(TEST_CURRCNTR_HZ), NORM_RS, 
+                        NORM_RS_QVALUE, NORM_LSDT, NORM_LSDT_QVALUE);
+    kp = TestGain(pi.kp, pi.nkp);
+    ki = TestGain(pi.ki, pi.nki);
+    kpRef = TestGain(D_CURRCNTR_PTERM, D_CURRCNTR_PTERM_SCALE);
+    kiRef = TestGain(D_CURRCNTR_ITERM, D_CURRCNTR_ITERM_SCALE);
+    TEST_CHECK((fabs(kp/kpRef - 1.0) < TEST_CURRCNTR_ERROR) && 
+        (fabs(ki/kiRef - 1.0) < TEST_CURRCNTR_ERROR),
+        "%.0f Hz: Kp %.5f Ki %.6f, CURRCNTR Kp %.5f Ki %.6f", 
+        TEST_CURRCNTR_HZ, kp, ki, kpRef, kiRef);
+    printf("  %.0f Hz: Kp %d*2^%d = %.5f, Ki %d*2^%d = %.6f "
+            "(CURRCNTR %.5f, %.6f)\n", TEST_CURRCNTR_HZ, pi.kp, pi.nkp, kp, 
+            pi.ki, pi.nki, ki, kpRef, kiRef);
+    
+    /* Bandwidth above the limit is reduced to it */
+    MCAPP_PITuneCurrent(&pi, INT16_MAX, NORM_RS, NORM_RS_QVALUE, NORM_LSDT, 
+                        NORM_LSDT_QVALUE);
+    kp = TestGain(pi.kp, pi.nkp);
+    kpRef = (double)PI_TUNE_BANDWIDTH_MAX/32768.0*NORM_LSDT/
+                (1L << NORM_LSDT_QVALUE);
+    TEST_CHECK(fabs(kp/kpRef - 1.0) < TEST_CURRCNTR_ERROR,
+        "bandwidth limit: Kp %.5f, expected %.5f", kp, kpRef);
+}
+
+/* Coefficient keeps 15 bits of resolution from small to large gains */
+static void TestResolution(void)
+{
+    int16_t k, n, bits;
+    double gain, error, errorMax = 0;
+    
+    for(bits = -8; bits <= 8; bits++)
+    {
+        /* Gain 1.3*2^bits given with 23 significant bits */
+        gain = 1.3*pow(2.0, bits);
+        MCAPP_PITuneGain((int32_t)(gain*(1L << (22 - bits))), 22 - bits, 
+                            &k, &n);
+        error = fabs(TestGain(k, n)/gain - 1.0);
+        if(error > errorMax)
+        {
+            errorMax = error;
+        }
+        TEST_CHECK((k >= (INT16_MAX >> 1)) && (n >= PI_TUNE_SCALE_MIN) && 
+            (n <= PI_TUNE_SCALE_MAX) && (error < 1.0/16384.0),
+            "gain %.6f: coefficient %d, normalizing term %d", gain, k, n);
+    }
+    printf("  gains 2^-8 to 2^8: largest error %.2e\n", errorMax);
+}
+
+/* Runs the motor identification up to the end of the current step test at
+ * the given bandwidth and overshoot limit */
+static TEST_STEP_T TestStep(double hz, double overshootMax)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_MOTOR_ID_T *pId = &pControlScheme->motorId;
+    TEST_STEP_T result = {0, 0, 0, 0, 0};
+    uint32_t cycles;
+    int16_t peak = 0;
+    
+    SIM_Init();
+    SIM_Run(1);
+    pId->currentTuneEnable = 1;
+    pId->stepTestEnable = 1;
+    pId->qCurrentBandwidth = TEST_BANDWIDTH(hz);
+    pId->qOvershootMax = Q15(overshootMax);
+    pId->request = 1;
+    SIM_SpeedCommandSet(true, 1000);
+    
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_STEP_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        if(pId->state == MOTOR_ID_CURRENT_STEP)
+        {
+            if(pId->count == 1)
+            {
+                result.steps++;
+            }
+            if(pId->count >= pId->settleCountLimit)
+            {
+                peak = (pControlScheme->idq.d > peak) ? 
+                            pControlScheme->idq.d : peak;
+            }
+            else
+            {
+                peak = 0;
+            }
+        }
+        else if(result.steps > 0)
+        {
+            break;
+        }
+    }
+    result.bandwidth = pId->qCurrentBandwidth;
+    result.riseCount = pId->riseCount;
+    result.resultValid = pId->resultValid;
+    result.overshoot = (double)(peak - pId->qCurrentHigh)/
+                            (pId->qCurrentHigh - pId->qCurrentLow);
+    return result;
+}
+
+/* Step response of the tuned loop against the design */
+static void TestStepResponse(double hz)
+{
+    TEST_STEP_T step = TestStep(hz, MOTOR_ID_STEP_OVERSHOOT);
+    double bandwidth = (hz < 0.35/(2.0*M_PI*LOOPTIME_SEC)) ? 
+                        2.0*M_PI*hz*LOOPTIME_SEC : 0.35;
+    double riseRatio = step.riseCount*bandwidth/log(10.0);
+    
+    TEST_CHECK((step.resultValid & MOTOR_ID_STEP_VALID) && (step.steps == 1),
+        "%.0f Hz: %u steps, results 0x%04x", hz, step.steps, 
+        step.resultValid);
+    TEST_CHECK((riseRatio > TEST_RISE_RATIO_MIN) && 
+        (riseRatio < TEST_RISE_RATIO_MAX) && 
+        (step.overshoot < MOTOR_ID_STEP_OVERSHOOT),
+        "%.0f Hz: rise time %u cycles, %.2f of first order, overshoot %.3f", 
+        hz, step.riseCount, riseRatio, step.overshoot);
+    printf("  %.0f Hz step: 90%% rise in %u cycles (%.1f first order), "
+            "overshoot %.1f%%\n", hz, step.riseCount, log(10.0)/bandwidth, 
+            100.0*step.overshoot);
+}
+
+/* Step test halves the bandwidth while the step overshoots */
+static void TestRetune(void)
+{
+    const double hz = 890.0, overshootMax = 0.02;
+    TEST_STEP_T step = TestStep(hz, overshootMax);
+    
+    TEST_CHECK((step.steps == 2) && 
+        (step.bandwidth == (TEST_BANDWIDTH(hz) >> 1)) && 
+        (step.overshoot < overshootMax) && 
+        (step.resultValid & MOTOR_ID_STEP_VALID),
+        "retune: %u steps, bandwidth %d, overshoot %.3f", step.steps, 
+        step.bandwidth, step.overshoot);
+    printf("  %.0f Hz with %.0f%% overshoot limit: %u steps, %.0f Hz, "
+            "overshoot %.1f%%\n", hz, 100.0*overshootMax, step.steps, 
+            step.bandwidth/(2.0*M_PI*LOOPTIME_SEC*32768.0), 
+            100.0*step.overshoot);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestCurrcntr();
+    TestResolution();
+    TestStepResponse(300.0);
+    TestStepResponse(CURRENT_LOOP_BANDWIDTH_HZ);
+    TestStepResponse(890.0);
+    TestRetune();
+    
+    return TEST_RESULT("test_pi_tune");
+}
@@ -0,0 +1,327 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_position.c
+ *
+ * @brief Host test of position control. Runs point-to-point moves with HFI 
+ * holding position at standstill, and compares profile time, settling, 
+ * overshoot and the accumulated position against the motor model, with and 
+ * without acceleration feedforward. Homing runs against an end stop placed 
+ * in the model.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Decrease of the incremental D axis inductance per Amp, the HFI polarity
+ * detection relies on it */
+#define TEST_LD_SATURATION      0.03
+
+/* Electrical angle counts per mechanical revolution */
+#define TEST_COUNTS_PER_REV     (POLEPAIRS*65536.0)
+
+#define TEST_START_TIME_SEC     1.5
+#define TEST_MOVE_TIME_SEC      3.0
+
+/* Move distances in mechanical revolutions, long move reaches the speed 
+ * limit, short move only the acceleration limit */
+#define TEST_LONG_MOVE_REV      10.0
+#define TEST_MID_MOVE_REV       2.0
+#define TEST_SHORT_MOVE_REV     0.25
+
+/* Profile time against the ideal trapezoid in position steps, settling 
+ * band, overshoot, final error and estimator position error in 
+ * mechanical revolutions, settling time after the profile */
+#define TEST_TIME_ERROR_STEPS   10
+#define TEST_SETTLE_BAND_REV    0.01
+#define TEST_OVERSHOOT_REV      0.05
+#define TEST_FINAL_ERROR_REV    0.002
+#define TEST_SETTLE_SEC         1.0
+
+/* End stop below the start position in mechanical revolutions, and the 
+ * move from home */
+#define TEST_STOP_REV           0.5
+#define TEST_HOME_MOVE_REV      2.0
+#define TEST_HOME_TIME_SEC      2.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        profileTime,        /* Time until the reference is at the target */
+        settleTime,         /* Time until the rotor stays in the band */
+        overshoot,          /* Rotor beyond the target in revolutions */
+        finalError,         /* Rotor position error at the end */
+        estimatorError;     /* Position against the model at the end */
+    
+    uint16_t faultState;    /* Faults at the end */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+/* End stop position of the model in revolutions, rotor is held there 
+ * while the motor torque pushes into it */
+static double stopPosition;
+static bool stopEnable;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static void TestRun(uint32_t cycles)
+{
+    for(; cycles > 0; cycles--)
+    {
+        SIM_Run(1);
+        if(stopEnable && (sim.motor.position <= stopPosition) && 
+            (sim.motor.torque <= 0))
+        {
+            sim.motor.position = stopPosition;
+            sim.motor.locked = true;
+        }
+        else
+        {
+            sim.motor.locked = false;
+        }
+    }
+}
+
+static double TestPositionRev(void)
+{
+    return MCAPP_MC1PositionGet()/TEST_COUNTS_PER_REV;
+}
+
+/* Starts the motor with HFI in position control, holding the start 
+ * position */
+static void TestStart(void)
+{
+    SIM_Init();
+    SIM_Run(1);
+    pMC1Data->controlScheme.ctrlParam.hfiEnable = 1;
+    pMC1Data->controlScheme.position.enable = 1;
+    sim.motor.ldSaturation = TEST_LD_SATURATION;
+    stopEnable = false;
+    SIM_SpeedCommandSet(true, 0);
+    TestRun(SIM_CYCLES(TEST_START_TIME_SEC));
+}
+
+/* Profile time of a trapezoid with the speed and acceleration limits */
+static double TestIdealTime(double distance)
+{
+    const double speed = POSITION_SPEED_MAX_RPM/60.0;
+    const double accel = POSITION_ACCEL_RPM_S/60.0;
+    
+    distance = fabs(distance);
+    if(distance > speed*speed/accel)
+    {
+        return distance/speed + speed/accel;
+    }
+    return 2*sqrt(distance/accel);
+}
+
+static TEST_RESULT_T TestMove(double distance)
+{
+    TEST_RESULT_T result = {-1, -1, 0, 0, 0, 0};
+    const double direction = (distance > 0) ? 1 : -1;
+    const double modelStart = sim.motor.position;
+    const double start = TestPositionRev();
+    uint32_t cycles;
+    double error;
+    
+    MCAPP_MC1PositionMove((int32_t)lround(distance*TEST_COUNTS_PER_REV), 
+                            true);
+    for(cycles = 1; cycles <= SIM_CYCLES(TEST_MOVE_TIME_SEC); cycles++)
+    {
+        TestRun(1);
+        if((result.profileTime < 0) && MCAPP_MC1PositionIsDone())
+        {
+            result.profileTime = cycles*LOOPTIME_SEC;
+        }
+        error = sim.motor.position - modelStart - distance;
+        result.overshoot = fmax(result.overshoot, error*direction);
+        if(fabs(error) > TEST_SETTLE_BAND_REV)
+        {
+            result.settleTime = -1;
+        }
+        else if(result.settleTime < 0)
+        {
+            result.settleTime = cycles*LOOPTIME_SEC;
+        }
+    }
+    result.finalError = error;
+    result.estimatorError = (TestPositionRev() - start) - 
+                                (sim.motor.position - modelStart);
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+/* Moves reach the target in the time of the trapezoid profile, settle 
+ * without losing the position */
+static void TestMoves(void)
+{
+    const double distance[] = {TEST_LONG_MOVE_REV, -TEST_LONG_MOVE_REV, 
+                                TEST_SHORT_MOVE_REV};
+    const double stepSec = POSITION_STEP_SEC;
+    TEST_RESULT_T result;
+    double idealTime;
+    uint16_t index;
+    
+    TestStart();
+    for(index = 0; index < sizeof(distance)/sizeof(distance[0]); index++)
+    {
+        result = TestMove(distance[index]);
+        idealTime = TestIdealTime(distance[index]);
+        TEST_CHECK((result.faultState == 0) && 
+            (fabs(result.profileTime - idealTime) < 
+            TEST_TIME_ERROR_STEPS*stepSec), 
+            "%+.2f rev: profile %.3f s, ideal %.3f s, faults 0x%04x", 
+            distance[index], result.profileTime, idealTime, 
+            result.faultState);
+        TEST_CHECK((result.settleTime > 0) && 
+            (result.settleTime < result.profileTime + TEST_SETTLE_SEC) && 
+            (result.overshoot < TEST_OVERSHOOT_REV), 
+            "%+.2f rev: settled after %.3f s, overshoot %.4f rev", 
+            distance[index], result.settleTime, result.overshoot);
+        TEST_CHECK((fabs(result.finalError) < TEST_FINAL_ERROR_REV) && 
+            (fabs(result.estimatorError) < TEST_FINAL_ERROR_REV), 
+            "%+.2f rev: position error %.4f rev, estimated position error "
+            "%.4f rev", distance[index], result.finalError, 
+            result.estimatorError);
+        printf("  %+6.2f rev: profile %.3f s (ideal %.3f s), settled after"
+            " %.3f s, overshoot %.4f rev, error %.4f rev\n", 
+            distance[index], result.profileTime, idealTime, 
+            result.settleTime, result.overshoot, result.finalError);
+    }
+}
+
+/* Acceleration feedforward shortens settling */
+static void TestFeedForward(void)
+{
+    TEST_RESULT_T withFF, withoutFF;
+    
+    TestStart();
+    withFF = TestMove(TEST_MID_MOVE_REV);
+    TestStart();
+    pMC1Data->controlScheme.position.qAccelFFGain = 0;
+    withoutFF = TestMove(TEST_MID_MOVE_REV);
+    TEST_CHECK((withFF.settleTime > 0) && (withoutFF.settleTime > 0) && 
+        (withFF.settleTime < 0.5*withoutFF.settleTime), 
+        "settled after %.3f s with feedforward, %.3f s without", 
+        withFF.settleTime, withoutFF.settleTime);
+    printf("  %+6.2f rev: settled after %.3f s, overshoot %.4f rev with "
+        "feedforward; %.3f s, %.4f rev without\n", TEST_MID_MOVE_REV, 
+        withFF.settleTime, withFF.overshoot, withoutFF.settleTime, 
+        withoutFF.overshoot);
+}
+
+/* Homing stops at the end stop with limited current and sets the home 
+ * position there */
+static void TestHoming(void)
+{
+    MCAPP_POSITION_T *pPosition = &pMC1Data->controlScheme.position;
+    const double current = POSITION_HOME_CURRENT;
+    uint32_t cycles;
+    double iqMax = 0;
+    
+    TestStart();
+    stopPosition = sim.motor.position - TEST_STOP_REV;
+    stopEnable = true;
+    MCAPP_MC1PositionHome();
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_HOME_TIME_SEC); cycles++)
+    {
+        TestRun(1);
+        iqMax = fmax(iqMax, fabs(sim.motor.iq));
+        if(pPosition->homed)
+        {
+            break;
+        }
+    }
+    TEST_CHECK(pPosition->homed && (sim.motor.position == stopPosition) && 
+        (fabs(TestPositionRev()) < TEST_FINAL_ERROR_REV), 
+        "homed %d: rotor %.4f rev from the end stop, position %.4f rev", 
+        pPosition->homed, sim.motor.position - stopPosition, 
+        TestPositionRev());
+    TEST_CHECK(iqMax < 1.02*current, "homing: Iq %.2f A, limit %.2f A", 
+        iqMax, current);
+    printf("  homing: at the end stop after %.3f s, Iq %.2f A, limit "
+        "%.2f A\n", cycles*LOOPTIME_SEC, iqMax, current);
+    
+    MCAPP_MC1PositionMove((int32_t)(TEST_HOME_MOVE_REV*TEST_COUNTS_PER_REV), 
+                            false);
+    TestRun(SIM_CYCLES(TEST_MOVE_TIME_SEC));
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        (fabs(sim.motor.position - stopPosition - TEST_HOME_MOVE_REV) < 
+        TEST_SETTLE_BAND_REV), "move to %.2f rev: rotor %.4f rev from the "
+        "end stop, faults 0x%04x", TEST_HOME_MOVE_REV, 
+        sim.motor.position - stopPosition, pMC1Data->fault.faultState);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestMoves();
+    TestFeedForward();
+    TestHoming();
+    
+    return TEST_RESULT("test_position");
+}
@@ -0,0 +1,221 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_pwm_fault.c
+ *
+ * @brief Host test of the deferred re-initialization after a PWM PCI fault. 
+ * Checks on the simulated motor that the re-initialization stops the motor 
+ * with the PCI fault latched, keeps identified, tuned and adapted parameters
+ * and the fault history, and that the motor restarts after the fault clear.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "board_service.h"
+#include "fault.h"
+#include "mc_app_types.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Closed loop speed when the PCI fault occurs */
+#define TEST_SPEED_RPM          1000.0
+
+/* Time to start the motor and reach TEST_SPEED_RPM */
+#define TEST_START_TIME_SEC     6.0
+
+/* Control cycles between the PCI fault and the main loop re-init */
+#define TEST_REINIT_DELAY       10
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+static bool pwmFaultInjected;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static void TestReinitKeepsParameters(void)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_MOTOR_T *pMotor = &pMC1Data->motor;
+    int16_t rs, lsDt, speedKp, currentKi, invKfi;
+    int32_t rsStateVar;
+    uint16_t faultHistory;
+    
+    SIM_Init();
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    TEST_CHECK((pControlScheme->focState == FOC_CLOSE_LOOP) && 
+        (pMC1Data->fault.faultState == 0),
+        "closed loop not reached, focState %d fault 0x%04x", 
+        pControlScheme->focState, pMC1Data->fault.faultState);
+    
+    /* Values other than the configuration: identified motor parameters, 
+     * auto-tuned gains and adapted estimator parameters */
+    pMotor->qRs += 16;
+    pMotor->qLsDt += 16;
+    pControlScheme->piSpeed.kp += 1;
+    pControlScheme->piQCurrent.ki += 1;
+    pControlScheme->estimPLL.qInvKfiConst += 16;
+    pControlScheme->estimAdapt.rsStateVar += 0x10000;
+    rs = pMotor->qRs;
+    lsDt = pMotor->qLsDt;
+    speedKp = pControlScheme->piSpeed.kp;
+    currentKi = pControlScheme->piQCurrent.ki;
+    invKfi = pControlScheme->estimPLL.qInvKfiConst;
+    rsStateVar = pControlScheme->estimAdapt.rsStateVar;
+    
+    /* PWM fault ISR, fault state set in the next control loop ISR, then the
+     * main loop re-init a few cycles later */
+    MCAPP_MC1PWMFaultSet();
+    SIM_Run(1);
+    TEST_CHECK((pMC1Data->appState == MCAPP_FAULT) && 
+        (sim.outputsEnabledPending == 0), "state %d, outputs %d after the "
+        "PWM fault", pMC1Data->appState, sim.outputsEnabledPending);
+    faultHistory = pMC1Data->fault.faultHistory;
+    SIM_Run(TEST_REINIT_DELAY);
+    MCAPP_MC1PWMFaultReinit();
+    SIM_Run(TEST_REINIT_DELAY);
+    
+    TEST_CHECK(pMC1Data->appState == MCAPP_FAULT, 
+        "state %d after re-init", pMC1Data->appState);
+    TEST_CHECK(pMC1Data->fault.faultState & MCAPP_PWM_PCI_FAULT, 
+        "PCI fault not latched, fault 0x%04x", pMC1Data->fault.faultState);
+    TEST_CHECK(pMC1Data->fault.faultHistory == faultHistory, 
+        "fault history 0x%04x changed", pMC1Data->fault.faultHistory);
+    TEST_CHECK(pMC1Data->pwmFaultReinitRequest == 0, "re-init still requested");
+    TEST_CHECK(sim.motor.outputsEnabled == 0, "outputs enabled in fault");
+    TEST_CHECK((pControlScheme->piSpeed.integrator == 0) && 
+        (pControlScheme->ctrlParam.qVelRef == 0),
+        "control state not initialized");
+    
+    TEST_CHECK((pMotor->qRs == rs) && (pMotor->qLsDt == lsDt), 
+        "motor parameters lost, Rs %d Ls/dt %d", pMotor->qRs, pMotor->qLsDt);
+    TEST_CHECK((pControlScheme->piSpeed.kp == speedKp) && 
+        (pControlScheme->piQCurrent.ki == currentKi), 
+        "controller gains lost, speed Kp %d current Ki %d", 
+        pControlScheme->piSpeed.kp, pControlScheme->piQCurrent.ki);
+    TEST_CHECK((pControlScheme->estimPLL.qInvKfiConst == invKfi) && 
+        (pControlScheme->estimAdapt.rsStateVar == rsStateVar), 
+        "adapted estimator parameters lost");
+    
+    /* Restart with the kept parameters after the fault clear. The model has no
+     * friction, the rotor would coast at speed forever and does not settle in
+     * rotor lock; stop it at the lock angle so the start does not depend on 
+     * where the rotor coasted to. A start that does not lock is reported as
+     * stall, covered by test_if_start */
+    sim.motor.omega = 0;
+    sim.motor.thetaElec = 0;
+    MCAPP_MC1FaultClear();
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    
+    printf("restart after PCI fault: focState %d, %.0f rpm, fault 0x%04x\n",
+        pControlScheme->focState, PMSM_ModelSpeedRpm(&sim.motor), 
+        pMC1Data->fault.faultState);
+    TEST_CHECK((pControlScheme->focState == FOC_CLOSE_LOOP) && 
+        (pMC1Data->fault.faultState == 0),
+        "no restart after fault clear, focState %d fault 0x%04x", 
+        pControlScheme->focState, pMC1Data->fault.faultState);
+    TEST_CHECK(pMotor->qRs == rs, "Rs changed by restart");
+}
+
+/* PWM fault ISR right after the control loop ISR enabled the outputs at 
+ * motor start, the control loop ISR resumes and moves to MCAPP_RUN */
+static void TestPWMFaultEnableOutputs(void)
+{
+    HAL_MC1PWMEnableOutputs();
+    if(pwmFaultInjected == 0)
+    {
+        HAL_MC1PWMDisableOutputs();
+        MCAPP_MC1PWMFaultSet();
+        pwmFaultInjected = 1;
+    }
+}
+
+static void TestFaultDuringStart(void)
+{
+    uint32_t cycles;
+    
+    SIM_Init();
+    pMC1Data->HAL_PWMEnableOutputs = TestPWMFaultEnableOutputs;
+    pwmFaultInjected = 0;
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    for(cycles = 0; (cycles < SIM_CYCLES(TEST_START_TIME_SEC)) && 
+                    (pwmFaultInjected == 0); cycles++)
+    {
+        SIM_Run(1);
+    }
+    
+    TEST_CHECK(pwmFaultInjected, "outputs not enabled at start");
+    TEST_CHECK((pMC1Data->appState == MCAPP_FAULT) && 
+        (pMC1Data->fault.faultState & MCAPP_PWM_PCI_FAULT) && 
+        (sim.outputsEnabledPending == 0), "PWM fault during start undone: "
+        "state %d, fault 0x%04x, outputs %d", pMC1Data->appState, 
+        pMC1Data->fault.faultState, sim.outputsEnabledPending);
+    
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    TEST_CHECK((pMC1Data->appState == MCAPP_FAULT) && 
+        (sim.motor.outputsEnabled == 0), "state %d, outputs %d after the "
+        "PWM fault during start", pMC1Data->appState, 
+        sim.motor.outputsEnabled);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestReinitKeepsParameters();
+    TestFaultDuringStart();
+    
+    return TEST_RESULT("test_pwm_fault");
+}
@@ -0,0 +1,330 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_speed_profile.c
+ *
+ * @brief Host test of the S-curve speed profile. Runs the profile on ramps, 
+ * retargeting, reversal with different acceleration and deceleration limits 
+ * and a slow ramp below one speed count per step, checking time to target, 
+ * acceleration and jerk limits and overshoot. In closed loop the motor speed 
+ * overshoot is compared with the fixed rate ramp.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define TEST_STEP_SEC           SPEED_PROFILE_STEP_SEC
+#define TEST_STEPS_MAX          30000
+
+/* Time to target against the ideal S-curve profile in profile steps */
+#define TEST_TIME_ERROR_STEPS   10
+
+/* Deceleration limit of the reversal case, acceleration limit of the slow
+ * ramp, below one speed count per step, in RPM/s */
+#define TEST_REVERSAL_DECEL     400.0
+#define TEST_SLOW_ACCEL         2.0
+
+/* Closed loop speed step and jerk limit, longer S-curve than the default 
+ * to round the ramp ends over the speed controller response */
+#define TEST_LOOP_START_RPM     1000.0
+#define TEST_LOOP_TARGET_RPM    2000.0
+#define TEST_LOOP_JERK_RPM_S2   100.0
+#define TEST_LOOP_START_SEC     8.0
+#define TEST_LOOP_RAMP_SEC      14.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        settleTime,         /* Time to target with zero acceleration in s */
+        jerkMax,            /* Largest acceleration change per jerk */
+        accelMax,           /* Largest acceleration per limit, speed rising */
+        decelMax,           /* Largest acceleration per limit, speed falling */
+        overshoot;          /* Speed beyond the target in counts */
+    
+    bool
+        limitExceeded;      /* Acceleration above limit and not falling */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+static MCAPP_SPEED_PROFILE_T *pProfile;
+static MCAPP_CONTROL_T *pCtrlParam;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Speed change between the speed counts of two speeds in RPM */
+static double TestSpeedChange(double startRpm, double targetRpm)
+{
+    return fabs(SIM_RpmFromNorm((int16_t)SIM_NormFromRpm(targetRpm)) - 
+                SIM_RpmFromNorm((int16_t)SIM_NormFromRpm(startRpm)));
+}
+
+static int32_t TestAccel(double rpmPerSec)
+{
+    return (int32_t)(rpmPerSec*TEST_STEP_SEC/(MC1_PEAK_SPEED_RPM)*
+                        2147483648.0);
+}
+
+/* Runs the profile from startRpm towards targetRpm, the target changes to
+ * retargetRpm at retargetSec if it is above zero */
+static TEST_RESULT_T TestProfile(double startRpm, double targetRpm, 
+                                double retargetSec, double retargetRpm)
+{
+    TEST_RESULT_T result = {-1, 0, 0, 0, 0, false};
+    const uint16_t retargetStep = (uint16_t)(retargetSec/TEST_STEP_SEC);
+    int32_t accelLast = 0, accel, limit;
+    double velocity, velocityLast, direction;
+    bool rising;
+    uint16_t step, cycles;
+    
+    MCAPP_SpeedProfileInit(pProfile);
+    pCtrlParam->qVelRef = (int16_t)SIM_NormFromRpm(startRpm);
+    pCtrlParam->qTargetVelocity = (int16_t)SIM_NormFromRpm(targetRpm);
+    velocityLast = pCtrlParam->qVelRef;
+    for(step = 0; step < TEST_STEPS_MAX; step++)
+    {
+        if((retargetSec > 0) && (step == retargetStep))
+        {
+            pCtrlParam->qTargetVelocity = (int16_t)SIM_NormFromRpm(
+                                                            retargetRpm);
+        }
+        for(cycles = 0; cycles < pProfile->countLimit; cycles++)
+        {
+            MCAPP_SpeedProfileStep(pProfile);
+        }
+        accel = pProfile->accel;
+        velocity = pProfile->velocity/65536.0;
+        result.jerkMax = fmax(result.jerkMax, 
+                                fabs((double)accel - accelLast)/pProfile->jerk);
+        
+        /* Deceleration limit while speed magnitude falls at the start of 
+         * the step. Deceleration above the acceleration limit after zero 
+         * speed must fall */
+        rising = ((velocityLast >= 0) && (accel >= 0)) || 
+                    ((velocityLast <= 0) && (accel <= 0));
+        limit = rising ? pProfile->accelMax : pProfile->decelMax;
+        if(labs(accel) >= labs(accelLast))
+        {
+            if(rising)
+            {
+                result.accelMax = fmax(result.accelMax, 
+                                        fabs((double)accel)/limit);
+            }
+            else
+            {
+                result.decelMax = fmax(result.decelMax, 
+                                        fabs((double)accel)/limit);
+            }
+            result.limitExceeded |= (labs(accel) > limit);
+        }
+        
+        /* Speed moving away from the target after passing it */
+        direction = pCtrlParam->qTargetVelocity - velocityLast;
+        if(((velocity - velocityLast)*direction < 0) && 
+            ((pCtrlParam->qTargetVelocity - velocity)*direction < 0))
+        {
+            result.overshoot = fmax(result.overshoot, 
+                            fabs(velocity - pCtrlParam->qTargetVelocity));
+        }
+        if((step > retargetStep) && 
+            (pCtrlParam->qVelRef == pCtrlParam->qTargetVelocity) && 
+            (accel == 0) && (result.settleTime < 0))
+        {
+            result.settleTime = (step + 1)*TEST_STEP_SEC;
+        }
+        accelLast = accel;
+        velocityLast = velocity;
+    }
+    result.overshoot = fmax(result.overshoot, 
+            fabs((double)pCtrlParam->qVelRef - pCtrlParam->qTargetVelocity));
+    return result;
+}
+
+/* Checks a profile run, ideal time to target is skipped if negative */
+static void TestProfileCheck(const char *name, TEST_RESULT_T result, 
+                                double idealTime)
+{
+    TEST_CHECK((result.settleTime > 0) && ((idealTime < 0) || 
+        (fabs(result.settleTime - idealTime) < 
+        TEST_TIME_ERROR_STEPS*TEST_STEP_SEC)), 
+        "%s: target reached after %.3f s, ideal %.3f s", name, 
+        result.settleTime, idealTime);
+    TEST_CHECK(result.jerkMax <= 1.0, "%s: jerk %.3f of limit", name, 
+        result.jerkMax);
+    TEST_CHECK(!result.limitExceeded && (result.accelMax <= 1.0) && 
+        (result.decelMax <= 1.0), 
+        "%s: acceleration %.3f, deceleration %.3f of limit", name, 
+        result.accelMax, result.decelMax);
+    TEST_CHECK(result.overshoot == 0, "%s: overshoot %.2f counts", name, 
+        result.overshoot);
+    printf("  %-10s target after %6.3f s", name, result.settleTime);
+    if(idealTime > 0)
+    {
+        printf(" (ideal %6.3f s)", idealTime);
+    }
+    printf(", jerk %.3f, acceleration %.3f, deceleration %.3f of limit\n",
+        result.jerkMax, result.accelMax, result.decelMax);
+}
+
+static void TestProfiles(void)
+{
+    const double accel = SPEED_PROFILE_ACCEL_RPM_S;
+    const double jerk = SPEED_PROFILE_JERK_RPM_S2;
+    TEST_RESULT_T result;
+    
+    SIM_Init();
+    pProfile = &pMC1Data->controlScheme.speedProfile;
+    pCtrlParam = &pMC1Data->controlScheme.ctrlParam;
+    TEST_CHECK((pProfile->accelMax == TestAccel(accel)) && 
+        (pProfile->jerk == (uint16_t)(TestAccel(jerk)*TEST_STEP_SEC)), 
+        "acceleration %ld, jerk %u counts", (long)pProfile->accelMax, 
+        pProfile->jerk);
+    
+    /* Acceleration limit reached, ideal time speed change/acceleration + 
+     * acceleration/jerk */
+    result = TestProfile(1000, 3000, 0, 0);
+    TestProfileCheck("up", result, 
+                        TestSpeedChange(1000, 3000)/accel + accel/jerk);
+    result = TestProfile(3000, 1000, 0, 0);
+    TestProfileCheck("down", result, 
+                        TestSpeedChange(3000, 1000)/accel + accel/jerk);
+    
+    /* Acceleration limit not reached, 2*sqrt(speed change/jerk) */
+    result = TestProfile(1000, 1010, 0, 0);
+    TestProfileCheck("short", result, 
+                        2*sqrt(TestSpeedChange(1000, 1010)/jerk));
+    
+    /* Target raised and lowered below the present speed during the ramp */
+    result = TestProfile(1000, 3000, 3.0, 2000);
+    TestProfileCheck("raised", result, 
+                        TestSpeedChange(1000, 2000)/accel + accel/jerk);
+    result = TestProfile(1000, 3000, 3.0, 1200);
+    TestProfileCheck("lowered", result, -1);
+    
+    /* Reversal, deceleration limit until zero speed */
+    pProfile->decelMax = TestAccel(TEST_REVERSAL_DECEL);
+    result = TestProfile(1500, -1500, 0, 0);
+    TestProfileCheck("reversal", result, -1);
+    TEST_CHECK(result.decelMax > 0.99, "reversal: deceleration %.3f of "
+        "limit", result.decelMax);
+    pProfile->decelMax = SPEED_PROFILE_DECEL;
+    
+    /* Acceleration below one speed count per step */
+    pProfile->accelMax = TestAccel(TEST_SLOW_ACCEL);
+    result = TestProfile(1000, 1010, 0, 0);
+    TestProfileCheck("slow", result, TestSpeedChange(1000, 1010)/
+                        TEST_SLOW_ACCEL + TEST_SLOW_ACCEL/jerk);
+}
+
+/* Motor speed overshoot at the end of a speed change, fixed rate ramp or 
+ * S-curve profile */
+static double TestLoopOvershoot(bool profile)
+{
+    uint32_t cycles;
+    double overshoot = 0;
+    
+    SIM_Init();
+    SIM_Run(1);
+    SIM_SpeedCommandSet(true, TEST_LOOP_START_RPM);
+    SIM_Run(SIM_CYCLES(TEST_LOOP_START_SEC));
+    pMC1Data->controlScheme.speedProfile.enable = profile;
+    pMC1Data->controlScheme.speedProfile.jerk = (uint16_t)(
+                    TestAccel(TEST_LOOP_JERK_RPM_S2)*TEST_STEP_SEC);
+    SIM_SpeedCommandSet(true, TEST_LOOP_TARGET_RPM);
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOOP_RAMP_SEC); cycles++)
+    {
+        SIM_Run(1);
+        overshoot = fmax(overshoot, 
+                    PMSM_ModelSpeedRpm(&sim.motor) - TEST_LOOP_TARGET_RPM);
+    }
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_LOOP_TARGET_RPM) < 1),
+        "%s: %.1f rpm, faults 0x%04x", profile ? "S-curve" : "ramp", 
+        PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+    return overshoot;
+}
+
+static void TestLoop(void)
+{
+    const double ramp = TestLoopOvershoot(false);
+    const double profile = TestLoopOvershoot(true);
+    
+    TEST_CHECK(profile < 0.5*ramp, "speed overshoot %.1f rpm with S-curve, "
+        "%.1f rpm with ramp", profile, ramp);
+    printf("  closed loop %.0f to %.0f rpm: speed overshoot %.1f rpm with "
+        "S-curve, %.1f rpm with fixed rate ramp\n", TEST_LOOP_START_RPM, 
+        TEST_LOOP_TARGET_RPM, profile, ramp);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestProfiles();
+    TestLoop();
+    
+    return TEST_RESULT("test_speed_profile");
+}
@@ -0,0 +1,209 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_speed_tune.c
+ *
+ * @brief Host test of the speed controller tuning from the identified
+ * mechanical time constant. Runs a speed step on the motor model over a 100x
+ * range of inertia with the fixed SPEEDCNTR gains and with the gains set from
+ * the motor identification, and compares overshoot and settling time.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+/* Speed step, small enough for the proportional part of the step to stay 
+ * within the speed controller output limit at the highest inertia */
+#define TEST_SPEED_RPM          1000.0
+#define TEST_STEP_RPM           10.0
+
+/* Identification time limit */
+#define TEST_ID_TIME_SEC        20.0
+
+/* Start and speed ramp time, plus this per unit of inertia ratio */
+#define TEST_START_TIME_SEC     8.0
+#define TEST_START_TIME_INERTIA_SEC 2.0
+
+/* Step response time and settling band, fraction of the step */
+#define TEST_STEP_TIME_SEC      3.0
+#define TEST_SETTLE_BAND        0.05
+
+/* Limits with tuned gains: overshoot, and the ratio of the longest to the
+ * shortest settling time over the inertia range */
+#define TEST_OVERSHOOT_MAX      0.25
+#define TEST_SETTLE_SPREAD_MAX  1.5
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        overshoot,          /* Fraction of the step */
+        settleTime,         /* Time to stay within TEST_SETTLE_BAND in s */
+        tauRatio;           /* Identified to model mechanical time constant */
+    
+    uint16_t
+        faultState;         /* Faults at the end of the run */
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+/* Speed step with the model inertia changed by the given ratio, with the 
+ * fixed gains or with the gains from motor identification */
+static TEST_RESULT_T TestSpeedStep(double inertiaRatio, bool tune)
+{
+    MCAPP_CONTROL_SCHEME_T *pControlScheme = &pMC1Data->controlScheme;
+    MCAPP_MOTOR_ID_T *pId = &pControlScheme->motorId;
+    MCAPP_CONTROL_T *pCtrlParam = &pControlScheme->ctrlParam;
+    TEST_RESULT_T result = {0, 0, 0, 0};
+    double error, errorMax = 0;
+    uint32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    sim.motor.inertia *= inertiaRatio;
+    if(tune)
+    {
+        pControlScheme->speedTune.enable = 1;
+        pId->request = 1;
+        SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+        for(cycles = 0; (cycles < SIM_CYCLES(TEST_ID_TIME_SEC)) && 
+                            !MCAPP_MotorIdIsComplete(pId); cycles++)
+        {
+            SIM_Run(1);
+        }
+        result.tauRatio = pId->tauMech/(SPEED_LOOP_TAU_MECH*inertiaRatio);
+        
+        /* Restart from standstill at the lock angle, as test_motor_id */
+        SIM_SpeedCommandSet(false, TEST_SPEED_RPM);
+        SIM_Run(SIM_CYCLES(0.5));
+        sim.motor.omega = 0;
+        sim.motor.thetaElec = 0;
+    }
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC + 
+                        TEST_START_TIME_INERTIA_SEC*inertiaRatio));
+    
+    /* Step of the speed reference in one ramp increment */
+    SIM_SpeedCommandSet(true, TEST_SPEED_RPM + TEST_STEP_RPM);
+    SIM_Run(1);
+    pCtrlParam->CLSpeedRampRate = 
+                (int16_t)pCtrlParam->qTargetVelocity - pCtrlParam->qVelRef;
+    pCtrlParam->speedRampSkipCnt = pCtrlParam->speedRampIncLimit;
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_STEP_TIME_SEC); cycles++)
+    {
+        SIM_Run(1);
+        error = PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_RPM - 
+                    TEST_STEP_RPM;
+        errorMax = (error > errorMax) ? error : errorMax;
+        if(fabs(error) > TEST_SETTLE_BAND*TEST_STEP_RPM)
+        {
+            result.settleTime = (cycles + 1)*LOOPTIME_SEC;
+        }
+    }
+    result.overshoot = errorMax/TEST_STEP_RPM;
+    result.faultState = pMC1Data->fault.faultState;
+    return result;
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    const double inertiaRatio[] = {0.1, 0.3, 1.0, 3.0, 10.0};
+    const uint16_t count = sizeof(inertiaRatio)/sizeof(inertiaRatio[0]);
+    TEST_RESULT_T fixed, tuned;
+    double fixedMin = 1e9, fixedMax = 0, tunedMin = 1e9, tunedMax = 0;
+    uint16_t index;
+    
+    for(index = 0; index < count; index++)
+    {
+        fixed = TestSpeedStep(inertiaRatio[index], false);
+        tuned = TestSpeedStep(inertiaRatio[index], true);
+        TEST_CHECK((fixed.faultState == 0) && (tuned.faultState == 0),
+            "inertia x%.1f: faults 0x%04x fixed, 0x%04x tuned", 
+            inertiaRatio[index], fixed.faultState, tuned.faultState);
+        TEST_CHECK(tuned.overshoot < TEST_OVERSHOOT_MAX,
+            "inertia x%.1f: overshoot %.3f with tuned gains", 
+            inertiaRatio[index], tuned.overshoot);
+        printf("  inertia x%4.1f: fixed %5.1f%% %.3f s, tuned %5.1f%% %.3f s"
+            " (tau x%.2f)\n", inertiaRatio[index], 100.0*fixed.overshoot, 
+            fixed.settleTime, 100.0*tuned.overshoot, tuned.settleTime, 
+            tuned.tauRatio);
+        fixedMin = fmin(fixedMin, fixed.settleTime);
+        fixedMax = fmax(fixedMax, fixed.settleTime);
+        tunedMin = fmin(tunedMin, tuned.settleTime);
+        tunedMax = fmax(tunedMax, tuned.settleTime);
+    }
+    TEST_CHECK(tunedMax < TEST_SETTLE_SPREAD_MAX*tunedMin,
+        "settling time %.3f to %.3f s with tuned gains", tunedMin, tunedMax);
+    /* The fixed gains do not follow the inertia */
+    TEST_CHECK(fixedMax > TEST_SETTLE_SPREAD_MAX*fixedMin,
+        "settling time %.3f to %.3f s with fixed gains", fixedMin, fixedMax);
+    printf("  settling time %.3f to %.3f s fixed, %.3f to %.3f s tuned\n",
+            fixedMin, fixedMax, tunedMin, tunedMax);
+    
+    return TEST_RESULT("test_speed_tune");
+}
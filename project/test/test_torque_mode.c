@@ -0,0 +1,304 @@
+// <editor-fold defaultstate="collapsed" desc="Description/Instruction ">
+/**
+ * @file test_torque_mode.c
+ *
+ * @brief Host test of torque mode. Switches between speed and torque mode in 
+ * closed loop under load, and checks the current reference at the switches,
+ * the slew rate of the current command, the response of the motor current 
+ * and the speed limit of torque mode.
+ *
+ * Component: TEST
+ *
+ */
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="Disclaimer ">
+
+/*******************************************************************************
+* SOFTWARE LICENSE AGREEMENT
+* 
+*  [2024] Microchip Technology Inc. and its subsidiaries
+* 
+* Subject to your compliance with these terms, you may use this Microchip 
+* software and any derivatives exclusively with Microchip products. 
+* You are responsible for complying with third party license terms applicable to
+* your use of third party software (including open source software) that may 
+* accompany this Microchip software.
+* 
+* Redistribution of this Microchip software in source or binary form is allowed 
+* and must include the above terms of use and the following disclaimer with the
+* distribution and accompanying materials.
+* 
+* SOFTWARE IS "AS IS." NO WARRANTIES, WHETHER EXPRESS, IMPLIED OR STATUTORY,
+* APPLY TO THIS SOFTWARE, INCLUDING ANY IMPLIED WARRANTIES OF NON-INFRINGEMENT,
+* MERCHANTABILITY, OR FITNESS FOR A PARTICULAR PURPOSE. IN NO EVENT WILL 
+* MICROCHIP BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE, INCIDENTAL OR 
+* CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND WHATSOEVER RELATED TO
+* THE SOFTWARE, HOWEVER CAUSED, EVEN IF MICROCHIP HAS BEEN ADVISED OF THE 
+* POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO THE FULLEST EXTENT ALLOWED BY
+* LAW, MICROCHIP'S TOTAL LIABILITY ON ALL CLAIMS RELATED TO THE SOFTWARE WILL
+* NOT EXCEED AMOUNT OF FEES, IF ANY, YOU PAID DIRECTLY TO MICROCHIP FOR THIS
+* SOFTWARE
+*
+* You agree that you are solely responsible for testing the code and
+* determining its suitability.  Microchip has no obligation to modify, test,
+* certify, or support the code.
+*
+*******************************************************************************/
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="HEADER FILES ">
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <math.h>
+
+#include "mc_app_types.h"
+#include "mc1_calc_params.h"
+#include "mc1_service.h"
+#include "mc1_sim.h"
+#include "test_util.h"
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="DEFINITIONS ">
+
+#define TEST_START_RPM          1500.0
+#define TEST_SPEED_MODE_RPM     2000.0
+
+/* Load as fraction of nominal torque, and current commands as fraction of 
+ * SPEEDCNTR_OUTMAX, above the load current */
+#define TEST_LOAD               0.2
+#define TEST_COMMAND            0.4
+#define TEST_COMMAND_HIGH       0.9
+
+#define TEST_START_TIME_SEC     8.0
+#define TEST_LOAD_RAMP_SEC      1.0
+#define TEST_SWITCH_TIME_SEC    1.0
+#define TEST_LIMIT_TIME_SEC     3.0
+
+/* Largest current reference change per control cycle at a mode switch, 
+ * speed change after switching to torque mode at the load current */
+#define TEST_SWITCH_STEP_A      0.01
+#define TEST_SWITCH_SPEED_RPM   20.0
+
+/* Slew rate error, time after the slew for the motor current to reach the 
+ * command within TEST_CURRENT_ERROR_A */
+#define TEST_SLEW_ERROR         0.02
+#define TEST_CURRENT_ERROR_A    0.02
+#define TEST_CURRENT_DELAY_SEC  0.002
+
+/* Speed above the torque mode limit and speed error at the limit */
+#define TEST_LIMIT_OVERSHOOT    0.1
+#define TEST_LIMIT_ERROR_RPM    5.0
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLE TYPE DEFINITIONS ">
+
+typedef struct
+{
+    double
+        iqStepMax,          /* Largest current reference change per cycle */
+        speedMin,           /* Speed range in RPM */
+        speedMax;
+    
+}TEST_RESULT_T;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="VARIABLES ">
+
+TEST_MAIN;
+
+// </editor-fold>
+
+// <editor-fold defaultstate="collapsed" desc="STATIC FUNCTIONS ">
+
+static double TestCurrent(int16_t qCurrent)
+{
+    return qCurrent*MC1_PEAK_CURRENT/32768.0;
+}
+
+/* Current command of MCAPP_MC1TorqueCommandSet() for a current reference */
+static int16_t TestCommand(int16_t qCurrent)
+{
+    return (int16_t)(((int32_t)qCurrent << 15)/
+                        pMC1Data->controlScheme.torqueControl.qIqMax);
+}
+
+static TEST_RESULT_T TestRun(double seconds)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pMC1Data->controlScheme.ctrlParam;
+    TEST_RESULT_T result = {0, 1e9, -1e9};
+    int16_t iqLast = pCtrlParam->qIqRef;
+    uint32_t cycles;
+    double speed;
+    
+    for(cycles = 0; cycles < SIM_CYCLES(seconds); cycles++)
+    {
+        SIM_Run(1);
+        result.iqStepMax = fmax(result.iqStepMax, 
+                            fabs(TestCurrent(pCtrlParam->qIqRef - iqLast)));
+        iqLast = pCtrlParam->qIqRef;
+        speed = PMSM_ModelSpeedRpm(&sim.motor);
+        result.speedMin = fmin(result.speedMin, speed);
+        result.speedMax = fmax(result.speedMax, speed);
+    }
+    return result;
+}
+
+/* Starts in speed mode with the load ramped in after reaching speed */
+static void TestStart(void)
+{
+    double loadTorque;
+    uint32_t cycles;
+    
+    SIM_Init();
+    SIM_Run(1);
+    loadTorque = TEST_LOAD*1.5*sim.motor.polePairs*sim.motor.flux*
+                    NOMINAL_CURRENT_PEAK;
+    pMC1Data->controlScheme.torqueControl.enable = 1;
+    SIM_SpeedCommandSet(true, TEST_START_RPM);
+    SIM_Run(SIM_CYCLES(TEST_START_TIME_SEC));
+    for(cycles = 0; cycles < SIM_CYCLES(TEST_LOAD_RAMP_SEC); cycles++)
+    {
+        sim.motor.loadTorque = loadTorque*cycles/
+                                    SIM_CYCLES(TEST_LOAD_RAMP_SEC);
+        SIM_Run(1);
+    }
+    sim.motor.loadTorque = loadTorque;
+    SIM_Run(SIM_CYCLES(TEST_SWITCH_TIME_SEC));
+}
+
+/* Torque mode with the command at the present current keeps current and
+ * speed */
+static void TestSwitchToTorque(void)
+{
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->controlScheme.torqueControl;
+    TEST_RESULT_T result;
+    
+    MCAPP_MC1TorqueCommandSet(TestCommand(
+                    pMC1Data->controlScheme.ctrlParam.qIqRef));
+    TEST_CHECK(MCAPP_MC1TorqueModeSet(true), "torque mode request");
+    result = TestRun(TEST_SWITCH_TIME_SEC);
+    TEST_CHECK((pTorque->mode == MCAPP_TORQUE_CONTROL_TORQUE_MODE) && 
+        (result.iqStepMax < TEST_SWITCH_STEP_A) && 
+        (result.speedMax - result.speedMin < TEST_SWITCH_SPEED_RPM), 
+        "to torque mode: mode %d, Iq step %.4f A, speed %.1f to %.1f rpm",
+        pTorque->mode, result.iqStepMax, result.speedMin, result.speedMax);
+    printf("  speed to torque mode at %.0f rpm: Iq step %.4f A, speed %.1f "
+        "to %.1f rpm\n", TEST_START_RPM, result.iqStepMax, result.speedMin, 
+        result.speedMax);
+}
+
+/* Current reference follows the command at TORQUE_SLEW_A_S, the motor 
+ * current reaches it without the speed controller delay */
+static void TestSlew(void)
+{
+    MCAPP_CONTROL_T *pCtrlParam = &pMC1Data->controlScheme.ctrlParam;
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->controlScheme.torqueControl;
+    const double iqStart = TestCurrent(pCtrlParam->qIqRef);
+    double iqTarget, slewTime, slewRate = 0, settleTime = -1;
+    uint32_t cycles;
+    
+    MCAPP_MC1TorqueCommandSet(Q15(TEST_COMMAND));
+    iqTarget = TestCurrent(pTorque->qIqTarget);
+    slewTime = (iqTarget - iqStart)/TORQUE_SLEW_A_S;
+    for(cycles = 1; cycles <= SIM_CYCLES(2*slewTime); cycles++)
+    {
+        SIM_Run(1);
+        if(cycles == SIM_CYCLES(0.5*slewTime))
+        {
+            slewRate = (TestCurrent(pCtrlParam->qIqRef) - iqStart)/
+                            (cycles*LOOPTIME_SEC);
+        }
+        if((settleTime < 0) && 
+            (fabs(sim.motor.iq - iqTarget) < TEST_CURRENT_ERROR_A))
+        {
+            settleTime = cycles*LOOPTIME_SEC;
+        }
+    }
+    TEST_CHECK(fabs(slewRate/TORQUE_SLEW_A_S - 1) < TEST_SLEW_ERROR, 
+        "slew rate %.1f A/s, set %.1f A/s", slewRate, TORQUE_SLEW_A_S);
+    TEST_CHECK((settleTime > 0) && 
+        (settleTime < slewTime + TEST_CURRENT_DELAY_SEC), 
+        "Iq at %.3f A after %.2f ms, slew %.2f ms", iqTarget, 
+        settleTime*1000, slewTime*1000);
+    printf("  command %.3f to %.3f A: slew rate %.1f A/s, motor current at "
+        "the command after %.2f ms, slew %.2f ms\n", iqStart, iqTarget, 
+        slewRate, settleTime*1000, slewTime*1000);
+}
+
+/* Speed controller limits the speed in torque mode, independent of the 
+ * command, and releases it when the command is below the load */
+static void TestSpeedLimit(void)
+{
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->controlScheme.torqueControl;
+    const double limit = TORQUE_SPEED_LIMIT_RPM;
+    TEST_RESULT_T result;
+    double speed;
+    
+    result = TestRun(TEST_LIMIT_TIME_SEC);
+    speed = PMSM_ModelSpeedRpm(&sim.motor);
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        pTorque->speedLimitActive && 
+        (fabs(speed - limit) < TEST_LIMIT_ERROR_RPM) && 
+        (result.speedMax < (1 + TEST_LIMIT_OVERSHOOT)*limit), 
+        "speed limit %d: %.1f rpm, peak %.1f rpm, faults 0x%04x", 
+        pTorque->speedLimitActive, speed, result.speedMax, 
+        pMC1Data->fault.faultState);
+    printf("  command %.1f: held at %.1f rpm, peak %.1f rpm\n", TEST_COMMAND,
+        speed, result.speedMax);
+    
+    MCAPP_MC1TorqueCommandSet(Q15(TEST_COMMAND_HIGH));
+    result = TestRun(TEST_LIMIT_TIME_SEC);
+    TEST_CHECK(pTorque->speedLimitActive && 
+        (result.speedMax < limit + TEST_LIMIT_ERROR_RPM), 
+        "command %.1f: speed limit %d, peak %.1f rpm", TEST_COMMAND_HIGH, 
+        pTorque->speedLimitActive, result.speedMax);
+    
+    /* Command below the load current */
+    MCAPP_MC1TorqueCommandSet(Q15(0.5*TEST_LOAD));
+    result = TestRun(TEST_SWITCH_TIME_SEC);
+    TEST_CHECK(!pTorque->speedLimitActive && (result.speedMin < limit - 
+        10*TEST_LIMIT_ERROR_RPM), "command %.2f: speed limit %d, "
+        "%.1f rpm", 0.5*TEST_LOAD, pTorque->speedLimitActive, 
+        result.speedMin);
+}
+
+/* Speed mode continues from the present speed and current */
+static void TestSwitchToSpeed(void)
+{
+    MCAPP_TORQUE_CONTROL_T *pTorque = &pMC1Data->controlScheme.torqueControl;
+    const double speed = PMSM_ModelSpeedRpm(&sim.motor);
+    TEST_RESULT_T result;
+    
+    SIM_SpeedCommandSet(true, TEST_SPEED_MODE_RPM);
+    MCAPP_MC1TorqueModeSet(false);
+    result = TestRun(TEST_SWITCH_TIME_SEC);
+    TEST_CHECK((pTorque->mode == MCAPP_TORQUE_CONTROL_SPEED_MODE) && 
+        (result.iqStepMax < TEST_SWITCH_STEP_A), 
+        "to speed mode: mode %d, Iq step %.4f A", pTorque->mode, 
+        result.iqStepMax);
+    printf("  torque to speed mode at %.0f rpm: Iq step %.4f A\n", speed, 
+        result.iqStepMax);
+    TestRun(TEST_START_TIME_SEC);
+    TEST_CHECK((pMC1Data->fault.faultState == 0) && 
+        (fabs(PMSM_ModelSpeedRpm(&sim.motor) - TEST_SPEED_MODE_RPM) < 
+        TEST_LIMIT_ERROR_RPM), "speed mode: %.1f rpm, faults 0x%04x", 
+        PMSM_ModelSpeedRpm(&sim.motor), pMC1Data->fault.faultState);
+}
+
+// </editor-fold>
+
+int main(void)
+{
+    TestStart();
+    TestSwitchToTorque();
+    TestSlew();
+    TestSpeedLimit();
+    TestSwitchToSpeed();
+    
+    return TEST_RESULT("test_torque_mode");
+}